@@ -84,15 +84,12 @@ ID id) const throw ()
     assert(id.isAtom() || id.isLiteral());
     assert(id.isAggregateAtom());
 
-    ReadLock lock(mutex);
-    const AddressIndex& idx = container.get<impl::AddressTag>();
-    // the following check only works for random access indices, but here it is ok
-    assert( id.address < idx.size() );
-    return idx.at(id.address);
+    assert( id.address < directory.size() );
+    return directory[id.address];
 }
 
 
-// store symbol, assuming it does not exist (this is only asserted)
+// store symbol, assuming it does not exist (if it was stored concurrently, return the existing one)
 ID AggregateAtomTable::storeAndGetID(
 const AggregateAtom& atm) throw()
 {
@@ -106,11 +103,13 @@ const AggregateAtom& atm) throw()
     WriteLock lock(mutex);
     AddressIndex& idx = container.get<impl::AddressTag>();
     boost::tie(it, success) = idx.push_back(atm);
-    (void)success;
-    assert(success);
+    // if an equal element was stored concurrently since the caller looked it up,
+    // it points to that element and its address is returned
+    if( success )
+        directory.push_back(*it);
 
     return ID(
-        atm.kind,                // kind
+        it->kind,                // kind
                                  // address
         container.project<impl::AddressTag>(it) - idx.begin()
         );
@@ -52,6 +52,7 @@
 
 #include <vector>
 #include <list>
+#include <map>
 
 DLVHEX_NAMESPACE_BEGIN
 
@@ -129,6 +130,14 @@ class DLVHEX_EXPORT AnnotatedGroundProgram
     /** \brief Stores if the overall program contains cycles through external atoms. */
     bool eCyclesTotal;
 
+    // members for incremental analysis (see AnnotatedGroundProgram::updateGroundProgram)
+    /** \brief %Set of atoms which occur in the rules of groundProgram (in contrast to programMask without the EDB). */
+    InterpretationPtr idbAtoms;
+    /** \brief Stores for each external atom the rules of groundProgram with a replacement atom of it in their body. */
+    std::map<ID, std::vector<ID> > rulesWithExternalAtom;
+    /** \brief Stores for each external atom the input atoms which are connected to the heads of AnnotatedGroundProgram::rulesWithExternalAtom by e-edges. */
+    std::map<ID, InterpretationPtr> connectedInputAtoms;
+
     // initialization members
     /** \brief Initializes programMask. */
     void createProgramMask();
@@ -140,12 +149,50 @@ class DLVHEX_EXPORT AnnotatedGroundProgram
     void initialize();
     /** \brief Creates depGraph. */
     void computeAtomDependencyGraph();
+    /**
+     * \brief Returns the node of an atom in depGraph and creates it if necessary.
+     * @param atom Address of a ground atom.
+     * @return Node of \p atom.
+     */
+    Node getDependencyNode(IDAddress atom);
+    /**
+     * \brief Adds the dependencies introduced by a rule to depGraph.
+     * @param ruleID ID of a rule in groundProgram.
+     * @param newEdges If not NULL, edges added to depGraph are appended to this vector.
+     */
+    void addRuleDependencies(ID ruleID, std::vector<std::pair<IDAddress, IDAddress> >* newEdges);
+    /**
+     * \brief Adds e-edges to input atoms which were added to the registry after the rules using the external atom were analyzed.
+     * @param newEdges Edges added to depGraph are appended to this vector.
+     */
+    void connectNewInputAtoms(std::vector<std::pair<IDAddress, IDAddress> >& newEdges);
+    /**
+     * \brief Extends the analysis of a program to a ground program which contains the rules of the analyzed program (at its beginning) and possibly more.
+     *
+     * Only the strongly connected components which are affected by new dependencies are recomputed;
+     * all others are taken over from the previous analysis.
+     * @param newGroundProgram Ground program whose first rules are the ones of groundProgram; the EDB may be arbitrary.
+     */
+    void extendAnalysis(const OrdinaryASPProgram& newGroundProgram);
+    /**
+     * \brief Updates the strongly connected components after depGraph was extended.
+     * @param newEdges Edges which were added to depGraph since the components were computed.
+     * @param newRules Rules which were added to groundProgram since the components were computed.
+     * @param newAtoms Atoms which are not yet part of any component.
+     * @param staleAtoms Atoms without dependencies which shall no longer be part of any component.
+     */
+    void updateStronglyConnectedComponents(const std::vector<std::pair<IDAddress, IDAddress> >& newEdges, const std::vector<ID>& newRules, const std::vector<IDAddress>& newAtoms, const std::vector<IDAddress>& staleAtoms);
     /** \brief Adds dependencies defined via dependencyIDB (see constructor AnnotatedGroundProgram::AnnotatedGroundProgram). */
     void computeAdditionalDependencies();
     /** \brief Computes strongly connected components in depSCC. */
     void computeStronglyConnectedComponents();
     /** \brief Analyzes all components and the overall program for head cycles. */
     void computeHeadCycles();
+    /**
+     * \brief Analyzes a single component for head cycles and marks its rules in headCyclicRules if it has some.
+     * @param comp Index of a component in depSCC.
+     */
+    void computeHeadCycles(int comp);
     /** \brief Analyzes all components and the overall program for cycles through external atoms. */
     void computeECycles();
     public:
@@ -195,6 +242,20 @@ class DLVHEX_EXPORT AnnotatedGroundProgram
          */
         void addProgram(const AnnotatedGroundProgram& other);
 
+        /**
+         * \brief Replaces the analyzed ground program by another one and updates the meta information.
+         *
+         * If the rules of \p groundProgram start with the rules of the analyzed program
+         * (e.g. for the programs of a grounder which supports GenuineGrounder::updateInput),
+         * then the atom dependency graph and its strongly connected components are extended by the new rules
+         * instead of being recomputed; otherwise \p groundProgram is analyzed from scratch.
+         * The EDB of \p groundProgram may differ arbitrarily from the previous one.
+         *
+         * Copies of this object which were made before are not affected.
+         * @param groundProgram The ground program to analyze.
+         */
+        void updateGroundProgram(const OrdinaryASPProgram& groundProgram);
+
         /**
          * \brief Assignment operator.
          * @param other Assign another AnnotatedGroundProgram and overwrite the contents. */
@@ -34,8 +34,14 @@
 
 #include "dlvhex2/PlatformDefinitions.h"
 #include "dlvhex2/PluginInterface.h"
+#include "dlvhex2/Interpretation.h"
 #include "dlvhex2/fwd.h"
 
+#include <boost/unordered_map.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include <string>
+
 DLVHEX_NAMESPACE_BEGIN
 
 /** \brief Base class for customized answer set printers. */
@@ -57,6 +63,77 @@ public ModelCallback
     protected:
         /** \brief Mask representing the set of all atoms to be included in the output; might be NULL to represent that all atoms shall be output. */
         PredicateMaskPtr filterpm;
+        /** \brief Output format as given by option OutputFormat (0 = text, 1 = NDJSON). */
+        int format;
+
+        /** \brief Rendering state of a ground atom. */
+        enum SymbolState
+        {
+            /** \brief The atom is not printed for the user (hidden or auxiliary without printer). */
+            Hidden,
+            /** \brief The atom is rendered in Symbol::text. */
+            Rendered,
+            /** \brief The atom is rendered in Symbol::text and was already written to the NDJSON symbol table as Symbol::number. */
+            Announced
+        };
+        /** \brief Rendering of a ground atom. */
+        struct Symbol
+        {
+            /** \brief See SymbolState. */
+            SymbolState state;
+            /** \brief Text which is printed for the user. */
+            std::string text;
+            /** \brief Number of the atom in the NDJSON output (valid in state Announced). */
+            unsigned number;
+        };
+        /** \brief Renderings of the ground atoms of one registry. */
+        struct SymbolTable
+        {
+            /** \brief Registry the addresses refer to; used to detect a new registry at the address of an expired one. */
+            boost::weak_ptr<Registry> registry;
+            /** \brief Renderings of the ground atoms which occurred in an answer set so far; only these are kept, as ground atom addresses may be large and sparse. */
+            boost::unordered_map<IDAddress, Symbol> symbols;
+        };
+        /** \brief Symbol tables of the registries of the answer sets printed so far (answer sets may come from different registries, e.g. in MLP). */
+        boost::unordered_map<const Registry*, SymbolTable> tables;
+        /** \brief Number of atoms written to the NDJSON symbol table so far; atoms are numbered in this order, as addresses of different registries clash. */
+        unsigned announced;
+        /** \brief Output buffer which is reused for all answer sets. */
+        std::string buffer;
+
+        /**
+         * \brief Returns the symbol table of a registry.
+         * @param reg Registry.
+         * @return Symbol table of \p reg, which is empty if no answer set of \p reg was printed so far.
+         */
+        boost::unordered_map<IDAddress, Symbol>& getSymbols(RegistryPtr reg);
+        /**
+         * \brief Renders a ground atom for the user, or returns the rendering cached from an earlier answer set.
+         *
+         * Auxiliary printers are consulted only once per atom, they must therefore print an atom always the same way.
+         * @param symbols Symbol table of \p reg.
+         * @param reg Registry.
+         * @param address IDAddress of a ground atom.
+         * @return Rendering of the atom or NULL if the atom is not printed.
+         */
+        Symbol* getSymbol(boost::unordered_map<IDAddress, Symbol>& symbols, RegistryPtr reg, IDAddress address);
+        /**
+         * \brief Appends the answer set in the default text format to buffer.
+         * @param symbols Symbol table of \p reg.
+         * @param reg Registry.
+         * @param begin Enumerator of the atoms to print.
+         * @param end End of the atom enumeration.
+         */
+        void renderText(boost::unordered_map<IDAddress, Symbol>& symbols, RegistryPtr reg, Interpretation::Storage::enumerator begin, Interpretation::Storage::enumerator end);
+        /**
+         * \brief Appends the answer set as NDJSON to buffer, preceded by symbol table entries for atoms not seen before.
+         * @param symbols Symbol table of \p reg.
+         * @param reg Registry.
+         * @param as Answer set to print (used for its weight vector).
+         * @param begin Enumerator of the atoms to print.
+         * @param end End of the atom enumeration.
+         */
+        void renderNDJSON(boost::unordered_map<IDAddress, Symbol>& symbols, RegistryPtr reg, AnswerSetPtr as, Interpretation::Storage::enumerator begin, Interpretation::Storage::enumerator end);
 };
 
 DLVHEX_NAMESPACE_END
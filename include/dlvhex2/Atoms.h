@@ -94,20 +94,6 @@ struct DLVHEX_EXPORT OrdinaryAtom:
 public Atom,
 private ostream_printable<OrdinaryAtom>
 {
-    /** \brief The textual representation of the whole thing
-     * this is stored for efficient parsing and printing.
-     *
-     * Note: We could make 'text' part of a template parameter of OrdinaryAtom,
-     * such that different backends can store different "efficient"
-     * representations here (e.g., we could store clasp- or dlv-library internal
-     * atom representations here and index them). If we don't need it, we can
-     * replace it by an empty struct and conserve space.
-     *
-     * Also note: If we only need this for printing, we should generate it on-demand
-     * and save a lot of effort if not everything is printed.
-     */
-    std::string text;
-
     /**
      * \brief Checks if the atom unifies with another one.
      *
@@ -125,6 +111,25 @@ private ostream_printable<OrdinaryAtom>
      * @return True if this atom unifies with \p a and false otherwise.
      */
     bool unifiesWith(const OrdinaryAtom& a, RegistryPtr reg) const;
+    /**
+     * \brief Checks if this ground atom is an instance of another (possibly nonground) one.
+     *
+     * Like unifiesWith(const OrdinaryAtom&, RegistryPtr) for ground atoms, but does not copy the tuples;
+     * repeated variables must be mapped to the same term, also within function terms, anonymous variables match any term.
+     * @param pattern Atom to compare to.
+     * @param reg Registry used to interpret atom arguments.
+     * @return True if a substitution of the variables in \p pattern yields this atom and false otherwise.
+     */
+    bool isInstanceOf(const OrdinaryAtom& pattern, RegistryPtr reg) const;
+    /**
+     * \brief Checks if this ground atom is an instance of another (possibly nonground) one and computes the substitution.
+     * @param pattern Atom to compare to.
+     * @param reg Registry used to interpret atom arguments.
+     * @param substitution Receives the pairs of non-anonymous variables of \p pattern and the terms they are mapped to;
+     * undefined if this atom is not an instance of \p pattern.
+     * @return True if a substitution of the variables in \p pattern yields this atom and false otherwise.
+     */
+    bool isInstanceOf(const OrdinaryAtom& pattern, RegistryPtr reg, std::vector<std::pair<ID, ID> >& substitution) const;
     /**
      * \brief Checks if there is a homomorphism which maps this atom to another one.
      *
@@ -141,26 +146,39 @@ private ostream_printable<OrdinaryAtom>
      * @param kind See Atom::kind.
      */
     OrdinaryAtom(IDKind kind):
-    Atom(kind), text()
+    Atom(kind)
         { assert(ID(kind,0).isOrdinaryAtom()); }
     /**
      * \brief Constructor.
      * @param kind See Atom::kind.
-     * @param test See OrdinaryAtom::text.
+     * @param tuple See Atom::tuple.
      */
-    OrdinaryAtom(IDKind kind, const std::string& text):
-    Atom(kind), text(text)
-        { assert(ID(kind,0).isOrdinaryAtom()); assert(!text.empty()); }
+    OrdinaryAtom(IDKind kind, const Tuple& tuple):
+    Atom(kind, tuple)
+        { assert(ID(kind,0).isOrdinaryAtom()); }
     /**
      * \brief Constructor.
+     *
+     * Ordinary atoms do not store their textual representation,
+     * it is generated from the tuple when the atom is printed (see RawPrinter).
+     * The text (second argument) is ignored, it is kept for source compatibility.
+     * @param kind See Atom::kind.
+     * \deprecated Use OrdinaryAtom(IDKind) instead, this constructor will be removed.
+     */
+    DLVHEX_DEPRECATED OrdinaryAtom(IDKind kind, const std::string&):
+    Atom(kind)
+        { assert(ID(kind,0).isOrdinaryAtom()); }
+    /**
+     * \brief Constructor.
+     *
+     * The text (second argument) is ignored, it is kept for source compatibility.
      * @param kind See Atom::kind.
-     * @param test See OrdinaryAtom::text.
      * @param tuple See Atom::tuple.
+     * \deprecated Use OrdinaryAtom(IDKind, const Tuple&) instead, this constructor will be removed.
      */
-    OrdinaryAtom(IDKind kind, const std::string& text, const Tuple& tuple):
-    Atom(kind, tuple), text(text) {
+    DLVHEX_DEPRECATED OrdinaryAtom(IDKind kind, const std::string&, const Tuple& tuple):
+    Atom(kind, tuple) {
         assert(ID(kind,0).isOrdinaryAtom());
-        assert(!text.empty());
     }
     /**
      * \brief Prints the atom in a human readable format.
@@ -168,7 +186,7 @@ private ostream_printable<OrdinaryAtom>
      * @return \p o.
      */
     std::ostream& print(std::ostream& o) const
-        { return o << "OrdinaryAtom(" << std::hex << kind << std::dec << ",'" << text << "'," << printvector(tuple) << ")"; }
+        { return o << "OrdinaryAtom(" << std::hex << kind << std::dec << "," << printvector(tuple) << ")"; }
 
 };
 
@@ -59,11 +59,20 @@ public ModelGeneratorFactoryBase<Interpretation>
     // methods
     public:
         /** \brief Constructor. */
-        BaseModelGeneratorFactory() {}
+        BaseModelGeneratorFactory(): threadSafe(false) {}
         /** \brief Destructor. */
         virtual ~BaseModelGeneratorFactory() {}
 
+        /** \brief Declares whether the model generators of this factory may run concurrently with others.
+         * @param value True if the solver backend of the model generators runs in a separate process
+         * and all external sources evaluated by them are thread-safe (see ExtSourceProperties::isThreadSafe). */
+        inline void setThreadSafe(bool value) { threadSafe = value; }
+        virtual bool isThreadSafe() const { return threadSafe; }
+
     protected:
+        /** \brief See setThreadSafe. */
+        bool threadSafe;
+
         /** \brief Rewrite all eatoms in body to auxiliary replacement atoms
          * store into registry and return id.
          *
@@ -350,6 +359,36 @@ public ModelGeneratorBase<Interpretation>
             NogoodContainerPtr nogoods,
             bool* fromCache = 0) const;
 
+        /**
+         * \brief Builds the queries of an external atom, i.e., one query for each input vector.
+         *
+         * @param ctx ProgramCtx.
+         * @param eatomID The external atom whose queries shall be built.
+         * @param inputi Interpretation to use as input to the external atom.
+         * @param assigned Set of atoms currently assigned, can be NULL (see BaseModelGenerator::evaluateExternalAtom).
+         * @param changed Set of atoms which possibly changed since last evaluation, can be NULL (see BaseModelGenerator::evaluateExternalAtom).
+         * @param queries Receives the queries in the order in which they are evaluated sequentially.
+         */
+        void buildExternalAtomQueries(ProgramCtx& ctx,
+            ID eatomID,
+            InterpretationConstPtr inputi,
+            InterpretationConstPtr assigned,
+            InterpretationConstPtr changed,
+            std::vector<PluginAtom::Query>& queries) const;
+
+        /**
+         * \brief Passes the answer to a query of an external atom to a callback.
+         *
+         * @param query See PluginInterface::Query.
+         * @param answer Answer of the external source to \p query.
+         * @param cb Callback during evaluation of the external atom (see BaseModelGenerator::ExternalAnswerTupleCallback).
+         * @return False if process was aborted by callback and true otherwise.
+         */
+        bool integrateExternalAnswer(
+            const PluginAtom::Query& query,
+            const PluginAtom::Answer& answer,
+            ExternalAnswerTupleCallback& cb) const;
+
         /**
          * \brief Calculates constant input tuples from auxiliary input predicates and from given constants
          * calls eatom function with each input tuple and maximum input for support set learning.
@@ -367,6 +406,9 @@ public ModelGeneratorBase<Interpretation>
          * \brief Evaluates multiple external atoms.
          *
          * Calls BaseModelGenerator::evaluateExternalAtom for each atom in eatoms.
+         * If parallel evaluation of external atoms is enabled, the queries of all atoms are answered
+         * concurrently (queries to sources which are not thread-safe one after the other) and the answers
+         * are passed to the callback in the same order as in sequential evaluation.
          *
          * @param eatoms Vector of all external atoms to evaluate.
          * @param inputi Interpretation to use as input to the external atoms.
@@ -36,6 +36,9 @@
 #include "dlvhex2/Interpretation.h"
 #include <vector>
 #include <set>
+#include <deque>
+#include <algorithm>
+#include <iterator>
 #include <map>
 #include <boost/foreach.hpp>
 #include "dlvhex2/Printhelpers.h"
@@ -90,8 +93,8 @@ class CDNLSolver : virtual public NogoodContainer, virtual public SATSolver
         InterpretationPtr factWasSet;
         /** \brief Decision level for each atom; undefined if unassigned. */
         DynamicVector<IDAddress, int> decisionlevel;
-        /** \brief Stores for each atom the index and hash of the clause which implied it; undefined if unassigned or guessed. */
-        boost::unordered_map<IDAddress, int, SimpleHashIDAddress> cause;
+        /** \brief Stores for each atom the index of the nogood which implied it; undefined if unassigned or guessed. */
+        DynamicVector<IDAddress, int> cause;
         /** \brief Current decision level >= 0. */
         int currentDL;
         /** \brief Stores the current assignment in chronoligical order. */
@@ -105,31 +108,92 @@ class CDNLSolver : virtual public NogoodContainer, virtual public SATSolver
         /** \brief Stores for each decision level the guessed literal (=decision literal). */
         DynamicVector<int, ID> decisionLiteralOfDecisionLevel;
 
-        // watching data structures for efficient unit propagation
-        /** \brief Stores for each positive literal the nogoods which contain. */
-        boost::unordered_map<IDAddress, Set<int>, SimpleHashIDAddress > nogoodsOfPosLiteral;
-        /** \brief Stores for each negative literal the nogoods which contain. */
-        boost::unordered_map<IDAddress, Set<int>, SimpleHashIDAddress > nogoodsOfNegLiteral;
-        /** \brief Stores for each positive literal the nogoods which watch it (i.e., which might fire once the literal becomes true). */
-        boost::unordered_map<IDAddress, Set<int>, SimpleHashIDAddress > watchingNogoodsOfPosLiteral;
-        /** \brief Stores for each negative literal the nogoods which watch it (i.e., which might fire once the literal becomes true). */
-        boost::unordered_map<IDAddress, Set<int>, SimpleHashIDAddress > watchingNogoodsOfNegLiteral;
-        /** \brief Stores for each nogood the set of watched literals. */
-        std::vector<Set<ID> > watchedLiteralsOfNogood;
-        /** \brief Stores the nogoods which are currently unit (i.e., all literals but one are satisfied). */
-        Set<int> unitNogoods;
-        /** \brief Stores the nogoods which are currently contradictory (i.e., all literals are satisfied). */
-        Set<int> contradictoryNogoods;
+        // flat clause arena and watching data structures for efficient unit propagation
+        /** \brief Number of header words in front of the literals of each clause in the arena (literal count and nogood index). */
+        static const uint32_t clauseHeaderSize = 2;
+        /** \brief Value of clauseOfNogood for nogoods which were deleted from nogoodset. */
+        static const uint32_t noClause = 0xFFFFFFFF;
+        /** \brief Contiguous storage of all nogoods as literal codes (see litCode); a clause is referenced by the 32-bit offset of its header.
+         *
+         * The first two literals of a clause with at least two literals are its watched literals. */
+        std::vector<uint32_t> clauseArena;
+        /** \brief Maps the indices of nogoods in nogoodset to their clause references. */
+        std::vector<uint32_t> clauseOfNogood;
+        /** \brief A watch of a clause together with a blocker literal of the same clause.
+         *
+         * If the blocker is falsified, the clause is inactive and does not need to be visited. */
+        struct Watch
+        {
+            /** \brief Clause reference. */
+            uint32_t clause;
+            /** \brief Code of some other literal of the clause. */
+            uint32_t blocker;
+            Watch(uint32_t clause, uint32_t blocker) : clause(clause), blocker(blocker) {}
+        };
+        /** \brief Stores for each literal code the clauses which watch it (i.e., which might fire once the literal becomes true). */
+        std::vector<std::vector<Watch> > watches;
+        /** \brief Stores for each atom the clauses which must be inspected again once the atom becomes unassigned.
+         *
+         * This is needed for clauses whose state depends on an atom which was assigned on a higher decision level than their watched literals. */
+        std::vector<std::vector<uint32_t> > reexamineOnClear;
+        /** \brief Truth value of each atom: 0 if unassigned, 1 if true and -1 if false. */
+        std::vector<signed char> truthValue;
+        /** \brief Stores the clauses which were unit when they were inspected (i.e., all literals but one are satisfied). */
+        std::vector<uint32_t> unitClauses;
+        /** \brief Stores the clauses which were contradictory when they were inspected (i.e., all literals are satisfied). */
+        std::vector<uint32_t> contradictoryClauses;
 
         // variable selection heuristics
         /** \brief Counter for total number of conflicts so far (periodic reset). */
         int conflicts;
         /** \brief Counts for each positive literal the number of conflicts it was involved in (periodic reset). */
-        boost::unordered_map<IDAddress, int, SimpleHashIDAddress> varCounterPos;
+        DynamicVector<IDAddress, int> varCounterPos;
         /** \brief Counts for each negative literal the number of conflicts it was involved in (periodic reset). */
-        boost::unordered_map<IDAddress, int, SimpleHashIDAddress> varCounterNeg;
+        DynamicVector<IDAddress, int> varCounterNeg;
         /** \brief Stores the indexes of the clauses which were recently contradictory in chronological order. */
         std::vector<int> recentConflicts;
+        /** \brief Stores for each atom its most recent truth value (1 or -1), or 0 if it was never assigned (phase saving). */
+        std::vector<signed char> savedPhase;
+        /** \brief Whether getGuess prefers the saved phase of an atom over the conflict counters. */
+        bool phaseSaving;
+
+        // learned nogood management
+        /** \brief Restart policies. */
+        enum RestartPolicy
+        {
+            /** \brief Never restart. */
+            RestartNone,
+            /** \brief Restart after a number of conflicts following the Luby sequence. */
+            RestartLuby,
+            /** \brief Restart when the recently learned nogoods have a worse literal block distance than the average (Glucose-style). */
+            RestartGlucose
+        };
+        /** \brief Selected restart policy. */
+        RestartPolicy restartPolicy;
+        /** \brief Number of conflicts in one unit of the Luby sequence. */
+        int restartBase;
+        /** \brief Number of conflicts since the last restart. */
+        long conflictsSinceRestart;
+        /** \brief Literal block distances of the most recently learned nogoods (for Glucose-style restarts). */
+        std::deque<uint32_t> recentLBDs;
+        /** \brief Sum of recentLBDs. */
+        long recentLBDSum;
+        /** \brief Sum of the literal block distances of all learned nogoods. */
+        long totalLBDSum;
+        /** \brief Literal block distance of each nogood learned from conflicts; 0 for all other nogoods, which are never deleted. */
+        std::vector<uint32_t> lbdOfNogood;
+        /** \brief Indices of the learned nogoods which are currently part of the instance. */
+        std::vector<int> learnedNogoods;
+        /** \brief Number of conflicts before the first deletion of learned nogoods; 0 disables deletion. */
+        int reduceBase;
+        /** \brief Number of conflicts between the previous and the next deletion of learned nogoods (grows after each deletion). */
+        long reduceInterval;
+        /** \brief Number of conflicts at which learned nogoods are deleted next. */
+        long nextReduce;
+        /** \brief Number of conflicts so far (never reset). */
+        long totalConflicts;
+        /** \brief Number of nogoods which were added to the instance so far; unlike the size of nogoodset, this never decreases. */
+        long nogoodsAdded;
 
         // statistics
         /** \brief Number of assignments so far. */
@@ -142,36 +206,75 @@ class CDNLSolver : virtual public NogoodContainer, virtual public SATSolver
         long cntResSteps;
         /** \brief Number of conflicts so far. */
         long cntDetectedConflicts;
-
-        /** \brief Temporary objects (they are just class members in order to make them reuseable without reallocation). */
-        Set<ID> tmpWatched;
+        /** \brief Number of restarts so far. */
+        long cntRestarts;
+        /** \brief Number of learned nogoods deleted so far. */
+        long cntDeletedNogoods;
 
         // members
+        /** \brief Retrieves the truth value of an atom.
+         * @param litadr Atom IDAddress.
+         * @return 0 if \p litadr is unassigned, 1 if it is true and -1 if it is false. */
+        inline signed char valueOf(IDAddress litadr) const {
+            return litadr < truthValue.size() ? truthValue[litadr] : 0;
+        }
+
         /** \brief Checks if an atom is assigned.
          * @param litadr Atom IDAddress.
          * @return True if \p litadr is assigned and false otherwise. */
         inline bool assigned(IDAddress litadr) {
-            return factWasSet->getFact(litadr);
+            return valueOf(litadr) != 0;
         }
 
         /** \brief Checks if a literal is satisfied.
          * @param lit Literal ID.
          * @return True if \p lit is satisfied and false otherwise. */
         inline bool satisfied(ID lit) {
-            // fact must have been set
-            if (!assigned(lit.address)) return false;
-            // truth value must be the same
-            return interpretation->getFact(lit.address) == !lit.isNaf();
+            return satisfiedCode(litCode(lit));
         }
 
         /** \brief Checks if a literal is falsified.
          * @param litlitadr Literal ID.
          * @return True if \p lit is falsified and false otherwise. */
         inline bool falsified(ID lit) {
-            // fact must have been set
-            if (!assigned(lit.address)) return false;
-            // truth value must be negated
-            return interpretation->getFact(lit.address) != !lit.isNaf();
+            return falsifiedCode(litCode(lit));
+        }
+
+        /** \brief Encodes a literal as index into the watch lists.
+         * @param lit Literal ID.
+         * @return Twice the address of \p lit, plus one if \p lit is default-negated. */
+        static inline uint32_t litCode(ID lit) {
+            return (lit.address << 1) | (lit.isNaf() ? 1 : 0);
+        }
+
+        /** \brief Decodes a literal code.
+         * @param code Literal code as created by litCode.
+         * @return Literal ID. */
+        static inline ID codeLit(uint32_t code) {
+            return createLiteral(code >> 1, (code & 1) == 0);
+        }
+
+        /** \brief Checks if an encoded literal is satisfied.
+         * @param code Literal code.
+         * @return True if the literal is satisfied and false otherwise. */
+        inline bool satisfiedCode(uint32_t code) const {
+            signed char v = valueOf(code >> 1);
+            return v != 0 && (v > 0) == ((code & 1) == 0);
+        }
+
+        /** \brief Checks if an encoded literal is falsified.
+         * @param code Literal code.
+         * @return True if the literal is falsified and false otherwise. */
+        inline bool falsifiedCode(uint32_t code) const {
+            signed char v = valueOf(code >> 1);
+            return v != 0 && (v > 0) == ((code & 1) != 0);
+        }
+
+        /** \brief Retrieves the decision level of an assigned literal.
+         * @param code Literal code.
+         * @return Decision level of the atom of the literal. */
+        inline int levelOf(uint32_t code) {
+            return decisionlevel[code >> 1];
         }
 
         /** \brief Negates a literal ID.
@@ -200,37 +303,79 @@ class CDNLSolver : virtual public NogoodContainer, virtual public SATSolver
         void flipDecisionLiteral();
 
         // members for maintaining the watching data structures
-        /** \brief Performs unit propagation. */
+        /** \brief Possible states of a clause as computed by watchClause. */
+        enum ClauseState
+        {
+            /** \brief At least one literal is falsified. */
+            ClauseInactive,
+            /** \brief No literal is falsified and at least two are unassigned. */
+            ClauseOpen,
+            /** \brief All literals but one are satisfied and the remaining one is unassigned. */
+            ClauseUnit,
+            /** \brief All literals are satisfied. */
+            ClauseContradictory
+        };
+        /** \brief Rebuilds the clause arena and all watches from nogoodset. */
         void initWatchingStructures();
-        /** \brief Updates all data structures after a nogood was added.
-         * @param index Index of added nogood. */
-        void updateWatchingStructuresAfterAddNogood(int index);
-        /** \brief Updates all data structures after a nogood was removed
-         * @param index Former index of removed nogood. */
-        void updateWatchingStructuresAfterRemoveNogood(int index);
+        /** \brief Makes sure that all per-atom vectors can hold a given atom.
+         * @param litadr Atom IDAddress. */
+        void ensureAtomCapacity(IDAddress litadr);
+        /** \brief Copies a nogood of nogoodset into the clause arena and watches it.
+         * @param index Index of the nogood in nogoodset.
+         * @return Clause reference of the new clause. */
+        uint32_t attachNogood(int index);
+        /** \brief Inspects all literals of a clause and moves its watches such that they are valid with respect to the current assignment.
+         *
+         * Unit clauses watch the unassigned literal at position 0 and the satisfied literal with the highest decision level at position 1.
+         * @param cref Clause reference.
+         * @return State of the clause. */
+        ClauseState watchClause(uint32_t cref);
+        /** \brief Calls watchClause and schedules the clause for propagation if it is unit or contradictory.
+         * @param cref Clause reference. */
+        void examineClause(uint32_t cref);
+        /** \brief Replaces a watched literal of a clause.
+         * @param cref Clause reference.
+         * @param from Literal code which shall not be watched any longer.
+         * @param to Literal code which shall now be watched. */
+        void moveWatch(uint32_t cref, uint32_t from, uint32_t to);
         /** \brief Updates all data structures after a literal was assigned to true.
          * @param lit Literal which is now true. */
         void updateWatchingStructuresAfterSetFact(ID lit);
-        /** \brief Updates all data structures after a literal was unassigned.
-         * @param lit Literal which is now unassigned. */
-        void updateWatchingStructuresAfterClearFact(ID lit);
-        /** \brief Removed all watches for a nogood.
-         * @param nogoodNr Index of the nogood to remove all watches for. */
-        void inactivateNogood(int nogoodNr);
-        /** \brief Removed a single watche for a nogood.
-         * @param nogoodNr Index of the nogood to remove the watche for.
-         * @param lit The literal which shall not be watched any longer. */
-        void stopWatching(int nogoodNr, ID lit);
-        /** \brief Adds a single watche for a nogood.
-         * @param nogoodNr Index of the nogood to add the watche for.
-         * @param lit The literal which shall now be watched. */
-        void startWatching(int nogoodNr, ID lit);
+        /** \brief Retrieves the index of a clause in nogoodset.
+         * @param cref Clause reference.
+         * @return Nogood index. */
+        inline int nogoodIndex(uint32_t cref) const {
+            return (int)clauseArena[cref + 1];
+        }
 
         // members for variable selection heuristics
         /** \brief Increses the usage counter for all variables in a nogood.
          * @param ng The nogood whose variables shall be touched. */
         void touchVarsInNogood(Nogood& ng);
 
+        // members for restarts and learned nogood deletion
+        /** \brief Adds a nogood learned by conflict analysis and records its literal block distance.
+         *
+         * Must be called before backtracking since the literal block distance depends on the current decision levels.
+         * @param ng Learned nogood.
+         * @return Index of the new nogood. */
+        int addLearnedNogood(const Nogood& ng);
+        /** \brief Restarts the search and deletes learned nogoods if the respective policy says so; to be called after backtracking from a conflict. */
+        void applySearchPolicies();
+        /** \brief Checks if the restart policy asks for a restart.
+         * @return True if the solver should restart now. */
+        bool restartDue();
+        /** \brief Deletes about half of the learned nogoods with the highest literal block distance which are not the cause of an assignment. */
+        void reduceLearnedNogoods();
+        /** \brief Computes the n-th element of the Luby sequence (1, 1, 2, 1, 1, 2, 4, ...).
+         * @param n Index starting at 0.
+         * @return Element of the sequence. */
+        static long luby(long n);
+        /** \brief Chooses the polarity of a guess according to the saved phase of its atom (if phase saving is enabled and the atom was assigned before).
+         * @param guess Guessed literal.
+         * @return \p guess or its negation. */
+        ID applySavedPhase(ID guess);
+
         // external learning
         /** \brief Set of atoms which (possibly) changes since last call of external learners because they have been reassigned. */
         InterpretationPtr changed;
@@ -256,16 +401,14 @@ class CDNLSolver : virtual public NogoodContainer, virtual public SATSolver
         inline bool contains(const std::vector<T>& s, T el) {
             return std::find(s.begin(), s.end(), el) != s.end();
         }
-        /** \brief Checks if two vectors intersect.
-         * @param a First vector.
-         * @param b Second vector.
-         * @return True if \p a and \p b intersect and false otherwise. */
+        /** \brief Intersects two sorted vectors.
+         * @param a First vector (sorted).
+         * @param b Second vector (sorted).
+         * @return Intersection of \p a and \p b (sorted). */
         template <typename T>
         inline std::vector<T> intersect(const std::vector<T>& a, const std::vector<T>& b) {
             std::vector<T> i;
-            BOOST_FOREACH (T el, a) {
-                if (contains(b, el)) i.push_back(el);
-            }
+            std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(i));
             return i;
         }
 
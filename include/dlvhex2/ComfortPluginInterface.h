@@ -591,6 +591,16 @@ public PluginAtom
          */
         virtual void retrieve(const ComfortQuery& q, ComfortAnswer& a) = 0;
 
+        /**
+         * \brief Retrieve answers to multiple queries (external computation happens here).
+         *
+         * The default implementation calls retrieve(const ComfortQuery&, ComfortAnswer&) for each query;
+         * override it if answering all queries at once is cheaper.
+         * @param qs Queries, see ComfortPluginAtom::ComfortQuery.
+         * @param as Receives exactly one answer per query (in the same order); it is empty when called.
+         */
+        virtual void retrieveBatch(const std::vector<ComfortQuery>& qs, std::vector<ComfortAnswer>& as);
+
     protected:
         /**
          * \brief Implementation of non-comfort interface.
@@ -603,6 +613,17 @@ public PluginAtom
          * @param a See ComfortPluginAtom::ComfortAnswer.
          */
         virtual void retrieve(const Query& q, Answer& a);
+
+        /**
+         * \brief Implementation of non-comfort batch interface.
+         *
+         * Converts all queries (each distinct interpretation only once) and passes them
+         * to the comfort retrieveBatch().
+         * @param qs Queries.
+         * @param as Receives one answer per query.
+         * @param nogoods Not used by comfort plugins.
+         */
+        virtual void retrieveBatch(const std::vector<Query>& qs, std::vector<Answer>& as, const std::vector<NogoodContainerPtr>& nogoods);
 };
 
 DLVHEX_NAMESPACE_END
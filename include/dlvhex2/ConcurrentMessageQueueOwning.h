@@ -30,12 +30,15 @@
 #define _CONCURRENT_MESSAGE_QUEUE_OWNING_H
 
 #include <boost/shared_ptr.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/atomic.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
 #include <boost/thread/thread_time.hpp>
 #include <boost/date_time/time_duration.hpp>
 
-#include <queue>
+#include <vector>
 
 namespace dlvhex
 {
@@ -43,6 +46,16 @@ namespace dlvhex
     /**
      * Message queue for inter-thread communication. Modelled after
      * boost::interprocess::message_queue.
+     *
+     * The messages are stored in a bounded ring buffer which can be used
+     * by multiple producers and consumers without locking: each slot carries
+     * a sequence number which tells whether it can be written or read in
+     * the current round, and producers and consumers claim slots by
+     * incrementing their position counter atomically.
+     *
+     * Blocking operations first spin a few rounds and then sleep on a
+     * condition variable. The mutex is only taken by threads which go to
+     * sleep and by threads which have to wake up a sleeping thread.
      */
     template<class MessageBase>
         class ConcurrentMessageQueueOwning
@@ -50,125 +63,205 @@ namespace dlvhex
         private:
             typedef boost::shared_ptr<MessageBase> MessagePtr;
 
-            /** \brief Holds data of message queue. */
-            std::queue<MessagePtr> q;
+            /** \brief Slot of the ring buffer. */
+            struct Slot
+            {
+                /** \brief Twice the position which may write the slot next, or twice the position which wrote it plus one if the message is ready to read. */
+                boost::atomic<std::size_t> sequence;
+                /** \brief Message stored in this slot. */
+                MessagePtr message;
+            };
+
+            /** \brief Number of attempts before a blocking operation yields the processor. */
+            static const unsigned SpinAttempts = 16;
+            /** \brief Number of attempts before a blocking operation goes to sleep. */
+            static const unsigned YieldAttempts = 32;
+
             /** \brief Capacity of message queue. */
             const std::size_t n;
-            /** \brief Enqueuing counter. */
-            std::size_t enq;
-            /** \brief Dequeuing counter. */
-            std::size_t deq;
-
-            /** \brief A mutex lock and the associated condition variable. */
+            /** \brief Holds data of message queue. */
+            boost::scoped_array<Slot> slots;
+            /** \brief Position of the next message to enqueue. */
+            boost::atomic<std::size_t> enqPos;
+            /** \brief Position of the next message to dequeue. */
+            boost::atomic<std::size_t> deqPos;
+            /** \brief Number of producers which sleep until capacity is available. */
+            boost::atomic<std::size_t> enq;
+            /** \brief Number of consumers which sleep until a message is available. */
+            boost::atomic<std::size_t> deq;
+
+            /** \brief Protects sleeping on the condition variables. */
             mutable boost::mutex mtx;
-            /** \brief Condition for multithreading access. */
-            boost::condition_variable cnd;
+            /** \brief Condition for producers. */
+            boost::condition_variable notFull;
+            /** \brief Condition for consumers. */
+            boost::condition_variable notEmpty;
+
+            /** \brief Initializes the slots. */
+            inline void
+            init() {
+                slots.reset(new Slot[n]);
+                for (std::size_t i = 0; i < n; ++i)
+                    slots[i].sequence.store(2 * i, boost::memory_order_relaxed);
+                enqPos.store(0, boost::memory_order_relaxed);
+                deqPos.store(0, boost::memory_order_relaxed);
+                enq.store(0, boost::memory_order_relaxed);
+                deq.store(0, boost::memory_order_relaxed);
+            }
 
             /** \brief Notifier of model consumer. */
             inline void
             notifyConsumer() {
-                if (deq > 0) {   // is some consumer waiting?
-                                 // notify one consuming thread
-                    cnd.notify_one();
+                // pairs with the increment in waitOnEmpty: either the consumer sees the new message or we see the consumer
+                boost::atomic_thread_fence(boost::memory_order_seq_cst);
+                if (deq.load(boost::memory_order_relaxed) > 0) {
+                    // is some consumer waiting?
+                    // taking the lock ensures that it is either before its check or already sleeping
+                    boost::mutex::scoped_lock lock(mtx);
+                    notEmpty.notify_all();
                 }
             }
 
             /** \brief Notifier of model produces. */
             inline void
             notifyProducer() {
-                if (enq > 0) {   // is some producer waiting?
-                                 // notify one producing thread
-                    cnd.notify_one();
+                boost::atomic_thread_fence(boost::memory_order_seq_cst);
+                if (enq.load(boost::memory_order_relaxed) > 0) {
+                    // is some producer waiting?
+                    boost::mutex::scoped_lock lock(mtx);
+                    notFull.notify_all();
                 }
             }
 
-            /** \brief Wait until free space is available in the queue. */
-            inline void
-            waitOnCapacity(boost::mutex::scoped_lock& lock) {
-                                 // maximum capacity reached
-                while (n == q.size()) {
-                    ++enq;
-                    cnd.wait(lock);
-                    --enq;
+            /** \brief Add a message if there is free space.
+             * @param m Message to add.
+             * @return True if the message was added. */
+            inline bool
+            pushMessage (const MessagePtr& m) {
+                std::size_t pos = enqPos.load(boost::memory_order_relaxed);
+                for (;;) {
+                    Slot& slot = slots[pos % n];
+                    std::size_t seq = slot.sequence.load(boost::memory_order_acquire);
+                    std::ptrdiff_t diff = (std::ptrdiff_t)(seq - 2 * pos);
+                    if (diff == 0) {
+                        // slot is free in this round, try to claim it
+                        if (enqPos.compare_exchange_weak(pos, pos + 1, boost::memory_order_relaxed)) {
+                            slot.message = m;
+                            slot.sequence.store(2 * pos + 1, boost::memory_order_release);
+                            return true;
+                        }
+                    }
+                    else if (diff < 0) {
+                        // slot still belongs to the previous round: queue is full
+                        return false;
+                    }
+                    else {
+                        // another producer was faster
+                        pos = enqPos.load(boost::memory_order_relaxed);
+                    }
                 }
-
-                notifyConsumer();
             }
 
-            /** \brief Wait until the queue is empty. */
-            inline void
-            waitOnEmpty(boost::mutex::scoped_lock& lock) {
-                                 // minimum capacity reached
-                while (q.empty()) {
-                    ++deq;
-                    cnd.wait(lock);
-                    --deq;
+            /** \brief Retrieve and remove a message if there is one.
+             * @param m Retrieved message.
+             * @return True if a message was retrieved. */
+            inline bool
+            popMessage (MessagePtr& m) {
+                std::size_t pos = deqPos.load(boost::memory_order_relaxed);
+                for (;;) {
+                    Slot& slot = slots[pos % n];
+                    std::size_t seq = slot.sequence.load(boost::memory_order_acquire);
+                    std::ptrdiff_t diff = (std::ptrdiff_t)(seq - (2 * pos + 1));
+                    if (diff == 0) {
+                        // slot holds the message of this round, try to claim it
+                        if (deqPos.compare_exchange_weak(pos, pos + 1, boost::memory_order_relaxed)) {
+                            m.swap(slot.message);
+                            slot.message.reset();
+                            slot.sequence.store(2 * (pos + n), boost::memory_order_release);
+                            return true;
+                        }
+                    }
+                    else if (diff < 0) {
+                        // message of this round was not written (completely) yet: queue is empty
+                        return false;
+                    }
+                    else {
+                        // another consumer was faster
+                        pos = deqPos.load(boost::memory_order_relaxed);
+                    }
                 }
-
-                notifyProducer();
             }
 
-            /** \brief Wait until free space is available in the queue respecting a timeout.
-             * @param lock Mutex.
-             * @param t Timeout
-             * @return True if free space is available, false if timeout occurred. */
+            /** \brief Add a message, wait until free space is available in the queue.
+             * @param m Message to add.
+             * @param deadline Sleep at most until this point in time, if given.
+             * @return True if the message was added, false if timeout occurred. */
             inline bool
-            waitOnTimedCapacity(boost::mutex::scoped_lock& lock, const boost::posix_time::time_duration& t) {
-                bool no_timeout = true;
-
-                                 // maximum capacity reached
-                while (n == q.size() && no_timeout) {
-                    ++enq;
-                    no_timeout = cnd.timed_wait(lock, t);
-                    --enq;
+            waitOnCapacity(const MessagePtr& m, const boost::system_time* deadline = 0) {
+                for (unsigned attempt = 0; attempt < YieldAttempts; ++attempt) {
+                    if (pushMessage(m))
+                        return true;
+                    if (attempt >= SpinAttempts)
+                        boost::this_thread::yield();
                 }
 
-                notifyConsumer();
-
-                return no_timeout;
-            }
-
-            /** \brief Wait until queue is empty respecting a timeout.
-             * @param lock Mutex.
-             * @param t Timeout
-             * @return True if queue is empty, false if timeout occurred. */
-            inline bool
-            waitOnTimedEmpty(boost::mutex::scoped_lock& lock, const boost::posix_time::time_duration& t) {
+                boost::mutex::scoped_lock lock(mtx);
                 bool no_timeout = true;
-
-                                 // minimum capacity reached
-                while (q.empty() && no_timeout) {
-                    ++deq;
-                    no_timeout = cnd.timed_wait(lock, t);
-                    --deq;
+                ++enq;
+                boost::atomic_thread_fence(boost::memory_order_seq_cst);
+                // maximum capacity reached
+                while (!pushMessage(m)) {
+                    if (!no_timeout) {
+                        --enq;
+                        return false;
+                    }
+                    if (deadline)
+                        no_timeout = notFull.timed_wait(lock, *deadline);
+                    else
+                        notFull.wait(lock);
                 }
-
-                notifyProducer();
-
-                return no_timeout;
+                --enq;
+                return true;
             }
 
-            /** \brief Add a message.
-             * @param m Message to add. */
-            inline void
-            pushMessage (MessagePtr m) {
-                q.push(m);
-            }
+            /** \brief Retrieve and remove a message, wait until the queue is not empty.
+             * @param m Retrieved message.
+             * @param deadline Sleep at most until this point in time, if given.
+             * @return True if a message was retrieved, false if timeout occurred. */
+            inline bool
+            waitOnEmpty(MessagePtr& m, const boost::system_time* deadline = 0) {
+                for (unsigned attempt = 0; attempt < YieldAttempts; ++attempt) {
+                    if (popMessage(m))
+                        return true;
+                    if (attempt >= SpinAttempts)
+                        boost::this_thread::yield();
+                }
 
-            /** \brief Retrieve and remove a message.
-             * @param m Retrieved message. */
-            inline void
-            popMessage (MessagePtr& m) {
-                m = q.front();
-                q.pop();
+                boost::mutex::scoped_lock lock(mtx);
+                bool no_timeout = true;
+                ++deq;
+                boost::atomic_thread_fence(boost::memory_order_seq_cst);
+                // minimum capacity reached
+                while (!popMessage(m)) {
+                    if (!no_timeout) {
+                        --deq;
+                        return false;
+                    }
+                    if (deadline)
+                        no_timeout = notEmpty.timed_wait(lock, *deadline);
+                    else
+                        notEmpty.wait(lock);
+                }
+                --deq;
+                return true;
             }
 
         public:
 
             /** \brief Default constructor, capacity is one. */
             ConcurrentMessageQueueOwning()
-                : n(1), enq(0), deq(0)
-                { }
+                : n(1)
+                { init(); }
 
             /**
              * Initialize with capacity, if @a capacity is 0, we force it to be 1.
@@ -176,14 +269,14 @@ namespace dlvhex
              * @param capacity the capacity of this message queue.
              */
             ConcurrentMessageQueueOwning(std::size_t capacity)
-                : n(capacity > 0 ? capacity : 1), enq(0), deq(0)
-                { }
+                : n(capacity > 0 ? capacity : 1)
+                { init(); }
 
             /** \brief Copy-constructor, just take capacity but not content.
              * @param q Second ConcurrentMessageQueueOwning. */
             ConcurrentMessageQueueOwning(const ConcurrentMessageQueueOwning<MessageBase>& q)
-                : n(q.n), enq(0), deq(0)
-                { }
+                : n(q.n)
+                { init(); }
 
             /** \brief Destructor. */
             virtual
@@ -192,28 +285,27 @@ namespace dlvhex
             }
 
             /** \brief Pop all element from the queue. */
-            void flush() { {
-                    boost::mutex::scoped_lock lock(mtx);
-                    // just pop all elements from the queue (the smart pointers automatically
-                    // destruct the elements and free the memory)
-                    while (!q.empty())
-                        q.pop();
-                }
+            void flush() {
+                // just pop all elements from the queue (the smart pointers automatically
+                // destruct the elements and free the memory)
+                MessagePtr m;
+                while (popMessage(m))
+                    m.reset();
                 notifyProducer();
             }
 
-            /** \brief Clear queue.
-             * @return True. */
+            /** \brief Check if the queue is empty.
+             * @return True if there is no message in the queue. */
             bool
                 empty () const
             {
-                boost::mutex::scoped_lock lock(mtx);
-                return q.empty();
+                std::size_t pos = deqPos.load(boost::memory_order_relaxed);
+                return slots[pos % n].sequence.load(boost::memory_order_acquire) != 2 * pos + 1;
             }
 
-            /** \brief Return size of the queue.
-             * @return Size. */
-            bool
+            /** \brief Return capacity of the queue.
+             * @return Capacity. */
+            std::size_t
                 size () const
             {
                 return n;
@@ -224,9 +316,23 @@ namespace dlvhex
              * @param prio Unused. */
             void
             send (MessagePtr m, unsigned int prio) {
-                boost::mutex::scoped_lock lock(mtx);
-                waitOnCapacity(lock);
-                pushMessage(m);
+                waitOnCapacity(m);
+                notifyConsumer();
+            }
+
+            /** \brief Send several messages in this order, waking up consumers only once if possible.
+             * @param ms Messages.
+             * @param prio Unused. */
+            void
+            send_batch (const std::vector<MessagePtr>& ms, unsigned int prio) {
+                for (typename std::vector<MessagePtr>::const_iterator it = ms.begin(); it != ms.end(); ++it) {
+                    if (!pushMessage(*it)) {
+                        // let consumers make room before we wait
+                        notifyConsumer();
+                        waitOnCapacity(*it);
+                    }
+                }
+                notifyConsumer();
             }
 
             /** \brief Try to send a message.
@@ -235,10 +341,7 @@ namespace dlvhex
              * @return True if succeeded. */
             bool
             try_send (MessagePtr m, unsigned int prio) {
-                boost::mutex::scoped_lock lock(mtx);
-
-                if (q.size() < n) {
-                    pushMessage(m);
+                if (pushMessage(m)) {
                     notifyConsumer();
                     return true;
                 }
@@ -253,10 +356,9 @@ namespace dlvhex
              * @return True if succeeded. */
             bool
             timed_send (MessagePtr m, unsigned int prio, const boost::posix_time::time_duration& t) {
-                boost::mutex::scoped_lock lock(mtx);
-
-                if (waitOnTimedCapacity(lock, t)) {
-                    pushMessage(m);
+                boost::system_time deadline = boost::get_system_time() + t;
+                if (waitOnCapacity(m, &deadline)) {
+                    notifyConsumer();
                     return true;
                 }
 
@@ -268,9 +370,27 @@ namespace dlvhex
              * @param prio Unused. */
             void
             receive (MessagePtr& m, unsigned int& prio) {
-                boost::mutex::scoped_lock lock(mtx);
-                waitOnEmpty(lock);
-                popMessage(m);
+                waitOnEmpty(m);
+                notifyProducer();
+            }
+
+            /** \brief Receive at least one and at most \p max messages in the order in which they were sent (by each producer).
+             * @param ms Vector to which the messages are appended.
+             * @param max Maximum number of messages to receive.
+             * @param prio Unused.
+             * @return Number of received messages. */
+            std::size_t
+            receive_batch (std::vector<MessagePtr>& ms, std::size_t max, unsigned int& prio) {
+                if (max == 0)
+                    return 0;
+                MessagePtr m;
+                waitOnEmpty(m);
+                ms.push_back(m);
+                std::size_t received = 1;
+                for (; received < max && popMessage(m); ++received)
+                    ms.push_back(m);
+                notifyProducer();
+                return received;
             }
 
             /** \brief Try to receive a message.
@@ -279,10 +399,7 @@ namespace dlvhex
              * @return True if succeeded. */
             bool
             try_receive (MessagePtr& m, unsigned int prio) {
-                boost::mutex::scoped_lock lock(mtx);
-
-                if (!q.empty()) {
-                    popMessage(m);
+                if (popMessage(m)) {
                     notifyProducer();
                     return true;
                 }
@@ -297,10 +414,9 @@ namespace dlvhex
              * @return True if succeeded. */
             bool
             timed_receive (MessagePtr& m, unsigned int& prio, const boost::posix_time::time_duration& t) {
-                boost::mutex::scoped_lock lock(mtx);
-
-                if (waitOnTimedEmpty(lock, t)) {
-                    popMessage(m);
+                boost::system_time deadline = boost::get_system_time() + t;
+                if (waitOnEmpty(m, &deadline)) {
+                    notifyProducer();
                     return true;
                 }
 
@@ -0,0 +1,170 @@
+/* dlvhex -- Answer-Set Programming with external interfaces.
+ * Copyright (C) 2005-2007 Roman Schindlauer
+ * Copyright (C) 2006-2015 Thomas Krennwallner
+ * Copyright (C) 2009-2015 Peter Schüller
+ * Copyright (C) 2011-2015 Christoph Redl
+ *
+ * This file is part of dlvhex.
+ *
+ * dlvhex is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * dlvhex is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with dlvhex; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+/**
+ * @file   DeltaInterpretation.h
+ *
+ * @brief  Interpretations of the model graph which share the interpretations of the models they are built from.
+ */
+
+#ifndef DELTA_INTERPRETATION_HPP_INCLUDED__17102026
+#define DELTA_INTERPRETATION_HPP_INCLUDED__17102026
+
+#include "dlvhex2/PlatformDefinitions.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <set>
+#include <vector>
+
+DLVHEX_NAMESPACE_BEGIN
+
+/**
+ * \brief Copy-on-write interpretation of a model in the model graph.
+ *
+ * An interpretation is the union of the interpretations of its bases and of a delta.
+ * Model generators output only the atoms derived in their unit, hence output models are deltas without bases.
+ * Input models unite the output models of their predecessors; they reference them instead of copying them,
+ * and the interpretation as a whole is materialized on demand.
+ * The materialized union is kept until the deltas it consists of change.
+ */
+template<typename InterpretationT>
+class DeltaInterpretation
+{
+    // types
+    public:
+        typedef DeltaInterpretation<InterpretationT> Self;
+        typedef boost::shared_ptr<Self> Ptr;
+        typedef boost::shared_ptr<const Self> ConstPtr;
+        typedef typename InterpretationT::Ptr InterpretationPtr;
+        typedef typename InterpretationT::ConstPtr InterpretationConstPtr;
+
+        // storage
+    protected:
+        /** \brief Interpretations contained in this interpretation. */
+        std::vector<ConstPtr> bases;
+        /** \brief Atoms not contained in the bases; might be NULL for unions. */
+        InterpretationConstPtr delta;
+        /** \brief Deltas of the last materialized union. */
+        mutable std::vector<InterpretationConstPtr> materializedDeltas;
+        /** \brief Last materialized union (NULL if not yet materialized). */
+        mutable InterpretationConstPtr materialized;
+        /** \brief Protects materializedDeltas and materialized. */
+        mutable boost::mutex materializedMutex;
+
+        // methods
+    public:
+        /** \brief Constructor for an interpretation without bases.
+         * @param delta Interpretation to share. */
+        DeltaInterpretation(InterpretationConstPtr delta):
+        bases(), delta(delta) {}
+
+        /** \brief Constructor for the union of interpretations.
+         * @param bases Interpretations to unite. */
+        DeltaInterpretation(const std::vector<ConstPtr>& bases):
+        bases(bases), delta() {}
+
+        /**
+         * \brief Computes the represented interpretation.
+         *
+         * Interpretations without bases are returned without copying.
+         * Unions are computed only if a delta changed since the last call.
+         * @return Interpretation which must not be modified.
+         */
+        InterpretationConstPtr materialize() const;
+
+        /** \brief Replaces the atoms not contained in the bases.
+         * @param delta Interpretation to share. */
+        void setDelta(InterpretationConstPtr delta);
+
+    protected:
+        /** \brief Collects all deltas reachable from this interpretation.
+         * @param visited Interpretations visited so far.
+         * @param deltas Deltas found so far. */
+        void collectDeltas(std::set<const Self*>& visited, std::vector<InterpretationConstPtr>& deltas) const;
+};
+
+template<typename InterpretationT>
+typename DeltaInterpretation<InterpretationT>::InterpretationConstPtr
+DeltaInterpretation<InterpretationT>::materialize() const
+{
+    if( bases.empty() )
+        return delta;
+
+    // collecting the deltas does not copy atoms, and it detects changed deltas of bases
+    std::set<const Self*> visited;
+    std::vector<InterpretationConstPtr> deltas;
+    collectDeltas(visited, deltas);
+
+    boost::mutex::scoped_lock lock(materializedMutex);
+    if( !!materialized && deltas == materializedDeltas )
+        return materialized;
+    if( deltas.empty() )
+        return InterpretationConstPtr();
+
+    InterpretationPtr result(new InterpretationT(*deltas.front()));
+    typename std::vector<InterpretationConstPtr>::const_iterator it;
+    for(it = deltas.begin() + 1; it != deltas.end(); ++it)
+        result->add(**it);
+    materializedDeltas.swap(deltas);
+    materialized = result;
+    return result;
+}
+
+
+template<typename InterpretationT>
+void
+DeltaInterpretation<InterpretationT>::setDelta(
+InterpretationConstPtr delta)
+{
+    this->delta = delta;
+    boost::mutex::scoped_lock lock(materializedMutex);
+    materializedDeltas.clear();
+    materialized.reset();
+}
+
+
+template<typename InterpretationT>
+void
+DeltaInterpretation<InterpretationT>::collectDeltas(
+std::set<const Self*>& visited, std::vector<InterpretationConstPtr>& deltas) const
+{
+    // a base might be reachable via several paths
+    if( !visited.insert(this).second )
+        return;
+    if( !!delta )
+        deltas.push_back(delta);
+    typename std::vector<ConstPtr>::const_iterator it;
+    for(it = bases.begin(); it != bases.end(); ++it)
+        (*it)->collectDeltas(visited, deltas);
+}
+
+
+DLVHEX_NAMESPACE_END
+#endif                           // DELTA_INTERPRETATION_HPP_INCLUDED__17102026
+
+// vim:expandtab:ts=4:sw=4:
+// mode: C++
+// End:
@@ -120,6 +120,8 @@ struct ExtSourceProperties
     bool usesEnvironment;        // external atom uses the environment (cf. acthex)
     /** \brief See ExtSourceProperties::hasFiniteFiber. */
     bool finiteFiber;            // a fixed output value can be produced only by finitly many different inputs
+    /** \brief See ExtSourceProperties::isThreadSafe. */
+    bool threadSafe;             // retrieve may be called concurrently for different queries
     /** \brief See ExtSourceProperties::hasWellorderingStrlen. */
                                  // <i,j> means that output value at position j is strictly smaller than at input position i (strlen)
     std::set<std::pair<int, int> > wellorderingStrlen;
@@ -136,6 +138,7 @@ struct ExtSourceProperties
         tuplelevellinear = false;
         usesEnvironment = false;
         finiteFiber = false;
+        threadSafe = false;
         supportSets = false;
         completePositiveSupportSets = false;
         completeNegativeSupportSets = false;
@@ -186,6 +189,8 @@ struct ExtSourceProperties
     inline void setUsesEnvironment(bool value) { usesEnvironment = value; }
     /** \brief See ExtSourceProperties::hasFiniteFiber. */
     inline void setFiniteFiber(bool value) { finiteFiber = value; }
+    /** \brief See ExtSourceProperties::isThreadSafe. */
+    inline void setThreadSafe(bool value) { threadSafe = value; }
     /** \brief See ExtSourceProperties::hasWellorderingStrlen. */
     inline void addWellorderingStrlen(int index1, int index2) { wellorderingStrlen.insert(std::pair<int, int>(index1, index2)); }
     /** \brief See ExtSourceProperties::hasWellorderingNatural. */
@@ -357,6 +362,17 @@ struct ExtSourceProperties
     bool hasVariableOutputArity() const
         { return variableOutputArity; }
 
+    /**
+     * \brief Checks if the external source may be evaluated concurrently.
+     *
+     * If the external source specifies this property, then PluginAtom::retrieve might be called
+     * concurrently from multiple threads for different queries, provided that parallel evaluation
+     * of external atoms is enabled (option --parallelext).
+     * @return True if PluginAtom::retrieve is thread-safe.
+     */
+    bool isThreadSafe() const
+        { return threadSafe; }
+
     /**
      * \brief Checks if the external source is interested in the assigned atoms during evaluation.
      *
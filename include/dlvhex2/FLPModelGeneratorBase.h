@@ -152,8 +152,8 @@ public BaseModelGenerator
         /** \brief Reference to the factory which created this model generator. */
         FLPModelGeneratorFactoryBase& factory;
 
-        /** \brief Meta information about the ground program of this model generator. */
-        AnnotatedGroundProgram annotatedGroundProgram;
+        /** \brief Meta information about the ground program of this model generator; might be shared with the factory and other model generators. */
+        boost::shared_ptr<AnnotatedGroundProgram> annotatedGroundProgram;
     protected:
         /** \brief Checks whether guessed external atom truth values
          * and external atom computations coincide.
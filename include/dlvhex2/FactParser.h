@@ -0,0 +1,184 @@
+/* dlvhex -- Answer-Set Programming with external interfaces.
+ * Copyright (C) 2005-2007 Roman Schindlauer
+ * Copyright (C) 2006-2015 Thomas Krennwallner
+ * Copyright (C) 2009-2015 Peter Schüller
+ * Copyright (C) 2011-2015 Christoph Redl
+ *
+ * This file is part of dlvhex.
+ *
+ * dlvhex is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * dlvhex is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with dlvhex; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+/**
+ * @file   FactParser.h
+ *
+ * @brief  Hand-written parser for ground facts which bypasses the HEX grammar.
+ */
+
+#ifndef FACT_PARSER_HPP_INCLUDED__17102026
+#define FACT_PARSER_HPP_INCLUDED__17102026
+
+#include "dlvhex2/PlatformDefinitions.h"
+#include "dlvhex2/fwd.h"
+#include "dlvhex2/Atoms.h"
+
+#include <string>
+#include <vector>
+
+DLVHEX_NAMESPACE_BEGIN
+
+/**
+ * \brief Parses ground facts of the form <tt>p(t1,...,tn).</tt> directly into the Registry and the EDB.
+ *
+ * The arguments may be constants, strings and nonnegative integers. Every other
+ * statement (rules, nested terms, strong negation, disjunction, variables, ...)
+ * is rejected without side effects, such that it can be parsed by the HexGrammar.
+ * Facts are stored exactly like the HexGrammar stores them outside of MLP modules.
+ *
+ * Scanning a part of the input (scan()) does not access the Registry and can run
+ * concurrently for different parts; storing the scanned facts (store()) assigns
+ * the same IDs as parsing the facts one by one with parseFact().
+ */
+class DLVHEX_EXPORT FactParser
+{
+    public:
+        /** \brief Facts of a part of the input which were scanned but not stored yet. */
+        struct ScannedFacts
+        {
+            /** \brief Sequence of facts which starts at the beginning of a line. */
+            struct Run
+            {
+                /** \brief Beginning of the line where the first fact starts. */
+                const char* begin;
+                /** \brief Position behind the last fact. */
+                const char* end;
+                /** \brief Index of the first fact in sizes. */
+                unsigned firstFact;
+                /** \brief Number of facts. */
+                unsigned facts;
+                /** \brief Index of the first term of the first fact in tuples. */
+                unsigned firstTerm;
+                /** \brief Largest integer in the facts. */
+                uint32_t maxint;
+            };
+
+            /** \brief Position where scanning starts; must be the beginning of a line. */
+            const char* begin;
+            /** \brief Scanning stops at the first statement which starts at or behind this position. */
+            const char* limit;
+            /** \brief End of the input. */
+            const char* inputEnd;
+            /** \brief Runs of facts; after another statement, scanning continues at the next line. */
+            std::vector<Run> runs;
+            /** \brief Distinct constants and strings in the order of their first occurrence. */
+            std::vector<std::string> symbols;
+            /** \brief Term IDs of the symbols, resolved by store() on first use. */
+            std::vector<ID> symbolIDs;
+            /** \brief Tuples of all facts; constants refer to an index in symbols, integers are integer terms. */
+            std::vector<ID> tuples;
+            /** \brief Tuple size of each fact. */
+            std::vector<unsigned> sizes;
+
+            /** \brief Constructor.
+             * @param begin See ScannedFacts::begin.
+             * @param limit See ScannedFacts::limit.
+             * @param inputEnd See ScannedFacts::inputEnd. */
+            ScannedFacts(const char* begin, const char* limit, const char* inputEnd);
+        };
+
+        /** \brief Constructor.
+         * @param ctx ProgramCtx whose registry and EDB receive the facts. */
+        FactParser(ProgramCtx& ctx);
+
+        /** \brief Skips whitespace and comments like the HexParserSkipper.
+         * @param it Begin of the input.
+         * @param end End of the input.
+         * @return First position which is neither whitespace nor part of a comment. */
+        static const char* skip(const char* it, const char* end);
+
+        /** \brief Parses a single fact.
+         * @param begin Begin of the input; on success set behind the terminating period, otherwise unchanged.
+         * @param end End of the input.
+         * @return True if a fact was parsed and added to the EDB, false if the next statement is not a simple fact. */
+        bool parseFact(const char*& begin, const char* end);
+
+        /** \brief Scans the facts from ScannedFacts::begin up to ScannedFacts::limit.
+         *
+         * Thread-safe, the Registry is not accessed. A run may start within a
+         * multi-line statement, hence it must only be stored if the parser
+         * reaches its beginning at a statement boundary.
+         * @param facts Part of the input to scan, receives the facts. */
+        static void scan(ScannedFacts& facts);
+
+        /** \brief Stores a run of scanned facts in the Registry and adds them to the EDB.
+         *
+         * Runs must be stored in the order of the input, then the same IDs are assigned as by parseFact().
+         * @param facts Facts scanned by scan(); receives the IDs of the symbols.
+         * @param run Run of facts to store. */
+        void store(ScannedFacts& facts, const ScannedFacts::Run& run);
+
+    private:
+        /** \brief Kind of a scanned token. */
+        enum TokenKind { CONSTANT, INTEGER };
+        /** \brief Scanned predicate or argument. */
+        struct Token
+        {
+            TokenKind kind;
+            const char* begin;
+            const char* end;
+            uint32_t value;
+        };
+
+        /** \brief ProgramCtx which receives the facts. */
+        ProgramCtx& ctx;
+        /** \brief Tokens of the current fact (reused to avoid allocations). */
+        std::vector<Token> tokens;
+        /** \brief Buffer for symbols of constants (reused to avoid allocations). */
+        std::string symbol;
+        /** \brief Atom under construction (reused to avoid allocations). */
+        OrdinaryAtom atom;
+
+        /** \brief Scans a fact.
+         * @param it Begin of the fact; set behind the terminating period on success.
+         * @param end End of the input.
+         * @param tokens Receives the predicate and the arguments.
+         * @return True if a fact was scanned. */
+        static bool scanFact(const char*& it, const char* end, std::vector<Token>& tokens);
+        /** \brief Scans a term.
+         * @param it Begin of the term; set behind it on success.
+         * @param end End of the input.
+         * @param tokens Receives the term.
+         * @return True if a constant, string or integer was scanned. */
+        static bool scanTerm(const char*& it, const char* end, std::vector<Token>& tokens);
+        /** \brief Looks up or stores a constant term.
+         * @param symbol Constant or string.
+         * @return ID of the term. */
+        ID storeConstant(const std::string& symbol);
+        /** \brief Looks up or stores the term of a scanned token.
+         * @param token Scanned token.
+         * @return ID of the term. */
+        ID storeTerm(const Token& token);
+        /** \brief Stores the atom under construction and adds it to the EDB. */
+        void storeAtom();
+};
+
+DLVHEX_NAMESPACE_END
+#endif                           // FACT_PARSER_HPP_INCLUDED__17102026
+
+
+// vim:expandtab:ts=4:sw=4:
+// mode: C++
+// End:
@@ -46,11 +46,39 @@
 
 #include <boost/unordered_map.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/optional.hpp>
+
+#include <deque>
+#include <set>
 
 DLVHEX_NAMESPACE_BEGIN
 
 class GenuineGuessAndCheckModelGeneratorFactory;
 
+/**
+ * \brief Splitting of the search space of a component into disjoint parts.
+ *
+ * Each part is enumerated by its own GenuineGuessAndCheckModelGenerator.
+ * The model generators exchange the ground nogoods learned from external atoms through this object.
+ */
+struct SearchSpaceSplit
+{
+    /** \brief Number of parts. */
+    int parts;
+    /** \brief Ground nogoods published so far, each with the part whose model generator learned it. */
+    std::vector<std::pair<int, Nogood> > nogoods;
+    /** \brief Protects nogoods. */
+    boost::mutex mutex;
+
+    /** \brief Constructor.
+     * @param parts See SearchSpaceSplit::parts. */
+    SearchSpaceSplit(int parts): parts(parts) {}
+};
+typedef boost::shared_ptr<SearchSpaceSplit> SearchSpaceSplitPtr;
+
 /** \brief Model generator for arbitrary components. */
 class GenuineGuessAndCheckModelGenerator:
 public FLPModelGeneratorBase,
@@ -59,6 +87,7 @@ public PropagatorCallback
 {
     // types
     public:
+        friend class SplittingGuessAndCheckModelGenerator;
         typedef GenuineGuessAndCheckModelGeneratorFactory Factory;
 
         // storage
@@ -111,6 +140,18 @@ public PropagatorCallback
         UnfoundedSetCheckerManagerPtr ufscm;
         /** \brief All atoms in the program. */
         InterpretationPtr programMask;
+        /** \brief Version of ProgramCtx::modelBound which was already added to the solver. */
+        unsigned modelBoundVersion;
+        /** \brief Search space splitting this model generator takes part in (NULL if it enumerates the whole search space). */
+        SearchSpaceSplitPtr split;
+        /** \brief Part of SearchSpaceSplit enumerated by this model generator. */
+        int part;
+        /** \brief Number of nogoods in SearchSpaceSplit::nogoods which were already imported. */
+        unsigned splitNogoodsImported;
+        /** \brief True if the part of this model generator is empty because the search space has too few guessed atoms. */
+        bool partEmpty;
+        /** \brief Index in learnedEANogoods up to which nogoods were offered to GenuineGuessAndCheckModelGeneratorFactory::inputIndependentNogoods. */
+        int learnedEANogoodsPublishedIndex;
 
         // members
 
@@ -146,6 +187,28 @@ public PropagatorCallback
          */
         void updateEANogoods(InterpretationConstPtr compatibleSet, InterpretationConstPtr assigned = InterpretationConstPtr(), InterpretationConstPtr changed = InterpretationConstPtr());
 
+        /**
+         * \brief Adds the input-independent nogoods learned so far to the factory such that model generators for other inputs can use them.
+         */
+        void publishInputIndependentNogoods();
+
+        /**
+         * \brief Restricts the solver to the part of the search space which is enumerated by this model generator.
+         *
+         * The first ceil(log2(SearchSpaceSplit::parts)) guessed atoms (external atom replacements first, then ordinary atoms,
+         * each in the order of their addresses) define the parts: part i gets all truth assignments to these atoms
+         * whose binary value is congruent to i modulo the number of parts.
+         * Sets partEmpty if there are fewer assignments than parts and the part of this model generator gets none of them.
+         * GenuineGuessAndCheckModelGeneratorFactory::gpMask and GenuineGuessAndCheckModelGeneratorFactory::gnMask
+         * must have been updated after grounding; they are not updated here as the parts read them concurrently.
+         */
+        void restrictToPart();
+
+        /**
+         * \brief Publishes the ground nogoods learned since the last transfer to the solver and imports those published by the other parts.
+         */
+        void exchangeSplitNogoods();
+
         /**
          * \brief Checks after completion of an assignment if it is compatible.
          *
@@ -271,8 +334,11 @@ public PropagatorCallback
          * \brief Constructor.
          * @param factory Reference to the factory which created this model generator.
          * @param input Input interpretation to this model generator.
+         * @param split Search space splitting this model generator takes part in (NULL to enumerate the whole search space).
+         * @param part Part of \p split to enumerate.
          */
-        GenuineGuessAndCheckModelGenerator(Factory& factory, InterpretationConstPtr input);
+        GenuineGuessAndCheckModelGenerator(Factory& factory, InterpretationConstPtr input,
+            SearchSpaceSplitPtr split = SearchSpaceSplitPtr(), int part = 0);
 
         /**
          * \brief Destuctor.
@@ -283,6 +349,70 @@ public PropagatorCallback
         virtual InterpretationPtr generateNextModel();
 };
 
+/**
+ * \brief Model generator which enumerates the models of a component in disjoint parts of the search space concurrently.
+ *
+ * Each part is enumerated by a GenuineGuessAndCheckModelGenerator running on its own thread
+ * (see SearchSpaceSplit). As the threads evaluate external atoms concurrently, this model generator
+ * is only used if all inner external atoms are thread-safe (see ExtSourceProperties::isThreadSafe). Models are returned in the order in which they are found,
+ * and each thread computes at most one model ahead of the consumer.
+ */
+class SplittingGuessAndCheckModelGenerator:
+public BaseModelGenerator
+{
+    // types
+    public:
+        typedef GenuineGuessAndCheckModelGeneratorFactory Factory;
+
+        // storage
+    protected:
+        /** \brief Reference to the factory which created this model generator. */
+        Factory& factory;
+        /** \brief Search space splitting shared by the workers. */
+        SearchSpaceSplitPtr split;
+        /** \brief Model generator of each part; constructed and destructed by the thread which owns this model generator. */
+        std::vector<boost::shared_ptr<GenuineGuessAndCheckModelGenerator> > generators;
+        /** \brief One thread per part. */
+        boost::thread_group workers;
+        /** \brief Models which were found but not returned yet. */
+        std::deque<InterpretationPtr> models;
+        /** \brief Number of workers which did not finish their part yet. */
+        int running;
+        /** \brief True if the workers shall stop as soon as possible. */
+        bool cancelled;
+        /** \brief Error message if a worker failed. */
+        boost::optional<std::string> error;
+        /** \brief Protects models, running, cancelled and error. */
+        boost::mutex mutex;
+        /** \brief Signalled if a model was found or a worker finished. */
+        boost::condition_variable modelAvailable;
+        /** \brief Signalled if a model was returned or the workers shall stop. */
+        boost::condition_variable modelTaken;
+
+        /** \brief Main loop of the worker for one part.
+         * @param part Part of the search space to enumerate. */
+        void work(int part);
+
+    public:
+        /**
+         * \brief Constructor; constructs the model generators of the parts on the calling thread and starts the workers.
+         * @param factory Reference to the factory which created this model generator.
+         * @param input Input interpretation to this model generator.
+         * @param parts Number of parts (and threads).
+         */
+        SplittingGuessAndCheckModelGenerator(Factory& factory, InterpretationConstPtr input, int parts);
+
+        /**
+         * \brief Destuctor; stops the workers and waits until their current model computation has finished.
+         */
+        virtual ~SplittingGuessAndCheckModelGenerator();
+
+        // generate and return next model, return null after last model
+        virtual InterpretationPtr generateNextModel();
+
+        virtual std::ostream& print(std::ostream& o) const;
+};
+
 /** \brief Factory for the GenuineGuessAndCheckModelGenerator. */
 class GenuineGuessAndCheckModelGeneratorFactory:
 public FLPModelGeneratorFactoryBase,
@@ -291,6 +421,7 @@ public ostream_printable<GenuineGuessAndCheckModelGeneratorFactory>
     // types
     public:
         friend class GenuineGuessAndCheckModelGenerator;
+        friend class SplittingGuessAndCheckModelGenerator;
         typedef ComponentGraph::ComponentInfo ComponentInfo;
 
         // storage
@@ -305,6 +436,32 @@ public ostream_printable<GenuineGuessAndCheckModelGeneratorFactory>
 
         /** \brief Outer external atoms of the component. */
             std::vector<ID> outerEatoms;
+        /** \brief Grounder shared by all model generators of this factory if option PersistentGrounder is set. */
+        GenuineGrounderPtr persistentGrounder;
+        /** \brief Analysis of the last ground program of GenuineGuessAndCheckModelGeneratorFactory::persistentGrounder, which is extended for the next one; shared with the model generators which use it (it is copied before an update if one of them still exists). */
+        boost::shared_ptr<AnnotatedGroundProgram> persistentAnnotatedGroundProgram;
+        /** \brief Protects GenuineGuessAndCheckModelGeneratorFactory::persistentGrounder and GenuineGuessAndCheckModelGeneratorFactory::persistentAnnotatedGroundProgram. */
+        boost::mutex persistentGrounderMutex;
+        /** \brief External predicates whose inner external atoms are all monotonic in their predicate parameters. */
+        std::set<ID> monotonicExternalPredicates;
+        /** \brief External predicates whose inner external atoms are all functional. */
+        std::set<ID> functionalExternalPredicates;
+        /** \brief Learned external atom nogoods which are valid for all inputs of the component; seed the nogoods of new model generators. */
+        NogoodSet inputIndependentNogoods;
+        /** \brief Protects GenuineGuessAndCheckModelGeneratorFactory::inputIndependentNogoods. */
+        boost::mutex inputIndependentNogoodsMutex;
+
+        /**
+         * \brief Checks if a learned nogood is valid for all inputs of the component.
+         *
+         * This is the case for nogoods which state that an output tuple of a monotonic external source
+         * is true if some input atoms are true (because additional input atoms of other inputs
+         * cannot invalidate them), and for nogoods which exclude two output tuples of a functional source.
+         * Nogoods which depend on false input atoms or on the absence of input atoms are specific to the input.
+         * @param ng Learned nogood (ground or nonground).
+         * @return True if \p ng may be used by model generators for any input.
+         */
+        bool isInputIndependent(const Nogood& ng) const;
 
     public:
         /** \brief Constructor.
@@ -76,6 +76,10 @@ public ostream_printable<GenuinePlainModelGenerator>
 
         /** \brief Solver instance. */
         GenuineSolverPtr solver;
+        /** \brief All atoms in the ground program (computed when ProgramCtx::modelBound is used). */
+        InterpretationPtr programMask;
+        /** \brief Version of ProgramCtx::modelBound which was already added to the solver. */
+        unsigned modelBoundVersion;
 
         // members
 
@@ -77,6 +77,15 @@ class DLVHEX_EXPORT GenuineGrounder
     public:
         virtual const OrdinaryASPProgram& getGroundProgram() = 0;
 
+        /**
+         * \brief Replaces the facts of the program passed on construction and updates the ground program accordingly.
+         *
+         * Grounders which keep their state between inputs may override this; none of the current implementations does.
+         * @param input New facts.
+         * @return True if the ground program was updated, false if the grounder does not support this and a new instance must be created.
+         */
+        virtual bool updateInput(InterpretationConstPtr) { return false; }
+
         typedef boost::shared_ptr<GenuineGrounder> Ptr;
         typedef boost::shared_ptr<const GenuineGrounder> ConstPtr;
 
@@ -87,9 +96,10 @@ class DLVHEX_EXPORT GenuineGrounder
          * @param program OrdinaryASPProgram to be grounded.
          * @param frozen A set of atoms which occur in \p ns and are saved from being optimized away (e.g. because their trutz values are relevant);
          * if NULL, then all variables are frozen.
+         * @param persistent If true, then the grounder is prepared for subsequent calls of updateInput (currently ignored, as no grounder supports this).
          * @return Pointer to the new grounder instance.
          */
-        static Ptr getInstance(ProgramCtx& ctx, const OrdinaryASPProgram& program, InterpretationConstPtr frozen = InterpretationConstPtr());
+        static Ptr getInstance(ProgramCtx& ctx, const OrdinaryASPProgram& program, InterpretationConstPtr frozen = InterpretationConstPtr(), bool persistent = false);
 };
 
 typedef GenuineGrounder::Ptr GenuineGrounderPtr;
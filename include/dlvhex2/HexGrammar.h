@@ -119,8 +119,8 @@ boost::spirit::qi::grammar<Iterator>
     boost::spirit::qi::rule<Iterator> ws;
 };
 
-//! concrete iterator type used
-typedef std::string::iterator HexParserIterator;
+//! concrete iterator type used (parsing runs directly on the buffers of the InputProvider)
+typedef const char* HexParserIterator;
 
 //! concrete skip parser used
 typedef HexParserSkipperGrammar<HexParserIterator> HexParserSkipper;
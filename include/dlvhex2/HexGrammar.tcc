@@ -861,7 +861,7 @@ struct sem<HexGrammarSemantics::add>
             // fact -> put into EDB
             if( !source.isOrdinaryGroundAtom() )
                 throw SyntaxError(
-                    "fact '"+reg->onatoms.getByID(source).text+"' not safe!");
+                    "fact '"+printToString<RawPrinter>(source, reg)+"' not safe!");
 
             if ( mgr.mlpMode == 0 ) {
                                  // ordinary encoding
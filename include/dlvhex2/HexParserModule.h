@@ -76,6 +76,15 @@ class HexParserModule
          * @param Custom grammar. */
         virtual HexParserModuleGrammarPtr createGrammarModule() = 0;
 
+        /** \brief Checks if the module might parse statements which look like ground facts.
+         *
+         * Ground facts are read without the grammar if option FastFactParser is set (see --fastfacts);
+         * this is only done if no registered module returns true here.
+         * Modules which only accept syntax starting with a character other than a lowercase letter
+         * (e.g. a prefix or a variable) should return false.
+         * @return True if the module might parse a statement of the form p(c1,...,cn). differently than the grammar. */
+        virtual bool mayParseGroundFacts() const { return type != BODYATOM; }
+
     protected:
         /** \brief Type of the parser module. */
         Type type;
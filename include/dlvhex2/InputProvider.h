@@ -40,6 +40,7 @@
 
 #include <vector>
 #include <string>
+#include <utility>
 #include <iosfwd>
 
 DLVHEX_NAMESPACE_BEGIN
@@ -48,6 +49,9 @@ DLVHEX_NAMESPACE_BEGIN
 class DLVHEX_EXPORT InputProvider
 {
     public:
+        /** \brief Contiguous range of characters holding one input. */
+        typedef std::pair<const char*, const char*> Buffer;
+
         /** \brief Constructor. */
         InputProvider();
         /** \brief Destructor. */
@@ -62,8 +66,9 @@ class DLVHEX_EXPORT InputProvider
          * @param contentname Unique name for this input. */
         void addStringInput(const std::string& content, const std::string& contentname);
         /** \brief Add input from a file.
-         * @param filename File to read from.
-         * @param contentname Unique name for this input. */
+         *
+         * Regular files are memory-mapped, other files are read.
+         * @param filename File to read from; also used as content name. */
         void addFileInput(const std::string& filename);
     #ifdef HAVE_CURL
         /** \brief Add input from a URL.
@@ -78,7 +83,15 @@ class DLVHEX_EXPORT InputProvider
          * @return Vector of input names. */
         const std::vector<std::string>& contentNames() const;
 
+        /** \brief Get the inputs without copying them.
+         *
+         * The buffers are in the order of contentNames() and remain valid as long as this InputProvider exists.
+         * @return Vector of buffers. */
+        std::vector<Buffer> getAsBuffers() const;
+
         /** \brief Get input as a single stream.
+         *
+         * This copies the inputs into a stream, use getAsBuffers() if possible.
          * @return Input stream. */
         std::istream& getAsStream();
 
@@ -254,6 +254,21 @@ class InternalGroundASPSolver : public CDNLSolver, public GenuineGroundSolver
             return out;
         }
 
+        /** \brief Checks if two sets intersect without computing the intersection.
+         * @param a First Set.
+         * @param b Second Set.
+         * @return True if \p a and \p b have a common element and false otherwise. */
+        template <typename T>
+        inline bool intersects(const Set<T>& a, const Set<T>& b) {
+            typename Set<T>::const_iterator ia = a.begin(), ib = b.begin();
+            while (ia != a.end() && ib != b.end()) {
+                if (*ia < *ib) ++ia;
+                else if (*ib < *ia) ++ib;
+                else return true;
+            }
+            return false;
+        }
+
         /** \brief Projects dummy atoms for rule bodies away.
          * @param intr Interpretation to project.
          * @return Projection of \p intr. */
@@ -40,6 +40,7 @@
 #include <bm/bm.h>
 #include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/atomic.hpp>
 
 DLVHEX_NAMESPACE_BEGIN
 
@@ -64,15 +65,71 @@ public ostream_printable<Interpretation>
         RegistryPtr registry;
         /** \brief Internal bitset storage. */
         Storage bits;
+        /** \brief Order-independent hash of the true atoms, see getFingerprint.
+         *
+         * Maintained by setFact and clearFact; 0 means that it must be recomputed
+         * (e.g. after the storage was handed out for modification).
+         * Atomic because getFingerprint caches it in const interpretations
+         * which may be shared between threads. */
+        mutable boost::atomic<std::size_t> fingerprint;
+        /** \brief True if the storage was handed out for modification (see getStorage).
+         *
+         * The holder of the reference may modify the storage at any later time,
+         * thus the fingerprint of such an interpretation is never cached. */
+        bool storageExposed;
+
+        /** \brief Fingerprint of the empty interpretation. */
+        static const std::size_t EmptyFingerprint = 0x2545f491;
+
+        /**
+         * \brief Computes the contribution of a single atom to the fingerprint.
+         * @param id Address of a ground atom ID.
+         * @return Well-mixed hash of \p id.
+         */
+        static inline std::size_t fingerprintOf(IDAddress id)
+        {
+            uint64_t x = static_cast<uint64_t>(id) + 0x9e3779b97f4a7c15ULL;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            return static_cast<std::size_t>(x ^ (x >> 31));
+        }
+
+        /**
+         * \brief Toggles the contribution of a changed atom in a valid fingerprint.
+         * @param id Address of the ground atom which was added or removed.
+         */
+        inline void updateFingerprint(IDAddress id)
+        {
+            // modifications are not concurrent to other accesses, only caching in getFingerprint is
+            const std::size_t fp = fingerprint.load(boost::memory_order_relaxed);
+            if( fp != 0 ) fingerprint.store(fp ^ fingerprintOf(id), boost::memory_order_relaxed);
+        }
+
+        /** \brief Marks the fingerprint for recomputation. */
+        inline void invalidateFingerprint()
+        {
+            // avoid the store if it is already invalid (frequent for read-only uses)
+            if( fingerprint.load(boost::memory_order_relaxed) != 0 )
+                fingerprint.store(0, boost::memory_order_relaxed);
+        }
 
         // members
     public:
         /** \brief Constructor. */
-        inline Interpretation(){};
+        inline Interpretation(): fingerprint(EmptyFingerprint), storageExposed(false) {};
         /** \brief Constructor.
          * @param registry Registry to use for interpreting IDs.
          */
         Interpretation(RegistryPtr registry);
+        /** \brief Copy constructor.
+         * @param other Interpretation to copy.
+         */
+        Interpretation(const Interpretation& other);
+        /** \brief Assignment operator.
+         * @param other Interpretation to copy.
+         * @return Reference to this interpretation.
+         */
+        Interpretation& operator=(const Interpretation& other);
         /** \brief Destructor. */
         virtual ~Interpretation();
         // TODO: bitset stuff with bitmagic
@@ -167,14 +224,18 @@ public ostream_printable<Interpretation>
          * @param id Address of a ground atom ID.
          */
         inline void setFact(IDAddress id)
-            { bits.set(id); }
+        {
+            if( bits.set_bit(id) ) updateFingerprint(id);
+        }
 
         /**
          * \brief Removes an atom from the interpretation.
          * @param id Address of a ground atom ID.
          */
         inline void clearFact(IDAddress id)
-            { bits.clear_bit(id); }
+        {
+            if( bits.set_bit(id, false) ) updateFingerprint(id);
+        }
 
         /**
          * \brief Checks if a ground atom is true in the interpretation.
@@ -185,10 +246,28 @@ public ostream_printable<Interpretation>
 
         /**
          * \brief Returns the internal storage of the interpretation.
+         *
+         * After the non-const version was called, the fingerprint of this interpretation
+         * is recomputed whenever it is needed because the storage might be modified through
+         * the reference at any time. Read-only users of a non-const interpretation should go
+         * through a const reference, and modifications should use setFact, clearFact, add, bit_and
+         * or clear where possible, which keep the fingerprint cached.
          * @return Interpretation as bitset (cf. bitmagic).
          */
         const Storage& getStorage() const { return bits; }
-        Storage& getStorage() { return bits; }
+        Storage& getStorage() { storageExposed = true; invalidateFingerprint(); return bits; }
+
+        /**
+         * \brief Returns a hash of the set of true atoms.
+         *
+         * The fingerprint is maintained incrementally by setFact and clearFact,
+         * hence this is usually constant time; otherwise it is recomputed once
+         * (or every time if the storage was handed out for modification, see getStorage).
+         * Equal interpretations have equal fingerprints.
+         * Safe to call concurrently on an interpretation which is not modified meanwhile.
+         * @return Fingerprint of the interpretation.
+         */
+        std::size_t getFingerprint() const;
 
         /**
          * \brief Returns a pair of a begin and an end operator to iterate through true atoms in the interpretation.
@@ -229,7 +308,7 @@ public ostream_printable<Interpretation>
          * \brief Resets the interpretation to the empty one.
          */
         inline void clear()
-            {  bits.clear();  }
+            {  bits.clear(); fingerprint.store(storageExposed ? 0 : EmptyFingerprint, boost::memory_order_relaxed);  }
 
         /**
          * \brief Compares this interpretation atomwise to another one.
@@ -73,6 +73,7 @@
 #include <boost/graph/graphviz.hpp>
 
 #include <iostream>
+#include <map>
 #include <string>
 #include <fstream>
 #include <time.h>
@@ -231,7 +232,40 @@ class DLVHEX_EXPORT MLPSolver
     bool containFin(const std::vector<IDSet>& VectorOfIDSet, int idxPjT);
     int getInstIndexOfRule(const Rule& r);
     void updateTop(std::vector<IDSet>& Top, const Tuple& top);
-    bool comp(ValueCallsType C); // return false if the program is not ic-stratified
+
+    // parallel exploration of the value calls: workers are solvers on their own copy of the registry;
+    // a worker hands the remaining answer sets of its oldest branch point to an idle worker
+    struct Branch;
+    typedef boost::shared_ptr<Branch> BranchPtr;
+    struct Exploration;
+    Exploration* exploration;
+    void installBranch(const BranchPtr& branch);
+    void work();
+
+    // return false if the program is not ic-stratified; if branch is given, the search continues at this branch point
+    bool comp(ValueCallsType C, const BranchPtr& branch = BranchPtr());
+
+    // memoization of the answer sets of rewritten programs (i.e., of module instantiations with their input)
+    struct MemoEntry
+    {
+        // answer sets in the format of the DLV output
+        std::vector<std::string> answerSets;
+        // true if all answer sets have been retrieved from the solver
+        bool complete;
+        // answer sets over a specific registry (empty if they have to be parsed from answerSets)
+        PreparedResults::Storage parsed;
+        RegistryPtr parsedRegistry;
+        MemoEntry(): complete(false) {}
+    };
+    typedef boost::shared_ptr<MemoEntry> MemoEntryPtr;
+    // records the answer sets of a solver call in a MemoEntry
+    class MemoizingResults;
+    // canonical text of the rewritten program -> its answer sets
+    std::map<std::string, MemoEntryPtr> memo;
+    std::string canonicalProgram(const OrdinaryASPProgram& program);
+    ASPSolverManager::ResultsPtr solveMemoized(ASPSolverManager& mgr, const OrdinaryASPProgram& program);
+    void loadMemo();
+    void saveMemo();
 
     // for instantiation - ogatoms indexing
     std::vector<std::vector<ID> > instOgatoms;
@@ -246,6 +280,9 @@ class DLVHEX_EXPORT MLPSolver
     int nASReturned;
     int forget;
     int instSplitting;
+    int memoization;
+    std::string memoFile;
+    int threads;
     int recordingTime;
     double totalTimePost;
     double totalTimePartA;
@@ -275,10 +312,14 @@ class DLVHEX_EXPORT MLPSolver
         int ctrAS;
         int ctrASFromDLV;
         int ctrCallToDLV;
+        int ctrMemoHits;
         MLPSolver(ProgramCtx& ctx1);
         void setNASReturned(int n);
         void setForget(int n);
         void setInstSplitting(int n);
+        void setMemoization(int n);
+        void setMemoFile(const std::string& file);
+        void setThreads(int n);
         void setPrintLevel(int level);
         bool solve();            // return false if the program is not ic-stratified
 
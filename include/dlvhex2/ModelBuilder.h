@@ -35,6 +35,7 @@
 #include "dlvhex2/PlatformDefinitions.h"
 #include "EvalGraph.h"
 #include "ModelGraph.h"
+#include "DeltaInterpretation.h"
 
 DLVHEX_NAMESPACE_BEGIN
 
@@ -45,13 +46,19 @@ struct ModelBuilderConfig
     /** \brief Constructor.
      * @param eg See ModelBuilderConfig::eg. */
     ModelBuilderConfig(EvalGraphT& eg):
-    eg(eg), redundancyElimination(true), constantSpace(false) {}
+    eg(eg), redundancyElimination(true), constantSpace(false), compactModels(false), workerThreads(0), optimization(false) {}
     /** \brief Evaluation graph to use for model building. */
     EvalGraphT& eg;
     /** \brief True to optimize redundant parts in the model building process. */
     bool redundancyElimination;
     /** \brief True to work with constant space. */
     bool constantSpace;
+    /** \brief True to let input models reference the output models they are joined from instead of copying them (see DeltaInterpretation). */
+    bool compactModels;
+    /** \brief Number of worker threads for model builders which evaluate units concurrently (0 = number of hardware threads). */
+    unsigned workerThreads;
+    /** \brief True if model generators prune with the current optimum, which is updated after each model (model generators must then not compute models in advance). */
+    bool optimization;
 };
 
 /** \brief Base class for all model builders. */
@@ -86,12 +93,18 @@ class ModelBuilder
             Interpretation;
         typedef typename EvalUnitPropertyBundle::Interpretation::Ptr
             InterpretationPtr;
+        typedef typename EvalUnitPropertyBundle::Interpretation::ConstPtr
+            InterpretationConstPtr;
+        typedef DeltaInterpretation<Interpretation>
+            CompactInterpretation;
 
         /** \brief Properties of a model. */
         struct ModelProperties
         {
-            /** \brief The interpretation data of this model. */
+            /** \brief The interpretation data of this model (NULL if the model is stored in compactInterpretation). */
             InterpretationPtr interpretation;
+            /** \brief The interpretation data of this model if models are compacted (see ModelBuilderConfig::compactModels). */
+            typename CompactInterpretation::ConstPtr compactInterpretation;
 
             // for input models only:
 
@@ -102,6 +115,9 @@ class ModelBuilder
 
             /** \brief Constructor. */
             ModelProperties();
+            /** \brief Returns the interpretation data of this model, materializing it if the model is compacted.
+             * @return Interpretation or NULL for dummy models. */
+            InterpretationConstPtr getInterpretation() const;
             /** \brief Prints this properties strcture.
              * @param o Stream to print to.
              * @return \p o. */
@@ -161,12 +177,23 @@ class ModelBuilder
 template<typename EvalGraphT>
 ModelBuilder<EvalGraphT>::ModelProperties::ModelProperties():
 interpretation(),
+compactInterpretation(),
 dummy(false),
 childModelsGenerated(false)
 {
 }
 
 
+template<typename EvalGraphT>
+typename ModelBuilder<EvalGraphT>::InterpretationConstPtr
+ModelBuilder<EvalGraphT>::ModelProperties::getInterpretation() const
+{
+    if( !!compactInterpretation )
+        return compactInterpretation->materialize();
+    return interpretation;
+}
+
+
 template<typename EvalGraphT>
 std::ostream&
 ModelBuilder<EvalGraphT>::ModelProperties::print(std::ostream& o) const
@@ -175,10 +202,11 @@ ModelBuilder<EvalGraphT>::ModelProperties::print(std::ostream& o) const
         o << "dummy ";
     if( childModelsGenerated )
         o << "childModelsGenerated ";
+    InterpretationConstPtr intp = getInterpretation();
     o <<
-        "interpretation=" << printptr(interpretation);
-    if( interpretation )
-        o << *interpretation;
+        "interpretation=" << printptr(intp);
+    if( intp )
+        o << *intp;
     return o;
 }
 
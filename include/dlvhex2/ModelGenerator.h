@@ -140,6 +140,13 @@ public ostream_printable<ModelGeneratorFactoryBase<InterpretationT> >
          * @param input Input interpretation. */
         virtual ModelGeneratorPtr createModelGenerator(
             InterpretationConstPtr input) = 0;
+        /** \brief Checks if model generators of this factory may run concurrently with other model generators.
+         *
+         * Model builders which evaluate units concurrently (see ParallelModelBuilder)
+         * execute model generators of other factories on their own thread.
+         * @return True if model generators created by this factory are thread-safe. */
+        virtual bool isThreadSafe() const
+            { return false; }
         virtual std::ostream& print(std::ostream& o) const
             { return o << "ModelGeneratorFactoryBase::print() not overloaded"; }
 };
@@ -99,7 +99,7 @@ BOOST_MULTI_INDEX_MEMBER(Module,std::string,moduleName)
 
         /** \brief Store symbol, assuming it does not exist.
          *
-         * Assert that symbol did not exist.
+         * If an equal symbol was stored concurrently, the existing one is returned.
          * @return mod Module to store.
          * @return Address of the stored module. */
         inline int storeAndGetAddress(const Module& mod) throw();
@@ -143,24 +143,18 @@ std::ostream& ModuleTable::print(std::ostream& o) const
 // retrieve by address
 const Module& ModuleTable::getByAddress(int address) const throw ()
 {
-    ReadLock lock(mutex);
-    const AddressIndex& idx = container.get<impl::AddressTag>();
-    // the following check only works for random access indices, but here it is ok
     const uint32_t& uaddress = address;
-    assert( uaddress < idx.size() );
-    return idx.at(address);
+    assert( uaddress < directory.size() );
+    return directory[uaddress];
 }
 
 
 // retrieve by address
 const std::string& ModuleTable::getModuleName(int address) const throw ()
 {
-    ReadLock lock(mutex);
-    const AddressIndex& idx = container.get<impl::AddressTag>();
-    // the following check only works for random access indices, but here it is ok
     const uint32_t& uaddress = address;
-    assert( uaddress < idx.size() );
-    return idx.at(address).moduleName;
+    assert( uaddress < directory.size() );
+    return directory[uaddress].moduleName;
 }
 
 
@@ -197,7 +191,7 @@ int ModuleTable::getAddressByName(const std::string& moduleName) const throw()
 
 
 // store module, assuming it does not exist
-// assert that symbol did not exist
+// if it was stored concurrently, return the existing one
 int ModuleTable::storeAndGetAddress(const Module& mod) throw()
 {
     assert(!mod.moduleName.empty());
@@ -208,8 +202,10 @@ int ModuleTable::storeAndGetAddress(const Module& mod) throw()
     WriteLock lock(mutex);
     AddressIndex& idx = container.get<impl::AddressTag>();
     boost::tie(it, success) = idx.push_back(mod);
-    (void)success;
-    assert(success);
+    // if an equal element was stored concurrently since the caller looked it up,
+    // it points to that element and its address is returned
+    if( success )
+        directory.push_back(*it);
 
     return ( container.project<impl::AddressTag>(it) - idx.begin() );
 
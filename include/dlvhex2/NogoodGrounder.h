@@ -40,6 +40,7 @@
 #include "dlvhex2/AnnotatedGroundProgram.h"
 
 #include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
 #include <boost/shared_ptr.hpp>
 
 DLVHEX_NAMESPACE_BEGIN
@@ -56,6 +57,13 @@ class DLVHEX_EXPORT NogoodGrounder
         SimpleNogoodContainerPtr destination;
         /** \brief Ground program with meta information. */
         AnnotatedGroundProgram& agp;
+
+        /**
+         * Selects the literal of a nonground nogood which binds the highest number of variables.
+         * @param ng A nonground nogood.
+         * @return The selected literal or ID_FAIL if \p ng contains only ground and guard atoms.
+         */
+        ID getWatchedLiteral(const Nogood& ng) const;
     public:
         /**
          * Initializes the nogood grounder for a container of watched nogoods
@@ -117,10 +125,19 @@ class DLVHEX_EXPORT LazyNogoodGrounder : public NogoodGrounder
     private:
         /** \brief Number of currently watched nogoods. */
         int watchedNogoodsCount;
-        /** \brief Stores for all literals the indexes of nogoods which watch it. */
-        std::vector<std::pair<ID, int> > watchedLiterals;
+        /** \brief Index key of a watched literal: its predicate and its first argument, each replaced by ID_FAIL if it is not a constant. */
+        typedef std::pair<ID, ID> WatchKey;
+        /** \brief Stores for all watch keys the watched literals and the indexes of nogoods which watch them. */
+        boost::unordered_map<WatchKey, std::vector<std::pair<ID, int> > > watchedLiterals;
         /** \brief Stores which atom was already compared to which nonground nogood. */
-        std::set<std::pair<IDAddress, int> > alreadyCompared;
+        boost::unordered_set<std::pair<IDAddress, int> > alreadyCompared;
+
+        /**
+         * Computes the index key of an atom.
+         * @param atom A ground or nonground atom.
+         * @return The predicate and the first argument of \p atom, where variables and nested terms are replaced by ID_FAIL.
+         */
+        static WatchKey getWatchKey(const OrdinaryAtom& atom);
     public:
         /**
          * Initializes the nogood grounder for a container of watched nogoods
@@ -198,12 +198,14 @@ public ModelBuilder<EvalGraphT>
          * @param m Input model. */
         void clearIModel(Model m) {
             mg.propsOf(m).interpretation.reset();
+            mg.propsOf(m).compactInterpretation.reset();
         }
 
         /** \brief Clears the interpretation of an output model.
          * @param msi ModelSuccessorIterator. */
         void clearOModel(ModelSuccessorIterator msi) {
             mg.propsOf(mg.sourceOf(*msi)).interpretation.reset();
+            mg.propsOf(mg.sourceOf(*msi)).compactInterpretation.reset();
         }
 
     private:
@@ -250,6 +252,8 @@ public ModelBuilder<EvalGraphT>
         bool redundancyElimination;
         /** \brief See ModelBuilderConfig. */
         bool constantSpace;
+        /** \brief See ModelBuilderConfig. */
+        bool compactModels;
 
         // methods
     public:
@@ -262,7 +266,8 @@ public ModelBuilder<EvalGraphT>
         // after the creation of this OnlineModelBuilder
             ego(new EvalGraphObserver(*this)),
             redundancyElimination(cfg.redundancyElimination),
-        constantSpace(cfg.constantSpace) {
+        constantSpace(cfg.constantSpace),
+        compactModels(cfg.compactModels) {
             EvalGraphT& eg = cfg.eg;
             // allocate full mbp (plus one unit, as we will likely get an additional vertex)
             EvalUnitModelBuildingProperties& mbproptemp = mbp[eg.countEvalUnits()];
@@ -316,6 +321,15 @@ public ModelBuilder<EvalGraphT>
          * @param m Model to remove. */
         void removeIModelFromGraphs(Model m);
 
+        /** \brief Creates the model generator which computes the output models of a unit for an input model.
+         *
+         * Derived model builders may override this to change how and where model generation is performed.
+         * @param u Evaluation unit.
+         * @param input Input interpretation (may be NULL for units without input).
+         * @return Model generator. */
+        virtual typename ModelGeneratorBase<Interpretation>::Ptr
+            createModelGenerator(EvalUnit u, typename Interpretation::ConstPtr input);
+
     public:
         // get next input model (projected if projection is configured) at unit u
         virtual OptionalModel getNextIModel(EvalUnit u);
@@ -452,6 +466,31 @@ EvalUnit u)
         }
     }
 
+    if( compactModels ) {
+        // share the predecessor interpretations instead of joining them
+        typename Base::CompactInterpretation::ConstPtr cjoin;
+        if( deps.size() == 1 ) {
+            LOG(MODELB,"only one predecessor -> linking to omodel");
+            cjoin = mg.propsOf(deps.front()).compactInterpretation;
+        }
+        else {
+            LOG(MODELB,"more than one predecessor -> referencing omodels");
+            std::vector<typename Base::CompactInterpretation::ConstPtr> bases;
+            typename std::vector<Model>::const_iterator it;
+            for(it = deps.begin(); it != deps.end(); ++it) {
+                assert(!!mg.propsOf(*it).compactInterpretation);
+                bases.push_back(mg.propsOf(*it).compactInterpretation);
+            }
+            cjoin.reset(new typename Base::CompactInterpretation(bases));
+        }
+        assert(cjoin != 0);
+
+        Model m = mg.addModel(u, MT_IN, deps);
+        LOG(MODELB,"returning new MT_IN model " << m);
+        mg.propsOf(m).compactInterpretation = cjoin;
+        return m;
+    }
+
     // create interpretation
     InterpretationPtr pjoin;
     if( deps.size() == 1 ) {
@@ -742,13 +781,10 @@ EvalUnit u)
         typename Interpretation::ConstPtr input;
         // input for creating model comes from current imodel
         // (this may be a dummy, so interpretation may be NULL which is ok)
-        input = mg.propsOf(mbprops.getIModel().get()).interpretation;
+        input = mg.propsOf(mbprops.getIModel().get()).getInterpretation();
 
-        // mgf is of type ModelGeneratorFactory::Ptr
         LOG(MODELB,"creating model generator");
-        mbprops.currentmg =
-            eg.propsOf(u).mgf->createModelGenerator(input)
-            ;
+        mbprops.currentmg = createModelGenerator(u, input);
     }
 
     // use model generator to create new model
@@ -766,7 +802,12 @@ EvalUnit u)
         LOG(MODELB,"stored new model " << m);
 
         // configure model
-        mg.propsOf(m).interpretation = intp;
+        if( compactModels ) {
+            mg.propsOf(m).compactInterpretation.reset(new typename Base::CompactInterpretation(intp));
+        }
+        else {
+            mg.propsOf(m).interpretation = intp;
+        }
 
         // TODO: handle projection here?
         #ifndef NDEBUG
@@ -810,6 +851,16 @@ EvalUnit u)
 }
 
 
+template<typename EvalGraphT>
+typename ModelGeneratorBase<typename OnlineModelBuilder<EvalGraphT>::Interpretation>::Ptr
+OnlineModelBuilder<EvalGraphT>::createModelGenerator(
+EvalUnit u, typename Interpretation::ConstPtr input)
+{
+    // mgf is of type ModelGeneratorFactory::Ptr
+    return eg.propsOf(u).mgf->createModelGenerator(input);
+}
+
+
 /**
  * nonrecursive "get next" wrt. a mandatory imodel
  *
@@ -54,11 +54,6 @@ boost::multi_index::indexed_by<
 boost::multi_index::random_access<
 boost::multi_index::tag<impl::AddressTag>
 >,
-// (unique) textual representation (parsing index, see TODO above)
-boost::multi_index::hashed_unique<
-boost::multi_index::tag<impl::TextTag>,
-BOOST_MULTI_INDEX_MEMBER(OrdinaryAtom,std::string,text)
->,
 // unique IDs for unique tuples
 boost::multi_index::hashed_unique<
 boost::multi_index::tag<impl::TupleTag>,
@@ -78,14 +73,28 @@ ID (Atom::*)() const,&Atom::front>
     public:
         typedef Container::index<impl::AddressTag>::type AddressIndex;
         //typedef Container::index<impl::KindTag>::type KindIndex;
-        typedef Container::index<impl::TextTag>::type TextIndex;
         typedef Container::index<impl::TupleTag>::type TupleIndex;
         typedef Container::index<impl::PredicateTag>::type PredicateIndex;
         typedef AddressIndex::iterator AddressIterator;
         typedef PredicateIndex::iterator PredicateIterator;
 
+        // storage
+    protected:
+        /** \brief Registry which owns this table (if any).
+         *
+         * Atoms do not store their textual representation,
+         * the registry is needed to look up the terms in getIDByString. */
+        Registry* registry;
+
         // methods
     public:
+        /** \brief Constructor. */
+        OrdinaryAtomTable(): registry(0) {}
+
+        /** \brief Sets the registry which owns this table.
+         * @param reg See OrdinaryAtomTable::registry. */
+        inline void setRegistry(Registry* reg) { registry = reg; }
+
         /** \brief Retrieve by ID.
          *
          * Assert that id.kind is correct for OrdinaryGroundAtom.
@@ -112,9 +121,16 @@ ID (Atom::*)() const,&Atom::front>
         inline ID getIDByAddress(IDAddress addr) const throw ();
 
         /** \brief Given string, look if already stored.
+         *
+         * Atoms are not indexed by their textual representation:
+         * \p text is split into the predicate and its arguments, which are looked up in the term and
+         * predicate tables, and the resulting tuple is looked up by getIDByTuple (nothing is stored).
+         * Use getIDByTuple whenever the tuple is at hand.
+         * Always fails if the table does not belong to a registry.
+         * Implementation in Registry.cpp!
          * @param text String representation of the ordinary atom to retrieve.
          * @return ID_FAIL if not stored, otherwise return ID. */
-        inline ID getIDByString(const std::string& text) const throw();
+        ID getIDByString(const std::string& text) const throw();
 
         /** \brief Given tuple, look if already stored.
          * @param tuple Tuple representation of the ordinary atom to retrieve.
@@ -138,7 +154,7 @@ ID (Atom::*)() const,&Atom::front>
 
         /** \brief Store atom, assuming it does not exist.
          *
-         * Assert that atom did not exist in table.
+         * If an equal atom was stored concurrently, the existing one is returned.
          * @param atom Atom to retrieve; must be in the table.
          * @return ID of \param atom. */
         inline ID storeAndGetID(const OrdinaryAtom& atom) throw();
@@ -170,11 +186,8 @@ ID id) const throw ()
 {
     assert(id.isAtom() || id.isLiteral());
     assert(id.isOrdinaryAtom());
-    ReadLock lock(mutex);
-    const AddressIndex& idx = container.get<impl::AddressTag>();
-    // the following check only works for random access indices, but here it is ok
-    assert( id.address < idx.size() );
-    return idx.at(id.address);
+    assert( id.address < directory.size() );
+    return directory[id.address];
 }
 
 
@@ -184,11 +197,8 @@ const OrdinaryAtom&
 OrdinaryAtomTable::getByAddress(
 IDAddress addr) const throw ()
 {
-    ReadLock lock(mutex);
-    const AddressIndex& idx(container.get<impl::AddressTag>());
-    // the following check only works for random access indices, but here it is ok
-    assert( addr < idx.size() );
-    return idx.at(addr);
+    assert( addr < directory.size() );
+    return directory[addr];
 }
 
 
@@ -203,28 +213,6 @@ IDAddress addr) const throw ()
 }
 
 
-// given string, look if already stored
-// if no, return ID_FAIL, otherwise return ID
-ID OrdinaryAtomTable::getIDByString(
-const std::string& str) const throw()
-{
-    typedef Container::index<impl::TextTag>::type OrdinaryAtomIndex;
-    ReadLock lock(mutex);
-    const TextIndex& sidx(container.get<impl::TextTag>());
-    TextIndex::const_iterator it(sidx.find(str));
-    if( it == sidx.end() )
-        return ID_FAIL;
-    else {
-        const AddressIndex& aidx(container.get<impl::AddressTag>());
-        return ID(
-            it->kind,            // kind
-                                 // address
-            container.project<impl::AddressTag>(it) - aidx.begin()
-            );
-    }
-}
-
-
 // given tuple, look if already stored
 // if no, return ID_FAIL, otherwise return ID
 ID OrdinaryAtomTable::getIDByTuple(
@@ -282,13 +270,13 @@ const OrdinaryAtom& atom) const throw ()
 }
 
 
-// store symbol, assuming it does not exist (this is only asserted)
+// store symbol, assuming it does not exist (if it was stored concurrently, return the existing one)
 ID OrdinaryAtomTable::storeAndGetID(
 const OrdinaryAtom& atm) throw()
 {
     assert(ID(atm.kind,0).isAtom());
     assert(ID(atm.kind,0).isOrdinaryAtom());
-    assert(!atm.text.empty());
+    assert(!atm.tuple.empty());
     assert(!(
         (atm.tuple.front().kind & ID::PROPERTY_AUX) != 0 &&
         (atm.kind & ID::PROPERTY_AUX) == 0 ) &&
@@ -300,11 +288,13 @@ const OrdinaryAtom& atm) throw()
     WriteLock lock(mutex);
     AddressIndex& idx(container.get<impl::AddressTag>());
     boost::tie(it, success) = idx.push_back(atm);
-    (void)success;
-    assert(success);
+    // if an equal element was stored concurrently since the caller looked it up,
+    // it points to that element and its address is returned
+    if( success )
+        directory.push_back(*it);
 
     return ID(
-        atm.kind,                // kind
+        it->kind,                // kind
                                  // address
         container.project<impl::AddressTag>(it) - idx.begin()
         );
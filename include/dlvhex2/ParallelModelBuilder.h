@@ -0,0 +1,359 @@
+/* dlvhex -- Answer-Set Programming with external interfaces.
+ * Copyright (C) 2005-2007 Roman Schindlauer
+ * Copyright (C) 2006-2015 Thomas Krennwallner
+ * Copyright (C) 2009-2015 Peter Schüller
+ * Copyright (C) 2011-2015 Christoph Redl
+ *
+ * This file is part of dlvhex.
+ *
+ * dlvhex is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * dlvhex is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with dlvhex; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+/**
+ * @file   ParallelModelBuilder.h
+ *
+ * @brief  Template for online model building which computes models of
+ *         independent evaluation units concurrently.
+ */
+
+#ifndef PARALLEL_MODEL_BUILDER_HPP_INCLUDED__14102026
+#define PARALLEL_MODEL_BUILDER_HPP_INCLUDED__14102026
+
+#include "dlvhex2/PlatformDefinitions.h"
+#include "dlvhex2/Error.h"
+#include "dlvhex2/OnlineModelBuilder.h"
+#include "dlvhex2/ThreadPool.h"
+
+#include <boost/bind.hpp>
+#include <boost/optional.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+DLVHEX_NAMESPACE_BEGIN
+
+/**
+ * \brief Model generator which computes the models of another model generator on a ThreadPool.
+ *
+ * The wrapped model generator is created and queried by the workers of the pool,
+ * always one model ahead of the consumer: the first model is computed as soon as
+ * this object is constructed, and the next model is computed as soon as the
+ * previous one has been returned by generateNextModel().
+ * The wrapped model generator is never accessed by two threads at the same time.
+ */
+template<typename InterpretationT>
+class PrefetchingModelGenerator:
+public ModelGeneratorBase<InterpretationT>
+{
+    // types
+    public:
+        typedef ModelGeneratorBase<InterpretationT> Base;
+        typedef typename Base::InterpretationConstPtr InterpretationConstPtr;
+        typedef typename Base::InterpretationPtr InterpretationPtr;
+        typedef typename ModelGeneratorFactoryBase<InterpretationT>::Ptr
+            ModelGeneratorFactoryPtr;
+
+    protected:
+        /** \brief State shared between the consumer and the worker computing the next model. */
+        struct SharedState
+        {
+            /** \brief Factory for creating the wrapped model generator. */
+            ModelGeneratorFactoryPtr mgf;
+            /** \brief Input of the wrapped model generator. */
+            InterpretationConstPtr input;
+            /** \brief Wrapped model generator (created by the first task). */
+            typename Base::Ptr generator;
+
+            /** \brief True while a worker computes the next model. */
+            bool pending;
+            /** \brief Model computed by the last task (NULL after the last model). */
+            InterpretationPtr next;
+            /** \brief Error message if the last task failed. */
+            boost::optional<std::string> error;
+
+            /** \brief Protects all members above. */
+            boost::mutex mutex;
+            /** \brief Signalled when a task has finished. */
+            boost::condition_variable done;
+
+            SharedState(ModelGeneratorFactoryPtr mgf, InterpretationConstPtr input):
+            mgf(mgf), input(input), generator(), pending(false), next(), error() {}
+        };
+        typedef boost::shared_ptr<SharedState> SharedStatePtr;
+
+        // storage
+    protected:
+        /** \brief Pool which executes the model computations. */
+        ThreadPool& pool;
+        /** \brief State shared with the worker. */
+        SharedStatePtr state;
+
+        // members
+    public:
+        /** \brief Constructor; schedules computation of the first model.
+         * @param pool Pool which executes the model computations.
+         * @param mgf Factory for the wrapped model generator.
+         * @param input Input interpretation. */
+        PrefetchingModelGenerator(ThreadPool& pool, ModelGeneratorFactoryPtr mgf, InterpretationConstPtr input):
+        Base(input), pool(pool), state(new SharedState(mgf, input)) {
+            prefetch();
+        }
+
+        /** \brief Destructor; waits for a running computation. */
+        virtual ~PrefetchingModelGenerator() {
+            // the wrapped model generator must not outlive the consumer's
+            // data structures (e.g., the registry), so do not leave it running
+            boost::mutex::scoped_lock lock(state->mutex);
+            while( state->pending )
+                state->done.wait(lock);
+        }
+
+        virtual InterpretationPtr generateNextModel() {
+            InterpretationPtr model;
+            {
+                boost::mutex::scoped_lock lock(state->mutex);
+                while( state->pending )
+                    state->done.wait(lock);
+                if( !!state->error )
+                    throw GeneralError("model generation failed in worker thread: " + state->error.get());
+                model.swap(state->next);
+            }
+            if( model )
+                prefetch();
+            return model;
+        }
+
+        virtual std::ostream& print(std::ostream& o) const
+        {
+            o << "PrefetchingModelGenerator";
+            if( state->generator )
+                o << "(" << *state->generator << ")";
+            return o;
+        }
+
+    protected:
+        /** \brief Schedules the computation of the next model. */
+        void prefetch() {
+            {
+                boost::mutex::scoped_lock lock(state->mutex);
+                assert(!state->pending);
+                state->pending = true;
+            }
+            pool.schedule(boost::bind(&PrefetchingModelGenerator::computeNextModel, state));
+        }
+
+        /** \brief Task executed by a worker: creates the wrapped model generator if necessary and computes its next model.
+         * @param state Shared state of the PrefetchingModelGenerator. */
+        static void computeNextModel(SharedStatePtr state) {
+            InterpretationPtr model;
+            boost::optional<std::string> error;
+            try
+            {
+                if( !state->generator )
+                    state->generator = state->mgf->createModelGenerator(state->input);
+                model = state->generator->generateNextModel();
+                // free resources of the wrapped model generator as early as possible
+                if( !model )
+                    state->generator.reset();
+            }
+            catch(const std::exception& e) {
+                error = std::string(e.what());
+            }
+            catch(...) {
+                error = std::string("unknown exception");
+            }
+
+            {
+                boost::mutex::scoped_lock lock(state->mutex);
+                state->next = model;
+                state->error = error;
+                state->pending = false;
+            }
+            state->done.notify_all();
+        }
+};
+
+/**
+ * \brief Online model builder which computes models of independent units concurrently.
+ *
+ * Model building is done exactly as in OnlineModelBuilder, and the model graph
+ * is only modified by the calling thread. However, model generators run on a
+ * ThreadPool (see PrefetchingModelGenerator), and before a unit with multiple
+ * predecessors collects output models of its predecessors, model generation is
+ * started at all predecessor units which can already compute models.
+ * Therefore sibling units which do not depend on each other compute their
+ * models concurrently, and each unit computes its next model while the
+ * previous one is processed by its successors.
+ */
+template<typename EvalGraphT>
+class ParallelModelBuilder:
+public OnlineModelBuilder<EvalGraphT>
+{
+    // types
+    public:
+        typedef OnlineModelBuilder<EvalGraphT> Base;
+        typedef ParallelModelBuilder<EvalGraphT> Self;
+
+        typedef typename Base::EvalUnit EvalUnit;
+        typedef typename Base::EvalUnitPredecessorIterator EvalUnitPredecessorIterator;
+        typedef typename Base::EvalUnitModelBuildingProperties EvalUnitModelBuildingProperties;
+        typedef typename Base::Interpretation Interpretation;
+        typedef typename Base::Model Model;
+        typedef typename Base::OptionalModel OptionalModel;
+        typedef typename Base::ModelSuccessorIterator ModelSuccessorIterator;
+
+        // storage
+    protected:
+        /** \brief Workers which execute the model generators. */
+        ThreadPool pool;
+        /** \brief False if model generators must not compute models in advance (see ModelBuilderConfig::optimization). */
+        bool prefetch;
+
+        // methods
+    public:
+        /** \brief Constructor.
+         * @param cfg Configuration; ModelBuilderConfig::workerThreads is the size of the thread pool. */
+        ParallelModelBuilder(ModelBuilderConfig<EvalGraphT>& cfg):
+        Base(cfg), pool(cfg.workerThreads), prefetch(!cfg.optimization) {
+            LOG(MODELB,"parallel model builder uses " << pool.size() << " worker threads");
+            if( !prefetch )
+                LOG(WARNING,"optimization is active, the parallel model builder evaluates all units on the calling thread");
+        }
+
+        /** \brief Destructor. */
+        virtual ~ParallelModelBuilder() {
+            // model generators hold a reference to the pool, destroy them before the pool
+            typename std::vector<EvalUnitModelBuildingProperties>::iterator it;
+            for(it = this->mbp.storage_begin(); it != this->mbp.storage_end(); ++it)
+                it->currentmg.reset();
+        }
+
+        // get next input model (projected if projection is configured) at unit u
+        virtual OptionalModel getNextIModel(EvalUnit u);
+
+    protected:
+        virtual typename ModelGeneratorBase<Interpretation>::Ptr
+            createModelGenerator(EvalUnit u, typename Interpretation::ConstPtr input);
+
+        /** \brief Starts model generation at all (transitive) predecessors of a unit which can compute output models now.
+         * @param u Evaluation unit. */
+        void startPredecessors(EvalUnit u);
+
+        /** \brief Checks if the model generators of a unit may run on the pool.
+         * @param u Evaluation unit.
+         * @return True if models of \p u can be computed concurrently. */
+        bool isConcurrent(EvalUnit u) const;
+
+        /** \brief Starts model generation at a unit if its current input model has no output models yet.
+         * @param u Evaluation unit with input model. */
+        void startModelGenerator(EvalUnit u);
+};
+
+template<typename EvalGraphT>
+typename ModelGeneratorBase<typename ParallelModelBuilder<EvalGraphT>::Interpretation>::Ptr
+ParallelModelBuilder<EvalGraphT>::createModelGenerator(
+EvalUnit u, typename Interpretation::ConstPtr input)
+{
+    // units which are not thread-safe are evaluated on the calling thread as by OnlineModelBuilder
+    if( !isConcurrent(u) )
+        return Base::createModelGenerator(u, input);
+
+    DBGLOG(DBG,"creating prefetching model generator for unit " << u);
+    return typename ModelGeneratorBase<Interpretation>::Ptr(
+        new PrefetchingModelGenerator<Interpretation>(pool, this->eg.propsOf(u).mgf, input));
+}
+
+
+template<typename EvalGraphT>
+bool
+ParallelModelBuilder<EvalGraphT>::isConcurrent(
+EvalUnit u) const
+{
+    // with optimization, a model computed in advance was pruned with an outdated optimum,
+    // and the model generator would read the optimum while it is updated
+    return prefetch && this->eg.propsOf(u).mgf->isThreadSafe();
+}
+
+
+template<typename EvalGraphT>
+void
+ParallelModelBuilder<EvalGraphT>::startModelGenerator(
+EvalUnit u)
+{
+    EvalUnitModelBuildingProperties& mbprops = this->mbp[u];
+    assert(!!mbprops.getIModel());
+    if( !!mbprops.currentmg || mbprops.hasOModel() )
+        return;
+    if( !isConcurrent(u) )
+        return;
+
+    Model imodel = mbprops.getIModel().get();
+    if( this->mg.propsOf(imodel).childModelsGenerated )
+        return;
+    // if there are successors, OnlineModelBuilder will use them before it uses a model generator
+    ModelSuccessorIterator sbegin, send;
+    boost::tie(sbegin, send) = this->mg.getSuccessors(imodel);
+    if( sbegin != send )
+        return;
+
+    LOG(MODELB,"starting model generation at unit " << u << " for imodel " << imodel);
+    mbprops.currentmg = createModelGenerator(u, this->mg.propsOf(imodel).getInterpretation());
+}
+
+
+template<typename EvalGraphT>
+void
+ParallelModelBuilder<EvalGraphT>::startPredecessors(
+EvalUnit u)
+{
+    EvalUnitPredecessorIterator pit, pend;
+    for(boost::tie(pit, pend) = this->eg.getPredecessors(u); pit != pend; ++pit) {
+        EvalUnit pred = this->eg.targetOf(*pit);
+        EvalUnitModelBuildingProperties& predmbprops = this->mbp[pred];
+        if( predmbprops.hasOModel() || !!predmbprops.currentmg )
+            continue;
+
+        if( !predmbprops.getIModel() ) {
+            if( predmbprops.needInput ) {
+                // input models of pred are not known yet, but maybe we can start its predecessors
+                startPredecessors(pred);
+                continue;
+            }
+            // for units without input this only sets the dummy imodel,
+            // which would be done by the first getNextOModel(pred) anyways
+            Base::getNextIModel(pred);
+        }
+        startModelGenerator(pred);
+    }
+}
+
+
+template<typename EvalGraphT>
+typename ParallelModelBuilder<EvalGraphT>::OptionalModel
+ParallelModelBuilder<EvalGraphT>::getNextIModel(
+EvalUnit u)
+{
+    if( prefetch && this->mbp[u].needInput )
+        startPredecessors(u);
+    return Base::getNextIModel(u);
+}
+
+
+DLVHEX_NAMESPACE_END
+#endif                           // PARALLEL_MODEL_BUILDER_HPP_INCLUDED__14102026
+
+// vim:expandtab:ts=4:sw=4:
+// mode: C++
+// End:
@@ -75,6 +75,15 @@
 #define WARNING(msg) _WARNING(message (#msg))
 #endif
 
+// marks functions which are kept only for source compatibility of plugins
+#if defined(__GNUC__)
+#define DLVHEX_DEPRECATED __attribute__((deprecated))
+#elif defined(_MSC_VER)
+#define DLVHEX_DEPRECATED __declspec(deprecated)
+#else
+#define DLVHEX_DEPRECATED
+#endif
+
 // on Windows we need to export the relevant part of the STL instantiation
 #ifdef WIN32
 #include <stdexcept>
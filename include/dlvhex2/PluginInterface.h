@@ -216,6 +216,7 @@
 #include "dlvhex2/ComponentGraph.h"
 #include "dlvhex2/ExtSourceProperties.h"
 #include "dlvhex2/ExternalAtomEvaluationHeuristicsInterface.h"
+#include "dlvhex2/ShardedCache.h"
 
 #include <boost/shared_ptr.hpp>
 #include <boost/unordered_map.hpp>
@@ -1050,6 +1051,8 @@ class DLVHEX_EXPORT PluginAtom
          * The function performs the following operations.
          * 1. It splits the query into atomic queries using PluginAtom::splitQuery.
          * 2. It answers the atomic queries by calling either PluginAtom::retrieveCached or PluginAtom::retrieve, depending on the settings.
+         *    If the external source is thread-safe (see ExtSourceProperties::isThreadSafe) and parallel evaluation is enabled,
+         *    the atomic queries are answered concurrently; the answers are merged in the order of the atomic queries.
          * 3. It applies default learning methods to the result (e.g. learning from IO behavior, monotonicity, functionality, etc.).
          *
          * This method must not be overridden.
@@ -1063,6 +1066,79 @@ class DLVHEX_EXPORT PluginAtom
          */
         bool retrieveFacade(const Query& query, Answer& answer, NogoodContainerPtr nogoods, bool useCache);
 
+        /**
+         * \brief Answers multiple external queries at once.
+         *
+         * Works as retrieveFacade(const Query&, Answer&, NogoodContainerPtr, bool) for each query, but the atomic queries
+         * of all queries which are not answered from cache are passed to the external source with a single call
+         * of PluginAtom::retrieveBatch (unless they are answered concurrently).
+         *
+         * This method must not be overridden.
+         *
+         * @param queries Inputs to the external source.
+         * @param answers Outputs of the external source; answers[i] corresponds to queries[i].
+         *                Missing elements are appended, tuples are appended to existing elements.
+         * @param nogoods Here, nogoods learned from the external source can be added to prune the search space; see Nogood, NogoodContainer and ExternalLearningHelper.
+         * @param useCache True to use the cache (if possible), false to answer the queries directly.
+         *
+         * @return True if at least one query was answered from cache and false otherwise.
+         */
+        bool retrieveFacade(const std::vector<Query>& queries, std::vector<Answer>& answers, NogoodContainerPtr nogoods, bool useCache);
+
+        /**
+         * \brief Default learning which was postponed by retrieveFacade, see PluginAtom::learnDeferred.
+         */
+        struct DeferredLearning
+        {
+            /** \brief Atomic queries which were not answered from cache. */
+            std::vector<Query> atomicQueries;
+            /** \brief Answers to atomicQueries. */
+            std::vector<Answer> atomicAnswers;
+            /** \brief Properties of the external atoms of atomicQueries. */
+            std::vector<const ExtSourceProperties*> atomicProps;
+            /** \brief Queries passed to retrieveFacade. */
+            std::vector<Query> queries;
+            /** \brief Answers to queries. */
+            std::vector<Answer> answers;
+            /** \brief Properties of the external atoms of queries. */
+            std::vector<const ExtSourceProperties*> props;
+        };
+
+        /**
+         * \brief Answers multiple external queries at once, but postpones the default learning methods.
+         *
+         * Works as retrieveFacade(const std::vector<Query>&, std::vector<Answer>&, NogoodContainerPtr, bool),
+         * but if \p deferred is not NULL, the default learning methods (which store atoms in the registry)
+         * are not applied but recorded in \p deferred.
+         * This allows for calling this method concurrently and learning on a single thread afterwards.
+         *
+         * @param queries Inputs to the external source.
+         * @param answers Outputs of the external source; answers[i] corresponds to queries[i].
+         * @param nogoods Here, nogoods learned by the external source itself are added.
+         * @param useCache True to use the cache (if possible), false to answer the queries directly.
+         * @param deferred Receives the postponed learning steps; NULL to learn immediately.
+         *
+         * @return True if at least one query was answered from cache and false otherwise.
+         */
+        bool retrieveFacade(const std::vector<Query>& queries, std::vector<Answer>& answers, NogoodContainerPtr nogoods, bool useCache, DeferredLearning* deferred);
+
+        /**
+         * \brief Applies the default learning methods which were postponed by retrieveFacade.
+         * @param deferred Learning steps recorded by retrieveFacade.
+         * @param nogoods Container for the learned nogoods.
+         */
+        void learnDeferred(const DeferredLearning& deferred, NogoodContainerPtr nogoods);
+
+        /**
+         * \brief Returns the thread pool used for concurrent evaluation of external atoms.
+         *
+         * The pool is owned by \p ctx, shared by all external atoms and created on first use with the number of threads
+         * given by option ParallelExternalEvaluation.
+         * @param ctx ProgramCtx whose configuration and thread pool is used.
+         * @return Thread pool, or NULL if external atoms shall be evaluated sequentially.
+         */
+        static ThreadPool* getEvaluationPool(const ProgramCtx& ctx);
+
         /**
          * \brief Retrieve answer object according to a query by using the cache if possible.
          *
@@ -1123,6 +1199,20 @@ class DLVHEX_EXPORT PluginAtom
          */
         virtual void retrieve(const Query& query, Answer& answer);
 
+        /**
+         * \brief Retrieve answers to multiple queries (external computation happens here).
+         *
+         * The default implementation calls retrieve(const Query& query, Answer& answer, NogoodContainerPtr nogoods)
+         * for each query. External sources with a high overhead per call (e.g. because they connect to a database
+         * or an interpreter) can override this method to answer all queries at once.
+         *
+         * @param queries Inputs to the external source.
+         * @param answers Receives exactly one answer per query (in the same order); it is empty when called.
+         * @param nogoods One container per query (in the same order), nogoods learned while answering queries[i] are added to nogoods[i]
+         * to prune the search space; see Nogood, NogoodContainer and ExternalLearningHelper. The containers are NULL if no nogoods are requested.
+         */
+        virtual void retrieveBatch(const std::vector<Query>& queries, std::vector<Answer>& answers, const std::vector<NogoodContainerPtr>& nogoods);
+
         /**
          * \brief Is called for learning support sets. Needs to be implemented if PluginAtom::prop declares
          * that the external source provides support sets.
@@ -1260,11 +1350,18 @@ class DLVHEX_EXPORT PluginAtom
             { return predicate; }
 
         /**
-         * \brief Erase all elements from queryAnswerCache and queryNogoodCache
+         * \brief Erase all elements from queryCache
          */
         void resetCache() {
-            queryAnswerCache.clear();
-            queryNogoodCache.clear();
+            queryCache.clear();
+        }
+
+        /**
+         * \brief Limits the memory used by queryCache; least recently used answers are evicted when the limit is exceeded.
+         * @param bytes Memory limit in bytes, 0 for unlimited.
+         */
+        void setCacheLimit(std::size_t bytes) {
+            queryCache.setCapacity(bytes);
         }
 
     protected:
@@ -1292,19 +1389,75 @@ class DLVHEX_EXPORT PluginAtom
         unsigned outputSize;
 
         // Query/Answer cache
-        /** \brief Type used for associating an Answer to a Query. */
-        typedef boost::unordered_map<const Query, Answer> QueryAnswerCache;
-        /** \brief Type used for associating a container of learned nogoods to a Query. */
-        typedef boost::unordered_map<const Query, SimpleNogoodContainerPtr> QueryNogoodCache;
-        /** \brief Associates an Answer to a Query. */
-        QueryAnswerCache queryAnswerCache;
-        /** \brief Associates a container of learned Nogoods Query. */
-        QueryNogoodCache queryNogoodCache;
-        /** \brief Mutex for accessing PluginAtom::queryAnswerCache and PluginAtom::queryNogoodCache. */
-        boost::mutex cacheMutex;
+        /** \brief Cached result of a Query. */
+        struct CachedAnswer
+        {
+            /** \brief Answer to the query. */
+            Answer answer;
+            /** \brief Nogoods learned while answering the query, NULL if learning was not requested. */
+            SimpleNogoodContainerPtr nogoods;
+        };
+        /** \brief Type used for associating a CachedAnswer to a Query. */
+        typedef ShardedCache<Query, CachedAnswer> QueryCache;
+        /** \brief Associates answers and learned nogoods to queries (thread-safe). */
+        QueryCache queryCache;
+
+        /**
+         * \brief Answers a query from a cached query with the same input and a more general pattern.
+         *
+         * The cached answer is filtered by the pattern of \p query.
+         * @param query Query whose pattern must not contain nested terms.
+         * @param result Receives the filtered answer and the nogoods of the general query.
+         * @param withNogoods If true, only entries with nogoods are considered.
+         * @return True if a more general query was found in the cache.
+         */
+        bool retrieveSubsumed(const Query& query, CachedAnswer& result, bool withNogoods);
+
+        /**
+         * \brief Answers an atomic query either by PluginAtom::retrieveCached or by PluginAtom::retrieve.
+         * @param query Atomic query.
+         * @param answer Output of the external source.
+         * @param nogoods Container for nogoods learned by the external source, may be NULL.
+         * @param useCache True to use the cache.
+         * @param fromCache Set to true if the query was answered from cache and to false otherwise.
+         */
+        void retrieveAtomic(const Query& query, Answer& answer, NogoodContainerPtr nogoods, bool useCache, bool& fromCache);
+
+        /**
+         * \brief Answers atomic queries from cache and the remaining ones with a single call of PluginAtom::retrieveBatch.
+         *
+         * As in PluginAtom::retrieveCached, each query is cached with the nogoods learned while answering it.
+         * @param queries Atomic queries.
+         * @param answers Receives one answer per query.
+         * @param fromCache Receives for each query whether it was answered from cache.
+         * @param nogoods Container for nogoods learned by the external source, may be NULL.
+         */
+        void retrieveCachedBatch(const std::vector<Query>& queries, std::vector<Answer>& answers, std::vector<bool>& fromCache, NogoodContainerPtr nogoods);
+
+        /**
+         * \brief Looks up the answer to a query in the cache.
+         * @param key Query with canonical pattern (see PluginAtom::retrieveCached).
+         * @param query Original query.
+         * @param answer Receives the cached answer.
+         * @param nogoods If not NULL, receives the cached nogoods; then only entries with nogoods can answer the query.
+         * @param inCache Set to true if an entry for \p key exists (possibly without nogoods).
+         * @return True if the query was answered from cache.
+         */
+        bool lookupCached(const Query& key, const Query& query, Answer& answer, NogoodContainerPtr nogoods, bool& inCache);
+
+        /**
+         * \brief Applies the default learning methods for a single atomic query (learning from IO behavior and functionality).
+         * @param atomicQuery Atomic query which was not answered from cache.
+         * @param atomicAnswer Answer to \p atomicQuery.
+         * @param prop Properties of the external atom.
+         * @param nogoods Container for the learned nogoods.
+         */
+        void learnFromAtomicAnswer(const Query& atomicQuery, const Answer& atomicAnswer, const ExtSourceProperties& prop, NogoodContainerPtr nogoods);
 
         /** \brief Output tuples generated so far (used for learning for functional sources). */
         std::vector<Tuple> otuples;
+        /** \brief Protects otuples if queries are answered concurrently. */
+        boost::mutex otuplesMutex;
 
         /** \brief Registry associated with this atom.
          *
@@ -1410,6 +1563,39 @@ class FinalCallback
 };
 typedef boost::shared_ptr<FinalCallback> FinalCallbackPtr;
 
+/**
+ * \brief Restricts the models which are still of interest during model enumeration.
+ *
+ * Setup such a bound in PluginInterface::setupProgramCtx
+ * Register it in ProgramCtx::modelBound
+ *
+ * The bound is usually strengthened by a ModelCallback after each model.
+ * Model generators based on the genuine solvers add the nogood of the bound
+ * to their solver before they search for the next model; this prunes models
+ * which cannot change the result, e.g., of cautious or brave reasoning.
+ * (For an example see QueryPlugin.cpp.)
+ */
+class ModelBound
+{
+    public:
+        virtual ~ModelBound() {}
+        /**
+         * \brief Computes the nogood of the bound for a ground program.
+         *
+         * The nogood must be violated by every model which is no longer of interest,
+         * and by every partial model of an evaluation unit whose extensions are all no longer of interest.
+         * Might be called concurrently by model generators of different evaluation units.
+         *
+         * @param programMask The atoms of the ground program; all other atoms are false in the models of this program
+         * or are not yet known because they are defined in a later evaluation unit.
+         * @param version The version of the bound which was already retrieved by the caller (initially 0); is set to the current version.
+         * @param ng Receives the nogood.
+         * @return True if \p ng shall be added, false if the bound did not change since \p version or does not apply to the program.
+         */
+        virtual bool getNogood(InterpretationConstPtr programMask, unsigned& version, Nogood& ng) = 0;
+};
+typedef boost::shared_ptr<ModelBound> ModelBoundPtr;
+
 /**
  * \brief Rewriter class.
  *
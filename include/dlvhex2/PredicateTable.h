@@ -97,7 +97,7 @@ BOOST_MULTI_INDEX_MEMBER(Predicate,std::string,symbol)
 
         /** \brief Store symbol, assuming it does not exist.
          *
-         * Assert that symbol did not exist.
+         * If an equal symbol was stored concurrently, the existing one is returned.
          * @param symb Predicate to store.
          * @return ID of the stored Predicate. */
         inline ID storeAndGetID(const Predicate& symb) throw();
@@ -118,11 +118,10 @@ const Predicate& PredicateTable::getByID(ID id) const throw ()
 {
     assert(id.isTerm());
     assert(id.isPredicateTerm() );
+    // elements are replaced in place by setArity(), hence we cannot read without locking
     ReadLock lock(mutex);
-    const AddressIndex& idx = container.get<impl::AddressTag>();
-    // the following check only works for random access indices, but here it is ok
-    assert( id.address < idx.size() );
-    return idx.at(id.address);
+    assert( id.address < directory.size() );
+    return directory[id.address];
 }
 
 
@@ -181,7 +180,7 @@ const Predicate& PredicateTable::getByString(const std::string& str) const throw
 
 
 // store symbol, assuming it does not exist
-// assert that symbol did not exist
+// if it was stored concurrently, return the existing one
 ID PredicateTable::storeAndGetID(const Predicate& symb) throw()
 {
     assert(ID(symb.kind,0).isTerm());
@@ -194,10 +193,12 @@ ID PredicateTable::storeAndGetID(const Predicate& symb) throw()
     WriteLock lock(mutex);
     AddressIndex& idx = container.get<impl::AddressTag>();
     boost::tie(it, success) = idx.push_back(symb);
-    (void)success;
-    assert(success);
+    // if an equal element was stored concurrently since the caller looked it up,
+    // it points to that element and its address is returned
+    if( success )
+        directory.push_back(*it);
 
-    return ID(symb.kind,         // kind
+    return ID(it->kind,          // kind
                                  // address
         container.project<impl::AddressTag>(it) - idx.begin()
         );
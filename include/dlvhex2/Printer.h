@@ -92,6 +92,9 @@ public Printer
         RawPrinter(std::ostream& out, RegistryPtr registry):
         Printer(out, registry) {}
         virtual void print(ID id);
+        /** \brief Prints an ordinary atom given by its storage, i.e., its predicate followed by the parenthesized arguments.
+         * @param atom Atom to print. */
+        void printOrdinaryAtom(const OrdinaryAtom& atom);
         /** \brief Prints a single ID without module prefix (cf. modular HEX).
          * @param id ID to print. */
         void printWithoutPrefix(ID id);
@@ -51,10 +51,12 @@
 
 #include <boost/shared_ptr.hpp>
 #include <boost/functional/factory.hpp>
+#include <boost/thread/mutex.hpp>
 
 #include <typeinfo>
 #include <vector>
 #include <string>
+#include <map>
 #include <iosfwd>
 
 DLVHEX_NAMESPACE_BEGIN
@@ -185,6 +187,8 @@ class DLVHEX_EXPORT ProgramCtx
         std::list<ModelCallbackPtr> modelCallbacks;
         /** \brief FinalCallback. */
         std::list<FinalCallbackPtr> finalCallbacks;
+        /** \brief Might be set to a bound for pruning model enumeration (see ModelBound). */
+        ModelBoundPtr modelBound;
         /** \brief ModelBuilder being used, may be online or offline. */
         ModelBuilderPtr modelBuilder;
         // model graph is only accessible via modelbuilder->getModelGraph()!
@@ -227,6 +231,15 @@ class DLVHEX_EXPORT ProgramCtx
         void
             setASPSoftware(ASPSolverManager::SoftwareConfigurationPtr c);
 
+        /** \brief Retrieves a thread pool of this ProgramCtx, the pool is created on first use.
+         *
+         * Pools for different purposes are kept apart, copies of this ProgramCtx share the pools.
+         * @param purpose Name of the pool.
+         * @param threads Number of worker threads if the pool is created.
+         * @return Thread pool which lives at least as long as this ProgramCtx. */
+        ThreadPool&
+            getThreadPool(const std::string& purpose, unsigned threads) const;
+
         //
         // plugin helpers
         //
@@ -362,6 +375,17 @@ class DLVHEX_EXPORT ProgramCtx
 
         /** \brief Atoms usable for evaluation (loaded from plugins or manually added). */
         PluginAtomMap pluginAtoms;
+
+        /** \brief Thread pools created by getThreadPool. */
+        struct ThreadPools
+        {
+            /** \brief Protects pools. */
+            boost::mutex mutex;
+            /** \brief Pools by purpose. */
+            std::map<std::string, boost::shared_ptr<ThreadPool> > pools;
+        };
+        /** \brief Thread pools of this ProgramCtx (shared with its copies). */
+        boost::shared_ptr<ThreadPools> threadPools;
 };
 
 // used by plugins to store specific plugin data in ProgramCtx
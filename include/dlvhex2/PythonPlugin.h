@@ -185,6 +185,7 @@
  *   <li>\code{.txt}bool isTrue(id)\endcode Checks if an input atom identified by ID \em id is assigned to true.</li>
  *   <li>\code{.txt}bool isFalse(id)\endcode Checks if an input atom identified by ID \em id is assigned to false.</li>
  *   <li>\code{.txt}void resetCacheOfPlugins()\endcode Empties all caches of external atom evaluation results and all cached nogoods from external learning.</li>
+ *   <li>\code{.txt}void selectQuery(i)\endcode Used internally if several queries to an external atom are answered by a single call into Python: makes the \em i-th of them the current query.</li>
  * </ul>
  *
  * <b>Conflict-driven Learning</b><br/>
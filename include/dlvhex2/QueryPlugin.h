@@ -86,6 +86,11 @@ public PluginInterface
              * Positive witnesses for brave and negative for cautious reasoning. */
             bool allWitnesses;
 
+            /** \brief Whether to enumerate all answer sets for nonground queries.
+             *
+             * Otherwise answer sets which cannot change the answer are pruned (see ModelBound). */
+            bool enumerateAllModels;
+
             CtxData();
             virtual ~CtxData() {};
     };
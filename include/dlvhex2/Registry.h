@@ -130,10 +130,8 @@ public boost::enable_shared_from_this<Registry>
         /**
          * \brief Retrieval of ordinary atoms.
          *
-         * Lookup by tuple, if does not exist create text and store as new atom
+         * Lookup by tuple, if does not exist store as new atom
          * assume, that oatom.kind and oatom.tuple is initialized!
-         * assume, that oatom.text is not initialized!
-         * oatom.text will be modified.
          *
          * The method can be used both for ground and nonground atoms.
          * @param ogatom Atom pattern.
@@ -143,10 +141,8 @@ public boost::enable_shared_from_this<Registry>
         /**
          * \brief Retrieval of ordinary ground atoms.
          *
-         * Lookup by tuple, if does not exist create text and store as new ground atom
+         * Lookup by tuple, if does not exist store as new ground atom
          * assume, that oatom.kind and oatom.tuple is initialized!
-         * assume, that oatom.text is not initialized!
-         * oatom.text will be modified.
          * @param ogatom Atom pattern.
          * @return ID of \p ogatom.
          */
@@ -154,10 +150,8 @@ public boost::enable_shared_from_this<Registry>
         /**
          * \brief Retrieval of ordinary nonground atoms.
          *
-         * Lookup by tuple, if does not exist create text and store as new nonground atom
+         * Lookup by tuple, if does not exist store as new nonground atom
          * assume, that oatom.kind and oatom.tuple is initialized!
-         * assume, that oatom.text is not initialized!
-         * oatom.text will be modified.
          * @param onatom Atom pattern.
          * @return ID of \p onatom.
          */
@@ -104,7 +104,7 @@ BOOST_MULTI_INDEX_MEMBER(Rule,Tuple,weakconstraintVector)
 
         /** Stores rule.
          *
-         * Assert that rule did not exist in table.
+         * If an equal rule was stored concurrently, the existing one is returned.
          * @param rule Rule to store.
          * @return ID of the stored rule.
          */
@@ -147,11 +147,10 @@ ID id) const throw ()
 {
     assert(id.isRule());
     assert(id.isRegularRule() || id.isConstraint() || id.isWeakConstraint() || id.isWeightRule());
+    // elements are replaced in place by update(), hence we cannot read without locking
     ReadLock lock(mutex);
-    const AddressIndex& idx = container.get<impl::AddressTag>();
-    // the following check only works for random access indices, but here it is ok
-    assert( id.address < idx.size() );
-    return idx.at(id.address);
+    assert( id.address < directory.size() );
+    return directory[id.address];
 }
 
 
@@ -193,11 +192,13 @@ const Rule& rule) throw()
     WriteLock lock(mutex);
     AddressIndex& idx = container.get<impl::AddressTag>();
     boost::tie(it, success) = idx.push_back(rule);
-    (void)success;
-    assert(success);
+    // if an equal element was stored concurrently since the caller looked it up,
+    // it points to that element and its address is returned
+    if( success )
+        directory.push_back(*it);
 
     return ID(
-        rule.kind,               // kind
+        it->kind,                // kind
                                  // address
         container.project<impl::AddressTag>(it) - idx.begin()
         );
@@ -208,6 +209,7 @@ void RuleTable::clear()
 {
     WriteLock lock(mutex);
     container.clear();
+    directory.clear();
 }
 
 
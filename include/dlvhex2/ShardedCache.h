@@ -0,0 +1,194 @@
+/* dlvhex -- Answer-Set Programming with external interfaces.
+ * Copyright (C) 2005-2007 Roman Schindlauer
+ * Copyright (C) 2006-2015 Thomas Krennwallner
+ * Copyright (C) 2009-2015 Peter Schüller
+ * Copyright (C) 2011-2015 Christoph Redl
+ *
+ * This file is part of dlvhex.
+ *
+ * dlvhex is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * dlvhex is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with dlvhex; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+/**
+ * @file   ShardedCache.h
+ *
+ * @brief  Thread-safe key-value cache with a memory budget and LRU eviction.
+ */
+
+#ifndef SHARDED_CACHE_HPP_INCLUDED__16102026
+#define SHARDED_CACHE_HPP_INCLUDED__16102026
+
+#include "dlvhex2/PlatformDefinitions.h"
+
+#include <boost/unordered_map.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/scoped_array.hpp>
+
+#include <list>
+#include <algorithm>
+
+DLVHEX_NAMESPACE_BEGIN
+
+/**
+ * \brief Thread-safe cache which evicts least recently used entries when a memory budget is exceeded.
+ *
+ * Entries are distributed over a fixed number of shards by their hash;
+ * each shard has its own lock and an equal part of the budget,
+ * hence concurrent accesses to different keys rarely contend.
+ * The cost of an entry is an estimate of its memory usage provided by the caller.
+ */
+template<typename KeyT, typename ValueT, typename HashT = boost::hash<KeyT> >
+class ShardedCache
+{
+    private:
+        /** \brief Cached entry, kept in a list ordered from most to least recently used. */
+        struct Entry
+        {
+            KeyT key;
+            ValueT value;
+            std::size_t cost;
+            Entry(const KeyT& key, const ValueT& value, std::size_t cost): key(key), value(value), cost(cost) {}
+        };
+        typedef std::list<Entry> EntryList;
+        typedef boost::unordered_map<KeyT, typename EntryList::iterator, HashT> EntryIndex;
+
+        /** \brief Independently locked part of the cache. */
+        struct Shard
+        {
+            boost::mutex mutex;
+            EntryList entries;
+            EntryIndex index;
+            std::size_t cost;
+            Shard(): cost(0) {}
+        };
+
+        /** \brief Number of shards. */
+        const unsigned shardCount;
+        /** \brief Shards of the cache. */
+        boost::scoped_array<Shard> shards;
+        /** \brief Budget per shard, 0 for unbounded. */
+        std::size_t shardCapacity;
+        /** \brief Hash function. */
+        HashT hash;
+
+        inline Shard& shardOf(const KeyT& key)
+        {
+            // the lower bits are used by the hash map within the shard
+            std::size_t h = hash(key);
+            return shards[(h ^ (h >> 16)) % shardCount];
+        }
+
+        /** \brief Removes least recently used entries until the shard fits into its budget; the most recent entry is always kept. */
+        void evict(Shard& shard)
+        {
+            if( shardCapacity == 0 ) return;
+            while( shard.cost > shardCapacity && shard.entries.size() > 1 ) {
+                Entry& last = shard.entries.back();
+                shard.cost -= last.cost;
+                shard.index.erase(last.key);
+                shard.entries.pop_back();
+            }
+        }
+
+        ShardedCache(const ShardedCache&);
+        ShardedCache& operator=(const ShardedCache&);
+
+    public:
+        /** \brief Constructor.
+         * @param capacity Memory budget in bytes, 0 for unbounded.
+         * @param shardCount Number of independently locked shards. */
+        ShardedCache(std::size_t capacity = 0, unsigned shardCount = 16):
+        shardCount(shardCount), shards(new Shard[shardCount]), shardCapacity(0) {
+            setCapacity(capacity);
+        }
+
+        /** \brief Changes the memory budget, evicting entries if necessary.
+         * @param capacity Memory budget in bytes, 0 for unbounded. */
+        void setCapacity(std::size_t capacity)
+        {
+            shardCapacity = (capacity == 0 ? 0 : std::max<std::size_t>(capacity / shardCount, 1));
+            for(unsigned i = 0; i < shardCount; ++i) {
+                boost::mutex::scoped_lock lock(shards[i].mutex);
+                evict(shards[i]);
+            }
+        }
+
+        /** \brief Looks up a key and marks it as most recently used.
+         * @param key Key to look up.
+         * @param value Receives a copy of the cached value if found.
+         * @return True if the key was found. */
+        bool lookup(const KeyT& key, ValueT& value)
+        {
+            Shard& shard = shardOf(key);
+            boost::mutex::scoped_lock lock(shard.mutex);
+            typename EntryIndex::iterator it = shard.index.find(key);
+            if( it == shard.index.end() ) return false;
+            shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+            value = it->second->value;
+            return true;
+        }
+
+        /** \brief Inserts or replaces the value of a key, evicting least recently used entries if the budget is exceeded.
+         * @param key Key to store.
+         * @param value Value to store.
+         * @param cost Estimated memory usage of the entry in bytes. */
+        void insert(const KeyT& key, const ValueT& value, std::size_t cost)
+        {
+            Shard& shard = shardOf(key);
+            boost::mutex::scoped_lock lock(shard.mutex);
+            typename EntryIndex::iterator it = shard.index.find(key);
+            if( it != shard.index.end() ) {
+                shard.cost -= it->second->cost;
+                shard.entries.erase(it->second);
+                shard.index.erase(it);
+            }
+            shard.entries.push_front(Entry(key, value, cost));
+            shard.index.insert(std::make_pair(key, shard.entries.begin()));
+            shard.cost += cost;
+            evict(shard);
+        }
+
+        /** \brief Removes all entries. */
+        void clear()
+        {
+            for(unsigned i = 0; i < shardCount; ++i) {
+                boost::mutex::scoped_lock lock(shards[i].mutex);
+                shards[i].index.clear();
+                shards[i].entries.clear();
+                shards[i].cost = 0;
+            }
+        }
+
+        /** \brief Retrieves the number of cached entries.
+         * @return Number of entries. */
+        std::size_t size()
+        {
+            std::size_t s = 0;
+            for(unsigned i = 0; i < shardCount; ++i) {
+                boost::mutex::scoped_lock lock(shards[i].mutex);
+                s += shards[i].index.size();
+            }
+            return s;
+        }
+};
+
+DLVHEX_NAMESPACE_END
+#endif                           // SHARDED_CACHE_HPP_INCLUDED__16102026
+
+// vim:expandtab:ts=4:sw=4:
+// mode: C++
+// End:
@@ -38,6 +38,7 @@
 
 #include <boost/multi_index_container.hpp>
 #include <boost/thread/shared_mutex.hpp>
+#include <boost/atomic.hpp>
 
 DLVHEX_NAMESPACE_BEGIN
 
@@ -72,6 +73,97 @@ namespace impl
     struct InstTag               // instantiation Tag, for ordinary ground atom (for MLP case)
     {
     };
+
+    /**
+     * \brief Append-only vector of pointers to table elements which can be read without locking.
+     *
+     * Entries are stored in chunks whose size doubles with each chunk,
+     * hence entries never move and growing does not invalidate concurrent reads.
+     * Appending and clearing must be serialized by the caller (the table's write lock).
+     */
+    template<typename ValueT>
+    class AddressDirectory
+    {
+        private:
+            typedef boost::atomic<const ValueT*> Slot;
+            /** \brief Size of the first chunk is 2^FirstChunkBits, chunk i has size 2^(FirstChunkBits+i). */
+            static const unsigned FirstChunkBits = 10;
+            /** \brief Enough chunks to address the full range of IDAddress. */
+            static const unsigned MaxChunks = 32 - FirstChunkBits + 1;
+
+            /** \brief Chunks allocated so far (NULL for the others). */
+            boost::atomic<Slot*> chunks[MaxChunks];
+            /** \brief Number of stored entries. */
+            boost::atomic<uint32_t> count;
+
+            /** \brief Computes the index of the most significant bit set in \p x (which must be nonzero). */
+            static inline unsigned highestBit(uint64_t x) {
+                unsigned bit = 0;
+                while( x >>= 1 ) ++bit;
+                return bit;
+            }
+
+            /** \brief Computes the chunk and the offset within the chunk of an address. */
+            static inline void locate(IDAddress addr, unsigned& chunk, uint32_t& offset) {
+                const uint64_t pos = static_cast<uint64_t>(addr) + (1u << FirstChunkBits);
+                #if defined(__GNUC__)
+                const unsigned bit = 63 - __builtin_clzll(pos);
+                #else
+                const unsigned bit = highestBit(pos);
+                #endif
+                chunk = bit - FirstChunkBits;
+                offset = static_cast<uint32_t>(pos - (static_cast<uint64_t>(1) << bit));
+            }
+
+            AddressDirectory(const AddressDirectory&);
+            AddressDirectory& operator=(const AddressDirectory&);
+
+        public:
+            AddressDirectory(): count(0) {
+                for(unsigned i = 0; i < MaxChunks; ++i) chunks[i].store(NULL, boost::memory_order_relaxed);
+            }
+
+            ~AddressDirectory() { clear(); }
+
+            /** \brief Number of entries, which is also the next address. */
+            inline uint32_t size() const { return count.load(boost::memory_order_acquire); }
+
+            /** \brief Retrieves the element stored at \p addr (which must exist). */
+            inline const ValueT& operator[](IDAddress addr) const
+            {
+                assert(addr < size());
+                unsigned chunk;
+                uint32_t offset;
+                locate(addr, chunk, offset);
+                return *chunks[chunk].load(boost::memory_order_acquire)[offset].load(boost::memory_order_acquire);
+            }
+
+            /** \brief Appends the element (which must have a stable address) at the next address. */
+            void push_back(const ValueT& value)
+            {
+                const uint32_t addr = count.load(boost::memory_order_relaxed);
+                unsigned chunk;
+                uint32_t offset;
+                locate(addr, chunk, offset);
+                Slot* slots = chunks[chunk].load(boost::memory_order_relaxed);
+                if( slots == NULL ) {
+                    slots = new Slot[static_cast<std::size_t>(1) << (FirstChunkBits + chunk)];
+                    chunks[chunk].store(slots, boost::memory_order_release);
+                }
+                slots[offset].store(&value, boost::memory_order_release);
+                count.store(addr + 1, boost::memory_order_release);
+            }
+
+            /** \brief Removes all entries; readers must not access the directory concurrently. */
+            void clear()
+            {
+                count.store(0, boost::memory_order_release);
+                for(unsigned i = 0; i < MaxChunks; ++i) {
+                    delete[] chunks[i].load(boost::memory_order_relaxed);
+                    chunks[i].store(NULL, boost::memory_order_relaxed);
+                }
+            }
+    };
 }
 
 
@@ -86,6 +178,7 @@ public ostream_printable< Table<ValueT,IndexT> >
             boost::multi_index_container<ValueT, IndexT> Container;
 
         // public, because other algorithms might need to lock this
+        // (access by address does not lock, see Table::directory)
         /** \brief Multithreading mutex. */
         mutable boost::shared_mutex mutex;
         typedef boost::shared_lock<boost::shared_mutex> ReadLock;
@@ -95,6 +188,15 @@ public ostream_printable< Table<ValueT,IndexT> >
     protected:
         /** \brief Internal container. */
         Container container;
+        /** \brief Elements of Table::container by address for reading without locking.
+         *
+         * Derived tables must append each element they store while holding the write lock.
+         * Tables which replace elements in place (e.g. RuleTable::update) must still take the read lock
+         * when reading through the directory. */
+        impl::AddressDirectory<ValueT> directory;
+
+        /** \brief Fills Table::directory from the address index of Table::container. */
+        void rebuildDirectory();
 
         // methods
     public:
@@ -119,6 +221,7 @@ public ostream_printable< Table<ValueT,IndexT> >
          * @param other Other table. */
         Table(const Table& other):
         container(other.container) {
+            rebuildDirectory();
         }
 
         /** \brief Assignment operator.
@@ -127,17 +230,31 @@ public ostream_printable< Table<ValueT,IndexT> >
         Table& operator=(const Table& other) {
             WriteLock lock(mutex);
             container = other.container;
+            rebuildDirectory();
+            return *this;
         }
 
         /** \brief Retrieves the size of the table.
          * @return Table size. */
         inline unsigned getSize() const
         {
-            ReadLock lock(mutex);
-            return container.size();
+            return directory.size();
         }
 };
 
+template<typename ValueT, typename IndexT>
+void Table<ValueT,IndexT>::rebuildDirectory()
+{
+    typedef typename Container::template index<impl::AddressTag>::type AddressIndex;
+    const AddressIndex& aidx = container.template get<impl::AddressTag>();
+
+    directory.clear();
+    for(typename AddressIndex::const_iterator it = aidx.begin();
+    it != aidx.end(); ++it) {
+        directory.push_back(*it);
+    }
+}
+
 template<typename ValueT, typename IndexT>
 std::ostream& Table<ValueT,IndexT>::print(std::ostream& o) const
 {
@@ -87,7 +87,7 @@ BOOST_MULTI_INDEX_MEMBER(Term,std::string,symbol)
 
         /** \brief Store term in the table.
          * Store symbol, assuming it does not exist.
-         * Assert that symbol did not exist.
+         * If an equal symbol was stored concurrently, the existing one is returned.
          *
          * @param symb Term to store.
          * @return ID of the stored term. */
@@ -106,11 +106,8 @@ ID id) const throw ()
     assert(id.isTerm());
     // integers are not allowed in this table!
     assert(id.isConstantTerm() || id.isVariableTerm() || id.isNestedTerm());
-    ReadLock lock(mutex);
-    const AddressIndex& idx = container.get<impl::AddressTag>();
-    // the following check only works for random access indices, but here it is ok
-    assert( id.address < idx.size() );
-    return idx.at(id.address);
+    assert( id.address < directory.size() );
+    return directory[id.address];
 }
 
 
@@ -160,7 +157,7 @@ const std::vector<ID>& args) const throw()
 #endif
 
 // store symbol, assuming it does not exist
-// assert that symbol did not exist
+// if it was stored concurrently, return the existing one
 ID TermTable::storeAndGetID(
 const Term& symb) throw()
 {
@@ -175,11 +172,13 @@ const Term& symb) throw()
     WriteLock lock(mutex);
     AddressIndex& idx = container.get<impl::AddressTag>();
     boost::tie(it, success) = idx.push_back(symb);
-    (void)success;
-    assert(success);
+    // if an equal element was stored concurrently since the caller looked it up,
+    // it points to that element and its address is returned
+    if( success )
+        directory.push_back(*it);
 
     return ID(
-        symb.kind,               // kind
+        it->kind,                // kind
                                  // address
         container.project<impl::AddressTag>(it) - idx.begin()
         );
@@ -0,0 +1,123 @@
+/* dlvhex -- Answer-Set Programming with external interfaces.
+ * Copyright (C) 2005-2007 Roman Schindlauer
+ * Copyright (C) 2006-2015 Thomas Krennwallner
+ * Copyright (C) 2009-2015 Peter Schüller
+ * Copyright (C) 2011-2015 Christoph Redl
+ *
+ * This file is part of dlvhex.
+ *
+ * dlvhex is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * dlvhex is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with dlvhex; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+/**
+ * @file   ThreadPool.h
+ *
+ * @brief  Fixed-size pool of worker threads for concurrent evaluation tasks.
+ */
+
+#ifndef THREAD_POOL_HPP_INCLUDED__14102026
+#define THREAD_POOL_HPP_INCLUDED__14102026
+
+#include "dlvhex2/PlatformDefinitions.h"
+#include "dlvhex2/fwd.h"
+
+#include <boost/function.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include <deque>
+#include <set>
+#include <vector>
+
+DLVHEX_NAMESPACE_BEGIN
+
+/**
+ * \brief Executes tasks on a fixed set of worker threads.
+ *
+ * Tasks are executed in the order in which they are scheduled, but
+ * possibly concurrently. Synchronization of the results is up to the
+ * caller; the pool only guarantees that all tasks have been executed
+ * after wait() returns or after the pool has been destroyed.
+ *
+ * Tasks passed to schedule() must not throw; exceptions are caught in the worker and
+ * logged. Errors of tasks executed by run() are reported to the caller.
+ */
+class DLVHEX_EXPORT ThreadPool
+{
+    public:
+        /** \brief Unit of work executed by a worker thread. */
+        typedef boost::function<void ()> Task;
+
+        /** \brief Constructor.
+         * @param threads Number of worker threads; 0 selects the number of hardware threads. */
+        ThreadPool(unsigned threads = 0);
+        /** \brief Destructor; executes all pending tasks and joins the workers. */
+        virtual ~ThreadPool();
+
+        /** \brief Schedules a task for execution.
+         * @param task Task to execute by some worker. */
+        void schedule(const Task& task);
+
+        /** \brief Blocks until all tasks scheduled so far have been executed. */
+        void wait();
+
+        /** \brief Executes a batch of tasks and blocks until exactly these tasks have been executed.
+         *
+         * In contrast to wait(), tasks scheduled concurrently by other threads are not waited for.
+         * If called from a worker of this pool, the tasks are executed sequentially by the caller
+         * such that nested batches cannot deadlock the pool.
+         * If a task throws, the remaining tasks are still executed and the error is rethrown
+         * as GeneralError after the batch has finished.
+         * @param batch Tasks to execute.
+         * @param callerTask If not empty, then this task is executed by the calling thread while the workers execute \p batch
+         * (for work which must not leave the calling thread); it belongs to the batch with respect to errors. */
+        void run(const std::vector<Task>& batch, const Task& callerTask = Task());
+
+        /** \brief Returns the number of worker threads.
+         * @return Number of worker threads. */
+        inline unsigned size() const { return threads; }
+
+    private:
+        /** \brief Main loop of each worker thread. */
+        void work();
+
+        /** \brief Number of worker threads. */
+        unsigned threads;
+        /** \brief Worker threads. */
+        boost::thread_group workers;
+        /** \brief Thread ids of the workers (constant after construction). */
+        std::set<boost::thread::id> workerIds;
+        /** \brief Tasks which were not picked up by a worker yet. */
+        std::deque<Task> tasks;
+        /** \brief Number of tasks which are currently executed. */
+        unsigned running;
+        /** \brief True if the workers shall terminate after all tasks have been executed. */
+        bool shutdown;
+        /** \brief Protects tasks, running and shutdown. */
+        boost::mutex mutex;
+        /** \brief Signalled if a new task was scheduled or if the pool shuts down. */
+        boost::condition_variable taskAvailable;
+        /** \brief Signalled if a worker finished a task. */
+        boost::condition_variable taskDone;
+};
+
+DLVHEX_NAMESPACE_END
+#endif                           // THREAD_POOL_HPP_INCLUDED__14102026
+
+// vim:expandtab:ts=4:sw=4:
+// mode: C++
+// End:
@@ -218,6 +218,20 @@ class UnfoundedSetChecker
          */
         virtual void learnNogoodsFromMainSearch(bool reset) = 0;
 
+        /**
+         * \brief Returns a copy of the state which the checker keeps from one check to the next.
+         *
+         * Used to undo speculative checks, whose result turns out to be not needed.
+         * @return State which can be passed to restoreState, or NULL if the state of the checker cannot be restored.
+         */
+        virtual InterpretationPtr saveState() const { return InterpretationPtr(); }
+
+        /**
+         * \brief Resets the checker to a state returned by saveState.
+         * @param state State of this checker returned by saveState.
+         */
+        virtual void restoreState(InterpretationConstPtr state) {}
+
         /**
          * Constructs a nogood which encodes the essence of an unfounded set using one of the overloaded versions of the method.
          * @param ufs The unfounded set to construct the nogood for.
@@ -450,6 +464,18 @@ class EncodingBasedUnfoundedSetChecker : public UnfoundedSetChecker
         std::vector<IDAddress> getUnfoundedSet(
             InterpretationConstPtr compatibleSet,
             const std::set<ID>& skipProgram);
+
+        /**
+         * \brief Returns a copy of the domain, which is the only part of the checker kept from one check to the next.
+         * @return Copy of the domain.
+         */
+        InterpretationPtr saveState() const;
+
+        /**
+         * \brief Resets the domain to a copy returned by saveState.
+         * @param state Domain returned by saveState.
+         */
+        void restoreState(InterpretationConstPtr state);
 };
 
 class AssumptionBasedUnfoundedSetChecker : public UnfoundedSetChecker
@@ -676,6 +702,35 @@ class DLVHEX_EXPORT UnfoundedSetCheckerManager
             InterpretationConstPtr componentAtoms = InterpretationConstPtr(),
             SimpleNogoodContainerPtr ngc = SimpleNogoodContainerPtr());
 
+        /**
+         * \brief Returns the UFS checker for a component and instantiates it if necessary.
+         * @param comp Component index.
+         * @param withExternals Specifies if the checker shall consider external atoms as such.
+         * @return UFS checker for component \p comp.
+         */
+        UnfoundedSetCheckerPtr getUnfoundedSetCheckerForComponent(int comp, bool withExternals);
+
+        /**
+         * \brief Checks the components concurrently for unfounded sets.
+         *
+         * Components whose check evaluates external atoms (or whose checker cannot restore its state) are checked
+         * sequentially afterwards, but only if they precede the first component with an unfounded set.
+         * A component is not checked anymore once an unfounded set has been found in a component with a smaller index.
+         * The checkers keep a state from one check to the next (see UnfoundedSetChecker::saveState), thus the states of the
+         * components after the first component with an unfounded set are restored after their (speculative) checks.
+         * Thus, the result and the states of the checkers are the same as for sequential checking in the order of the components.
+         * @param pool Thread pool to run the checks on.
+         * @param interpretation See UnfoundedSetCheckerManager::getUnfoundedSet.
+         * @param skipProgram See UnfoundedSetCheckerManager::getUnfoundedSet.
+         * @param components Indices of the components to check in ascending order.
+         * @return Unfounded set of the first component which has one, or the empty set of no unfounded set exists.
+         */
+        std::vector<IDAddress> getUnfoundedSetConcurrently(
+            ThreadPool& pool,
+            InterpretationConstPtr interpretation,
+            const std::set<ID>& skipProgram,
+            const std::vector<int>& components);
+
     public:
         /**
          * \brief Initializes the UFS checker with support for external atoms.
@@ -132,6 +132,8 @@ struct Rule;
 class State;
 typedef boost::shared_ptr<State> StatePtr;
 
+class ThreadPool;
+
 DLVHEX_NAMESPACE_END
 #endif                           // FWD_HPP_INCLUDED_14012011
 
@@ -225,26 +225,6 @@ namespace ASPSolver
                     if( fid == ID_FAIL ) {
                         OrdinaryAtom a(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG);
                         a.tuple.swap(ptuple);
-                        {
-                            WARNING("parsing efficiency problem see HexGrammarPTToASTConverter")
-                                std::stringstream ss;
-                            RawPrinter printer(ss, pimpl->reg);
-                            Tuple::const_iterator it = ptuple.begin();
-                            printer.print(*it);
-                            it++;
-                            if( it != ptuple.end() ) {
-                                ss << "(";
-                                printer.print(*it);
-                                it++;
-                                while(it != ptuple.end()) {
-                                    ss << ",";
-                                    printer.print(*it);
-                                    it++;
-                                }
-                                ss << ")";
-                            }
-                            a.text = ss.str();
-                        }
                         fid = pimpl->reg->ogatoms.storeAndGetID(a);
                         DBGLOG(DBG,"added fact " << a << " with id " << fid);
                     }
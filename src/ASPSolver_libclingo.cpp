@@ -186,33 +186,29 @@ namespace ASPSolver
                         if (s.value(it->second.lit.var()) == Clasp::trueValue(it->second.lit) && !it->second.name.empty()) {
                             const char* groundatom = it->second.name.c_str();
 
-                            // try to do it via string (unstructured)
-                            ID idga = registry->ogatoms.getIDByString(groundatom);
-                            if( idga == ID_FAIL ) {
-                                // parse groundatom, register and store
-                                DBGLOG(DBG,"parsing clingo ground atom '" << groundatom << "'");
-                                OrdinaryAtom ogatom(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG);
-                                ogatom.text = groundatom;
-                                {
-                                    // create ogatom.tuple
-                                    boost::char_separator<char> sep(",()");
-                                    typedef boost::tokenizer<boost::char_separator<char> > tokenizer;
-                                    tokenizer tok(ogatom.text, sep);
-                                    for(tokenizer::iterator it = tok.begin();
-                                    it != tok.end(); ++it) {
-                                        DBGLOG(DBG,"got token '" << *it << "'");
-                                        Term term(ID::MAINKIND_TERM, *it);
-                                        // the following takes care of int vs const/string
-                                        ID id = registry->storeTerm(term);
-                                        assert(id != ID_FAIL);
-                                        assert(!id.isVariableTerm());
-                                        if( id.isAuxiliary() )
-                                            ogatom.kind |= ID::PROPERTY_AUX;
-                                        ogatom.tuple.push_back(id);
-                                    }
+                            // parse groundatom, register and store (if new)
+                            DBGLOG(DBG,"parsing clingo ground atom '" << groundatom << "'");
+                            OrdinaryAtom ogatom(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG);
+                            {
+                                // create ogatom.tuple
+                                const std::string text(groundatom);
+                                boost::char_separator<char> sep(",()");
+                                typedef boost::tokenizer<boost::char_separator<char> > tokenizer;
+                                tokenizer tok(text, sep);
+                                for(tokenizer::iterator it = tok.begin();
+                                it != tok.end(); ++it) {
+                                    DBGLOG(DBG,"got token '" << *it << "'");
+                                    Term term(ID::MAINKIND_TERM, *it);
+                                    // the following takes care of int vs const/string
+                                    ID id = registry->storeTerm(term);
+                                    assert(id != ID_FAIL);
+                                    assert(!id.isVariableTerm());
+                                    if( id.isAuxiliary() )
+                                        ogatom.kind |= ID::PROPERTY_AUX;
+                                    ogatom.tuple.push_back(id);
                                 }
-                                idga = registry->ogatoms.storeAndGetID(ogatom);
                             }
+                            ID idga = registry->storeOrdinaryGAtom(ogatom);
                             assert(idga != ID_FAIL);
                             as->interpretation->setFact(idga.address);
                         }
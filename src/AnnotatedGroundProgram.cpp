@@ -48,6 +48,9 @@
 
 #include <boost/foreach.hpp>
 
+#include <algorithm>
+#include <functional>
+
 DLVHEX_NAMESPACE_BEGIN
 
 AnnotatedGroundProgram::AnnotatedGroundProgram() : ctx(0), groundProgram(OrdinaryASPProgram(RegistryPtr(), std::vector<ID>(), InterpretationConstPtr())), haveGrounding(false)
@@ -175,7 +178,7 @@ void AnnotatedGroundProgram::addProgram(const AnnotatedGroundProgram& other)
             DBGLOG(DBG, "maxint=" << programComponents[m.second]->program.maxint);
             depSCC[m.second].insert(other.depSCC[m.first].begin(), other.depSCC[m.first].end());
             if (other.headCycles[m.first]) headCycles[m.second] = true;
-            if (other.eCycles[m.first]) eCycles[m.second];
+            if (other.eCycles[m.first]) eCycles[m.second] = true;
 
             InterpretationPtr intr(new Interpretation(reg));
             intr->add(*other.programComponents[m.first]->componentAtoms);
@@ -252,17 +255,37 @@ void AnnotatedGroundProgram::addProgram(const AnnotatedGroundProgram& other)
 }
 
 
+void AnnotatedGroundProgram::updateGroundProgram(const OrdinaryASPProgram& groundProgram)
+{
+    assert(!!ctx && "AnnotatedGroundProgram is not initialized");
+
+    // the analysis can be extended if the analyzed rules are the first rules of the new program
+    if (haveGrounding && dependencyIDB.size() == 0 && this->groundProgram.idb.size() <= groundProgram.idb.size() &&
+    std::equal(this->groundProgram.idb.begin(), this->groundProgram.idb.end(), groundProgram.idb.begin())) {
+        DBGLOG(DBG, "Extending analysis of a program with " << this->groundProgram.idb.size() << " rules to " << groundProgram.idb.size() << " rules");
+        extendAnalysis(groundProgram);
+    }
+    else {
+        DBGLOG(DBG, "Analyzing program from scratch");
+        *this = AnnotatedGroundProgram(*ctx, groundProgram, indexedEatoms, dependencyIDB);
+    }
+}
+
+
 const AnnotatedGroundProgram&
 AnnotatedGroundProgram::operator=(
 const AnnotatedGroundProgram& other)
 {
+    ctx = other.ctx;
     reg = other.reg;
     groundProgram = other.groundProgram;
+    dependencyIDB = other.dependencyIDB;
     haveGrounding = other.haveGrounding;
     indexedEatoms = other.indexedEatoms;
     eaMasks = other.eaMasks;
     auxToEA = other.auxToEA;
     programMask = other.programMask;
+    depNodes = other.depNodes;
     depGraph = other.depGraph;
     depSCC = other.depSCC;
     componentOfAtom = other.componentOfAtom;
@@ -274,6 +297,9 @@ const AnnotatedGroundProgram& other)
     headCyclesTotal = other.headCyclesTotal;
     eCyclesTotal = other.eCyclesTotal;
     supportSets = other.supportSets;
+    idbAtoms = other.idbAtoms;
+    rulesWithExternalAtom = other.rulesWithExternalAtom;
+    connectedInputAtoms = other.connectedInputAtoms;
     return *this;
 }
 
@@ -282,13 +308,14 @@ void AnnotatedGroundProgram::createProgramMask()
 {
 
     // create mask of all atoms in the program
-    programMask = InterpretationPtr(new Interpretation(reg));
-    programMask->add(*groundProgram.edb);
+    idbAtoms = InterpretationPtr(new Interpretation(reg));
     BOOST_FOREACH (ID ruleID, groundProgram.idb) {
         const Rule& rule = reg->rules.getByID(ruleID);
-        BOOST_FOREACH (ID h, rule.head) programMask->setFact(h.address);
-        BOOST_FOREACH (ID b, rule.body) if (!b.isExternalAuxiliary()) programMask->setFact(b.address);
+        BOOST_FOREACH (ID h, rule.head) idbAtoms->setFact(h.address);
+        BOOST_FOREACH (ID b, rule.body) if (!b.isExternalAuxiliary()) idbAtoms->setFact(b.address);
     }
+    programMask = InterpretationPtr(new Interpretation(*idbAtoms));
+    programMask->add(*groundProgram.edb);
 }
 
 
@@ -405,52 +432,110 @@ void AnnotatedGroundProgram::computeAtomDependencyGraph()
         en++;
     }
     BOOST_FOREACH (ID ruleID, groundProgram.idb) {
-        const Rule& rule = reg->rules.getByID(ruleID);
+        addRuleDependencies(ruleID, NULL);
+    }
+}
 
-        BOOST_FOREACH (ID h, rule.head) {
-            if (depNodes.find(h.address) == depNodes.end()) depNodes[h.address] = boost::add_vertex(h.address, depGraph);
-        }
+
+AnnotatedGroundProgram::Node AnnotatedGroundProgram::getDependencyNode(IDAddress atom)
+{
+    boost::unordered_map<IDAddress, Node>::iterator it = depNodes.find(atom);
+    if (it != depNodes.end()) return it->second;
+    Node n = boost::add_vertex(atom, depGraph);
+    depNodes[atom] = n;
+    return n;
+}
+
+
+void AnnotatedGroundProgram::addRuleDependencies(ID ruleID, std::vector<std::pair<IDAddress, IDAddress> >* newEdges)
+{
+    const Rule& rule = reg->rules.getByID(ruleID);
+
+    BOOST_FOREACH (ID h, rule.head) getDependencyNode(h.address);
+    BOOST_FOREACH (ID b, rule.body) {
+        if (!b.isExternalAuxiliary()) getDependencyNode(b.address);
+    }
+
+    // add an arc from all head atoms to all positive body literals
+    // literals in weight rules always count as positive body atoms, even if they are default negated (because the weighted body as a whole is positive)
+    DBGLOG(DBG, "Adding ordinary edges");
+    BOOST_FOREACH (ID h, rule.head) {
         BOOST_FOREACH (ID b, rule.body) {
-            if (depNodes.find(b.address) == depNodes.end() && !b.isExternalAuxiliary()) depNodes[b.address] = boost::add_vertex(b.address, depGraph);
+            if ((!b.isNaf() || ruleID.isWeightRule()) && !b.isExternalAuxiliary()) {
+                DBGLOG(DBG, "Adding dependency from " << h.address << " to " << b.address);
+                boost::add_edge(depNodes[h.address], depNodes[b.address], depGraph);
+                if (newEdges) newEdges->push_back(std::pair<IDAddress, IDAddress>(h.address, b.address));
+            }
         }
+    }
 
-        // add an arc from all head atoms to all positive body literals
-        // literals in weight rules always count as positive body atoms, even if they are default negated (because the weighted body as a whole is positive)
-        DBGLOG(DBG, "Adding ordinary edges");
-        BOOST_FOREACH (ID h, rule.head) {
-            BOOST_FOREACH (ID b, rule.body) {
-                if ((!b.isNaf() || ruleID.isWeightRule()) && !b.isExternalAuxiliary()) {
-                    DBGLOG(DBG, "Adding dependency from " << h.address << " to " << b.address);
-                    boost::add_edge(depNodes[h.address], depNodes[b.address], depGraph);
+    // add an arc from all head atoms to atoms which are input to some external atom in the rule body
+    DBGLOG(DBG, "Adding e-edges");
+    BOOST_FOREACH (ID b, rule.body) {
+        if (b.isExternalAuxiliary()) {
+            BOOST_FOREACH (ID eaID, auxToEA[b.address]) {
+                // remember the rule such that input atoms which are added to the registry later can be connected (see connectNewInputAtoms)
+                std::vector<ID>& rules = rulesWithExternalAtom[eaID];
+                if (rules.size() == 0 || rules.back() != ruleID) rules.push_back(ruleID);
+                InterpretationPtr& inputAtoms = connectedInputAtoms[eaID];
+                if (!inputAtoms) {
+                    const ExternalAtom& ea = reg->eatoms.getByID(eaID);
+                    ea.updatePredicateInputMask();
+                    inputAtoms = InterpretationPtr(new Interpretation(*ea.getPredicateInputMask()));
+                }
+
+                bm::bvector<>::enumerator en = inputAtoms->getStorage().first();
+                bm::bvector<>::enumerator en_end = inputAtoms->getStorage().end();
+                while (en < en_end) {
+                    Node inputNode = getDependencyNode(*en);
+
+                    BOOST_FOREACH (ID h, rule.head) {
+                        if (!h.isExternalAuxiliary()) {
+                            DBGLOG(DBG, "Adding dependency from " << h.address << " to " << *en);
+                            boost::add_edge(depNodes[h.address], inputNode, depGraph);
+                            externalEdges.push_back(std::pair<IDAddress, IDAddress>(h.address, *en));
+                            if (newEdges) newEdges->push_back(std::pair<IDAddress, IDAddress>(h.address, *en));
+                        }
+                    }
+                    en++;
                 }
             }
         }
+    }
+}
 
-        // add an arc from all head atoms to atoms which are input to some external atom in the rule body
-        DBGLOG(DBG, "Adding e-edges");
-        BOOST_FOREACH (ID b, rule.body) {
-            if (b.isExternalAuxiliary()) {
-                BOOST_FOREACH (ID eaID, auxToEA[b.address]) {
-                    const ExternalAtom& ea = reg->eatoms.getByID(eaID);
 
-                    ea.updatePredicateInputMask();
-                    bm::bvector<>::enumerator en = ea.getPredicateInputMask()->getStorage().first();
-                    bm::bvector<>::enumerator en_end = ea.getPredicateInputMask()->getStorage().end();
-                    while (en < en_end) {
-                        if (depNodes.find(*en) == depNodes.end()) depNodes[*en] = boost::add_vertex(*en, depGraph);
-
-                        BOOST_FOREACH (ID h, rule.head) {
-                            if (!h.isExternalAuxiliary()) {
-                                DBGLOG(DBG, "Adding dependency from " << h.address << " to " << *en);
-                                boost::add_edge(depNodes[h.address], depNodes[*en], depGraph);
-                                externalEdges.push_back(std::pair<IDAddress, IDAddress>(h.address, *en));
-                            }
-                        }
-                        en++;
+void AnnotatedGroundProgram::connectNewInputAtoms(std::vector<std::pair<IDAddress, IDAddress> >& newEdges)
+{
+    typedef std::map<ID, std::vector<ID> >::value_type RulesOfExternalAtom;
+    BOOST_FOREACH (const RulesOfExternalAtom& rules, rulesWithExternalAtom) {
+        const ExternalAtom& ea = reg->eatoms.getByID(rules.first);
+        ea.updatePredicateInputMask();
+        InterpretationPtr& inputAtoms = connectedInputAtoms[rules.first];
+        Interpretation::Storage newInputAtoms = ea.getPredicateInputMask()->getStorage() - inputAtoms->getStorage();
+        if (newInputAtoms.none()) continue;
+
+        bm::bvector<>::enumerator en = newInputAtoms.first();
+        bm::bvector<>::enumerator en_end = newInputAtoms.end();
+        while (en < en_end) {
+            Node inputNode = getDependencyNode(*en);
+            BOOST_FOREACH (ID ruleID, rules.second) {
+                BOOST_FOREACH (ID h, reg->rules.getByID(ruleID).head) {
+                    if (!h.isExternalAuxiliary()) {
+                        DBGLOG(DBG, "Adding dependency from " << h.address << " to new input atom " << *en);
+                        boost::add_edge(depNodes[h.address], inputNode, depGraph);
+                        externalEdges.push_back(std::pair<IDAddress, IDAddress>(h.address, *en));
+                        newEdges.push_back(std::pair<IDAddress, IDAddress>(h.address, *en));
                     }
                 }
             }
+            en++;
         }
+
+        // the set may be shared with the analysis this one was copied from
+        InterpretationPtr extended(new Interpretation(*inputAtoms));
+        extended->getStorage() |= newInputAtoms;
+        inputAtoms = extended;
     }
 }
 
@@ -756,38 +841,280 @@ void AnnotatedGroundProgram::computeStronglyConnectedComponents()
 }
 
 
+void AnnotatedGroundProgram::extendAnalysis(const OrdinaryASPProgram& newGroundProgram)
+{
+    DLVHEX_BENCHMARK_REGISTER_AND_SCOPE(sid,"AnnotatedGroundProg extend");
+
+    // note: all sets and components which are modified are replaced by new objects because they might be shared with copies of this object
+    InterpretationConstPtr previousEdb = groundProgram.edb;
+    std::vector<ID> newRules(newGroundProgram.idb.begin() + groundProgram.idb.size(), newGroundProgram.idb.end());
+    Node previousNodeCount = boost::num_vertices(depGraph);
+    groundProgram = newGroundProgram;
+
+    // external atom masks depend on the whole program
+    // (keep the entries of auxiliaries which are not mapped to external atoms, as addRuleDependencies creates them)
+    typedef boost::unordered_map<IDAddress, std::vector<ID> >::value_type AuxToEAPair;
+    BOOST_FOREACH (AuxToEAPair& pair, auxToEA) pair.second.clear();
+    createEAMasks();
+    mapAuxToEAtoms();
+
+    // extend the program mask
+    InterpretationPtr newIdbAtoms(new Interpretation(*idbAtoms));
+    InterpretationPtr newRuleAtoms(new Interpretation(reg));
+    BOOST_FOREACH (ID ruleID, newRules) {
+        const Rule& rule = reg->rules.getByID(ruleID);
+        BOOST_FOREACH (ID h, rule.head) newRuleAtoms->setFact(h.address);
+        BOOST_FOREACH (ID b, rule.body) if (!b.isExternalAuxiliary()) newRuleAtoms->setFact(b.address);
+    }
+    newIdbAtoms->add(*newRuleAtoms);
+    idbAtoms = newIdbAtoms;
+    programMask = InterpretationPtr(new Interpretation(*idbAtoms));
+    programMask->add(*groundProgram.edb);
+
+    // extend the atom dependency graph
+    DBGLOG(DBG, "Adding " << newRules.size() << " rules to the atom dependency graph");
+    std::vector<std::pair<IDAddress, IDAddress> > newEdges;
+    connectNewInputAtoms(newEdges);
+    BOOST_FOREACH (ID ruleID, newRules) {
+        addRuleDependencies(ruleID, &newEdges);
+    }
+
+    // atoms which need a component: new nodes and atoms of this program which were removed from the components before
+    Interpretation::Storage candidates = groundProgram.edb->getStorage() | newRuleAtoms->getStorage();
+    typedef std::pair<IDAddress, IDAddress> Edge;
+    BOOST_FOREACH (Edge e, newEdges) candidates.set(e.second);
+    for (Node n = previousNodeCount; n < boost::num_vertices(depGraph); ++n) candidates.set(depGraph[n]);
+    std::vector<IDAddress> newAtoms;
+    bm::bvector<>::enumerator en = candidates.first();
+    bm::bvector<>::enumerator en_end = candidates.end();
+    while (en < en_end) {
+        getDependencyNode(*en);
+        if (componentOfAtom.find(*en) == componentOfAtom.end()) newAtoms.push_back(*en);
+        en++;
+    }
+
+    // atoms of the previous EDB which do not occur in this program anymore
+    std::vector<IDAddress> staleAtoms;
+    if (!!previousEdb) {
+        Interpretation::Storage removed = previousEdb->getStorage() - groundProgram.edb->getStorage() - idbAtoms->getStorage();
+        en = removed.first();
+        en_end = removed.end();
+        while (en < en_end) {
+            Node n = depNodes[*en];
+            if (boost::in_degree(n, depGraph) == 0 && boost::out_degree(n, depGraph) == 0 && componentOfAtom.find(*en) != componentOfAtom.end()) staleAtoms.push_back(*en);
+            en++;
+        }
+    }
+
+    updateStronglyConnectedComponents(newEdges, newRules, newAtoms, staleAtoms);
+    computeECycles();
+}
+
+
+void AnnotatedGroundProgram::updateStronglyConnectedComponents(const std::vector<std::pair<IDAddress, IDAddress> >& newEdges, const std::vector<ID>& newRules, const std::vector<IDAddress>& newAtoms, const std::vector<IDAddress>& staleAtoms)
+{
+    typedef std::pair<IDAddress, IDAddress> Edge;
+
+    // rules to be added to the components and components whose rules need to be analyzed again
+    std::vector<std::vector<ID> > addedRules(depSCC.size());
+    std::vector<bool> changed(depSCC.size(), false);
+    std::vector<int> removedComps;
+
+    // new atoms start in components of their own, atoms which are gone lose their (singleton) component
+    BOOST_FOREACH (IDAddress adr, newAtoms) {
+        componentOfAtom[adr] = depSCC.size();
+        depSCC.push_back(std::set<IDAddress>());
+        depSCC.back().insert(adr);
+        programComponents.push_back(ProgramComponentPtr());
+        headCycles.push_back(false);
+        addedRules.push_back(std::vector<ID>());
+        changed.push_back(true);
+    }
+    BOOST_FOREACH (IDAddress adr, staleAtoms) {
+        removedComps.push_back(componentOfAtom[adr]);
+        componentOfAtom.erase(adr);
+    }
+
+    // each new cycle contains a new edge u -> v between different components, and its components are reachable from the one of v and reach the one of u;
+    // since components are never split, it suffices to find the cycles among such components
+    std::vector<int> forward, backward;
+    BOOST_FOREACH (Edge e, newEdges) {
+        if (componentOfAtom[e.first] != componentOfAtom[e.second]) {
+            backward.push_back(componentOfAtom[e.first]);
+            forward.push_back(componentOfAtom[e.second]);
+        }
+    }
+    if (forward.size() > 0) {
+        std::vector<int> reached(depSCC.size(), 0);
+        while (forward.size() > 0) {
+            int comp = forward.back();
+            forward.pop_back();
+            if (reached[comp] & 1) continue;
+            reached[comp] |= 1;
+            BOOST_FOREACH (IDAddress adr, depSCC[comp]) {
+                Graph::out_edge_iterator it, it_end;
+                for (boost::tie(it, it_end) = boost::out_edges(depNodes[adr], depGraph); it != it_end; ++it) {
+                    int next = componentOfAtom[depGraph[boost::target(*it, depGraph)]];
+                    if (!(reached[next] & 1)) forward.push_back(next);
+                }
+            }
+        }
+        while (backward.size() > 0) {
+            int comp = backward.back();
+            backward.pop_back();
+            if (reached[comp] & 2) continue;
+            reached[comp] |= 2;
+            BOOST_FOREACH (IDAddress adr, depSCC[comp]) {
+                Graph::in_edge_iterator it, it_end;
+                for (boost::tie(it, it_end) = boost::in_edges(depNodes[adr], depGraph); it != it_end; ++it) {
+                    int next = componentOfAtom[depGraph[boost::source(*it, depGraph)]];
+                    if (!(reached[next] & 2)) backward.push_back(next);
+                }
+            }
+        }
+
+        // strongly connected components of the graph of affected components
+        typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::directedS, int> ComponentGraph;
+        ComponentGraph affectedGraph;
+        std::map<int, ComponentGraph::vertex_descriptor> affectedNodes;
+        for (uint32_t comp = 0; comp < reached.size(); ++comp) {
+            if (reached[comp] == 3) affectedNodes[comp] = boost::add_vertex(comp, affectedGraph);
+        }
+        typedef std::map<int, ComponentGraph::vertex_descriptor>::value_type NodePair;
+        BOOST_FOREACH (NodePair np, affectedNodes) {
+            BOOST_FOREACH (IDAddress adr, depSCC[np.first]) {
+                Graph::out_edge_iterator it, it_end;
+                for (boost::tie(it, it_end) = boost::out_edges(depNodes[adr], depGraph); it != it_end; ++it) {
+                    int next = componentOfAtom[depGraph[boost::target(*it, depGraph)]];
+                    if (next != np.first && reached[next] == 3) boost::add_edge(np.second, affectedNodes[next], affectedGraph);
+                }
+            }
+        }
+        std::vector<int> componentMap(boost::num_vertices(affectedGraph));
+        int num = boost::strong_components(affectedGraph, boost::make_iterator_property_map(componentMap.begin(), get(boost::vertex_index, affectedGraph)));
+        DBGLOG(DBG, "New dependencies affect " << affectedNodes.size() << " components, which are merged into " << num << " components");
+
+        // merge the components of each cycle into the largest one
+        std::vector<std::vector<int> > merged(num);
+        for (uint32_t n = 0; n < componentMap.size(); ++n) merged[componentMap[n]].push_back(affectedGraph[n]);
+        BOOST_FOREACH (const std::vector<int>& comps, merged) {
+            if (comps.size() < 2) continue;
+            int target = comps[0];
+            BOOST_FOREACH (int comp, comps) {
+                if (depSCC[comp].size() > depSCC[target].size()) target = comp;
+            }
+
+            OrdinaryASPProgram mergedProgram(reg, std::vector<ID>(), groundProgram.edb);
+            InterpretationPtr mergedAtoms(new Interpretation(reg));
+            BOOST_FOREACH (int comp, comps) {
+                if (!!programComponents[comp]) {
+                    mergedAtoms->add(*programComponents[comp]->componentAtoms);
+                    mergedProgram.idb.insert(mergedProgram.idb.end(), programComponents[comp]->program.idb.begin(), programComponents[comp]->program.idb.end());
+                }
+                else {
+                    BOOST_FOREACH (IDAddress adr, depSCC[comp]) mergedAtoms->setFact(adr);
+                }
+                if (comp == target) continue;
+                BOOST_FOREACH (IDAddress adr, depSCC[comp]) componentOfAtom[adr] = target;
+                depSCC[target].insert(depSCC[comp].begin(), depSCC[comp].end());
+                removedComps.push_back(comp);
+            }
+            programComponents[target] = ProgramComponentPtr(new ProgramComponent(mergedAtoms, mergedProgram));
+            changed[target] = true;
+        }
+    }
+
+    // rules belong to the components of their head atoms
+    BOOST_FOREACH (ID ruleID, newRules) {
+        BOOST_FOREACH (ID h, reg->rules.getByID(ruleID).head) {
+            int comp = componentOfAtom[h.address];
+            addedRules[comp].push_back(ruleID);
+            changed[comp] = true;
+        }
+    }
+
+    // fill the gaps of removed components with the last ones
+    std::sort(removedComps.begin(), removedComps.end(), std::greater<int>());
+    BOOST_FOREACH (int comp, removedComps) {
+        int last = depSCC.size() - 1;
+        if (comp != last) {
+            depSCC[comp].swap(depSCC[last]);
+            programComponents[comp] = programComponents[last];
+            headCycles[comp] = headCycles[last];
+            addedRules[comp].swap(addedRules[last]);
+            changed[comp] = changed[last];
+            BOOST_FOREACH (IDAddress adr, depSCC[comp]) componentOfAtom[adr] = comp;
+        }
+        depSCC.pop_back();
+        programComponents.pop_back();
+        headCycles.pop_back();
+        addedRules.pop_back();
+        changed.pop_back();
+    }
+
+    // create the component programs over the new EDB and analyze the changed ones for head cycles
+    headCyclicRules = InterpretationPtr(new Interpretation(*headCyclicRules));
+    headCyclesTotal = false;
+    for (uint32_t comp = 0; comp < depSCC.size(); ++comp) {
+        OrdinaryASPProgram componentProgram(reg, std::vector<ID>(), groundProgram.edb);
+        InterpretationConstPtr componentAtoms;
+        if (!!programComponents[comp]) {
+            componentAtoms = programComponents[comp]->componentAtoms;
+            componentProgram.idb = programComponents[comp]->program.idb;
+        }
+        else {
+            InterpretationPtr atoms(new Interpretation(reg));
+            BOOST_FOREACH (IDAddress ida, depSCC[comp]) atoms->setFact(ida);
+            componentAtoms = atoms;
+        }
+        componentProgram.idb.insert(componentProgram.idb.end(), addedRules[comp].begin(), addedRules[comp].end());
+        programComponents[comp] = ProgramComponentPtr(new ProgramComponent(componentAtoms, componentProgram));
+
+        if (changed[comp]) computeHeadCycles(comp);
+        headCyclesTotal |= headCycles[comp];
+    }
+    DBGLOG(DBG, "Program has " << depSCC.size() << " components after adding " << newRules.size() << " rules");
+}
+
+
 void AnnotatedGroundProgram::computeHeadCycles()
 {
 
     // check if the components contain head-cycles
     DBGLOG(DBG, "Computing head-cycles of components");
+    headCycles.resize(depSCC.size());
     headCyclesTotal = false;
     for (uint32_t comp = 0; comp < depSCC.size(); ++comp) {
-        int hcf = true;
-        BOOST_FOREACH (ID ruleID, programComponents[comp]->program.idb) {
-            const Rule& rule = reg->rules.getByID(ruleID);
-            int intersectionCount = 0;
-            BOOST_FOREACH (ID h, rule.head) {
-                //				if (std::find(depSCC[comp].begin(), depSCC[comp].end(), h.address) != depSCC[comp].end()){
-                if (programComponents[comp]->componentAtoms->getFact(h.address)) {
-                    intersectionCount++;
-                }
-                if (intersectionCount >= 2) break;
-            }
-            if (intersectionCount >= 2) {
-                hcf = false;
-                break;
+        computeHeadCycles(comp);
+        headCyclesTotal |= headCycles[comp];
+    }
+}
+
+
+void AnnotatedGroundProgram::computeHeadCycles(int comp)
+{
+    int hcf = true;
+    BOOST_FOREACH (ID ruleID, programComponents[comp]->program.idb) {
+        const Rule& rule = reg->rules.getByID(ruleID);
+        int intersectionCount = 0;
+        BOOST_FOREACH (ID h, rule.head) {
+            if (programComponents[comp]->componentAtoms->getFact(h.address)) {
+                intersectionCount++;
             }
+            if (intersectionCount >= 2) break;
         }
-        headCycles.push_back(!hcf);
-        headCyclesTotal |= headCycles[headCycles.size() - 1];
-        DBGLOG(DBG, "Component " << comp << ": " << !hcf);
-
-        if (!hcf) {
-            // all rules in the component are head-cyclic
-            BOOST_FOREACH (ID ruleID, programComponents[comp]->program.idb) {
-                headCyclicRules->setFact(ruleID.address);
-            }
+        if (intersectionCount >= 2) {
+            hcf = false;
+            break;
+        }
+    }
+    headCycles[comp] = !hcf;
+    DBGLOG(DBG, "Component " << comp << ": " << !hcf);
+
+    if (!hcf) {
+        // all rules in the component are head-cyclic
+        BOOST_FOREACH (ID ruleID, programComponents[comp]->program.idb) {
+            headCyclicRules->setFact(ruleID.address);
         }
     }
 }
@@ -798,6 +1125,7 @@ void AnnotatedGroundProgram::computeECycles()
 
     DBGLOG(DBG, "Computing e-cycles of components");
 
+    eCycles.clear();
     if (ctx->config.getOption("LegacyECycleDetection")) {
         eCyclesTotal = false;
         for (uint32_t comp = 0; comp < depSCC.size(); ++comp) {
@@ -43,9 +43,51 @@
 #include "dlvhex2/ProgramCtx.h"
 #include "dlvhex2/PredicateMask.h"
 
+#include <sstream>
+
 DLVHEX_NAMESPACE_BEGIN
 
-AnswerSetPrinterCallback::AnswerSetPrinterCallback(ProgramCtx& ctx)
+namespace
+{
+    // appends text as JSON string literal
+    void appendJSONString(std::string& out, const std::string& text) {
+        static const char* hex = "0123456789abcdef";
+        out += '"';
+        for(std::string::const_iterator it = text.begin(); it != text.end(); ++it) {
+            switch( *it ) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if( static_cast<unsigned char>(*it) < 0x20 ) {
+                        out += "\\u00";
+                        out += hex[(*it >> 4) & 0xf];
+                        out += hex[*it & 0xf];
+                    }
+                    else {
+                        out += *it;
+                    }
+            }
+        }
+        out += '"';
+    }
+
+    void appendNumber(std::string& out, unsigned long number) {
+        char digits[24];
+        char* pos = digits + sizeof(digits);
+        do {
+            *--pos = '0' + (number % 10);
+            number /= 10;
+        } while( number > 0 );
+        out.append(pos, digits + sizeof(digits));
+    }
+}
+
+
+AnswerSetPrinterCallback::AnswerSetPrinterCallback(ProgramCtx& ctx):
+format(ctx.config.getOption("OutputFormat")),
+announced(0)
 {
     RegistryPtr reg = ctx.registry();
 
@@ -67,14 +109,115 @@ AnswerSetPrinterCallback::AnswerSetPrinterCallback(ProgramCtx& ctx)
 }
 
 
+boost::unordered_map<IDAddress, AnswerSetPrinterCallback::Symbol>& AnswerSetPrinterCallback::getSymbols(RegistryPtr reg)
+{
+    SymbolTable& table = tables[reg.get()];
+    if( table.registry.lock() != reg ) {
+        // new registry, or a new one at the address of an expired registry
+        table.registry = reg;
+        table.symbols.clear();
+
+        // drop the tables of the other expired registries
+        boost::unordered_map<const Registry*, SymbolTable>::iterator it = tables.begin();
+        while( it != tables.end() ) {
+            if( it->second.registry.expired() )
+                it = tables.erase(it);
+            else
+                ++it;
+        }
+    }
+    return table.symbols;
+}
+
+
+AnswerSetPrinterCallback::Symbol* AnswerSetPrinterCallback::getSymbol(boost::unordered_map<IDAddress, Symbol>& symbols, RegistryPtr reg, IDAddress address)
+{
+    // references to elements of the map stay valid when it grows
+    std::pair<boost::unordered_map<IDAddress, Symbol>::iterator, bool> ins =
+        symbols.insert(std::make_pair(address, Symbol()));
+    Symbol& symbol = ins.first->second;
+    if( ins.second ) {
+        // uses the Registry to render the atom, including
+        // possible influence from AuxiliaryPrinter objects (if any are registered)
+        std::ostringstream ss;
+        if( reg->printAtomForUser(ss, address) ) {
+            symbol.text = ss.str();
+            symbol.state = Rendered;
+        }
+        else {
+            symbol.state = Hidden;
+        }
+    }
+    return symbol.state == Hidden ? NULL : &symbol;
+}
+
+
+void AnswerSetPrinterCallback::renderText(boost::unordered_map<IDAddress, Symbol>& symbols, RegistryPtr reg, Interpretation::Storage::enumerator it, Interpretation::Storage::enumerator it_end)
+{
+    buffer += '{';
+    bool gotOutput = false;
+    for(; it != it_end; ++it) {
+        const Symbol* symbol = getSymbol(symbols, reg, *it);
+        if( symbol ) {
+            if( gotOutput )
+                buffer += ',';
+            buffer += symbol->text;
+            gotOutput = true;
+        }
+    }
+    buffer += '}';
+}
+
+
+void AnswerSetPrinterCallback::renderNDJSON(boost::unordered_map<IDAddress, Symbol>& symbols, RegistryPtr reg, AnswerSetPtr as, Interpretation::Storage::enumerator it, Interpretation::Storage::enumerator it_end)
+{
+    // collect the printed atoms first, as their symbol table entries must precede the answer set
+    std::string atoms;
+    for(; it != it_end; ++it) {
+        Symbol* symbol = getSymbol(symbols, reg, *it);
+        if( !symbol )
+            continue;
+        if( symbol->state == Rendered ) {
+            symbol->number = announced++;
+            buffer += "{\"atom\":";
+            appendNumber(buffer, symbol->number);
+            buffer += ",\"symbol\":";
+            appendJSONString(buffer, symbol->text);
+            buffer += "}\n";
+            symbol->state = Announced;
+        }
+        if( !atoms.empty() )
+            atoms += ',';
+        appendNumber(atoms, symbol->number);
+    }
+
+    buffer += "{\"answerset\":[";
+    buffer += atoms;
+    buffer += ']';
+    const std::vector<int>& weights = as->getWeightVector();
+    bool first = true;
+    for(unsigned level = 0; level < weights.size(); ++level) {
+        if( weights[level] > 0 ) {
+            buffer += first ? ",\"cost\":[" : ",";
+            buffer += "{\"level\":";
+            appendNumber(buffer, level);
+            buffer += ",\"weight\":";
+            appendNumber(buffer, weights[level]);
+            buffer += '}';
+            first = false;
+        }
+    }
+    if( !first )
+        buffer += ']';
+    buffer += "}\n";
+}
+
+
 bool AnswerSetPrinterCallback::operator()(
 AnswerSetPtr as)
 {
     DLVHEX_BENCHMARK_REGISTER_AND_SCOPE(sid,"AnswerSetPrinterCallback");
 
-    // uses the Registry to print the interpretation, including
-    // possible influence from AuxiliaryPrinter objects (if any are registered)
-
     Interpretation::Storage::enumerator it, it_end;
 
     RegistryPtr reg = as->interpretation->getRegistry();
@@ -96,32 +239,19 @@ AnswerSetPtr as)
 
     std::ostream& o = std::cout;
 
-    WARNING("TODO think about more efficient printing")
-        o << '{';
-    if( it != it_end ) {
-        bool gotOutput =
-            reg->printAtomForUser(o, *it);
-        //DBGLOG(DBG,"printed with prefix ''  and output " << gotOutput << " " <<
-        //    printToString<RawPrinter>(ID(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG, *it), reg));
-        it++;
-        for(; it != it_end; ++it) {
-            if( gotOutput ) {
-                gotOutput |=
-                    reg->printAtomForUser(o, *it, ",");
-                //DBGLOG(DBG,"printed with prefix ',' and output " << gotOutput << " " <<
-                //    printToString<RawPrinter>(ID(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG, *it), reg));
-            }
-            else {
-                gotOutput |=
-                    reg->printAtomForUser(o, *it);
-                //DBGLOG(DBG,"printed with prefix ''  and output " << gotOutput << " " <<
-                //    printToString<RawPrinter>(ID(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG, *it), reg));
-            }
-        }
+    // render the whole answer set into the buffer and write it at once
+    buffer.clear();
+    if( format == 1 ) {
+        renderNDJSON(getSymbols(reg), reg, as, it, it_end);
+        o.write(buffer.data(), buffer.size());
+    }
+    else {
+        renderText(getSymbols(reg), reg, it, it_end);
+        o.write(buffer.data(), buffer.size());
+        as->printWeightVector(o);
+        o << '\n';
     }
-    o << '}';
-    as->printWeightVector(o);
-    o << std::endl;
+    o.flush();
 
     // never abort
     return true;
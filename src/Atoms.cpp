@@ -318,6 +318,77 @@ bool OrdinaryAtom::unifiesWith(const OrdinaryAtom& a, RegistryPtr reg) const
 }
 
 
+namespace
+{
+    // matches a ground term against a term of a pattern and extends the substitution of the pattern variables
+    bool matchTerm(RegistryPtr reg, ID term, ID pattern, std::vector<std::pair<ID, ID> >& substitution)
+    {
+        if (pattern.isVariableTerm()) {
+            if (pattern.isAnonymousVariable()) return true;
+            for (uint32_t i = 0; i < substitution.size(); ++i) {
+                if (substitution[i].first == pattern) return substitution[i].second == term;
+            }
+            substitution.push_back(std::make_pair(pattern, term));
+            return true;
+        }
+        if (pattern.isNestedTerm()) {
+            // function symbol and arguments must match
+            if (!term.isNestedTerm()) return false;
+            const Term& t = reg->terms.getByID(term);
+            const Term& p = reg->terms.getByID(pattern);
+            if (t.arguments.size() != p.arguments.size()) return false;
+            for (uint32_t i = 0; i < p.arguments.size(); ++i) {
+                if (!matchTerm(reg, t.arguments[i], p.arguments[i], substitution)) return false;
+            }
+            return true;
+        }
+        return term == pattern;
+    }
+}
+
+
+bool OrdinaryAtom::isInstanceOf(const OrdinaryAtom& pattern, RegistryPtr reg) const
+{
+    if( tuple.size() != pattern.tuple.size() )
+        return false;
+
+    // nested terms need a substitution as their variables are not at the top level
+    for (uint32_t i = 0; i < pattern.tuple.size(); ++i) {
+        if (pattern.tuple[i].isNestedTerm()) {
+            std::vector<std::pair<ID, ID> > substitution;
+            return isInstanceOf(pattern, reg, substitution);
+        }
+    }
+
+    // this atom is ground: each variable in pattern must be mapped to the term at its first occurrence
+    for (uint32_t i = 0; i < tuple.size(); ++i) {
+        if (pattern.tuple[i].isVariableTerm()) {
+            if (pattern.tuple[i].isAnonymousVariable()) continue;
+            uint32_t first = 0;
+            while (pattern.tuple[first] != pattern.tuple[i]) ++first;
+            if (tuple[first] != tuple[i]) return false;
+        }
+        else if (pattern.tuple[i] != tuple[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+bool OrdinaryAtom::isInstanceOf(const OrdinaryAtom& pattern, RegistryPtr reg, std::vector<std::pair<ID, ID> >& substitution) const
+{
+    substitution.clear();
+    if( tuple.size() != pattern.tuple.size() )
+        return false;
+
+    for (uint32_t i = 0; i < tuple.size(); ++i) {
+        if (!matchTerm(reg, tuple[i], pattern.tuple[i], substitution)) return false;
+    }
+    return true;
+}
+
+
 bool OrdinaryAtom::existsHomomorphism(RegistryPtr reg, const OrdinaryAtom& a) const
 {
     if( tuple.size() != a.tuple.size() )
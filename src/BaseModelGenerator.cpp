@@ -44,11 +44,14 @@
 #include "dlvhex2/Atoms.h"
 #include "dlvhex2/ExternalLearningHelper.h"
 #include "dlvhex2/LiberalSafetyChecker.h"
+#include "dlvhex2/ThreadPool.h"
 
+#include <boost/bind.hpp>
 #include <boost/foreach.hpp>
 #include <boost/ptr_container/ptr_vector.hpp>
 #include <boost/unordered_set.hpp>
 
+#include <algorithm>
 #include <fstream>
 
 DLVHEX_NAMESPACE_BEGIN
@@ -445,11 +448,58 @@ bool* fromCache) const
 
     const ExternalAtom& eatom = reg->eatoms.getByID(eatomID);
 
+    std::vector<PluginAtom::Query> queries;
+    buildExternalAtomQueries(ctx, eatomID, inputi, assigned, changed, queries);
+
+    // without input tuples we do not tell the callback about the eatom
+    if( queries.empty() )
+        return true;
+
+    // prepare callback for evaluation of this eatom
+    if( !cb.eatom(eatom) ) {
+        LOG(DBG,"callback aborted for eatom " << printToString<RawPrinter>(eatomID, reg));
+        return false;
+    }
+
+    if( queries.size() == 1 )
+        return evaluateExternalAtomQuery(queries.front(), cb, nogoods, fromCache);
+
+    // submit the queries for the input tuples in chunks such that the source can answer many of them at once,
+    // but the remaining queries are not evaluated if the callback aborts after a chunk;
+    // the chunks grow as long as the callback continues
+    const bool useCache = ctx.config.getOption("UseExtAtomCache");
+    if (fromCache) *fromCache = false;
+    std::size_t chunkSize = 1;
+    for (std::size_t begin = 0; begin < queries.size(); begin += chunkSize, chunkSize *= 2) {
+        const std::size_t end = std::min(queries.size(), begin + chunkSize);
+        std::vector<PluginAtom::Query> chunk(queries.begin() + begin, queries.begin() + end);
+        std::vector<PluginAtom::Answer> answers;
+        bool fromCache_ = eatom.pluginAtom->retrieveFacade(chunk, answers, nogoods, useCache);
+        if (fromCache) *fromCache = *fromCache || fromCache_;
+        LOG(PLUGIN,"got answers to " << answers.size() << " queries");
+
+        for (std::size_t i = 0; i < chunk.size(); ++i) {
+            if( ! integrateExternalAnswer(chunk[i], answers[i], cb) )
+                return false;
+        }
+    }
+    return true;
+}
+
+
+void BaseModelGenerator::buildExternalAtomQueries(ProgramCtx& ctx,
+ID eatomID,
+InterpretationConstPtr inputi,
+InterpretationConstPtr assigned,
+InterpretationConstPtr changed,
+std::vector<PluginAtom::Query>& queries) const
+{
+    RegistryPtr reg = ctx.registry();
+    const ExternalAtom& eatom = reg->eatoms.getByID(eatomID);
+
     // build input interpretation
     // for each input tuple (multiple auxiliary inputs possible)
     //   build query
-    //   call retrieve
-    //   integrate answer into interpretation i as additional facts
 
     // if this is wrong, we might have mixed up registries between plugin and program
     assert(!!eatom.pluginAtom && eatom.predicate == eatom.pluginAtom->getPredicateID());
@@ -473,17 +523,11 @@ bool* fromCache) const
     if( eatom.auxInputPredicate == ID_FAIL ) {
         // only one input tuple, and that is the one stored in eatom.inputs
 
-        // prepare callback for evaluation of this eatom
-        if( !cb.eatom(eatom) ) {
-            LOG(DBG,"callback aborted for eatom " << printToString<RawPrinter>(eatomID, reg));
-            return false;
-        }
-
         // XXX here we copy it, we should just reference it
         PluginAtom::Query query(&ctx, eatominp, eatom.inputs, eatom.tuple, eatomID, pim /*InterpretationPtr()*/, eatomassigned, eatomchanged);
         // XXX make this part of constructor
         query.extinterpretation = inputi;
-        return evaluateExternalAtomQuery(query, cb, nogoods, fromCache);
+        queries.push_back(query);
     }
     else {
         // auxiliary input predicate -> get input tuples (with cache)
@@ -502,27 +546,15 @@ bool* fromCache) const
         buildEAtomInputTuples(ctx.registry(), eatom, inputi, inputs);
 
         Interpretation::TrueBitIterator bit, bit_end;
-        boost::tie(bit, bit_end) = inputs->trueBits();
-
-        if( bit != bit_end ) {
-            // we have an input atom, so we tell the callback that we will process it
-            if( !cb.eatom(eatom) ) {
-                LOG(DBG,"callback aborted for eatom " << printToString<RawPrinter>(eatomID, reg));
-                return false;
-            }
-
-            for(;bit != bit_end; ++bit) {
-                const Tuple& inputtuple = eaitc.lookup(*bit);
-                // build query as reference to the storage in cache
-                // XXX here we copy, we could make it const ref in Query
-                PluginAtom::Query query(&ctx, eatominp, inputtuple, eatom.tuple, eatomID, pim /*InterpretationPtr()*/, eatomassigned, eatomchanged);
-                query.extinterpretation = inputi;
-                if( ! evaluateExternalAtomQuery(query, cb, nogoods, fromCache) )
-                    return false;
-            }
+        for(boost::tie(bit, bit_end) = inputs->trueBits(); bit != bit_end; ++bit) {
+            const Tuple& inputtuple = eaitc.lookup(*bit);
+            // build query as reference to the storage in cache
+            // XXX here we copy, we could make it const ref in Query
+            PluginAtom::Query query(&ctx, eatominp, inputtuple, eatom.tuple, eatomID, pim /*InterpretationPtr()*/, eatomassigned, eatomchanged);
+            query.extinterpretation = inputi;
+            queries.push_back(query);
         }
     }
-    return true;
 }
 
 
@@ -564,6 +596,20 @@ bool* fromCache) const
     if (fromCache) *fromCache = fromCache_;
     LOG(PLUGIN,"got " << answer.get().size() << " answer tuples");
 
+    return integrateExternalAnswer(query, answer, cb);
+}
+
+
+bool BaseModelGenerator::integrateExternalAnswer(
+const PluginAtom::Query& query,
+const PluginAtom::Answer& answer,
+ExternalAnswerTupleCallback& cb) const
+{
+    const ProgramCtx& ctx = *query.ctx;
+    const RegistryPtr reg = ctx.registry();
+    const ExternalAtom& eatom = ctx.registry()->eatoms.getByID(query.eatomID);
+    const Tuple& inputtuple = query.input;
+
     if( !answer.get().empty() ) {
         Tuple it;
         if (ctx.config.getOption("IncludeAuxInputInAuxiliaries") && eatom.auxInputPredicate != ID_FAIL) {
@@ -666,7 +712,36 @@ NogoodContainerPtr nogoods) const
 }
 
 
+namespace
+{
+    // query of BaseModelGenerator::evaluateExternalAtoms which is answered concurrently
+    struct ConcurrentQuery
+    {
+        const PluginAtom::Query* query;
+        PluginAtom::Answer answer;
+        // buffers learned nogoods because the target container might not be thread-safe
+        SimpleNogoodContainerPtr nogoods;
+        // default learning is done by the calling thread as it stores atoms in the registry
+        PluginAtom::DeferredLearning learning;
+    };
+
+    // answers a group of queries one after the other
+    void answerQueries(RegistryPtr reg, const std::vector<ConcurrentQuery*>& group, bool useCache) {
+        BOOST_FOREACH (ConcurrentQuery* cq, group) {
+            const ExternalAtom& eatom = reg->eatoms.getByID(cq->query->eatomID);
+            // the answer in the vector shares its storage with cq->answer
+            std::vector<PluginAtom::Query> queries(1, *cq->query);
+            std::vector<PluginAtom::Answer> answers(1, cq->answer);
+            eatom.pluginAtom->retrieveFacade(queries, answers, cq->nogoods, useCache, &cq->learning);
+            // the usage marker is not shared
+            cq->answer = answers.front();
+        }
+    }
+}
+
+
 // calls evaluateExternalAtom for each atom in eatoms
+// (or answers the queries of all atoms concurrently if parallel evaluation is enabled)
 
 bool BaseModelGenerator::evaluateExternalAtoms(ProgramCtx& ctx,
 const std::vector<ID>& eatoms,
@@ -674,11 +749,74 @@ InterpretationConstPtr inputi,
 ExternalAnswerTupleCallback& cb,
 NogoodContainerPtr nogoods) const
 {
-    BOOST_FOREACH(ID eatomid, eatoms) {
-        if( !evaluateExternalAtom(ctx, eatomid, inputi, cb, nogoods) ) {
+    ThreadPool* pool = eatoms.size() > 1 ? PluginAtom::getEvaluationPool(ctx) : 0;
+    if( !pool ) {
+        BOOST_FOREACH(ID eatomid, eatoms) {
+            if( !evaluateExternalAtom(ctx, eatomid, inputi, cb, nogoods) ) {
+                LOG(DBG,"callbacks aborted evaluateExternalAtoms");
+                return false;
+            }
+        }
+        return true;
+    }
+
+    DLVHEX_BENCHMARK_REGISTER_AND_SCOPE(sideeac,"evaluate external atoms concurrently");
+    RegistryPtr reg = ctx.registry();
+
+    // build all queries in this thread (this updates masks and the input tuple cache)
+    std::vector<std::vector<PluginAtom::Query> > queries(eatoms.size());
+    for (std::size_t i = 0; i < eatoms.size(); ++i) {
+        buildExternalAtomQueries(ctx, eatoms[i], inputi, InterpretationConstPtr(), InterpretationConstPtr(), queries[i]);
+    }
+
+    // queries to thread-safe sources are answered concurrently by the pool,
+    // all other queries are answered one after the other by the calling thread meanwhile
+    boost::ptr_vector<ConcurrentQuery> answers;
+    std::vector<std::vector<ConcurrentQuery*> > groups;
+    std::vector<ConcurrentQuery*> sequentialGroup;
+    for (std::size_t i = 0; i < eatoms.size(); ++i) {
+        bool threadSafe = reg->eatoms.getByID(eatoms[i]).getExtSourceProperties().isThreadSafe();
+        BOOST_FOREACH (const PluginAtom::Query& query, queries[i]) {
+            answers.push_back(new ConcurrentQuery());
+            ConcurrentQuery& cq = answers.back();
+            cq.query = &query;
+            if( !!nogoods ) cq.nogoods.reset(new SimpleNogoodContainer());
+            if( threadSafe ) groups.push_back(std::vector<ConcurrentQuery*>(1, &cq));
+            else sequentialGroup.push_back(&cq);
+        }
+    }
+    DBGLOG(DBG,"answering " << answers.size() << " queries of " << eatoms.size() << " external atoms in " << groups.size() << " concurrent tasks and " << sequentialGroup.size() << " sequential ones");
+
+    std::vector<ThreadPool::Task> tasks;
+    const bool useCache = ctx.config.getOption("UseExtAtomCache");
+    BOOST_FOREACH (const std::vector<ConcurrentQuery*>& group, groups) {
+        tasks.push_back(boost::bind(&answerQueries, reg, boost::cref(group), useCache));
+    }
+    ThreadPool::Task sequentialTask;
+    if( !sequentialGroup.empty() ) sequentialTask = boost::bind(&answerQueries, reg, boost::cref(sequentialGroup), useCache);
+    pool->run(tasks, sequentialTask);
+
+    // integrate nogoods and answers in the same order as sequential evaluation
+    if( !!nogoods ) {
+        BOOST_FOREACH (const ConcurrentQuery& cq, answers) {
+            for (int j = 0; j < cq.nogoods->getNogoodCount(); ++j) nogoods->addNogood(cq.nogoods->getNogood(j));
+            reg->eatoms.getByID(cq.query->eatomID).pluginAtom->learnDeferred(cq.learning, nogoods);
+        }
+    }
+    boost::ptr_vector<ConcurrentQuery>::const_iterator it = answers.begin();
+    for (std::size_t i = 0; i < eatoms.size(); ++i) {
+        if( queries[i].empty() )
+            continue;
+        if( !cb.eatom(reg->eatoms.getByID(eatoms[i])) ) {
             LOG(DBG,"callbacks aborted evaluateExternalAtoms");
             return false;
         }
+        for (std::size_t j = 0; j < queries[i].size(); ++j, ++it) {
+            if( !integrateExternalAnswer(*it->query, it->answer, cb) ) {
+                LOG(DBG,"callbacks aborted evaluateExternalAtoms");
+                return false;
+            }
+        }
     }
     return true;
 }
@@ -752,7 +890,7 @@ const ExternalAtom& eatom, InterpretationConstPtr full) const
         ret.reset(new Interpretation(reg));
     else
         ret.reset(new Interpretation(*full));
-    ret->getStorage() &= eatom.getPredicateInputMask()->getStorage();
+    ret->bit_and(*eatom.getPredicateInputMask());
     return ret;
 }
 
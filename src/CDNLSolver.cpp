@@ -50,32 +50,46 @@ DLVHEX_NAMESPACE_BEGIN
 
 // ---------- Class CDNLSolver ----------
 
+const uint32_t CDNLSolver::clauseHeaderSize;
+const uint32_t CDNLSolver::noClause;
+
 bool CDNLSolver::unitPropagation(Nogood& violatedNogood)
 {
 
     DBGLOG(DBG, "Unit propagation starts");
-    int nogoodNr;
-    while (unitNogoods.size() > 0) {
-        nogoodNr = *(unitNogoods.begin());
-        const Nogood& nextUnitNogood = nogoodset.getNogood(nogoodNr);
-        unitNogoods.erase(unitNogoods.begin());
-
-        // find propagation DL
-        int propDL = 0;
-        BOOST_FOREACH (ID lit, nextUnitNogood) {
-            if (assigned(lit.address) && decisionlevel[lit.address] > propDL) {
-                propDL = decisionlevel[lit.address];
+
+    // contradictory clauses might have changed their state due to backtracking
+    if (contradictoryClauses.size() > 0) {
+        std::vector<uint32_t> recheck;
+        recheck.swap(contradictoryClauses);
+        BOOST_FOREACH (uint32_t cref, recheck) examineClause(cref);
+    }
+
+    while (unitClauses.size() > 0 && contradictoryClauses.size() == 0) {
+        uint32_t cref = unitClauses.back();
+        unitClauses.pop_back();
+
+        // the clause might have changed its state since it was queued
+        switch (watchClause(cref)) {
+            case ClauseUnit:
+            {
+                // the unassigned literal is at position 0, the satisfied literal with the highest decision level at position 1;
+                // for nogoods of size 1 propagation happens at decision level 0
+                const uint32_t* lits = &clauseArena[cref + clauseHeaderSize];
+                int propDL = clauseArena[cref] > 1 ? levelOf(lits[1]) : 0;
+                setFact(negation(codeLit(lits[0])), propDL, nogoodIndex(cref));
+                break;
             }
+            case ClauseContradictory:
+                contradictoryClauses.push_back(cref);
+                break;
+            default:
+                break;
         }
-
-        // as the nogood is unit, it has a single watched literal
-        // its negation is the propagated one
-        ID propagatedLit = negation(*(watchedLiteralsOfNogood[nogoodNr].begin()));
-        setFact(propagatedLit, propDL, nogoodNr);
     }
 
-    if (contradictoryNogoods.size() > 0) {
-        violatedNogood = nogoodset.getNogood(*(contradictoryNogoods.begin()));
+    if (contradictoryClauses.size() > 0) {
+        violatedNogood = nogoodset.getNogood(nogoodIndex(contradictoryClauses.front()));
         DBGLOG(DBG, "Unit propagation finished with detected contradiction " << violatedNogood);
         return false;
     }
@@ -224,11 +238,14 @@ void CDNLSolver::setFact(ID fact, int dl, int c = -1)
     decisionlevel[fact.address] = dl;
     //if (c > -1)
     cause[fact.address] = c;     // store cause
+    ensureAtomCapacity(fact.address);
     if (fact.isNaf()) {          // store truth value
         interpretation->clearFact(fact.address);
+        truthValue[fact.address] = -1;
     }
     else {
         interpretation->setFact(fact.address);
+        truthValue[fact.address] = 1;
     }
     assignmentOrder.insert(fact.address);
     factsOnDecisionLevel[dl].push_back(fact.address);
@@ -248,10 +265,17 @@ void CDNLSolver::clearFact(IDAddress litadr)
     changed->setFact(litadr);
     cause[litadr] = -1;
     assignmentOrder.erase(litadr);
+    if (litadr < truthValue.size()) {
+        savedPhase[litadr] = truthValue[litadr];
+        truthValue[litadr] = 0;
+    }
 
-    // getFact will return the truth value which was just cleared
-    // (truth value remains until it is overridden by a new one)
-    updateWatchingStructuresAfterClearFact(createLiteral(litadr, interpretation->getFact(litadr)));
+    // watches remain valid when literals are unassigned, except for clauses which depend on this atom being assigned
+    if (litadr < reexamineOnClear.size() && reexamineOnClear[litadr].size() > 0) {
+        std::vector<uint32_t> pending;
+        pending.swap(reexamineOnClear[litadr]);
+        BOOST_FOREACH (uint32_t cref, pending) examineClause(cref);
+    }
 }
 
 
@@ -305,14 +329,14 @@ ID CDNLSolver::getGuess()
     for (std::vector<int>::reverse_iterator rit = recentConflicts.rbegin(); rit != recentConflicts.rend(); ++rit) {
         Nogood& ng = nogoodset.getNogood(*rit);
 
-        // skip satisfied and contraditory nogoods
-        if (watchedLiteralsOfNogood[*rit].size() == 0) {
-            continue;
-        }
-
         // find most active unassigned variable in this nogood
         ID mostActive = ID_FAIL;
+        bool inactive = false;
         BOOST_FOREACH (ID lit, ng) {
+            if (falsified(lit)) {
+                inactive = true;
+                break;
+            }
             if (!assigned(lit.address)) {
                 if (mostActive == ID_FAIL ||
                 (varCounterPos[lit.address] + varCounterNeg[lit.address]) > (varCounterPos[mostActive.address] + varCounterNeg[mostActive.address])) {
@@ -321,9 +345,12 @@ ID CDNLSolver::getGuess()
             }
         }
 
-        // if the nogood has no unassigned variable, it must be either satisfied or contradictory and the if above applies
-        assert(mostActive != ID_FAIL);
+        // skip satisfied and contraditory nogoods
+        if (inactive || mostActive == ID_FAIL) {
+            continue;
+        }
 
+        mostActive = applySavedPhase(mostActive);
         DBGLOG(DBG, "Guessing " << litToString(mostActive) << " because it occurs in recent conflicts");
         return mostActive;
     }
@@ -340,6 +367,7 @@ ID CDNLSolver::getGuess()
         }
     }
 
+    mostActive = applySavedPhase(mostActive);
     DBGLOG(DBG, "Guessing " << litToString(mostActive) << " because it is globally active");
     return mostActive;
 }
@@ -348,277 +376,270 @@ ID CDNLSolver::getGuess()
 void CDNLSolver::initWatchingStructures()
 {
 
-    // reset lazy data structures
-    watchedLiteralsOfNogood = std::vector<Set<ID> >(nogoodset.getNogoodCount());
-    watchingNogoodsOfPosLiteral.clear();
-    watchingNogoodsOfNegLiteral.clear();
-    nogoodsOfPosLiteral.clear();
-    nogoodsOfNegLiteral.clear();
+    // reset the arena and all watches
+    std::vector<uint32_t> previousClauseOfNogood;
+    previousClauseOfNogood.swap(clauseOfNogood);
+    clauseArena.clear();
+    watches.clear();
+    watches.resize(2 * truthValue.size());
+    reexamineOnClear.clear();
+    reexamineOnClear.resize(truthValue.size());
 
-    // reset unit and contradictory nogoods
-    unitNogoods.clear();
-    contradictoryNogoods.clear();
+    // reset unit and contradictory clauses
+    unitClauses.clear();
+    contradictoryClauses.clear();
 
     // each nogood watches (at most) two of its literals
     for (int nogoodNr = 0; nogoodNr < nogoodset.getNogoodCount(); ++nogoodNr) {
-        updateWatchingStructuresAfterAddNogood(nogoodNr);
+        // skip deleted nogoods (their slots in nogoodset are free)
+        if (nogoodNr < (int)previousClauseOfNogood.size() && previousClauseOfNogood[nogoodNr] == noClause) {
+            clauseOfNogood.resize(nogoodNr + 1, noClause);
+            continue;
+        }
+        attachNogood(nogoodNr);
     }
 }
 
 
-void CDNLSolver::updateWatchingStructuresAfterAddNogood(int index)
+void CDNLSolver::ensureAtomCapacity(IDAddress litadr)
+{
+    if (litadr < truthValue.size()) return;
+
+    // grow geometrically as each reallocation moves all watch lists
+    std::size_t size = std::max<std::size_t>(litadr + 1, 2 * truthValue.size());
+    truthValue.resize(size, 0);
+    savedPhase.resize(size, 0);
+    reexamineOnClear.resize(size);
+    watches.resize(2 * size);
+}
+
+
+uint32_t CDNLSolver::attachNogood(int index)
 {
 
-    DBGLOGD(DBG, "updateWatchingStructuresAfterAddNogood after adding nogood " << index);
     const Nogood& ng = nogoodset.getNogood(index);
+    uint32_t cref = clauseArena.size();
+    DBGLOGD(DBG, "Attaching nogood " << index << " as clause " << cref);
 
-    // remember for all literals in the nogood that they are contained in this nogood
+    clauseArena.push_back(ng.size());
+    clauseArena.push_back(index);
     BOOST_FOREACH (ID lit, ng) {
-        if (!lit.isNaf()) {
-            nogoodsOfPosLiteral[lit.address].insert(index);
-        }
-        else {
-            nogoodsOfNegLiteral[lit.address].insert(index);
-        }
+        ensureAtomCapacity(lit.address);
+        clauseArena.push_back(litCode(lit));
     }
-
-    // search for up to two unassigned literals to watch
-    bool inactive = false;
-    tmpWatched.clear();
-    BOOST_FOREACH (ID lit, ng) {
-        if (!assigned(lit.address) && tmpWatched.size() < 2) {
-            tmpWatched.insert(createLiteral(lit));
-        }
-        else if(falsified(lit)) {
-            inactive = true;
-        }
+    if ((int)clauseOfNogood.size() <= index) {
+        clauseOfNogood.resize(index + 1, noClause);
     }
-
-    // remember watches
-    if (!inactive) {
-        BOOST_FOREACH (ID lit, tmpWatched) {
-            startWatching(index, createLiteral(lit));
-        }
+    clauseOfNogood[index] = cref;
+    if ((int)lbdOfNogood.size() <= index) {
+        lbdOfNogood.resize(index + 1, 0);
     }
 
-    if (inactive) {
-        DBGLOGD(DBG, "Nogood " << index << " is inactive");
-    }
-    else if (tmpWatched.size() == 1) {
-        DBGLOGD(DBG, "Nogood " << index << " is unit");
-        unitNogoods.insert(index);
-    }
-    else if (tmpWatched.size() == 0) {
-        DBGLOGD(DBG, "Nogood " << index << " is contradictory");
-        contradictoryNogoods.insert(index);
+    // watch the first two literals, then let examineClause choose the right ones
+    if (ng.size() >= 2) {
+        const uint32_t* lits = &clauseArena[cref + clauseHeaderSize];
+        watches[lits[0]].push_back(Watch(cref, lits[1]));
+        watches[lits[1]].push_back(Watch(cref, lits[0]));
     }
+    examineClause(cref);
+    return cref;
 }
 
 
-void CDNLSolver::updateWatchingStructuresAfterRemoveNogood(int index)
+CDNLSolver::ClauseState CDNLSolver::watchClause(uint32_t cref)
 {
-    const Nogood& ng = nogoodset.getNogood(index);
 
-    // remove the nogood from all literal lists
-    BOOST_FOREACH (ID lit, ng) {
-        nogoodsOfPosLiteral[lit.address].erase(index);
-        nogoodsOfNegLiteral[lit.address].erase(index);
-    }
+    uint32_t size = clauseArena[cref];
+    uint32_t* lits = &clauseArena[cref + clauseHeaderSize];
 
-    // remove all watched literals
-    Set<ID>& watched = watchedLiteralsOfNogood[index];
-    BOOST_FOREACH (ID lit, watched) {
-        stopWatching(index, lit);
+    // nogoods with less than two literals are not watched; instead, they are inspected again when their atom is unassigned
+    if (size == 0) return ClauseContradictory;
+    if (size == 1) {
+        reexamineOnClear[lits[0] >> 1].push_back(cref);
+        if (!assigned(lits[0] >> 1)) return ClauseUnit;
+        return satisfiedCode(lits[0]) ? ClauseContradictory : ClauseInactive;
     }
-}
-
-
-void CDNLSolver::updateWatchingStructuresAfterSetFact(ID lit)
-{
 
-    DBGLOGD(DBG, "updateWatchingStructuresAfterSetFact after " << litToString(lit) << " was set");
-    bool changed;
-
-    // go through all nogoods which watch this literal negatively and inactivate them
-    if ((lit.isNaf() && watchingNogoodsOfPosLiteral.find(lit.address) != watchingNogoodsOfPosLiteral.end()) ||
-    (!lit.isNaf() && watchingNogoodsOfNegLiteral.find(lit.address) != watchingNogoodsOfNegLiteral.end())) {
-        do {
-            changed = false;
-            BOOST_FOREACH (int nogoodNr, lit.isNaf() ? watchingNogoodsOfPosLiteral[lit.address] : watchingNogoodsOfNegLiteral[lit.address]) {
-                inactivateNogood(nogoodNr);
-                changed = true;
-                break;
-            }
-        }while(changed);
-    }
-
-    // go through all nogoods which watch this literal positively and find a new watched literal
-    //	if (watchingNogoodsOfPosLiteral.find(lit.address) != watchingNogoodsOfPosLiteral.end()){
-    if ((!lit.isNaf() && watchingNogoodsOfPosLiteral.find(lit.address) != watchingNogoodsOfPosLiteral.end()) ||
-    (lit.isNaf() && watchingNogoodsOfNegLiteral.find(lit.address) != watchingNogoodsOfNegLiteral.end())) {
-        do {
-            changed = false;
-
-            BOOST_FOREACH (int nogoodNr, lit.isNaf() ? watchingNogoodsOfNegLiteral[lit.address] : watchingNogoodsOfPosLiteral[lit.address]) {
-                const Nogood& ng = nogoodset.getNogood(nogoodNr);
-
-                // stop watching lit
-                stopWatching(nogoodNr, lit);
-
-                // search for a new literal which is
-                // 1. not assigned yet
-                // 2. currently not watched
-                bool inactive = false;
-                BOOST_FOREACH (ID nglit, ng) {
-                    if ((watchedLiteralsOfNogood[nogoodNr].size() < 2) && !assigned(nglit.address) && (watchedLiteralsOfNogood[nogoodNr].count(nglit) == 0)) {
-                        // watch it
-                        startWatching(nogoodNr, createLiteral(nglit));
-                    }
-                    else if (falsified(nglit)) {
-                        DBGLOGD(DBG, "Nogood " << nogoodNr << " is now inactive");
-                        inactivateNogood(nogoodNr);
-                        inactive = true;
-                        break;
-                    }
-                }
-                if (!inactive) {
-                    // nogood might have become unit or contradictory
-                    if (watchedLiteralsOfNogood[nogoodNr].size() == 1) {
-                        DBGLOGD(DBG, "Nogood " << nogoodNr << " is now unit");
-                        unitNogoods.insert(nogoodNr);
-                    }
-                    else if (watchedLiteralsOfNogood[nogoodNr].size() == 0) {
-                        DBGLOGD(DBG, "Nogood " << nogoodNr << " is now contradictory");
-                        contradictoryNogoods.insert(nogoodNr);
-                        unitNogoods.erase(nogoodNr);
-                    }
-                }
-
-                changed = true;
-                break;
+    // collect up to two literals which are not satisfied (unassigned ones first)
+    // and the satisfied literal with the highest decision level
+    uint32_t unassignedPos[2], falsifiedPos[2];
+    int unassignedCount = 0, falsifiedCount = 0;
+    int maxSatisfiedPos = -1;
+    int maxSatisfiedDL = -1;
+    for (uint32_t i = 0; i < size; ++i) {
+        if (!assigned(lits[i] >> 1)) {
+            if (unassignedCount < 2) unassignedPos[unassignedCount++] = i;
+        }
+        else if (satisfiedCode(lits[i])) {
+            int dl = levelOf(lits[i]);
+            if (dl > maxSatisfiedDL) {
+                maxSatisfiedDL = dl;
+                maxSatisfiedPos = i;
             }
-        }while(changed);
-    }
-}
-
-
-void CDNLSolver::updateWatchingStructuresAfterClearFact(ID literal)
-{
-
-    // nogoods which watch the literal negatively were inactive before
-    // 	they can now either (i) still be inactive, or (ii) have at least one unassigned literal
-
-    // nogoods which watch the literal positively were either active or inconsistent before
-    //	if they were active, they can now (i) have more watched literals (if they had only one before); or
-    //					 (ii) have as many watched literals as before (if they had already two)
-    //	if they were inconsistent before, they have at least one watched literal
-
-    DBGLOGD(DBG, "updateWatchingStructuresAfterClearFact after " << litToString(literal) << " was cleared");
-
-    // go through all nogoods which contain this literal either positively or negatively
-    for (int positiveAndNegativeLiteral = 1; positiveAndNegativeLiteral <= 2; ++positiveAndNegativeLiteral) {
-
-        if ((positiveAndNegativeLiteral == 1 && nogoodsOfPosLiteral.find(literal.address) != nogoodsOfPosLiteral.end()) ||
-        (positiveAndNegativeLiteral == 2 && nogoodsOfNegLiteral.find(literal.address) != nogoodsOfNegLiteral.end())) {
-            BOOST_FOREACH (int nogoodNr, positiveAndNegativeLiteral == 1 ? nogoodsOfPosLiteral[literal.address] : nogoodsOfNegLiteral[literal.address]) {
-                DBGLOG(DBG, "Updating nogood " << nogoodNr);
-
-                const Nogood& ng = nogoodset.getNogood(nogoodNr);
-
-                bool stillInactive = false;
-
-                // check the number of currently watched literals
-                int watchedNum = watchedLiteralsOfNogood[nogoodNr].size();
-                switch(watchedNum) {
-                    case 0:      // nogood was inactive or contradictory before
-                        // nogood can:
-                        // 1. still be inactive
-                        // 2. have one unassigned literal
-                        // 3. have multiple unassigned literals
-                        // it cannot be contraditory anymore because at least one literal is unassigned!
-                        tmpWatched.clear();
-                        BOOST_FOREACH (ID lit, ng) {
-                            if (falsified(lit)) {
-                                stillInactive = true;
-                                break;
-                            }
-                            // collect up to 2 watched literals
-                            if (!assigned(lit.address) && tmpWatched.size() < 2) {
-                                tmpWatched.insert(lit);
-                            }
-                        }
-                        if (!stillInactive) {
-                            DBGLOG(DBG, "Nogood " << nogoodNr << " is reactivated");
-                            BOOST_FOREACH (ID lit, tmpWatched) {
-                                startWatching(nogoodNr, createLiteral(lit));
-                            }
-
-                            if (tmpWatched.size() == 1) {
-                                DBGLOGD(DBG, "Nogood " << nogoodNr << " becomes unit");
-                                unitNogoods.insert(nogoodNr);
-                            }
-
-                            // nogood is (for sure) not contradictory anymore
-                            contradictoryNogoods.erase(nogoodNr);
-                        }
-                        break;
-                    case 1:      // nogood was unit before
-                        // watch litadr
-                        startWatching(nogoodNr, createLiteral(literal));
-
-                        // nogood is not unit anymore
-                        DBGLOGD(DBG, "Nogood " << nogoodNr << " is not unit anymore");
-                        unitNogoods.erase(nogoodNr);
-                        break;
-                    default:     // nogood has more than one watched literal
-                        // number of unassigned literals has possibly even increased
-                        // nothing to do
-                        break;
-                }
+        }
+        else {
+            if (falsifiedCount < 2) falsifiedPos[falsifiedCount++] = i;
+        }
+    }
+    uint32_t nonSatisfied[2];
+    int nonSatisfiedCount = 0;
+    for (int i = 0; i < unassignedCount && nonSatisfiedCount < 2; ++i) nonSatisfied[nonSatisfiedCount++] = unassignedPos[i];
+    for (int i = 0; i < falsifiedCount && nonSatisfiedCount < 2; ++i) nonSatisfied[nonSatisfiedCount++] = falsifiedPos[i];
+
+    // determine the new watched positions
+    uint32_t w0, w1;
+    ClauseState state;
+    if (nonSatisfiedCount == 2) {
+        // two non-satisfied literals: the watches stay valid until one of them becomes true
+        w0 = nonSatisfied[0];
+        w1 = nonSatisfied[1];
+        state = falsifiedCount > 0 ? ClauseInactive : ClauseOpen;
+    }
+    else if (nonSatisfiedCount == 1) {
+        // watch the satisfied literal with the highest decision level, which is unassigned before all other satisfied ones
+        w0 = nonSatisfied[0];
+        w1 = maxSatisfiedPos;
+        if (unassignedCount == 1) {
+            state = ClauseUnit;
+        }
+        else {
+            state = ClauseInactive;
+            // the falsified literal might be unassigned without unassigning the satisfied one
+            if (levelOf(lits[w0]) > maxSatisfiedDL) {
+                reexamineOnClear[lits[w0] >> 1].push_back(cref);
             }
         }
     }
+    else {
+        w0 = maxSatisfiedPos;
+        w1 = maxSatisfiedPos == 0 ? 1 : 0;
+        state = ClauseContradictory;
+    }
+
+    // move the chosen literals to the front
+    uint32_t old0 = lits[0], old1 = lits[1];
+    std::swap(lits[0], lits[w0]);
+    if (w1 == 0) w1 = w0;
+    std::swap(lits[1], lits[w1]);
+    uint32_t released[2];
+    int releasedCount = 0;
+    if (old0 != lits[0] && old0 != lits[1]) released[releasedCount++] = old0;
+    if (old1 != lits[0] && old1 != lits[1]) released[releasedCount++] = old1;
+    int r = 0;
+    if (lits[0] != old0 && lits[0] != old1) moveWatch(cref, released[r++], lits[0]);
+    if (lits[1] != old0 && lits[1] != old1) moveWatch(cref, released[r++], lits[1]);
+    return state;
 }
 
 
-void CDNLSolver::inactivateNogood(int nogoodNr)
+void CDNLSolver::examineClause(uint32_t cref)
 {
-    DBGLOGD(DBG, "Nogood " << nogoodNr << " gets inactive");
 
-    BOOST_FOREACH (ID lit, watchedLiteralsOfNogood[nogoodNr]) {
-        watchingNogoodsOfPosLiteral[lit.address].erase(nogoodNr);
-        watchingNogoodsOfNegLiteral[lit.address].erase(nogoodNr);
+    switch (watchClause(cref)) {
+        case ClauseUnit:
+            DBGLOGD(DBG, "Nogood " << nogoodIndex(cref) << " is unit");
+            unitClauses.push_back(cref);
+            break;
+        case ClauseContradictory:
+            DBGLOGD(DBG, "Nogood " << nogoodIndex(cref) << " is contradictory");
+            contradictoryClauses.push_back(cref);
+            break;
+        default:
+            break;
     }
-    watchedLiteralsOfNogood[nogoodNr].clear();
-
-    unitNogoods.erase(nogoodNr);
-    contradictoryNogoods.erase(nogoodNr);
 }
 
 
-void CDNLSolver::stopWatching(int nogoodNr, ID lit)
+void CDNLSolver::moveWatch(uint32_t cref, uint32_t from, uint32_t to)
 {
-    DBGLOGD(DBG, "Nogood " << nogoodNr << " stops watching " << litToString(lit) << " (" << createLiteral(lit) << ")");
-    if (!lit.isNaf()) {
-        watchingNogoodsOfPosLiteral[lit.address].erase(nogoodNr);
-    }
-    else {
-        watchingNogoodsOfNegLiteral[lit.address].erase(nogoodNr);
+    DBGLOGD(DBG, "Nogood " << nogoodIndex(cref) << " stops watching " << litToString(codeLit(from)) << " and starts watching " << litToString(codeLit(to)));
+
+    std::vector<Watch>& ws = watches[from];
+    for (std::size_t i = 0; i < ws.size(); ++i) {
+        if (ws[i].clause == cref) {
+            ws[i] = ws.back();
+            ws.pop_back();
+            break;
+        }
     }
-    watchedLiteralsOfNogood[nogoodNr].erase(createLiteral(lit));
+    watches[to].push_back(Watch(cref, from));
 }
 
 
-void CDNLSolver::startWatching(int nogoodNr, ID lit)
+void CDNLSolver::updateWatchingStructuresAfterSetFact(ID lit)
 {
-    DBGLOGD(DBG, "Nogood " << nogoodNr << " starts watching " << litToString(lit) << " (" << createLiteral(lit) << ")");
-    watchedLiteralsOfNogood[nogoodNr].insert(createLiteral(lit));
-    if (!lit.isNaf()) {
-        watchingNogoodsOfPosLiteral[lit.address].insert(nogoodNr);
-    }
-    else {
-        watchingNogoodsOfNegLiteral[lit.address].insert(nogoodNr);
+
+    DBGLOGD(DBG, "updateWatchingStructuresAfterSetFact after " << litToString(lit) << " was set");
+
+    // go through all clauses which watch this literal and find a new watched literal
+    const uint32_t code = litCode(lit);
+    const int dl = levelOf(code);
+    std::vector<Watch>& ws = watches[code];
+    std::vector<Watch>::iterator i = ws.begin(), j = ws.begin(), end = ws.end();
+    while (i != end) {
+        // the clause is inactive if the blocker is falsified not later than lit
+        // (then it cannot be unassigned without unassigning lit)
+        if (falsifiedCode(i->blocker) && levelOf(i->blocker) <= dl) {
+            *j++ = *i++;
+            continue;
+        }
+
+        const uint32_t cref = i->clause;
+        const uint32_t size = clauseArena[cref];
+        uint32_t* lits = &clauseArena[cref + clauseHeaderSize];
+        ++i;
+
+        // make sure that lit is at position 1
+        if (lits[0] == code) std::swap(lits[0], lits[1]);
+        const uint32_t other = lits[0];
+        if (falsifiedCode(other) && levelOf(other) <= dl) {
+            *j++ = Watch(cref, other);
+            continue;
+        }
+
+        // search for a new literal which is not satisfied
+        bool found = false;
+        for (uint32_t k = 2; k < size; ++k) {
+            if (!satisfiedCode(lits[k])) {
+                std::swap(lits[1], lits[k]);
+                watches[lits[1]].push_back(Watch(cref, other));
+                found = true;
+                break;
+            }
+        }
+        if (found) continue;
+
+        // all literals but other are satisfied
+        if (falsifiedCode(other)) {
+            // other was falsified on a higher decision level than lit
+            DBGLOGD(DBG, "Nogood " << nogoodIndex(cref) << " is inactive until " << litToString(codeLit(other)) << " is unassigned");
+            reexamineOnClear[other >> 1].push_back(cref);
+            *j++ = Watch(cref, other);
+        }
+        else if (!assigned(other >> 1)) {
+            DBGLOGD(DBG, "Nogood " << nogoodIndex(cref) << " is now unit");
+            unitClauses.push_back(cref);
+
+            // watch the satisfied literal with the highest decision level
+            uint32_t maxPos = 1;
+            for (uint32_t k = 2; k < size; ++k) {
+                if (levelOf(lits[k]) > levelOf(lits[maxPos])) maxPos = k;
+            }
+            if (maxPos != 1) {
+                std::swap(lits[1], lits[maxPos]);
+                watches[lits[1]].push_back(Watch(cref, other));
+            }
+            else {
+                *j++ = Watch(cref, other);
+            }
+        }
+        else {
+            DBGLOGD(DBG, "Nogood " << nogoodIndex(cref) << " is now contradictory");
+            contradictoryClauses.push_back(cref);
+            *j++ = Watch(cref, other);
+        }
     }
+    ws.erase(j, ws.end());
 }
 
 
@@ -657,6 +678,7 @@ void CDNLSolver::resizeVectors()
     unsigned atomNamespaceSize = ctx.registry()->ogatoms.getSize();
     DBGLOG(DBG, "Resizing vectors to ground-atom namespace of size: " << atomNamespaceSize);
     assignmentOrder.resize(atomNamespaceSize);
+    if (atomNamespaceSize > 0) ensureAtomCapacity(atomNamespaceSize - 1);
 }
 
 
@@ -680,15 +702,174 @@ int CDNLSolver::addNogoodAndUpdateWatchingStructures(Nogood ng)
 
     int index = nogoodset.addNogood(ng);
     DBGLOG(DBG, "Adding nogood " << ng << " with index " << index);
-    if ((int)watchedLiteralsOfNogood.size() <= index) {
-        watchedLiteralsOfNogood.push_back(Set<ID>(2, 1));
+    if (index < (int)clauseOfNogood.size() && clauseOfNogood[index] != noClause) {
+        // nogood is already in the arena, but its state might be relevant for the caller
+        examineClause(clauseOfNogood[index]);
     }
-    updateWatchingStructuresAfterAddNogood(index);
+    else {
+        attachNogood(index);
+        ++nogoodsAdded;
+    }
+
+    return index;
+}
 
+
+int CDNLSolver::addLearnedNogood(const Nogood& ng)
+{
+
+    // literal block distance: number of distinct decision levels in the nogood
+    std::vector<int> levels;
+    BOOST_FOREACH (ID lit, ng) {
+        levels.push_back(decisionlevel[lit.address]);
+    }
+    std::sort(levels.begin(), levels.end());
+    uint32_t lbd = std::max<uint32_t>(1, std::unique(levels.begin(), levels.end()) - levels.begin());
+
+    long added = nogoodsAdded;
+    int index = addNogoodAndUpdateWatchingStructures(ng);
+    if (nogoodsAdded != added) {
+        lbdOfNogood[index] = lbd;
+        learnedNogoods.push_back(index);
+    }
+    else if (index < (int)lbdOfNogood.size() && lbdOfNogood[index] > lbd) {
+        // nogood was learned before
+        lbdOfNogood[index] = lbd;
+    }
+    DBGLOG(DBG, "Learned nogood " << index << " has literal block distance " << lbd);
+
+    ++totalConflicts;
+    ++conflictsSinceRestart;
+    totalLBDSum += lbd;
+    recentLBDs.push_back(lbd);
+    recentLBDSum += lbd;
+    if (recentLBDs.size() > 50) {
+        recentLBDSum -= recentLBDs.front();
+        recentLBDs.pop_front();
+    }
     return index;
 }
 
 
+void CDNLSolver::applySearchPolicies()
+{
+
+    if (restartDue()) {
+        DBGLOG(DBG, "Restart after " << conflictsSinceRestart << " conflicts");
+        ++cntRestarts;
+        conflictsSinceRestart = 0;
+        recentLBDs.clear();
+        recentLBDSum = 0;
+
+        // decision levels up to exhaustedDL represent the part of the search space which was already enumerated
+        if (currentDL > exhaustedDL) {
+            currentDL = exhaustedDL;
+            backtrack(currentDL);
+        }
+    }
+
+    if (reduceBase > 0 && totalConflicts >= nextReduce) {
+        reduceLearnedNogoods();
+        reduceInterval += reduceBase / 4;
+        nextReduce = totalConflicts + reduceInterval;
+    }
+}
+
+
+bool CDNLSolver::restartDue()
+{
+
+    switch (restartPolicy) {
+        case RestartLuby:
+            return conflictsSinceRestart >= restartBase * luby(cntRestarts);
+        case RestartGlucose:
+            // restart if the recent average is worse than 125% of the overall average
+            return recentLBDs.size() >= 50 && 4 * recentLBDSum * totalConflicts > 5 * totalLBDSum * (long)recentLBDs.size();
+        default:
+            return false;
+    }
+}
+
+
+void CDNLSolver::reduceLearnedNogoods()
+{
+
+    DBGLOG(DBG, "Reducing " << learnedNogoods.size() << " learned nogoods");
+
+    // nogoods which are the cause of an assignment must be kept
+    std::vector<bool> locked(nogoodset.getNogoodCount(), false);
+    bm::bvector<>::enumerator en = factWasSet->getStorage().first();
+    bm::bvector<>::enumerator en_end = factWasSet->getStorage().end();
+    while (en < en_end) {
+        int c = cause[*en];
+        if (c >= 0 && c < (int)locked.size()) locked[c] = true;
+        ++en;
+    }
+
+    // nogoods with a literal block distance of at most 2 ("glue" nogoods) are kept as well
+    std::vector<int> kept;
+    std::vector<std::pair<uint32_t, int> > candidates;
+    BOOST_FOREACH (int index, learnedNogoods) {
+        if (locked[index] || lbdOfNogood[index] <= 2) kept.push_back(index);
+        else candidates.push_back(std::pair<uint32_t, int>(lbdOfNogood[index], index));
+    }
+
+    // delete the half with the highest literal block distance
+    std::sort(candidates.begin(), candidates.end(), std::greater<std::pair<uint32_t, int> >());
+    std::size_t toDelete = std::min(candidates.size(), learnedNogoods.size() / 2);
+    for (std::size_t i = 0; i < candidates.size(); ++i) {
+        int index = candidates[i].second;
+        if (i < toDelete) {
+            nogoodset.removeNogood(index);
+            clauseOfNogood[index] = noClause;
+            lbdOfNogood[index] = 0;
+            ++cntDeletedNogoods;
+        }
+        else {
+            kept.push_back(index);
+        }
+    }
+    learnedNogoods.swap(kept);
+
+    std::vector<int> conflictsKept;
+    BOOST_FOREACH (int index, recentConflicts) {
+        if (index < (int)clauseOfNogood.size() && clauseOfNogood[index] != noClause) conflictsKept.push_back(index);
+    }
+    recentConflicts.swap(conflictsKept);
+
+    // rebuild the arena without the deleted nogoods
+    initWatchingStructures();
+    DBGLOG(DBG, "Deleted " << toDelete << " learned nogoods");
+}
+
+
+long CDNLSolver::luby(long n)
+{
+    // find the finite subsequence which contains n, and its size
+    long size = 1;
+    int seq = 0;
+    while (size < n + 1) {
+        ++seq;
+        size = 2 * size + 1;
+    }
+    while (size - 1 != n) {
+        size = (size - 1) >> 1;
+        --seq;
+        n = n % size;
+    }
+    return 1L << seq;
+}
+
+
+ID CDNLSolver::applySavedPhase(ID guess)
+{
+    if (!phaseSaving || guess == ID_FAIL) return guess;
+    IDAddress litadr = guess.address;
+    if (litadr >= savedPhase.size() || savedPhase[litadr] == 0) return guess;
+    return createLiteral(litadr, savedPhase[litadr] > 0);
+}
+
+
 std::string CDNLSolver::getStatistics()
 {
 
@@ -698,7 +879,10 @@ std::string CDNLSolver::getStatistics()
         << "Guesses: " << cntGuesses << std::endl
         << "Backtracks: " << cntBacktracks << std::endl
         << "Resolution steps: " << cntResSteps << std::endl
-        << "Conflicts: " << cntDetectedConflicts;
+        << "Conflicts: " << cntDetectedConflicts << std::endl
+        << "Restarts: " << cntRestarts << std::endl
+        << "Learned nogoods in database: " << learnedNogoods.size() << std::endl
+        << "Deleted learned nogoods: " << cntDeletedNogoods;
     return ss.str();
     #else
     std::stringstream ss;
@@ -708,7 +892,7 @@ std::string CDNLSolver::getStatistics()
 }
 
 
-CDNLSolver::CDNLSolver(ProgramCtx& c, NogoodSet ns) : ctx(c), nogoodset(ns), conflicts(0), cntAssignments(0), cntGuesses(0), cntBacktracks(0), cntResSteps(0), cntDetectedConflicts(0), tmpWatched(2, 1)
+CDNLSolver::CDNLSolver(ProgramCtx& c, NogoodSet ns) : nogoodset(ns), ctx(c), conflicts(0), conflictsSinceRestart(0), recentLBDSum(0), totalLBDSum(0), totalConflicts(0), nogoodsAdded(0), cntAssignments(0), cntGuesses(0), cntBacktracks(0), cntResSteps(0), cntDetectedConflicts(0), cntRestarts(0), cntDeletedNogoods(0)
 {
 
     DLVHEX_BENCHMARK_REGISTER_AND_SCOPE(sidsolvertime, "Solver time");
@@ -722,6 +906,19 @@ CDNLSolver::CDNLSolver(ProgramCtx& c, NogoodSet ns) : ctx(c), nogoodset(ns), con
     currentDL = 0;
     exhaustedDL = 0;
 
+    // search policies
+    phaseSaving = ctx.config.getOption("InternalSolverPhaseSaving") != 0;
+    switch (ctx.config.getOption("InternalSolverRestarts")) {
+        case 1: restartPolicy = RestartLuby; break;
+        case 2: restartPolicy = RestartGlucose; break;
+        default: restartPolicy = RestartNone; break;
+    }
+    restartBase = ctx.config.getOption("InternalSolverRestartBase");
+    if (restartBase <= 0) restartBase = 100;
+    reduceBase = ctx.config.getOption("InternalSolverReduceBase");
+    reduceInterval = reduceBase;
+    nextReduce = reduceBase;
+
     initWatchingStructures();
 };
 
@@ -740,6 +937,7 @@ void CDNLSolver::restartWithAssumptions(const std::vector<ID>& assumptions)
     interpretation.reset(new Interpretation(ctx.registry()));
     factWasSet.reset(new Interpretation(ctx.registry()));
     changed.reset(new Interpretation(ctx.registry()));
+    truthValue.assign(truthValue.size(), 0);
     cause.clear();
     assignmentOrder = OrderedSet<IDAddress, SimpleHashIDAddress>();
     factsOnDecisionLevel.clear();
@@ -794,7 +992,7 @@ bool CDNLSolver::handlePreviousModel()
             // the new nogood is for sure contraditory
             Nogood learnedNogood;
             analysis(modelNogood, learnedNogood, currentDL);
-            recentConflicts.push_back(addNogoodAndUpdateWatchingStructures(learnedNogood));
+            recentConflicts.push_back(addLearnedNogood(learnedNogood));
             DBGLOG(DBG, "Backtrack");
             backtrack(currentDL);
             return true;
@@ -839,10 +1037,11 @@ InterpretationPtr CDNLSolver::getNextModel()
         }
     }
 
-                                 // if set to true, the loop will run even if the interpretation is already complete
-    bool anotherIterationEvenIfComplete = false;
-    // (needed to check if newly added nogood (e.g. by external learners) are satisfied)
-    while (!complete()) {
+    // if set to true, the loop will run even if the interpretation is already complete
+    // (needed to check if newly added nogoods (e.g. by external learners or since the previous model) are satisfied)
+    bool anotherIterationEvenIfComplete = nogoodsToAdd.getNogoodCount() > 0;
+    loadAddedNogoods();
+    while (!complete() || anotherIterationEvenIfComplete) {
         anotherIterationEvenIfComplete = false;
         DBGLOG(DBG, "Unit propagation");
         if (!unitPropagation(violatedNogood)) {
@@ -856,10 +1055,11 @@ InterpretationPtr CDNLSolver::getNextModel()
                     Nogood learnedNogood;
                     int k = currentDL;
                     analysis(violatedNogood, learnedNogood, k);
-                    recentConflicts.push_back(addNogoodAndUpdateWatchingStructures(learnedNogood));
+                    recentConflicts.push_back(addLearnedNogood(learnedNogood));
                                  // do not jump below exhausted level, this could lead to regeneration of models
                     currentDL = k > exhaustedDL ? k : exhaustedDL;
                     backtrack(currentDL);
+                    applySearchPolicies();
                 }
                 else {
                     flipDecisionLiteral();
@@ -868,18 +1068,18 @@ InterpretationPtr CDNLSolver::getNextModel()
         }
         else {
             DBGLOG(DBG, "Calling external learner");
-            int nogoodCount = nogoodset.getNogoodCount();
+            long nogoodCount = nogoodsAdded;
             BOOST_FOREACH (PropagatorCallback* cb, propagator) {
                 DBGLOG(DBG, "Calling external learners with interpretation: " << *interpretation);
                 cb->propagate(interpretation, factWasSet, changed);
             }
             // add new nogoods
-            int ngc = nogoodset.getNogoodCount();
+            long ngc = nogoodsAdded;
             loadAddedNogoods();
-            if (ngc != nogoodset.getNogoodCount()) anotherIterationEvenIfComplete = true;
+            if (ngc != nogoodsAdded) anotherIterationEvenIfComplete = true;
             changed->clear();
 
-            if (nogoodset.getNogoodCount() != nogoodCount) {
+            if (nogoodsAdded != nogoodCount) {
                 DBGLOG(DBG, "Learned something");
             }
             else {
@@ -896,6 +1096,7 @@ InterpretationPtr CDNLSolver::getNextModel()
             }
         }
         // add new nogoods
+        if (nogoodsToAdd.getNogoodCount() > 0) anotherIterationEvenIfComplete = true;
         loadAddedNogoods();
     }
     DBGLOG(DBG, "Got model");
@@ -914,8 +1115,12 @@ void CDNLSolver::addNogood(Nogood ng)
 std::vector<Nogood> CDNLSolver::getContradictoryNogoods()
 {
 
+    Set<int> indices;
+    BOOST_FOREACH (uint32_t cref, contradictoryClauses) {
+        indices.insert(nogoodIndex(cref));
+    }
     std::vector<Nogood> ngg;
-    BOOST_FOREACH (int idx, contradictoryNogoods) {
+    BOOST_FOREACH (int idx, indices) {
         ngg.push_back(nogoodset.getNogood(idx));
     }
     return ngg;
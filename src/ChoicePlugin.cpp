@@ -426,6 +426,11 @@ namespace
                 LOG(INFO,"created ChoiceParserModuleGrammar");
                 return grammarModule;
             }
+
+            // choice rules contain braces, which is never the case for ground facts
+            virtual bool mayParseGroundFacts() const {
+                return false;
+            }
     };
 
 }                                // anonymous namespace
@@ -1023,7 +1023,7 @@ void ClaspSolver::updateSymbolTable()
         std::string ss(it->second.name.c_str());
         IDAddress hexAdr = stringToIDAddress(it->second.name.c_str());
         storeHexToClasp(hexAdr, it->second.lit);
-        DBGLOG(DBG, "H:" << hexAdr << " (" << reg->ogatoms.getByAddress(hexAdr).text <<  ") <--> "
+        DBGLOG(DBG, "H:" << hexAdr << " (" << printToString<RawPrinter>(reg->ogatoms.getIDByAddress(hexAdr), reg) <<  ") <--> "
             "C:" << it->second.lit.index() << "/" << (it->second.lit.sign() ? "!" : "") << it->second.lit.var());
         assert(it->second.lit.index() < claspToHex.size());
         AddressVector* &c2h = claspToHex[it->second.lit.index()];
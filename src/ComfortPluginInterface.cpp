@@ -41,6 +41,7 @@ WARNING("TODO how to implement strong negation (StrongNegationPlugin) with Comfo
 #include "dlvhex2/ProgramCtx.h"
 #include "dlvhex2/Registry.h"
 
+#include <map>
 #include <sstream>
 
 DLVHEX_NAMESPACE_BEGIN
@@ -346,6 +347,44 @@ namespace
 }
 
 
+namespace
+{
+    void convertInterpretation(RegistryPtr reg, InterpretationConstPtr intr, ComfortInterpretation& out) {
+        for(Interpretation::Storage::enumerator it =
+            intr->getStorage().first();
+        it != intr->getStorage().end(); ++it) {
+            ID ogid(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG, *it);
+            const OrdinaryAtom& ogatom = reg->ogatoms.getByID(ogid);
+            ComfortAtom cogatom;
+            convertTuple(reg, ogatom.tuple, cogatom.tuple);
+            DBGLOG(DBG,"converted ogatom " << ogatom <<
+                " to " << printrange(cogatom.tuple));
+            out.insert(cogatom);
+        }
+    }
+
+    void convertAnswer(RegistryPtr reg, const ComfortPluginAtom::ComfortAnswer& ca, PluginAtom::Answer& answer) {
+        #ifndef NDEBUG
+        if( ca.empty() ) {
+            DBGLOG(DBG,"comfort-retrieve returned no answer tuples");
+        }
+        else {
+            DBGLOG(DBG,"comfort-retrieve returned " << ca.size() << " answer tuples:");
+            BOOST_FOREACH(const ComfortTuple& at, ca) {
+                DBGLOG(DBG,"  " << printrange(at));
+            }
+        }
+        #endif
+
+        BOOST_FOREACH(const ComfortTuple& at, ca) {
+            // avoid copying: first create, than directly convert into it
+            answer.get().push_back(Tuple());
+            convertTuple(reg, at, answer.get().back());
+        }
+    }
+}
+
+
 /**
  * * convert ID-based query to ComfortQuery
  * * call comfort-retrieve
@@ -363,17 +402,7 @@ void ComfortPluginAtom::retrieve(const Query& query, Answer& answer)
     ComfortQuery cq;
     convertTuple(reg, query.input, cq.input);
     convertTuple(reg, query.pattern, cq.pattern);
-    for(Interpretation::Storage::enumerator it =
-        query.interpretation->getStorage().first();
-    it != query.interpretation->getStorage().end(); ++it) {
-        ID ogid(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG, *it);
-        const OrdinaryAtom& ogatom = reg->ogatoms.getByID(ogid);
-        ComfortAtom cogatom;
-        convertTuple(reg, ogatom.tuple, cogatom.tuple);
-        DBGLOG(DBG,"converted ogatom " << ogatom <<
-            " to " << printrange(cogatom.tuple));
-        cq.interpretation.insert(cogatom);
-    }
+    convertInterpretation(reg, query.interpretation, cq.interpretation);
     DBGLOG(DBG,"query conversion result before calling comfort-retrieve:");
     DBGLOG(DBG,"  input=" << printrange(cq.input));
     DBGLOG(DBG,"  pattern=" << printrange(cq.pattern));
@@ -383,23 +412,63 @@ void ComfortPluginAtom::retrieve(const Query& query, Answer& answer)
     ComfortAnswer ca;
     retrieve(cq, ca);
 
-    #ifndef NDEBUG
-    if( ca.empty() ) {
-        DBGLOG(DBG,"comfort-retrieve returned no answer tuples");
-    }
-    else {
-        DBGLOG(DBG,"comfort-retrieve returned " << ca.size() << " answer tuples:");
-        BOOST_FOREACH(const ComfortTuple& at, ca) {
-            DBGLOG(DBG,"  " << printrange(at));
+    // convert back
+    convertAnswer(reg, ca, answer);
+}
+
+
+/**
+ * * convert all queries, converting each distinct interpretation only once
+ *   (the atomic queries of one evaluation often share the interpretation)
+ * * call comfort-retrieveBatch
+ * * convert ComfortAnswers to ID-based answer tuples
+ */
+void ComfortPluginAtom::retrieveBatch(const std::vector<Query>& queries, std::vector<Answer>& answers, const std::vector<NogoodContainerPtr>&)
+{
+    DBGLOG_SCOPE(DBG,"CPA::rB",false);
+    DBGLOG(DBG,"= ComfortPluginAtom::retrieveBatch() for " << queries.size() << " queries");
+
+    RegistryPtr reg = getRegistry();
+    assert(!!reg && "registry must be set for ComfortPluginAtom::retrieveBatch(...)");
+
+    std::map<const Interpretation*, const ComfortInterpretation*> converted;
+    std::vector<ComfortQuery> cqs(queries.size());
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        const Query& query = queries[i];
+        ComfortQuery& cq = cqs[i];
+        convertTuple(reg, query.input, cq.input);
+        convertTuple(reg, query.pattern, cq.pattern);
+        std::map<const Interpretation*, const ComfortInterpretation*>::const_iterator it =
+            converted.find(query.interpretation.get());
+        if( it != converted.end() ) {
+            cq.interpretation = *it->second;
+        }
+        else {
+            convertInterpretation(reg, query.interpretation, cq.interpretation);
+            converted[query.interpretation.get()] = &cq.interpretation;
         }
     }
-    #endif
+
+    // call comfort retrieve method
+    std::vector<ComfortAnswer> cas;
+    retrieveBatch(cqs, cas);
+    if( cas.size() != cqs.size() )
+        throw PluginError("comfort external atom " + getPredicate() + " returned a wrong number of answers to a batch of queries");
 
     // convert back
-    BOOST_FOREACH(const ComfortTuple& at, ca) {
-        // avoid copying: first create, than directly convert into it
-        answer.get().push_back(Tuple());
-        convertTuple(reg, at, answer.get().back());
+    for (std::size_t i = 0; i < cas.size(); ++i) {
+        answers.push_back(Answer());
+        convertAnswer(reg, cas[i], answers.back());
+        answers.back().use();
+    }
+}
+
+
+void ComfortPluginAtom::retrieveBatch(const std::vector<ComfortQuery>& qs, std::vector<ComfortAnswer>& as)
+{
+    BOOST_FOREACH (const ComfortQuery& q, qs) {
+        as.push_back(ComfortAnswer());
+        retrieve(q, as.back());
     }
 }
 
@@ -264,26 +264,7 @@ struct handle_fact
 
         // TODO lookup by string in registry, then by tuple
         ID id = state.registry->ogatoms.getIDByTuple(atom.tuple);
-        if( id == ID_FAIL ) { {
-                WARNING("parsing efficiency problem see HexGrammarPTToASTConverter")
-                    std::stringstream ss;
-                RawPrinter printer(ss, state.registry);
-                Tuple::const_iterator it = atom.tuple.begin();
-                printer.print(*it);
-                it++;
-                if( it != atom.tuple.end() ) {
-                    ss << "(";
-                    printer.print(*it);
-                    it++;
-                    while(it != atom.tuple.end()) {
-                        ss << ",";
-                        printer.print(*it);
-                        it++;
-                    }
-                    ss << ")";
-                }
-                atom.text = ss.str();
-            }
+        if( id == ID_FAIL ) {
             //DBGLOG(DBG,"storing atom " << atom);
             id = state.registry->ogatoms.storeAndGetID(atom);
         }
@@ -582,25 +582,6 @@ const std::list<ID>& variables)
     head.tuple.push_back(idauxpred);
     head.tuple.insert(head.tuple.end(), variables.begin(), variables.end());
 
-    // TODO: outsource this, together with printing in HexGrammarPTToASTConverter.cpp, use iterator interface
-    std::stringstream ss;
-    RawPrinter printer(ss, registry);
-    Tuple::const_iterator it = head.tuple.begin();
-    printer.print(*it);
-    it++;
-    if( it != head.tuple.end() ) {
-        ss << "(";
-        printer.print(*it);
-        it++;
-        while(it != head.tuple.end()) {
-            ss << ",";
-            printer.print(*it);
-            it++;
-        }
-        ss << ")";
-    }
-    head.text = ss.str();
-
                                  // onatoms.storeAndGetID(head);
     ID idhead = registry->storeOrdinaryAtom(head);
     return idhead;
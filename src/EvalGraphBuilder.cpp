@@ -44,6 +44,7 @@
 #include "dlvhex2/Registry.h"
 #include "dlvhex2/ProgramCtx.h"
 #include "dlvhex2/PluginInterface.h"
+#include "dlvhex2/ASPSolver.h"
 
 #include <boost/range/iterator_range.hpp>
 
@@ -207,6 +208,19 @@ const std::list<Component>& comps, const std::list<Component>& ccomps)
                     }
                 }
             }
+
+            // the unit may be evaluated concurrently with other units (ParallelModelBuilder)
+            // only if its solver runs in a separate process and all external sources it evaluates are thread-safe;
+            // the genuine and the library solvers work on state shared through the registry and ProgramCtx
+            bool threadSafe = ctx.config.getOption("GenuineSolver") == 0 &&
+                dynamic_cast<const ASPSolver::DLVSoftware::Configuration*>(externalEvalConfig.get()) != 0;
+            BOOST_FOREACH(ID eaid, ci.outerEatoms) {
+                threadSafe &= ctx.registry()->eatoms.getByID(eaid).getExtSourceProperties().isThreadSafe();
+            }
+            BOOST_FOREACH(ID eaid, ci.innerEatoms) {
+                threadSafe &= ctx.registry()->eatoms.getByID(eaid).getExtSourceProperties().isThreadSafe();
+            }
+            boost::static_pointer_cast<BaseModelGeneratorFactory>(uprops.mgf)->setThreadSafe(threadSafe);
         }
     }
 
@@ -54,6 +54,7 @@ ExtSourceProperties& ExtSourceProperties::operator|=(const ExtSourceProperties&
     tuplelevellinear |= prop2.tuplelevellinear;
     usesEnvironment |= prop2.usesEnvironment;
     finiteFiber |= prop2.finiteFiber;
+    threadSafe |= prop2.threadSafe;
     BOOST_FOREACH (int i, prop2.finiteOutputDomain) finiteOutputDomain.insert(i);
     wellorderingStrlen.insert(prop2.wellorderingStrlen.begin(), prop2.wellorderingStrlen.end());
     wellorderingNatural.insert(prop2.wellorderingNatural.begin(), prop2.wellorderingNatural.end());
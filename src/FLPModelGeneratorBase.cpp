@@ -419,7 +419,7 @@ FLPModelGeneratorBase::FLPModelGeneratorBase(
 FLPModelGeneratorFactoryBase& _factory, InterpretationConstPtr input):
 BaseModelGenerator(input),
 factory(_factory),
-annotatedGroundProgram(_factory.ctx, _factory.innerEatoms)
+annotatedGroundProgram(new AnnotatedGroundProgram(_factory.ctx, _factory.innerEatoms))
 {
 }
 
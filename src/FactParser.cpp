@@ -0,0 +1,301 @@
+/* dlvhex -- Answer-Set Programming with external interfaces.
+ * Copyright (C) 2005-2007 Roman Schindlauer
+ * Copyright (C) 2006-2015 Thomas Krennwallner
+ * Copyright (C) 2009-2015 Peter Schüller
+ * Copyright (C) 2011-2015 Christoph Redl
+ *
+ * This file is part of dlvhex.
+ *
+ * dlvhex is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * dlvhex is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with dlvhex; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+/**
+ * @file   FactParser.cpp
+ *
+ * @brief  Hand-written parser for ground facts which bypasses the HEX grammar.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif                           // HAVE_CONFIG_H
+
+#include "dlvhex2/FactParser.h"
+#include "dlvhex2/ProgramCtx.h"
+#include "dlvhex2/Registry.h"
+#include "dlvhex2/Interpretation.h"
+
+#include <boost/foreach.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+DLVHEX_NAMESPACE_BEGIN
+
+namespace
+{
+    // character classes of the HexGrammar (ASCII only, independent of the locale)
+    inline bool isLower(char c) { return c >= 'a' && c <= 'z'; }
+    inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+    inline bool isIdentChar(char c) { return isLower(c) || (c >= 'A' && c <= 'Z') || isDigit(c) || c == '_'; }
+    inline bool isSpace(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+    // integers with more digits might not fit into 32 bits, leave them to the grammar
+    const int maxIntegerDigits = 9;
+}
+
+FactParser::ScannedFacts::ScannedFacts(const char* begin, const char* limit, const char* inputEnd):
+begin(begin),
+limit(limit),
+inputEnd(inputEnd)
+{
+}
+
+
+FactParser::FactParser(ProgramCtx& ctx):
+ctx(ctx),
+atom(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG)
+{
+}
+
+
+const char* FactParser::skip(const char* it, const char* end)
+{
+    while( it != end ) {
+        if( isSpace(*it) ) {
+            ++it;
+        }
+        else if( *it == '%' ) {
+            // comment until end of line
+            while( it != end && *it != '\n' && *it != '\r' ) ++it;
+        }
+        else {
+            break;
+        }
+    }
+    return it;
+}
+
+
+bool FactParser::scanTerm(const char*& it, const char* end, std::vector<Token>& tokens)
+{
+    Token token;
+    token.begin = it;
+    token.value = 0;
+    if( isLower(*it) ) {
+        token.kind = CONSTANT;
+        while( it != end && isIdentChar(*it) ) ++it;
+    }
+    else if( *it == '"' ) {
+        token.kind = CONSTANT;
+        ++it;
+        while( it != end && *it != '"' ) {
+            // strings must not span multiple lines
+            if( *it == '\n' || *it == '\r' ) return false;
+            // escaped quote
+            if( *it == '\\' && it + 1 != end && *(it + 1) == '"' ) ++it;
+            ++it;
+        }
+        if( it == end ) return false;
+        ++it;
+    }
+    else if( isDigit(*it) ) {
+        token.kind = INTEGER;
+        while( it != end && isDigit(*it) ) {
+            if( it - token.begin == maxIntegerDigits ) return false;
+            token.value = 10 * token.value + (*it - '0');
+            ++it;
+        }
+    }
+    else {
+        // variables, negative integers, builtins, ...
+        return false;
+    }
+    token.end = it;
+    tokens.push_back(token);
+    return true;
+}
+
+
+bool FactParser::scanFact(const char*& begin, const char* end, std::vector<Token>& tokens)
+{
+    const char* it = skip(begin, end);
+
+    // predicate
+    if( it == end || !isLower(*it) || !scanTerm(it, end, tokens) ) return false;
+    it = skip(it, end);
+
+    // arguments
+    if( it != end && *it == '(' ) {
+        it = skip(it + 1, end);
+        while( true ) {
+            if( it == end || !scanTerm(it, end, tokens) ) return false;
+            it = skip(it, end);
+            if( it == end ) return false;
+            if( *it == ',' ) {
+                it = skip(it + 1, end);
+            }
+            else if( *it == ')' ) {
+                ++it;
+                break;
+            }
+            else {
+                // nested terms, ranges, ...
+                return false;
+            }
+        }
+        it = skip(it, end);
+    }
+
+    // a period must follow, otherwise we have a disjunction, a rule, a query, ...
+    if( it == end || *it != '.' ) return false;
+    begin = it + 1;
+    return true;
+}
+
+
+ID FactParser::storeConstant(const std::string& symbol)
+{
+    RegistryPtr reg = ctx.registry();
+    ID id = reg->terms.getIDByString(symbol);
+    if( id == ID_FAIL ) {
+        Term term(ID::MAINKIND_TERM | ID::SUBKIND_TERM_CONSTANT, symbol);
+        id = reg->terms.storeAndGetID(term);
+    }
+    return id;
+}
+
+
+ID FactParser::storeTerm(const Token& token)
+{
+    if( token.kind == INTEGER ) {
+        // like the HexGrammar, set maxint to the largest number in the input
+        if( token.value > ctx.maxint ) ctx.maxint = token.value;
+        return ID::termFromInteger(token.value);
+    }
+    symbol.assign(token.begin, token.end);
+    return storeConstant(symbol);
+}
+
+
+void FactParser::storeAtom()
+{
+    ID id = ctx.registry()->storeOrdinaryGAtom(atom);
+    ctx.edb->setFact(id.address);
+}
+
+
+bool FactParser::parseFact(const char*& begin, const char* end)
+{
+    assert(!!ctx.edb);
+
+    // scan the whole statement before storing anything
+    tokens.clear();
+    if( !scanFact(begin, end, tokens) ) return false;
+
+    atom.tuple.clear();
+    for( unsigned i = 0; i < tokens.size(); ++i ) {
+        atom.tuple.push_back(storeTerm(tokens[i]));
+    }
+    storeAtom();
+    return true;
+}
+
+
+void FactParser::scan(ScannedFacts& facts)
+{
+    // index of each symbol in facts.symbols
+    boost::unordered_map<std::string, uint32_t> symbolIndex;
+    std::vector<Token> tokens;
+    std::string symbol;
+
+    // it is always the beginning of a line
+    const char* it = facts.begin;
+    while( skip(it, facts.inputEnd) < facts.limit ) {
+        ScannedFacts::Run run;
+        run.begin = it;
+        run.end = it;
+        run.firstFact = facts.sizes.size();
+        run.facts = 0;
+        run.firstTerm = facts.tuples.size();
+        run.maxint = 0;
+
+        const char* pos = it;
+        while( skip(pos, facts.inputEnd) < facts.limit ) {
+            tokens.clear();
+            if( !scanFact(pos, facts.inputEnd, tokens) ) break;
+            run.end = pos;
+            ++run.facts;
+
+            BOOST_FOREACH (const Token& token, tokens) {
+                if( token.kind == INTEGER ) {
+                    if( token.value > run.maxint ) run.maxint = token.value;
+                    facts.tuples.push_back(ID::termFromInteger(token.value));
+                }
+                else {
+                    symbol.assign(token.begin, token.end);
+                    std::pair<boost::unordered_map<std::string, uint32_t>::iterator, bool> ins =
+                        symbolIndex.insert(std::make_pair(symbol, facts.symbols.size()));
+                    if( ins.second ) facts.symbols.push_back(symbol);
+                    facts.tuples.push_back(ID(ID::MAINKIND_TERM | ID::SUBKIND_TERM_CONSTANT, ins.first->second));
+                }
+            }
+            facts.sizes.push_back(tokens.size());
+        }
+        if( run.facts > 0 ) facts.runs.push_back(run);
+
+        // some other statement: try again at the next line
+        pos = skip(pos, facts.inputEnd);
+        if( pos >= facts.limit ) break;
+        it = std::find(pos, facts.inputEnd, '\n');
+        if( it == facts.inputEnd ) break;
+        ++it;
+    }
+}
+
+
+void FactParser::store(ScannedFacts& facts, const ScannedFacts::Run& run)
+{
+    assert(!!ctx.edb);
+
+    // symbols are resolved on first use, thus new terms get the same IDs as if the facts were parsed one by one
+    if( facts.symbolIDs.empty() )
+        facts.symbolIDs.resize(facts.symbols.size(), ID_FAIL);
+    if( run.maxint > ctx.maxint ) ctx.maxint = run.maxint;
+
+    std::vector<ID>::const_iterator it = facts.tuples.begin() + run.firstTerm;
+    for( unsigned f = run.firstFact; f < run.firstFact + run.facts; ++f ) {
+        atom.tuple.clear();
+        for( unsigned i = 0; i < facts.sizes[f]; ++i, ++it ) {
+            if( it->isIntegerTerm() ) {
+                atom.tuple.push_back(*it);
+            }
+            else {
+                ID& id = facts.symbolIDs[it->address];
+                if( id == ID_FAIL ) id = storeConstant(facts.symbols[it->address]);
+                atom.tuple.push_back(id);
+            }
+        }
+        storeAtom();
+    }
+}
+
+
+DLVHEX_NAMESPACE_END
+
+// vim:expandtab:ts=4:sw=4:
+// mode: C++
+// End:
@@ -44,6 +44,7 @@
 #include "dlvhex2/Benchmarking.h"
 #include "dlvhex2/InternalGroundDASPSolver.h"
 #include "dlvhex2/UnfoundedSetChecker.h"
+#include "dlvhex2/Error.h"
 
 #include <bm/bmalgo.h>
 
@@ -84,6 +85,16 @@ outerEatoms(ci.outerEatoms)
     }
 
     innerEatoms = ci.innerEatoms;
+    // determine the external sources whose learned nogoods can be reused for other inputs (see isInputIndependent)
+    std::set<ID> nonmonotonic, nonfunctional;
+    BOOST_FOREACH (ID eaid, innerEatoms) {
+        const ExternalAtom& eatom = ctx.registry()->eatoms.getByID(eaid);
+        (eatom.getExtSourceProperties().isMonotonic() ? monotonicExternalPredicates : nonmonotonic).insert(eatom.predicate);
+        (eatom.getExtSourceProperties().isFunctional() ? functionalExternalPredicates : nonfunctional).insert(eatom.predicate);
+    }
+    BOOST_FOREACH (ID pred, nonmonotonic) monotonicExternalPredicates.erase(pred);
+    BOOST_FOREACH (ID pred, nonfunctional) functionalExternalPredicates.erase(pred);
+
     // create guessing rules "gidb" for innerEatoms in all inner rules and constraints
     createEatomGuessingRules(ctx);
 
@@ -105,10 +116,57 @@ outerEatoms(ci.outerEatoms)
 }
 
 
+bool GenuineGuessAndCheckModelGeneratorFactory::isInputIndependent(const Nogood& ng) const
+{
+    RegistryPtr reg = ctx.registry();
+
+    // classify the literals
+    int positiveInputs = 0;
+    std::vector<bool> outputTrue;
+    std::vector<ID> outputPredicates;
+    BOOST_FOREACH (ID lit, ng) {
+        ID id = lit.isOrdinaryNongroundAtom() ? reg->onatoms.getIDByAddress(lit.address) : reg->ogatoms.getIDByAddress(lit.address);
+        if (id.isExternalAuxiliary() && !id.isExternalInputAuxiliary()) {
+            // a true replacement of the negated external atom means that the output tuple is false
+            outputTrue.push_back(lit.isNaf() == reg->isNegativeExternalAtomAuxiliaryAtom(id));
+            outputPredicates.push_back(reg->getIDByAuxiliaryConstantSymbol(reg->lookupOrdinaryAtom(id).tuple[0]));
+        }
+        else {
+            if (lit.isNaf()) return false;
+            positiveInputs++;
+        }
+    }
+
+    // true input atoms imply a true output tuple of a monotonic source
+    if (outputTrue.size() == 1 && !outputTrue[0]) {
+        return monotonicExternalPredicates.count(outputPredicates[0]) > 0;
+    }
+
+    // a functional source does not produce two output tuples (with the same non-functional prefix) at the same time
+    if (outputTrue.size() == 2 && positiveInputs == 0 && outputTrue[0] && outputTrue[1]) {
+        return outputPredicates[0] == outputPredicates[1] && functionalExternalPredicates.count(outputPredicates[0]) > 0;
+    }
+
+    return false;
+}
+
+
 GenuineGuessAndCheckModelGeneratorFactory::ModelGeneratorPtr
 GenuineGuessAndCheckModelGeneratorFactory::createModelGenerator(
 InterpretationConstPtr input)
 {
+    // enumerate disjoint parts of the search space concurrently if requested;
+    // the parts evaluate the inner external atoms concurrently and the explicit FLP check updates masks shared by the parts;
+    // with optimization the parts would read the current optimum while it is updated, and queued models could be worse than it
+    int parts = ctx.config.getOption("SplitSearch");
+    if (parts > 1 && !ctx.config.getOption("FLPCheck") && !ctx.config.getOption("Optimization")) {
+        bool threadSafe = true;
+        BOOST_FOREACH (ID eatom, innerEatoms) {
+            threadSafe &= reg->eatoms.getByID(eatom).getExtSourceProperties().isThreadSafe();
+        }
+        if (threadSafe) return ModelGeneratorPtr(new SplittingGuessAndCheckModelGenerator(*this, input, parts));
+        DBGLOG(DBG, "Not splitting the search space because an inner external atom is not thread-safe");
+    }
     return ModelGeneratorPtr(new GenuineGuessAndCheckModelGenerator(*this, input));
 }
 
@@ -177,10 +235,18 @@ std::ostream& o, bool verbose) const
 
 GenuineGuessAndCheckModelGenerator::GenuineGuessAndCheckModelGenerator(
 Factory& factory,
-InterpretationConstPtr input):
+InterpretationConstPtr input,
+SearchSpaceSplitPtr split,
+int part):
 FLPModelGeneratorBase(factory, input),
 factory(factory),
-reg(factory.reg)
+reg(factory.reg),
+modelBoundVersion(0),
+split(split),
+part(part),
+splitNogoodsImported(0),
+partEmpty(false),
+learnedEANogoodsPublishedIndex(0)
 {
     DLVHEX_BENCHMARK_REGISTER_AND_SCOPE(sidconstruct, "genuine g&c mg constructor");
     DBGLOG(DBG, "Genuine GnC-ModelGenerator is instantiated for a " << (factory.ci.disjunctiveHeads ? "" : "non-") << "disjunctive component");
@@ -238,17 +304,56 @@ reg(factory.reg)
         program.idb.insert(program.idb.end(), factory.gidb.begin(), factory.gidb.end());
 
         DLVHEX_BENCHMARK_REGISTER_AND_SCOPE(sidhexground, "HEX grounder GuessPr GenGnCMG");
-        grounder = GenuineGrounder::getInstance(factory.ctx, program);
-        OrdinaryASPProgram gp = grounder->getGroundProgram();
+        OrdinaryASPProgram gp(reg);
+        if (factory.ctx.config.getOption("PersistentGrounder")) {
+            // the nonground program is the same for all inputs of this unit:
+            // reuse the grounder of the previous model generator if it supports input updates
+            boost::mutex::scoped_lock lock(factory.persistentGrounderMutex);
+            if (!factory.persistentGrounder || !factory.persistentGrounder->updateInput(postprocessedInput)) {
+                factory.persistentGrounder = GenuineGrounder::getInstance(factory.ctx, program, InterpretationConstPtr(), true);
+            }
+            grounder = factory.persistentGrounder;
+            gp = grounder->getGroundProgram();
+        }
+        else {
+            grounder = GenuineGrounder::getInstance(factory.ctx, program);
+            gp = grounder->getGroundProgram();
+        }
 
         // do not project within the solver as auxiliaries might be relevant for UFS checking (projection is done in G&C mg)
         if (!!gp.mask) mask->add(*gp.mask);
         gp.mask = InterpretationConstPtr();
 
+        if (factory.ctx.config.getOption("PersistentGrounder")) {
+            // if the ground program extends the one of the previous model generator,
+            // then its analysis is extended instead of being recomputed (see AnnotatedGroundProgram::updateGroundProgram)
+            boost::mutex::scoped_lock lock(factory.persistentGrounderMutex);
+            if (!factory.persistentAnnotatedGroundProgram) {
+                factory.persistentAnnotatedGroundProgram.reset(new AnnotatedGroundProgram(factory.ctx, gp, factory.innerEatoms));
+            }
+            else {
+                // the analysis is shared with the model generators which use it; copy it only if one of them still exists
+                if (!factory.persistentAnnotatedGroundProgram.unique()) {
+                    DBGLOG(DBG, "Copying the analysis of the ground program because another model generator still uses it");
+                    factory.persistentAnnotatedGroundProgram.reset(new AnnotatedGroundProgram(*factory.persistentAnnotatedGroundProgram));
+                }
+                factory.persistentAnnotatedGroundProgram->updateGroundProgram(gp);
+            }
+            // support sets for verification are stored in the analysis, hence we need our own copy then
+            if (factory.ctx.config.getOption("SupportSets")) {
+                annotatedGroundProgram.reset(new AnnotatedGroundProgram(*factory.persistentAnnotatedGroundProgram));
+            }
+            else {
+                annotatedGroundProgram = factory.persistentAnnotatedGroundProgram;
+            }
+        }
+        else {
+            annotatedGroundProgram.reset(new AnnotatedGroundProgram(factory.ctx, gp, factory.innerEatoms));
+        }
+
         // run solver
-        annotatedGroundProgram = AnnotatedGroundProgram(factory.ctx, gp, factory.innerEatoms);
         solver = GenuineGroundSolver::getInstance(
-            factory.ctx, annotatedGroundProgram,
+            factory.ctx, *annotatedGroundProgram,
             InterpretationConstPtr(),
         // do the UFS check for disjunctions only if we don't do
         // a minimality check in this class;
@@ -260,7 +365,16 @@ reg(factory.reg)
     // external learning related initialization
     learnedEANogoods = SimpleNogoodContainerPtr(new SimpleNogoodContainer());
     learnedEANogoodsTransferredIndex = 0;
-    nogoodGrounder = NogoodGrounderPtr(new ImmediateNogoodGrounder(factory.ctx.registry(), learnedEANogoods, learnedEANogoods, annotatedGroundProgram));
+    if (factory.ctx.config.getOption("ExternalLearning") && factory.ctx.config.getOption("ExternalLearningReuse")) {
+        // start with what model generators for previous inputs learned (they are transferred to the solver like our own nogoods)
+        boost::mutex::scoped_lock lock(factory.inputIndependentNogoodsMutex);
+        for (int i = 0; i < factory.inputIndependentNogoods.getNogoodCount(); ++i) {
+            learnedEANogoods->addNogood(factory.inputIndependentNogoods.getNogood(i));
+        }
+        DLVHEX_BENCHMARK_REGISTER_AND_COUNT(sidreused, "Reused EA-Nogoods", learnedEANogoods->getNogoodCount());
+        learnedEANogoodsPublishedIndex = learnedEANogoods->getNogoodCount();
+    }
+    nogoodGrounder = NogoodGrounderPtr(new ImmediateNogoodGrounder(factory.ctx.registry(), learnedEANogoods, learnedEANogoods, *annotatedGroundProgram));
     if(factory.ctx.config.getOption("NoPropagator") == 0) {
         DBGLOG(DBG, "Adding propagator to solver");
         solver->addPropagator(this);
@@ -271,7 +385,7 @@ reg(factory.reg)
     //   initialize UFS checker
     //     Concerning the last parameter, note that clasp backend uses choice rules for implementing disjunctions:
     //     this must be regarded in UFS checking (see examples/trickyufs.hex)
-    ufscm = UnfoundedSetCheckerManagerPtr(new UnfoundedSetCheckerManager(*this, factory.ctx, annotatedGroundProgram,
+    ufscm = UnfoundedSetCheckerManagerPtr(new UnfoundedSetCheckerManager(*this, factory.ctx, *annotatedGroundProgram,
         factory.ctx.config.getOption("GenuineSolver") >= 3,
         factory.ctx.config.getOption("ExternalLearning") ? learnedEANogoods : SimpleNogoodContainerPtr()));
 
@@ -282,6 +396,7 @@ reg(factory.reg)
 
 GenuineGuessAndCheckModelGenerator::~GenuineGuessAndCheckModelGenerator()
 {
+    publishInputIndependentNogoods();
     DBGLOG(DBG, "Removing propagator to solver");
     solver->removePropagator(this);
     DBGLOG(DBG, "Final Statistics:" << std::endl << solver->getStatistics());
@@ -313,7 +428,7 @@ void GenuineGuessAndCheckModelGenerator::setHeuristics()
     }
 
     // create ufs check heuristics as selected
-    ufsCheckHeuristics = factory.ctx.unfoundedSetCheckHeuristicsFactory->createHeuristics(annotatedGroundProgram, reg);
+    ufsCheckHeuristics = factory.ctx.unfoundedSetCheckHeuristicsFactory->createHeuristics(*annotatedGroundProgram, reg);
     verifiedAuxes = InterpretationPtr(new Interpretation(reg));
 }
 
@@ -327,15 +442,15 @@ void GenuineGuessAndCheckModelGenerator::createVerificationWatchLists()
     for (uint32_t i = 0; i < factory.innerEatoms.size(); ++i) {
 
         // watch all atoms in the scope of the external atom for watch one input atom for verification
-        bm::bvector<>::enumerator en = annotatedGroundProgram.getEAMask(i)->mask()->getStorage().first();
-        bm::bvector<>::enumerator en_end = annotatedGroundProgram.getEAMask(i)->mask()->getStorage().end();
+        bm::bvector<>::enumerator en = annotatedGroundProgram->getEAMask(i)->mask()->getStorage().first();
+        bm::bvector<>::enumerator en_end = annotatedGroundProgram->getEAMask(i)->mask()->getStorage().end();
         if (en < en_end) {
             verifyWatchList[*en].push_back(i);
         }
 
         // watch all atoms in the scope of the external atom for unverification
-        en = annotatedGroundProgram.getEAMask(i)->mask()->getStorage().first();
-        en_end = annotatedGroundProgram.getEAMask(i)->mask()->getStorage().end();
+        en = annotatedGroundProgram->getEAMask(i)->mask()->getStorage().first();
+        en_end = annotatedGroundProgram->getEAMask(i)->mask()->getStorage().end();
         while (en < en_end) {
             unverifyWatchList[*en].push_back(i);
             en++;
@@ -350,6 +465,11 @@ InterpretationPtr GenuineGuessAndCheckModelGenerator::generateNextModel()
     DLVHEX_BENCHMARK_REGISTER_AND_SCOPE(sidgcsolve, "genuine guess and check loop");
     DLVHEX_BENCHMARK_REGISTER_AND_SCOPE(sidhexsolve, "HEX solver time (gNM GenGnC)");
 
+    if (partEmpty) {
+        LOG(DBG,"part " << part << " of the search space is empty -> returning no model");
+        return InterpretationPtr();
+    }
+
     InterpretationPtr modelCandidate;
     do {
         LOG(DBG,"asking for next model");
@@ -359,6 +479,15 @@ InterpretationPtr GenuineGuessAndCheckModelGenerator::generateNextModel()
         // if the costs of a partial model are greater than the current global optimum then also any completion of this partial model (by combining it with other units)
         // would be non-optimal.
         if (factory.ctx.config.getOption("OptimizationByBackend")) solver->setOptimum(factory.ctx.currentOptimum);
+
+        // Search space pruning: the model bound (if any) eliminates models which cannot change the final result (e.g., of a query).
+        if (!!factory.ctx.modelBound) {
+            Nogood bound;
+            if (factory.ctx.modelBound->getNogood(annotatedGroundProgram->getProgramMask(), modelBoundVersion, bound)) {
+                DBGLOG(DBG, "Adding model bound " << bound.getStringRepresentation(reg));
+                solver->addNogood(bound);
+            }
+        }
         modelCandidate = solver->getNextModel();
 
         DBGLOG(DBG, "Statistics:" << std::endl << solver->getStatistics());
@@ -407,16 +536,16 @@ void GenuineGuessAndCheckModelGenerator::generalizeNogood(Nogood ng)
     // find the external atom related to this nogood
     ID eaid = ID_FAIL;
     BOOST_FOREACH (ID l, ng) {
-        if (reg->ogatoms.getIDByAddress(l.address).isExternalAuxiliary() && annotatedGroundProgram.mapsAux(l.address)) {
+        if (reg->ogatoms.getIDByAddress(l.address).isExternalAuxiliary() && annotatedGroundProgram->mapsAux(l.address)) {
             eaid = l;
             break;
         }
     }
     if (eaid == ID_FAIL) return;
 
-    assert(annotatedGroundProgram.getAuxToEA(eaid.address).size() > 0);
-    DBGLOG(DBG, "External atom is " << annotatedGroundProgram.getAuxToEA(eaid.address)[0]);
-    const ExternalAtom& ea = reg->eatoms.getByID(annotatedGroundProgram.getAuxToEA(eaid.address)[0]);
+    assert(annotatedGroundProgram->getAuxToEA(eaid.address).size() > 0);
+    DBGLOG(DBG, "External atom is " << annotatedGroundProgram->getAuxToEA(eaid.address)[0]);
+    const ExternalAtom& ea = reg->eatoms.getByID(annotatedGroundProgram->getAuxToEA(eaid.address)[0]);
 
     // learn related nonground nogoods
     int oldCount = learnedEANogoods->getNogoodCount();
@@ -443,7 +572,7 @@ void GenuineGuessAndCheckModelGenerator::learnSupportSets()
         DLVHEX_BENCHMARK_COUNT(sidnongroundpsupportsets, potentialSupportSets->getNogoodCount());
 
         // ground the support sets exhaustively
-        NogoodGrounderPtr nogoodgrounder = NogoodGrounderPtr(new ImmediateNogoodGrounder(factory.ctx.registry(), potentialSupportSets, potentialSupportSets, annotatedGroundProgram));
+        NogoodGrounderPtr nogoodgrounder = NogoodGrounderPtr(new ImmediateNogoodGrounder(factory.ctx.registry(), potentialSupportSets, potentialSupportSets, *annotatedGroundProgram));
 
         int nc = 0;
         while (nc < potentialSupportSets->getNogoodCount()) {
@@ -469,11 +598,11 @@ void GenuineGuessAndCheckModelGenerator::learnSupportSets()
                 if (eaAux == ID_FAIL) throw GeneralError("Set " + ng.getStringRepresentation(reg) + " is not a valid support set because it contains no external literals");
 
                 // determine the according external atom
-                if (annotatedGroundProgram.mapsAux(eaAux.address)) {
+                if (annotatedGroundProgram->mapsAux(eaAux.address)) {
                     DBGLOG(DBG, "Evaluating guards of " << ng.getStringRepresentation(reg));
                     keep = true;
                     Nogood ng2 = ng;
-                    reg->eatoms.getByID(annotatedGroundProgram.getAuxToEA(eaAux.address)[0]).pluginAtom->guardSupportSet(keep, ng2, eaAux);
+                    reg->eatoms.getByID(annotatedGroundProgram->getAuxToEA(eaAux.address)[0]).pluginAtom->guardSupportSet(keep, ng2, eaAux);
                     if (keep) {
                         #ifdef DEBUG
                         // ng2 must be a subset of ng and still a valid support set
@@ -503,7 +632,7 @@ void GenuineGuessAndCheckModelGenerator::learnSupportSets()
 
         // add them to the annotated ground program to make use of them for verification
         DBGLOG(DBG, "Adding " << supportSets->getNogoodCount() << " support sets to annotated ground program");
-        annotatedGroundProgram.setCompleteSupportSetsForVerification(supportSets);
+        annotatedGroundProgram->setCompleteSupportSetsForVerification(supportSets);
     }
 }
 
@@ -550,11 +679,13 @@ InterpretationConstPtr changed)
         DBGLOG(DBG, "Adding learned nogood " << ng.getStringRepresentation(reg) << " to solver");
         if (ng.isGround()) solver->addNogood(ng);
     }
+    if (!!split) exchangeSplitNogoods();
+    publishInputIndependentNogoods();
 
     // for encoding-based UFS checkers and explicit FLP checks, we need to keep learned nogoods (otherwise future UFS searches will not be able to use them)
     // for assumption-based UFS checkers we can delete them as soon as nogoods were added both to the main search and to the UFS search
     if (factory.ctx.config.getOption("UFSCheckAssumptionBased") ||
-    (annotatedGroundProgram.hasECycles() == 0 && factory.ctx.config.getOption("FLPDecisionCriterionE"))) {
+    (annotatedGroundProgram->hasECycles() == 0 && factory.ctx.config.getOption("FLPDecisionCriterionE"))) {
         ufscm->learnNogoodsFromMainSearch(true);
         nogoodGrounder->resetWatched(learnedEANogoods);
         learnedEANogoods->clear();
@@ -563,6 +694,81 @@ InterpretationConstPtr changed)
         learnedEANogoods->forgetLeastFrequentlyAdded();
     }
     learnedEANogoodsTransferredIndex = learnedEANogoods->getNogoodCount();
+    learnedEANogoodsPublishedIndex = learnedEANogoodsTransferredIndex;
+}
+
+
+void GenuineGuessAndCheckModelGenerator::publishInputIndependentNogoods()
+{
+    if (!factory.ctx.config.getOption("ExternalLearning") || !factory.ctx.config.getOption("ExternalLearningReuse")) return;
+
+    int published = 0;
+    boost::mutex::scoped_lock lock(factory.inputIndependentNogoodsMutex);
+    for (; learnedEANogoodsPublishedIndex < learnedEANogoods->getNogoodCount(); ++learnedEANogoodsPublishedIndex) {
+        const Nogood& ng = learnedEANogoods->getNogood(learnedEANogoodsPublishedIndex);
+        if (factory.isInputIndependent(ng)) {
+            factory.inputIndependentNogoods.addNogood(ng);
+            published++;
+        }
+    }
+    DLVHEX_BENCHMARK_REGISTER_AND_COUNT(sidpublished, "Published EA-Nogoods", published);
+}
+
+
+void GenuineGuessAndCheckModelGenerator::restrictToPart()
+{
+    // number of atoms which are necessary to distinguish the parts
+    unsigned bits = 0;
+    while ((1 << bits) < split->parts) bits++;
+
+    // all parts must select the same atoms, hence we choose them by address;
+    // external atom guesses first because they are the choices of the guess and check algorithm
+    bm::bvector<> guesses = annotatedGroundProgram->getProgramMask()->getStorage() - postprocessedInput->getStorage();
+    bm::bvector<> ordinary = guesses - factory.gpMask.mask()->getStorage() - factory.gnMask.mask()->getStorage();
+    guesses &= factory.gpMask.mask()->getStorage();
+    std::vector<IDAddress> atoms;
+    for (bm::bvector<>::enumerator en = guesses.first(); en < guesses.end() && atoms.size() < bits; ++en) atoms.push_back(*en);
+    for (bm::bvector<>::enumerator en = ordinary.first(); en < ordinary.end() && atoms.size() < bits; ++en) atoms.push_back(*en);
+
+    if (part >= (1 << atoms.size())) {
+        DBGLOG(DBG, "Search space has only " << atoms.size() << " guessed atoms, part " << part << " is empty");
+        partEmpty = true;
+        return;
+    }
+
+    // exclude all assignments to the atoms which belong to other parts
+    for (int assignment = 0; assignment < (1 << atoms.size()); ++assignment) {
+        if (assignment % split->parts == part) continue;
+        Nogood ng;
+        for (unsigned i = 0; i < atoms.size(); ++i) {
+            ng.insert(NogoodContainer::createLiteral(atoms[i], (assignment >> i) & 1));
+        }
+        DBGLOG(DBG, "Excluding " << ng.getStringRepresentation(reg) << " from part " << part);
+        solver->addNogood(ng);
+    }
+}
+
+
+void GenuineGuessAndCheckModelGenerator::exchangeSplitNogoods()
+{
+    boost::mutex::scoped_lock lock(split->mutex);
+
+    // import nogoods learned by the other parts (they are independent of the part, i.e., valid in the whole search space)
+    int imported = 0;
+    for (; splitNogoodsImported < split->nogoods.size(); ++splitNogoodsImported) {
+        if (split->nogoods[splitNogoodsImported].first == part) continue;
+        solver->addNogood(split->nogoods[splitNogoodsImported].second);
+        imported++;
+    }
+    DLVHEX_BENCHMARK_REGISTER_AND_COUNT(sidimported, "Imported EA-Nogoods", imported);
+
+    // publish our own ones
+    for (int i = learnedEANogoodsTransferredIndex; i < learnedEANogoods->getNogoodCount(); ++i) {
+        const Nogood& ng = learnedEANogoods->getNogood(i);
+        if (ng.isGround()) split->nogoods.push_back(std::make_pair(part, ng));
+    }
+    // we know our own nogoods already
+    splitNogoodsImported = split->nogoods.size();
 }
 
 
@@ -607,7 +813,7 @@ bool GenuineGuessAndCheckModelGenerator::isModel(InterpretationConstPtr compatib
 
     DLVHEX_BENCHMARK_REGISTER_AND_SCOPE(sidcc, "GenuineGnCMG: isModel");
     // FLP: ensure minimality of the compatible set wrt. the reduct (if necessary)
-    if (annotatedGroundProgram.hasHeadCycles() == 0 && annotatedGroundProgram.hasECycles() == 0 &&
+    if (annotatedGroundProgram->hasHeadCycles() == 0 && annotatedGroundProgram->hasECycles() == 0 &&
     factory.ctx.config.getOption("FLPDecisionCriterionHead") && factory.ctx.config.getOption("FLPDecisionCriterionE")) {
         DBGLOG(DBG, "No head- or e-cycles --> No FLP/UFS check necessary");
         return true;
@@ -768,8 +974,8 @@ IDAddress GenuineGuessAndCheckModelGenerator::getWatchedLiteral(int eaIndex, Int
 {
 
     DLVHEX_BENCHMARK_REGISTER_AND_SCOPE(sid, "getWatchedLiteral");
-    bm::bvector<>::enumerator eaDepAtoms = annotatedGroundProgram.getEAMask(eaIndex)->mask()->getStorage().first();
-    bm::bvector<>::enumerator eaDepAtoms_end = annotatedGroundProgram.getEAMask(eaIndex)->mask()->getStorage().end();
+    bm::bvector<>::enumerator eaDepAtoms = annotatedGroundProgram->getEAMask(eaIndex)->mask()->getStorage().first();
+    bm::bvector<>::enumerator eaDepAtoms_end = annotatedGroundProgram->getEAMask(eaIndex)->mask()->getStorage().end();
     bm::bvector<>::enumerator searchb = search->getStorage().first();
     bm::bvector<>::enumerator searchb_end = search->getStorage().end();
 
@@ -805,7 +1011,7 @@ void GenuineGuessAndCheckModelGenerator::unverifyExternalAtoms(InterpretationCon
                 // unverify
                 eaVerified[eaIndex] = false;
                 eaEvaluated[eaIndex] = false;
-                verifiedAuxes->getStorage() -= annotatedGroundProgram.getEAMask(eaIndex)->mask()->getStorage();
+                verifiedAuxes->getStorage() -= annotatedGroundProgram->getEAMask(eaIndex)->mask()->getStorage();
 
                 // *en is our new watch (as it is either undefined or was recently changed)
                 verifyWatchList[*en].push_back(eaIndex);
@@ -862,8 +1068,8 @@ bool GenuineGuessAndCheckModelGenerator::verifyExternalAtoms(InterpretationConst
                         DBGLOG(DBG, "Calling " << (highFrequency ? "high" : "low") << " frequency heuristics for external atom " << eaEvalHeuristics[eaIndex]);
                         if (eaEvalHeuristics[eaIndex]->doEvaluate(
                             eatom,
-                            annotatedGroundProgram.getEAMask(eaIndex)->mask(),
-                            annotatedGroundProgram.getProgramMask(),
+                            annotatedGroundProgram->getEAMask(eaIndex)->mask(),
+                            annotatedGroundProgram->getProgramMask(),
                         partialInterpretation, assigned, changed)) {
                             // evaluate it
                             bool answeredFromCacheOrSupportSets;
@@ -912,7 +1118,7 @@ bool GenuineGuessAndCheckModelGenerator::verifyExternalAtom(int eaIndex, Interpr
     // if support sets are enabled, and the external atom provides complete support sets, we use them for verification
     if (!assigned && !changed && factory.ctx.config.getOption("SupportSets") &&
         (eatom.getExtSourceProperties().providesCompletePositiveSupportSets() || eatom.getExtSourceProperties().providesCompleteNegativeSupportSets()) &&
-    annotatedGroundProgram.allowsForVerificationUsingCompleteSupportSets()) {
+    annotatedGroundProgram->allowsForVerificationUsingCompleteSupportSets()) {
         if (answeredFromCacheOrSupportSets) *answeredFromCacheOrSupportSets = true;
         return verifyExternalAtomBySupportSets(eaIndex, partialInterpretation, assigned, changed);
     }
@@ -928,15 +1134,15 @@ bool GenuineGuessAndCheckModelGenerator::verifyExternalAtomByEvaluation(int eaIn
     DLVHEX_BENCHMARK_REGISTER_AND_SCOPE(sid, "gen. g&c verifyEAtom by eval.");
 
     // prepare EA evaluation
-    InterpretationConstPtr mask = (annotatedGroundProgram.getEAMask(eaIndex)->mask());
-    VerifyExternalAtomCB vcb(partialInterpretation, factory.ctx.registry()->eatoms.getByID(factory.innerEatoms[eaIndex]), *(annotatedGroundProgram.getEAMask(eaIndex)));
+    InterpretationConstPtr mask = (annotatedGroundProgram->getEAMask(eaIndex)->mask());
+    VerifyExternalAtomCB vcb(partialInterpretation, factory.ctx.registry()->eatoms.getByID(factory.innerEatoms[eaIndex]), *(annotatedGroundProgram->getEAMask(eaIndex)));
 
     InterpretationConstPtr evalIntr = partialInterpretation;
     if (!factory.ctx.config.getOption("IncludeAuxInputInAuxiliaries")) {
         // make sure that ALL input auxiliary atoms are true, otherwise we might miss some output atoms and consider true output atoms wrongly as unfounded
         // clone and extend
         InterpretationPtr ncevalIntr(new Interpretation(*partialInterpretation));
-        ncevalIntr->getStorage() |= annotatedGroundProgram.getEAMask(eaIndex)->getAuxInputMask()->getStorage();
+        ncevalIntr->getStorage() |= annotatedGroundProgram->getEAMask(eaIndex)->getAuxInputMask()->getStorage();
         evalIntr = ncevalIntr;
     }
 
@@ -949,8 +1155,8 @@ bool GenuineGuessAndCheckModelGenerator::verifyExternalAtomByEvaluation(int eaIn
     // if the input to the external atom was complete, then remember the verification result;
     // for incomplete input we cannot yet decide this yet, evaluation is only done for learning purposes in this case
     if( !assigned ||
-        !bm::any_sub(annotatedGroundProgram.getEAMask(eaIndex)->mask()->getStorage() & annotatedGroundProgram.getProgramMask()->getStorage(),
-    assigned->getStorage() & annotatedGroundProgram.getProgramMask()->getStorage() ) ) {
+        !bm::any_sub(annotatedGroundProgram->getEAMask(eaIndex)->mask()->getStorage() & annotatedGroundProgram->getProgramMask()->getStorage(),
+    assigned->getStorage() & annotatedGroundProgram->getProgramMask()->getStorage() ) ) {
         eaVerified[eaIndex] = vcb.verify();
 
         DBGLOG(DBG, "Verifying " << factory.innerEatoms[eaIndex] << " (Result: " << eaVerified[eaIndex] << ")");
@@ -959,7 +1165,7 @@ bool GenuineGuessAndCheckModelGenerator::verifyExternalAtomByEvaluation(int eaIn
         if(factory.ctx.config.getOption("NoPropagator") == 0) {
             DBGLOG(DBG, "Setting external atom status of " << eaIndex << " to evaluated");
             eaEvaluated[eaIndex] = true;
-            if (eaVerified[eaIndex]) verifiedAuxes->getStorage() |= annotatedGroundProgram.getEAMask(eaIndex)->mask()->getStorage();
+            if (eaVerified[eaIndex]) verifiedAuxes->getStorage() |= annotatedGroundProgram->getEAMask(eaIndex)->mask()->getStorage();
         }
 
         return !eaVerified[eaIndex];
@@ -976,8 +1182,8 @@ bool GenuineGuessAndCheckModelGenerator::verifyExternalAtomBySupportSets(int eaI
     assert (!assigned && !changed && " verification using complete support sets is only possible wrt. complete interpretations");
     DLVHEX_BENCHMARK_REGISTER_AND_SCOPE(sid, "genuine g&c verifyEAtom by suoport sets");
 
-    eaVerified[eaIndex] = annotatedGroundProgram.verifyExternalAtomsUsingCompleteSupportSets(eaIndex, partialInterpretation, InterpretationPtr());
-    if (eaVerified[eaIndex]) verifiedAuxes->getStorage() |= annotatedGroundProgram.getEAMask(eaIndex)->mask()->getStorage();
+    eaVerified[eaIndex] = annotatedGroundProgram->verifyExternalAtomsUsingCompleteSupportSets(eaIndex, partialInterpretation, InterpretationPtr());
+    if (eaVerified[eaIndex]) verifiedAuxes->getStorage() |= annotatedGroundProgram->getEAMask(eaIndex)->mask()->getStorage();
 
     // we remember that we evaluated, only if there is a propagator that can undo this memory (that can unverify an eatom during model search)
     if( factory.ctx.config.getOption("NoPropagator") == 0 ) {
@@ -991,7 +1197,7 @@ bool GenuineGuessAndCheckModelGenerator::verifyExternalAtomBySupportSets(int eaI
 
 const OrdinaryASPProgram& GenuineGuessAndCheckModelGenerator::getGroundProgram()
 {
-    return annotatedGroundProgram.getGroundProgram();
+    return annotatedGroundProgram->getGroundProgram();
 }
 
 
@@ -1018,6 +1224,113 @@ void GenuineGuessAndCheckModelGenerator::propagate(InterpretationConstPtr partia
 }
 
 
+
+//
+// the splitting model generator
+//
+
+SplittingGuessAndCheckModelGenerator::SplittingGuessAndCheckModelGenerator(
+Factory& factory,
+InterpretationConstPtr input,
+int parts):
+BaseModelGenerator(input),
+factory(factory),
+split(new SearchSpaceSplit(parts)),
+running(parts),
+cancelled(false)
+{
+    LOG(DBG, "splitting search space into " << parts << " parts");
+
+    // grounding and the evaluation of outer external atoms are not done concurrently
+    for (int part = 0; part < parts; ++part) {
+        generators.push_back(boost::shared_ptr<GenuineGuessAndCheckModelGenerator>(new GenuineGuessAndCheckModelGenerator(factory, input, split, part)));
+    }
+
+    // all guessed atoms exist after grounding, the masks are only read by the workers
+    factory.gpMask.updateMask();
+    factory.gnMask.updateMask();
+    for (int part = 0; part < parts; ++part) generators[part]->restrictToPart();
+
+    for (int part = 0; part < parts; ++part) {
+        workers.create_thread(boost::bind(&SplittingGuessAndCheckModelGenerator::work, this, part));
+    }
+}
+
+
+SplittingGuessAndCheckModelGenerator::~SplittingGuessAndCheckModelGenerator()
+{
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        cancelled = true;
+    }
+    modelTaken.notify_all();
+    // the model generators must not outlive the consumer's data structures (e.g., the registry)
+    workers.join_all();
+    // the model generators are destructed on this thread
+    generators.clear();
+}
+
+
+void SplittingGuessAndCheckModelGenerator::work(int part)
+{
+    boost::optional<std::string> failure;
+    try
+    {
+        GenuineGuessAndCheckModelGenerator& mg = *generators[part];
+        InterpretationPtr model;
+        while (!!(model = mg.generateNextModel())) {
+            boost::mutex::scoped_lock lock(mutex);
+            // do not queue more models than there are parts
+            while (!cancelled && models.size() >= (unsigned)split->parts)
+                modelTaken.wait(lock);
+            if (cancelled) break;
+            models.push_back(model);
+            modelAvailable.notify_one();
+        }
+    }
+    catch(const std::exception& e) {
+        failure = std::string(e.what());
+    }
+    catch(...) {
+        failure = std::string("unknown exception");
+    }
+
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        if (!!failure && !error) error = failure;
+        running--;
+    }
+    modelAvailable.notify_all();
+}
+
+
+InterpretationPtr SplittingGuessAndCheckModelGenerator::generateNextModel()
+{
+    DLVHEX_BENCHMARK_REGISTER_AND_SCOPE(sidsplit, "splitting g&c wait for model");
+
+    boost::mutex::scoped_lock lock(mutex);
+    while (models.empty() && running > 0 && !error)
+        modelAvailable.wait(lock);
+    if (!!error)
+        throw GeneralError("model generation failed in search space part: " + error.get());
+    if (models.empty()) {
+        LOG(DBG, "all parts of the search space are exhausted");
+        return InterpretationPtr();
+    }
+
+    InterpretationPtr model = models.front();
+    models.pop_front();
+    modelTaken.notify_all();
+    return model;
+}
+
+
+std::ostream& SplittingGuessAndCheckModelGenerator::print(std::ostream& o) const
+{
+    return o << "SplittingGuessAndCheckModelGenerator(" << split->parts << " parts)";
+}
+
+
 DLVHEX_NAMESPACE_END
 
 
@@ -125,7 +125,8 @@ GenuinePlainModelGenerator::GenuinePlainModelGenerator(
 Factory& factory,
 InterpretationConstPtr input):
 BaseModelGenerator(input),
-factory(factory)
+factory(factory),
+modelBoundVersion(0)
 {
     DLVHEX_BENCHMARK_REGISTER_AND_SCOPE(sidconstruct, "genuine plain mg construction");
     RegistryPtr reg = factory.ctx.registry();
@@ -270,6 +271,25 @@ GenuinePlainModelGenerator::generateNextModel()
     // if the costs of a partial model are greater than the current global optimum then also any completion of this partial model (by combining it with other units)
     // would be non-optimal.
     if (factory.ctx.config.getOption("OptimizationByBackend")) solver->setOptimum(factory.ctx.currentOptimum);
+
+    // Search space pruning: the model bound (if any) eliminates models which cannot change the final result (e.g., of a query).
+    if (!!factory.ctx.modelBound) {
+        if (!programMask) {
+            const OrdinaryASPProgram& gp = solver->getGroundProgram();
+            programMask.reset(new Interpretation(reg));
+            programMask->add(*gp.edb);
+            BOOST_FOREACH (ID ruleID, gp.idb) {
+                const Rule& rule = reg->rules.getByID(ruleID);
+                BOOST_FOREACH (ID h, rule.head) programMask->setFact(h.address);
+                BOOST_FOREACH (ID b, rule.body) if (b.isOrdinaryAtom()) programMask->setFact(b.address);
+            }
+        }
+        Nogood bound;
+        if (factory.ctx.modelBound->getNogood(programMask, modelBoundVersion, bound)) {
+            DBGLOG(DBG, "Adding model bound " << bound.getStringRepresentation(reg));
+            solver->addNogood(bound);
+        }
+    }
     InterpretationPtr modelCandidate = solver->getNextModel();
 
     DBGLOG(DBG, "Statistics:" << std::endl << solver->getStatistics());
@@ -64,7 +64,7 @@
 
 DLVHEX_NAMESPACE_BEGIN
 
-GenuineGrounderPtr GenuineGrounder::getInstance(ProgramCtx& ctx, const OrdinaryASPProgram& p, InterpretationConstPtr frozen)
+GenuineGrounderPtr GenuineGrounder::getInstance(ProgramCtx& ctx, const OrdinaryASPProgram& p, InterpretationConstPtr frozen, bool)
 {
 
     switch(ctx.config.getOption("GenuineSolver")) {
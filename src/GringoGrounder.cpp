@@ -299,9 +299,6 @@ void GringoGrounder::GroundHexProgramBuilder::addSymbol(uint32_t symbol)
 
         // create a propositional atom with this name
         OrdinaryAtom ogatom(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG | ID::PROPERTY_ATOM_HIDDEN);
-        std::stringstream name;
-        name << ctx.registry()->terms.getByID(anonymousPred).symbol << "(" << symbol << ")";
-        ogatom.text = name.str();
         if( anonymousPred.isAuxiliary() ) ogatom.kind |= ID::PROPERTY_AUX;
         if( anonymousPred.isExternalAuxiliary() ) ogatom.kind |= ID::PROPERTY_EXTERNALAUX;
         if( anonymousPred.isExternalInputAuxiliary() ) ogatom.kind |= ID::PROPERTY_EXTERNALINPUTAUX;
@@ -357,7 +354,6 @@ void GringoGrounder::GroundHexProgramBuilder::transformRules()
                         // make a constraint :- not unsat, where unsat is not defined elsewhere
 
                         OrdinaryAtom ogatom(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG);
-                        ogatom.text = ctx.registry()->terms.getByID(unsatPred).symbol;
                         ogatom.kind |= ID::PROPERTY_AUX;
                         ogatom.tuple.push_back(unsatPred);
                         ID aid = ctx.registry()->ogatoms.getIDByTuple(ogatom.tuple);
@@ -483,13 +479,13 @@ void GringoGrounder::GroundHexProgramBuilder::printSymbol(unsigned atomUid, Grin
 
     ID dlvhexId = ctx.registry()->ogatoms.getIDByString(str);
     if( dlvhexId == ID_FAIL ) {
-        OrdinaryAtom ogatom(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG, str);
+        OrdinaryAtom ogatom(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG);
 
         // parse groundatom, register and store
-        GPDBGLOG(DBG,"parsing gringo ground atom '" << ogatom.text << "'");
+        GPDBGLOG(DBG,"parsing gringo ground atom '" << str << "'");
         {
             // parse atom as nested term
-            Term dummyTerm(ID::MAINKIND_TERM, ogatom.text);
+            Term dummyTerm(ID::MAINKIND_TERM, str);
             dummyTerm.analyzeTerm(ctx.registry());
 
             // extract the predicate
@@ -979,9 +975,6 @@ void GringoGrounder::GroundHexProgramBuilder::addSymbol(uint32_t symbol)
 
         // create a propositional atom with this name
         OrdinaryAtom ogatom(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG | ID::PROPERTY_ATOM_HIDDEN);
-        std::stringstream name;
-        name << ctx.registry()->terms.getByID(tid).symbol << "(" << symbol << ")";
-        ogatom.text = name.str();
         if( tid.isAuxiliary() ) ogatom.kind |= ID::PROPERTY_AUX;
         if( tid.isExternalAuxiliary() ) ogatom.kind |= ID::PROPERTY_EXTERNALAUX;
         if( tid.isExternalInputAuxiliary() ) ogatom.kind |= ID::PROPERTY_EXTERNALINPUTAUX;
@@ -1032,7 +1025,6 @@ void GringoGrounder::GroundHexProgramBuilder::doFinalize()
                         // make a constraint :- not unsat, where unsat is not defined elsewhere
 
                         OrdinaryAtom ogatom(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG);
-                        ogatom.text = ctx.registry()->terms.getByID(unsatPred).symbol;
                         ogatom.kind |= ID::PROPERTY_AUX;
                         ogatom.tuple.push_back(unsatPred);
                         ID aid = ctx.registry()->ogatoms.getIDByTuple(ogatom.tuple);
@@ -1185,18 +1177,19 @@ void GringoGrounder::GroundHexProgramBuilder::printSymbolTableEntry(const AtomRe
     }
     //std::cerr << arity << " " << ss.str() << " " << printrange(symbolstarts) << std::endl;
     assert(symbolstarts.size() == arity+1);
-    OrdinaryAtom ogatom(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG, ss.str());
+    const std::string text = ss.str();
+    OrdinaryAtom ogatom(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG);
 
-    ID dlvhexId = ctx.registry()->ogatoms.getIDByString(ogatom.text);
+    ID dlvhexId = ctx.registry()->ogatoms.getIDByString(text);
 
     if( dlvhexId == ID_FAIL ) {
         // parse groundatom, register and store
-        GPDBGLOG(DBG,"parsing gringo ground atom '" << ogatom.text << "'");
+        GPDBGLOG(DBG,"parsing gringo ground atom '" << text << "'");
         {
             // create ogatom.tuple
             unsigned lastsymbolstart = 0;
             for(unsigned symidx = 0; symidx < arity+1; symidx++) {
-                Term term(ID::MAINKIND_TERM, ogatom.text.substr(lastsymbolstart, symbolstarts[symidx]-lastsymbolstart-1));
+                Term term(ID::MAINKIND_TERM, text.substr(lastsymbolstart, symbolstarts[symidx]-lastsymbolstart-1));
                 term.analyzeTerm(ctx.registry());
                 GPDBGLOG(DBG,"got token '" << term.symbol << "'");
 
@@ -1216,7 +1209,7 @@ void GringoGrounder::GroundHexProgramBuilder::printSymbolTableEntry(const AtomRe
     }
 
     indexToGroundAtomID[atom.first] = dlvhexId;
-    GPDBGLOG(DBG, "Got atom " << ogatom.text << " (arity " << (ogatom.tuple.size() - 1) << ") with Gringo-ID " << atom.first << " and dlvhex-ID " << dlvhexId);
+    GPDBGLOG(DBG, "Got atom " << text << " (arity " << (ogatom.tuple.size() - 1) << ") with Gringo-ID " << atom.first << " and dlvhex-ID " << dlvhexId);
 }
 
 
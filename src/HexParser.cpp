@@ -37,17 +37,137 @@
 #include "dlvhex2/ProgramCtx.h"
 #include "dlvhex2/HexGrammar.h"
 #include "dlvhex2/HexParserModule.h"
+#include "dlvhex2/FactParser.h"
+#include "dlvhex2/InputProvider.h"
+#include "dlvhex2/ThreadPool.h"
 #include "dlvhex2/fwd.h"
 
 #include <boost/spirit/include/qi_parse.hpp>
 
 #include <boost/scope_exit.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <algorithm>
 #include <fstream>
 
 //#include <unistd.h>
 
 DLVHEX_NAMESPACE_BEGIN
 
+namespace
+{
+
+    // approximate size of the parts of the inputs which are scanned concurrently
+    const std::size_t factChunkSize = 1 << 20;
+
+    // scanning tasks must not throw, a chunk which could not be scanned just contains no facts
+    void scanChunk(FactParser::ScannedFacts* facts)
+    {
+        try
+        {
+            FactParser::scan(*facts);
+        }
+        catch(const std::exception& e) {
+            LOG(WARNING,"could not scan facts concurrently: " << e.what());
+            facts->runs.clear();
+        }
+    }
+
+    // Splits the inputs at line boundaries into chunks and scans them for runs of
+    // facts using a thread pool (see FactParser::scan). The parser requests the
+    // runs in input order and stores them (see FactParser::store), hence IDs are
+    // assigned deterministically. A run is only used if the parser reaches its
+    // beginning at a statement boundary, otherwise it is skipped.
+    class ConcurrentFactScanner
+    {
+        public:
+            ConcurrentFactScanner(const std::vector<InputProvider::Buffer>& buffers, unsigned threads):
+            scheduled(0), completed(0), released(0), nextChunk(0), nextRun(0) {
+                firstChunk.push_back(0);
+                BOOST_FOREACH (const InputProvider::Buffer& buffer, buffers) {
+                    const char* begin = buffer.first;
+                    while( begin != buffer.second ) {
+                        const char* limit = buffer.second;
+                        if( std::size_t(buffer.second - begin) > factChunkSize ) {
+                            limit = std::find(begin + factChunkSize, buffer.second, '\n');
+                            if( limit != buffer.second ) ++limit;
+                        }
+                        chunks.push_back(FactParser::ScannedFacts(begin, limit, buffer.second));
+                        begin = limit;
+                    }
+                    firstChunk.push_back(chunks.size());
+                }
+                // a single chunk would be scanned while the parser waits
+                if( chunks.size() > 1 ) pool.reset(new ThreadPool(threads));
+            }
+
+            // returns the next run of the given input which begins between the current
+            // position and the beginning of the next statement, if there is one
+            bool get(unsigned input, const char* pos, const char* statement,
+            FactParser::ScannedFacts*& facts, const FactParser::ScannedFacts::Run*& run) {
+                if( !pool ) return false;
+                if( nextChunk < firstChunk[input] ) {
+                    nextChunk = firstChunk[input];
+                    nextRun = 0;
+                }
+                release(nextChunk);
+                while( nextChunk < firstChunk[input + 1] && chunks[nextChunk].begin <= statement ) {
+                    waitFor(nextChunk);
+                    FactParser::ScannedFacts& chunk = chunks[nextChunk];
+                    // runs in front of the current position cannot be used anymore
+                    while( nextRun < chunk.runs.size() && chunk.runs[nextRun].begin < pos ) ++nextRun;
+                    if( nextRun < chunk.runs.size() ) {
+                        if( chunk.runs[nextRun].begin > statement ) return false;
+                        facts = &chunk;
+                        run = &chunk.runs[nextRun++];
+                        return true;
+                    }
+                    ++nextChunk;
+                    nextRun = 0;
+                }
+                return false;
+            }
+
+        private:
+            std::vector<FactParser::ScannedFacts> chunks;
+            // chunks of input i are [firstChunk[i], firstChunk[i+1])
+            std::vector<unsigned> firstChunk;
+            // chunks [0, scheduled) were scheduled, [0, completed) were scanned, [0, released) were freed
+            unsigned scheduled, completed, released;
+            // first run which was not used or skipped yet
+            unsigned nextChunk, nextRun;
+            // declared last, such that it is joined before the chunks are destroyed
+            boost::scoped_ptr<ThreadPool> pool;
+
+            void waitFor(unsigned chunk) {
+                while( chunk >= completed ) {
+                    pool->wait();
+                    completed = scheduled;
+                    // scan the next batch while the facts of the completed one are stored
+                    const unsigned batch = std::min<unsigned>(chunks.size(), scheduled + 2 * pool->size());
+                    for( ; scheduled < batch; ++scheduled ) {
+                        pool->schedule(boost::bind(&scanChunk, &chunks[scheduled]));
+                    }
+                }
+            }
+
+            // frees the facts of all chunks in front of the given one
+            void release(unsigned chunk) {
+                for( ; released < chunk; ++released ) {
+                    waitFor(released);
+                    FactParser::ScannedFacts& facts = chunks[released];
+                    std::vector<FactParser::ScannedFacts::Run>().swap(facts.runs);
+                    std::vector<std::string>().swap(facts.symbols);
+                    std::vector<ID>().swap(facts.symbolIDs);
+                    std::vector<ID>().swap(facts.tuples);
+                    std::vector<unsigned>().swap(facts.sizes);
+                }
+            }
+    };
+
+}                                // anonymous namespace
+
 HexParser::~HexParser()
 {
 }
@@ -73,20 +193,20 @@ void ModuleHexParser::parse(InputProviderPtr in, ProgramCtx& ctx)
         DBGLOG(DBG, " not reset edb ");
     }
 
-    // put whole input from stream into a string
-    // (an alternative would be the boost::spirit::multi_pass iterator
-    // but this can be done later when the parser is updated to Spirit V2)
-    WARNING("TODO incrementally read and parse this stream")
-        std::ostringstream buf;
-    buf << in->getAsStream().rdbuf();
-    std::string input = buf.str();
-
     // create grammar
     HexGrammarSemantics semanticsMgr(ctx);
     HexGrammar<HexParserIterator, HexParserSkipper> grammar(semanticsMgr);
 
+    // ground facts are read by a hand-written parser, the grammar is used for all other statements
+    // (unless a module might parse ground facts differently)
+    bool fastFacts = ctx.config.getOption("FastFactParser");
+
     // configure grammar with modules
     BOOST_FOREACH(HexParserModulePtr module, modules) {
+        if( fastFacts && module->mayParseGroundFacts() ) {
+            LOG(INFO,"parsing ground facts with the grammar because a parser module might parse them");
+            fastFacts = false;
+        }
         switch(module->getType()) {
             case HexParserModule::TOPLEVEL:
                 grammar.registerToplevelModule(module->createGrammarModule());
@@ -107,47 +227,92 @@ void ModuleHexParser::parse(InputProviderPtr in, ProgramCtx& ctx)
         }
     }
 
-    // prepare iterators
-    HexParserIterator it_begin = input.begin();
-    HexParserIterator it_end = input.end();
-
-    // parse
-    HexParserSkipper skipper;
-    DBGLOG(DBG,"starting to parse");
-    bool success = false;
-    try
-    {
-        success = boost::spirit::qi::phrase_parse(
-            it_begin, it_end, grammar, skipper);
-        DBGLOG(DBG,"parsing returned with success=" << success);
-    }
-    catch(const boost::spirit::qi::expectation_failure<HexParserIterator>& e) {
-        LOG(ERROR,"parsing returned with failure: expected '" << e.what_ << "'");
-        it_begin = e.first;
-    }
-    if( !success || it_begin != it_end ) {
-        if( it_begin != it_end )
-            LOG(ERROR,"iterators not the same!");
-
-        HexParserIterator it_displaybegin = it_begin;
-        HexParserIterator it_displayend = it_begin;
-        unsigned usedLeft = 0;
-        while( usedLeft++ < 50 &&
-            it_displaybegin != input.begin() &&
-            *it_displaybegin != '\n' )
-            it_displaybegin--;
-        if( *it_displaybegin == '\n' ) {
-            it_displaybegin++;
-            usedLeft--;
+    FactParser factParser(ctx);
+
+    // parse each input directly from the buffer of the input provider
+    // (files are memory-mapped, hence they are not copied);
+    // each input is parsed on its own, thus a statement must not span several inputs
+    const std::vector<InputProvider::Buffer> buffers = in->getAsBuffers();
+
+    // with several threads, facts are scanned concurrently and only stored here
+    const unsigned parserThreads = ctx.config.getOption("ParserThreads");
+    boost::scoped_ptr<ConcurrentFactScanner> scanner;
+    if( fastFacts && parserThreads > 1 )
+        scanner.reset(new ConcurrentFactScanner(buffers, parserThreads));
+
+    for(unsigned i = 0; i < buffers.size(); ++i) {
+        const HexParserIterator input_begin = buffers[i].first;
+        const HexParserIterator input_end = buffers[i].second;
+
+        // prepare iterators
+        HexParserIterator it_begin = input_begin;
+        HexParserIterator it_end = input_end;
+
+        // parse
+        HexParserSkipper skipper;
+        DBGLOG(DBG,"starting to parse " << in->contentNames()[i]);
+        bool success = false;
+        try
+        {
+            if( fastFacts ) {
+                success = true;
+                while( success ) {
+                    // facts within MLP modules are stored differently, leave them to the grammar
+                    if( semanticsMgr.mlpMode == 0 ) {
+                        FactParser::ScannedFacts* facts;
+                        const FactParser::ScannedFacts::Run* run;
+                        if( !!scanner && scanner->get(i, it_begin, FactParser::skip(it_begin, it_end), facts, run) ) {
+                            factParser.store(*facts, *run);
+                            it_begin = run->end;
+                            continue;
+                        }
+                        if( factParser.parseFact(it_begin, it_end) )
+                            continue;
+                    }
+                    it_begin = FactParser::skip(it_begin, it_end);
+                    if( it_begin == it_end )
+                        break;
+                    // parse a single statement
+                    HexParserIterator it_statement = it_begin;
+                    success = boost::spirit::qi::phrase_parse(
+                        it_begin, it_end, grammar.toplevel, skipper) &&
+                        it_begin != it_statement;
+                }
+            }
+            else {
+                success = boost::spirit::qi::phrase_parse(
+                    it_begin, it_end, grammar, skipper);
+            }
+            DBGLOG(DBG,"parsing returned with success=" << success);
+        }
+        catch(const boost::spirit::qi::expectation_failure<HexParserIterator>& e) {
+            LOG(ERROR,"parsing returned with failure: expected '" << e.what_ << "'");
+            it_begin = e.first;
+        }
+        if( !success || it_begin != it_end ) {
+            if( it_begin != it_end )
+                LOG(ERROR,"iterators not the same!");
+
+            HexParserIterator it_displaybegin = it_begin;
+            HexParserIterator it_displayend = it_begin;
+            unsigned usedLeft = 0;
+            while( usedLeft++ < 50 &&
+                it_displaybegin != input_begin &&
+                *it_displaybegin != '\n' )
+                it_displaybegin--;
+            if( it_displaybegin != input_end && *it_displaybegin == '\n' ) {
+                it_displaybegin++;
+                usedLeft--;
+            }
+            unsigned limitRight = 50;
+            while( limitRight-- > 0 &&
+                it_displayend != it_end &&
+                *it_displayend != '\n' )
+                it_displayend++;
+            LOG(ERROR,"unparsed '" << std::string(it_displaybegin, it_displayend) << "'");
+            LOG(ERROR,"---------" << std::string(usedLeft, '-') << "^");
+            throw SyntaxError("Could not parse complete input!");
         }
-        unsigned limitRight = 50;
-        while( limitRight-- > 0 &&
-            it_displayend != it_end &&
-            *it_displayend != '\n' )
-            it_displayend++;
-        LOG(ERROR,"unparsed '" << std::string(it_displaybegin, it_displayend) << "'");
-        LOG(ERROR,"---------" << std::string(usedLeft, '-') << "^");
-        throw SyntaxError("Could not parse complete input!");
     }
 
     // workaround: making IDs in idb unique
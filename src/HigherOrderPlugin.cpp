@@ -270,6 +270,11 @@ namespace
                 LOG(INFO,"created HigherOrderParserModuleGrammar");
                 return grammarModule;
             }
+
+            // higher-order atoms start with a variable, which is never the case for ground facts
+            virtual bool mayParseGroundFacts() const {
+                return false;
+            }
     };
 
 }                                // anonymous namespace
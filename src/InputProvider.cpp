@@ -37,23 +37,53 @@
 #include "dlvhex2/InputProvider.h"
 #include "dlvhex2/URLBuf.h"
 #include "dlvhex2/Error.h"
+#include "dlvhex2/Logger.h"
+
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/foreach.hpp>
 
 #include <cassert>
 #include <fstream>
 #include <sstream>
+#include <iterator>
 
 DLVHEX_NAMESPACE_BEGIN
 
-WARNING("TODO use boost::iostream::chain or something similar to create real streaming/incremental input provider")
+namespace
+{
+    /** \brief A single input, either held in memory or memory-mapped from a file. */
+    struct Input
+    {
+        std::string content;
+        boost::iostreams::mapped_file_source mapped;
+
+        InputProvider::Buffer buffer() const
+        {
+            if( mapped.is_open() )
+                return InputProvider::Buffer(mapped.data(), mapped.data() + mapped.size());
+            else
+                return InputProvider::Buffer(content.data(), content.data() + content.size());
+        }
+    };
+    typedef boost::shared_ptr<Input> InputPtr;
+}
 
 class InputProvider::Impl
 {
     public:
-        std::stringstream stream;
+        std::vector<InputPtr> inputs;
         std::vector<std::string> contentNames;
+        // inputs are copied into this stream only on demand (see getAsStream)
+        std::stringstream stream;
+        unsigned streamed;
 
     public:
-        Impl() {
+        Impl(): streamed(0) {
+        }
+
+        void add(InputPtr input, const std::string& contentname) {
+            inputs.push_back(input);
+            contentNames.push_back(contentname);
         }
 };
 
@@ -70,33 +100,44 @@ InputProvider::~InputProvider()
 
 void InputProvider::addStreamInput(std::istream& i, const std::string& contentname)
 {
-    // read the input before adding it to pimpl->stream (otherwise empty input seems to make the overall stream corrupt)
-    std::stringstream inp;
-    inp << i.rdbuf();
-    pimpl->stream << inp.str();
-    pimpl->contentNames.push_back(contentname);
+    InputPtr input(new Input);
+    input->content.assign(std::istreambuf_iterator<char>(i), std::istreambuf_iterator<char>());
+    pimpl->add(input, contentname);
 }
 
 
 void InputProvider::addStringInput(const std::string& content, const std::string& contentname)
 {
-    pimpl->stream << content;
-    pimpl->contentNames.push_back(contentname);
+    InputPtr input(new Input);
+    input->content = content;
+    pimpl->add(input, contentname);
 }
 
 
 void InputProvider::addFileInput(const std::string& filename)
 {
-    std::ifstream ifs;
-    ifs.open(filename.c_str());
-
-    if (!ifs.is_open()) {
-        throw GeneralError("File " + filename + " not found");
+    InputPtr input(new Input);
+    try
+    {
+        input->mapped.open(filename);
+    }
+    catch(const std::exception& e) {
+        // empty files and non-regular files cannot be mapped
+        DBGLOG(DBG,"could not map file " << filename << ": " << e.what());
     }
 
-    pimpl->stream << ifs.rdbuf();
-    ifs.close();
-    pimpl->contentNames.push_back(filename);
+    if( !input->mapped.is_open() ) {
+        std::ifstream ifs;
+        ifs.open(filename.c_str());
+
+        if (!ifs.is_open()) {
+            throw GeneralError("File " + filename + " not found");
+        }
+
+        input->content.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+        ifs.close();
+    }
+    pimpl->add(input, filename);
 }
 
 
@@ -109,13 +150,14 @@ void InputProvider::addURLInput(const std::string& url)
     ubuf.open(url);
     std::istream is(&ubuf);
 
-    pimpl->stream << is.rdbuf();
+    InputPtr input(new Input);
+    input->content.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
 
     if (ubuf.responsecode() == 404) {
         throw GeneralError("Requested URL " + url + " was not found");
     }
 
-    pimpl->contentNames.push_back(url);
+    pimpl->add(input, url);
 }
 #endif
 
@@ -131,9 +173,25 @@ const std::vector<std::string>& InputProvider::contentNames() const
 }
 
 
+std::vector<InputProvider::Buffer> InputProvider::getAsBuffers() const
+{
+    std::vector<Buffer> buffers;
+    buffers.reserve(pimpl->inputs.size());
+    BOOST_FOREACH(InputPtr input, pimpl->inputs) {
+        buffers.push_back(input->buffer());
+    }
+    return buffers;
+}
+
+
 std::istream& InputProvider::getAsStream()
 {
     assert(hasContent() && "should have gotten some content before using content");
+    // copy inputs which were added since the last call
+    for(; pimpl->streamed < pimpl->inputs.size(); ++pimpl->streamed) {
+        const Buffer buffer = pimpl->inputs[pimpl->streamed]->buffer();
+        pimpl->stream.write(buffer.first, buffer.second - buffer.first);
+    }
     return pimpl->stream;
 }
 
@@ -539,8 +539,8 @@ void InternalGroundASPSolver::updateUnfoundedSetStructuresAfterSetFact(ID fact)
                 // only atoms which are not already unfounded or false
                 if (!falsified(createLiteral(newlyUnfoundedAtom)) && (unfoundedAtoms.count(newlyUnfoundedAtom) == 0)) {
                     // only atoms which occur in a component that depends on unfounded atoms
-                    if (intersect(depSCC[componentOfAtom[newlyUnfoundedAtom]], unfoundedAtoms).size() > 0 ||
-                    intersect(depSCC[componentOfAtom[newlyUnfoundedAtom]], newlyUnfoundedAtoms).size() > 0) {
+                    if (intersects(depSCC[componentOfAtom[newlyUnfoundedAtom]], unfoundedAtoms) ||
+                    intersects(depSCC[componentOfAtom[newlyUnfoundedAtom]], newlyUnfoundedAtoms)) {
                         DBGLOGD(DBG, "Atom " << newlyUnfoundedAtom << " becomes unfounded");
                         removeSourceFromAtom(newlyUnfoundedAtom);
                         unfoundedAtoms.insert(newlyUnfoundedAtom);
@@ -1031,10 +1031,11 @@ InterpretationPtr InternalGroundASPSolver::getNextModel()
                     Nogood learnedNogood;
                     int k = currentDL;
                     analysis(violatedNogood, learnedNogood, k);
-                    recentConflicts.push_back(addNogoodAndUpdateWatchingStructures(learnedNogood));
+                    recentConflicts.push_back(addLearnedNogood(learnedNogood));
                                  // do not jump below exhausted level, this could lead to regeneration of models
                     currentDL = k > exhaustedDL ? k : exhaustedDL;
                     backtrack(currentDL);
+                    applySearchPolicies();
                 }
                 else {
                     flipDecisionLiteral();
@@ -1059,18 +1060,18 @@ InterpretationPtr InternalGroundASPSolver::getNextModel()
                 DBGLOG(DBG, "No unfounded set exists");
 
                 DBGLOG(DBG, "Calling external learner");
-                int nogoodCount = nogoodset.getNogoodCount();
+                long nogoodCount = nogoodsAdded;
                 BOOST_FOREACH (PropagatorCallback* cb, propagator) {
                     DBGLOG(DBG, "Calling external learners with interpretation: " << *interpretation);
                     cb->propagate(interpretation, factWasSet, changed);
                 }
                 // add new nogoods
-                int ngc = nogoodset.getNogoodCount();
+                long ngc = nogoodsAdded;
                 loadAddedNogoods();
-                if (ngc != nogoodset.getNogoodCount()) anotherIterationEvenIfComplete = true;
+                if (ngc != nogoodsAdded) anotherIterationEvenIfComplete = true;
                 changed->clear();
 
-                if (nogoodset.getNogoodCount() != nogoodCount) {
+                if (nogoodsAdded != nogoodCount) {
                     DBGLOG(DBG, "Learned something");
                 }
                 else {
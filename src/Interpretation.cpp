@@ -42,21 +42,58 @@ DLVHEX_NAMESPACE_BEGIN
 
 std::size_t hash_value(const Interpretation& intr)
 {
-    std::size_t seed = 0;
-    Interpretation::Storage bits= intr.getStorage();
-    Interpretation::Storage::enumerator it = bits.first();
-    while ( it != bits.end() ) {
-        boost::hash_combine(seed, *it);
-        it++;
-    }
-    return seed;
+    return intr.getFingerprint();
 }
 
 
 Interpretation::Interpretation(RegistryPtr registry):
 registry(registry),
-bits()
+bits(),
+fingerprint(EmptyFingerprint),
+storageExposed(false)
+{
+}
+
+
+Interpretation::Interpretation(const Interpretation& other):
+InterpretationBase(other),
+ostream_printable<Interpretation>(other),
+registry(other.registry),
+bits(other.bits),
+fingerprint(other.fingerprint.load(boost::memory_order_relaxed)),
+storageExposed(false)
+{
+}
+
+
+Interpretation& Interpretation::operator=(const Interpretation& other)
 {
+    if( this != &other ) {
+        registry = other.registry;
+        bits = other.bits;
+        // the storage of this interpretation remains exposed if it was before
+        fingerprint.store(storageExposed ? 0 : other.fingerprint.load(boost::memory_order_relaxed), boost::memory_order_relaxed);
+    }
+    return *this;
+}
+
+
+std::size_t Interpretation::getFingerprint() const
+{
+    const std::size_t cached = fingerprint.load(boost::memory_order_relaxed);
+    if( cached != 0 )
+        return cached;
+
+    std::size_t fp = EmptyFingerprint;
+    for(Storage::enumerator it = bits.first();
+    it != bits.end(); ++it) {
+        fp ^= fingerprintOf(*it);
+    }
+    // if fp happens to be 0 it is just recomputed next time;
+    // concurrent callers compute and store the same value
+    if( !storageExposed )
+        fingerprint.store(fp, boost::memory_order_relaxed);
+    return fp;
 }
 
 
@@ -178,12 +215,14 @@ const char* first, const char* sep, const char* last) const
 void Interpretation::add(const Interpretation& other)
 {
     bits |= other.bits;
+    invalidateFingerprint();
 }
 
 
 void Interpretation::bit_and(const Interpretation& other)
 {
     bits &= other.bits;
+    invalidateFingerprint();
 }
 
 
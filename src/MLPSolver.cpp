@@ -37,6 +37,16 @@
 #ifdef HAVE_MLP
 
 #include "dlvhex2/MLPSolver.h"
+#include "dlvhex2/DLVresultParserDriver.h"
+
+#include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include <algorithm>
+#include <deque>
 
 DLVHEX_NAMESPACE_BEGIN
 
@@ -46,6 +56,9 @@ MLPSolver::MLPSolver(ProgramCtx& ctx1)
     nASReturned = 0;
     forget = 0;
     instSplitting = 0;
+    memoization = 0;
+    threads = 0;
+    exploration = 0;
     totalSizeInstOgatoms=0;
     ctx = ctx1;
     RegistryPtr R2(new Registry(*ctx.registry()) );
@@ -88,6 +101,24 @@ void MLPSolver::setInstSplitting(int n)
 }
 
 
+void MLPSolver::setMemoization(int n)
+{
+    if ( n==0 || n==1 ) memoization = n;
+}
+
+
+void MLPSolver::setMemoFile(const std::string& file)
+{
+    memoFile = file;
+}
+
+
+void MLPSolver::setThreads(int n)
+{
+    if ( n>=0 ) threads = n;
+}
+
+
 void MLPSolver::setPrintLevel(int level)
 {
     printLevel = level;
@@ -233,10 +264,8 @@ ID MLPSolver::rewriteOrdinaryAtom(ID oldAtomID, int idxMI)
     // rewrite the predicate inside atomRnew
     predR = predNew;
     DBGLOG(DBG, "[MLPSolver::rewriteOrdinaryAtom] new predR = " << predR);
-    // replace the atom text
-    atomRnew.text = getAtomTextFromTuple(atomRnew.tuple);
     // try to locate the new atom (the rewritten one)
-    ID atomFind = tbl->getIDByString(atomRnew.text);
+    ID atomFind = tbl->getIDByTuple(atomRnew.tuple);
     DBGLOG(DBG, "[MLPSolver::rewriteOrdinaryAtom] ID atomFind = " << atomFind);
     if (atomFind == ID_FAIL) {
         atomFind = tbl->storeAndGetID(atomRnew);
@@ -408,10 +437,8 @@ void MLPSolver::replacedModuleAtoms(int instIdx, InterpretationPtr& edb, Tuple&
                         // rewrite the predicate inside atomRnew
                         predR = predNew;
                         DBGLOG(DBG, "[MLPSolver::replacedModuleAtoms] new predR = " << predR);
-                        // replace the atom text
-                        newOutputAtom.text = getAtomTextFromTuple(newOutputAtom.tuple);
                         // try to locate the new atom (the rewritten one)
-                        ID atomFind = tbl->getIDByString(newOutputAtom.text);
+                        ID atomFind = tbl->getIDByTuple(newOutputAtom.tuple);
                         DBGLOG(DBG, "[MLPSolver::replacedModuleAtoms] ID atomFind = " << atomFind);
                         if (atomFind == ID_FAIL) {
                             atomFind = tbl->storeAndGetID(newOutputAtom);
@@ -1027,13 +1054,12 @@ void MLPSolver::restrictionAndRenaming(const Interpretation& intr, const Tuple&
         while ( itA != actualInputs.end() && found == false) {
             if (*itA == predName) {
                                  // if found in the actual input restriction
-                resultRestriction.push_back(registrySolver->ogatoms.getIDByString(atomR.text));
+                resultRestriction.push_back(registrySolver->ogatoms.getIDByAddress(*it));
                 OrdinaryAtom atomRnew = atomR;
                 DBGLOG(DBG, "[MLPSolver::restrictionAndRenaming] atomR: " << atomR);
                 DBGLOG(DBG, "[MLPSolver::restrictionAndRenaming] atomRnew: " << atomRnew);
                 // rename!
                 atomRnew.tuple.front() = formalInputs.at(ctr);
-                atomRnew.text = getAtomTextFromTuple(atomRnew.tuple);
                 DBGLOG(DBG, "[MLPSolver::restrictionAndRenaming] atomRnew after renaming: " << atomRnew);
                 // store in the ogatoms
                 ID id = registrySolver->ogatoms.getIDByTuple(atomRnew.tuple);
@@ -1176,7 +1202,292 @@ void MLPSolver::updateTop(std::vector<IDSet>& Top, const Tuple& top)
 
 
 // comp() from the paper
-bool MLPSolver::comp(ValueCallsType C)
+// records the answer sets while they are retrieved,
+// the entry becomes usable when the last answer set has been retrieved
+class MLPSolver::MemoizingResults:
+public ASPSolverManager::Results
+{
+    public:
+        MemoizingResults(ASPSolverManager::ResultsPtr results, MemoEntryPtr entry, RegistryPtr reg):
+        results(results), entry(entry), reg(reg) {}
+
+        virtual ~MemoizingResults() {}
+
+        virtual AnswerSet::Ptr getNextAnswerSet() {
+            AnswerSet::Ptr as = results->getNextAnswerSet();
+            if ( as != 0 ) {
+                std::ostringstream oss;
+                as->interpretation->print(oss);
+                entry->answerSets.push_back(oss.str());
+                entry->parsed.push_back(as);
+            }
+            else if ( entry->complete == false ) {
+                entry->complete = true;
+                entry->parsedRegistry = reg;
+            }
+            return as;
+        }
+
+    private:
+        ASPSolverManager::ResultsPtr results;
+        MemoEntryPtr entry;
+        RegistryPtr reg;
+};
+
+
+namespace
+{
+    void addParsedAnswerSet(PreparedResults::Storage& storage, AnswerSet::Ptr as)
+    {
+        storage.push_back(as);
+    }
+
+    // the solver parses the answer sets into the registry while they are retrieved;
+    // retrieving all of them first makes sure that a copy of the registry contains their atoms
+    ASPSolverManager::ResultsPtr retrieveAll(ASPSolverManager::ResultsPtr res)
+    {
+        PreparedResults::Storage storage;
+        AnswerSet::Ptr as = res->getNextAnswerSet();
+        while ( as != 0 ) {
+            storage.push_back(as);
+            as = res->getNextAnswerSet();
+        }
+        return ASPSolverManager::ResultsPtr(new PreparedResults(storage));
+    }
+}
+
+
+// the canonical text consists of the sorted facts and rules and maxint, one per line;
+// it does neither depend on the IDs of the current registry nor on the order in which atoms have been created
+std::string MLPSolver::canonicalProgram(const OrdinaryASPProgram& program)
+{
+    std::vector<std::string> parts;
+    std::ostringstream oss;
+    RawPrinter printer(oss, program.registry);
+    if ( program.edb != 0 ) {
+        Interpretation::Storage::enumerator it = program.edb->getStorage().first();
+        while ( it != program.edb->getStorage().end() ) {
+            oss.str("");
+            printer.print(ID(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG, *it));
+            oss << ".";
+            parts.push_back(oss.str());
+            it++;
+        }
+    }
+    Tuple::const_iterator itR = program.idb.begin();
+    while ( itR != program.idb.end() ) {
+        oss.str("");
+        printer.print(*itR);
+        parts.push_back(oss.str());
+        itR++;
+    }
+    std::sort(parts.begin(), parts.end());
+    parts.erase(std::unique(parts.begin(), parts.end()), parts.end());
+
+    oss.str("");
+    std::vector<std::string>::const_iterator itP = parts.begin();
+    while ( itP != parts.end() ) {
+        oss << *itP << std::endl;
+        itP++;
+    }
+    oss << "#maxint=" << program.maxint << ".";
+    return oss.str();
+}
+
+
+ASPSolverManager::ResultsPtr MLPSolver::solveMemoized(ASPSolverManager& mgr, const OrdinaryASPProgram& program)
+{
+    if ( memoization == 0 ) {
+        ctrCallToDLV++;
+        return mgr.solve(*ctx.getASPSoftware(), program);
+    }
+
+    MemoEntryPtr& entry = memo[canonicalProgram(program)];
+    if ( !!entry && entry->complete ) {
+        DBGLOG(DBG, "[MLPSolver::solveMemoized] reusing " << entry->answerSets.size() << " answer sets");
+        ctrMemoHits++;
+        if ( entry->parsedRegistry != program.registry ) {
+            // the answer sets were computed over another registry (or loaded from the memo file)
+            std::stringstream ss;
+            std::vector<std::string>::const_iterator it = entry->answerSets.begin();
+            while ( it != entry->answerSets.end() ) {
+                ss << *it << std::endl;
+                it++;
+            }
+            entry->parsed.clear();
+            DLVResultParser parser(program.registry);
+            parser.parse(ss, boost::bind(&addParsedAnswerSet, boost::ref(entry->parsed), _1));
+            entry->parsedRegistry = program.registry;
+        }
+        return ASPSolverManager::ResultsPtr(new PreparedResults(entry->parsed));
+    }
+
+    ctrCallToDLV++;
+    ASPSolverManager::ResultsPtr res = mgr.solve(*ctx.getASPSoftware(), program);
+    // if the entry exists, the answer sets of the same program are still being retrieved elsewhere
+    if ( !entry ) {
+        entry.reset(new MemoEntry());
+        res.reset(new MemoizingResults(res, entry, program.registry));
+    }
+    return res;
+}
+
+
+void MLPSolver::loadMemo()
+{
+    std::ifstream ifs(memoFile.c_str());
+    if ( !ifs.is_open() ) {
+        DBGLOG(DBG, "[MLPSolver::loadMemo] memo file " << memoFile << " does not exist yet");
+        return;
+    }
+    // each entry is a header with the length of the program text and the number of answer sets,
+    // followed by the program text and one answer set per line
+    std::string line;
+    while ( std::getline(ifs, line) ) {
+        if ( line.empty() ) continue;
+        std::istringstream header(line);
+        std::size_t length = 0;
+        int count = -1;
+        header >> length >> count;
+        if ( count < 0 ) throw GeneralError("MLP memo file '" + memoFile + "' is corrupt");
+        std::vector<char> program(length);
+        if ( length > 0 && !ifs.read(&program[0], length) ) throw GeneralError("MLP memo file '" + memoFile + "' is corrupt");
+        if ( !std::getline(ifs, line) || !line.empty() ) throw GeneralError("MLP memo file '" + memoFile + "' is corrupt");
+        MemoEntryPtr entry(new MemoEntry());
+        for ( int i = 0; i < count; i++ ) {
+            if ( !std::getline(ifs, line) ) throw GeneralError("MLP memo file '" + memoFile + "' is corrupt");
+            entry->answerSets.push_back(line);
+        }
+        entry->complete = true;
+        memo[std::string(program.begin(), program.end())] = entry;
+    }
+    DBGLOG(INFO, "[MLPSolver::loadMemo] loaded " << memo.size() << " memoized programs from " << memoFile);
+}
+
+
+void MLPSolver::saveMemo()
+{
+    std::ofstream ofs(memoFile.c_str());
+    if ( !ofs.is_open() ) throw GeneralError("could not write MLP memo file '" + memoFile + "'");
+    std::map<std::string, MemoEntryPtr>::const_iterator it = memo.begin();
+    while ( it != memo.end() ) {
+        if ( !!it->second && it->second->complete ) {
+            ofs << it->first.size() << " " << it->second->answerSets.size() << std::endl;
+            ofs << it->first << std::endl;
+            std::vector<std::string>::const_iterator itA = it->second->answerSets.begin();
+            while ( itA != it->second->answerSets.end() ) {
+                ofs << *itA << std::endl;
+                itA++;
+            }
+        }
+        it++;
+    }
+}
+
+
+// a branch point of comp together with the state it depends on;
+// the branch owns its registry, which becomes the registry of the worker that continues it
+struct MLPSolver::Branch
+{
+    // 0 = start with C, 1 = from part b, 2 = from part c
+    int status;
+    ValueCallsType C;
+    std::vector<ValueCallsType> path;
+    InterpretationPtr M;
+    std::vector<IDSet> A;
+    std::vector<IDSet> Top;
+    ID idAlpha;
+    // the answer sets which are still to be explored at this branch point
+    PreparedResults::Storage answers;
+    // registry of the instantiations in path, M, A and answers
+    RegistryPtr registry;
+    ModuleInstTable moduleInstTable;
+    InterpretationTable sTable;
+    std::vector<std::vector<ID> > instOgatoms;
+    int totalSizeInstOgatoms;
+    // snapshot of the branch point (forget mode only)
+    RegistryPtr stackRegistry;
+    ModuleInstTable stackMInst;
+    Graph callGraph;
+    std::vector<std::string> edgeName;
+    Branch(): status(0), idAlpha(ID_FAIL), totalSizeInstOgatoms(0) {}
+};
+
+// state shared by the workers exploring the value calls of one main module
+struct MLPSolver::Exploration
+{
+    // protects all members and the output of answer sets
+    boost::mutex mutex;
+    // signalled if a branch was donated or if the exploration ends
+    boost::condition_variable branchAvailable;
+    std::deque<BranchPtr> branches;
+    int workers;
+    int idle;
+    // true if enough answer sets have been found or if a worker failed
+    bool stop;
+    std::string error;
+    // number of answer sets printed so far
+    int ctrAS;
+    Exploration(int workers, int ctrAS): workers(workers), idle(0), stop(false), ctrAS(ctrAS) {}
+};
+
+
+void MLPSolver::installBranch(const BranchPtr& branch)
+{
+    registrySolver = branch->registry;
+    moduleInstTable = branch->moduleInstTable;
+    sTable = branch->sTable;
+    instOgatoms = branch->instOgatoms;
+    totalSizeInstOgatoms = branch->totalSizeInstOgatoms;
+    path = branch->path;
+    A = branch->A;
+    Top = branch->Top;
+    M.reset(new Interpretation(registrySolver));
+    if ( branch->M != 0 ) *M = *branch->M;
+    M->setRegistry(registrySolver);
+    callGraph = branch->callGraph;
+    edgeName = branch->edgeName;
+}
+
+
+// main loop of a worker thread: continues donated branch points until all workers are idle
+void MLPSolver::work()
+{
+    try
+    {
+        while ( true ) {
+            BranchPtr branch;
+            {
+                boost::mutex::scoped_lock lock(exploration->mutex);
+                exploration->idle++;
+                while ( exploration->branches.empty() && exploration->stop == false && exploration->idle < exploration->workers ) {
+                    exploration->branchAvailable.wait(lock);
+                }
+                if ( exploration->branches.empty() || exploration->stop == true ) {
+                    // nobody is working anymore, hence nobody can donate further branch points
+                    exploration->branchAvailable.notify_all();
+                    return;
+                }
+                branch = exploration->branches.front();
+                exploration->branches.pop_front();
+                exploration->idle--;
+            }
+            installBranch(branch);
+            if ( comp(branch->C, branch) == false ) {
+                throw FatalError("MLP solve: comp() return false");
+            }
+        }
+    }
+    catch(const std::exception& e) {
+        boost::mutex::scoped_lock lock(exploration->mutex);
+        if ( exploration->error == "" ) exploration->error = e.what();
+        exploration->stop = true;
+        exploration->branchAvailable.notify_all();
+    }
+}
+
+
+bool MLPSolver::comp(ValueCallsType C, const BranchPtr& branch)
 {
 
     //recording time for rewrite
@@ -1225,14 +1536,112 @@ bool MLPSolver::comp(ValueCallsType C)
     std::vector< Graph > stackCallGraph;
     std::vector< std::vector<std::string> > stackEdgeName;
 
-    stackStatus.push_back(0);
-    stackC.push_back(C);
+    if ( branch != 0 && branch->status != 0 ) {
+        // continue at a branch point donated by another worker (installBranch has set up the state)
+        PreparedResults::Storage answers(branch->answers);
+        stackAns.push_back(answers.front()->interpretation);
+        answers.pop_front();
+        stackAnsRes.push_back(ASPSolverManager::ResultsPtr(new PreparedResults(answers)));
+        stackStatus.push_back(branch->status);
+        stackC.push_back(branch->C);
+        stackPath.push_back(branch->path);
+        InterpretationPtr M2(new Interpretation(registrySolver));
+        *M2 = *M;
+        stackM.push_back(M2);
+        stackA.push_back(branch->A);
+        if ( instSplitting == 1 ) stackTop.push_back(branch->Top);
+        if ( forget == 1 ) {
+            stackRegistry.push_back(branch->stackRegistry);
+            stackMInst.push_back(branch->stackMInst);
+        }
+        if ( branch->status == 2 ) stackModuleSrcAtom.push_back(branch->idAlpha);
+        if ( (printLevel & Logger::INFO) != 0 ) {
+            stackCallGraph.push_back(branch->callGraph);
+            stackEdgeName.push_back(branch->edgeName);
+        }
+    }
+    else {
+        stackStatus.push_back(0);
+        stackC.push_back(C);
+    }
     int status = 0;              //status=0 for the first time
     ID idAlpha;
     int maxStackSize = 0;
     while (stackC.size()>0) {
         if ( stackC.size() > maxStackSize ) maxStackSize = stackC.size();
 
+        // if another worker is idle, hand over the remaining answer sets of the oldest branch point
+        if ( exploration != 0 ) {
+            bool donate;
+            {
+                boost::mutex::scoped_lock lock(exploration->mutex);
+                if ( exploration->stop == true ) return true;
+                donate = exploration->idle > (int)exploration->branches.size() && stackAnsRes.size() > 0;
+            }
+            if ( donate == true ) {
+                // retrieve all pending answer sets first, then no solver writes to the registry while it is copied
+                std::vector<PreparedResults::Storage> pending(stackAnsRes.size());
+                for (int i = 0; i < stackAnsRes.size(); i++) {
+                    AnswerSet::Ptr as = stackAnsRes[i]->getNextAnswerSet();
+                    while ( as != 0 ) {
+                        pending[i].push_back(as);
+                        as = stackAnsRes[i]->getNextAnswerSet();
+                    }
+                }
+                // stackStatus keeps the initial status 0 below the branch points
+                int offset = stackStatus.size() - stackAnsRes.size();
+                int i = 0;
+                int idxModuleSrcAtom = 0;
+                while ( i < pending.size() && pending[i].empty() ) {
+                    if ( stackStatus[offset+i] == 2 ) idxModuleSrcAtom++;
+                    i++;
+                }
+                if ( i < pending.size() ) {
+                    BranchPtr donated(new Branch());
+                    donated->status = stackStatus[offset+i];
+                    donated->C = stackC[i];
+                    donated->path = stackPath[i];
+                    donated->M.reset(new Interpretation(*stackM[i]));
+                    donated->A = stackA[i];
+                    if ( instSplitting == 1 ) donated->Top = stackTop[i];
+                    if ( donated->status == 2 ) donated->idAlpha = stackModuleSrcAtom[idxModuleSrcAtom];
+                    if ( forget == 1 ) {
+                        donated->stackRegistry.reset(new Registry(*stackRegistry[i]));
+                        donated->stackMInst = stackMInst[i];
+                        donated->registry = donated->stackRegistry;
+                        donated->moduleInstTable = stackMInst[i];
+                    }
+                    else {
+                        donated->registry.reset(new Registry(*registrySolver));
+                        donated->moduleInstTable = moduleInstTable;
+                    }
+                    donated->sTable = sTable;
+                    donated->instOgatoms = instOgatoms;
+                    donated->totalSizeInstOgatoms = totalSizeInstOgatoms;
+                    if ( (printLevel & Logger::INFO) != 0 ) {
+                        donated->callGraph = stackCallGraph[i];
+                        donated->edgeName = stackEdgeName[i];
+                    }
+                    PreparedResults::Storage::const_iterator itAns = pending[i].begin();
+                    while ( itAns != pending[i].end() ) {
+                        InterpretationPtr intr(new Interpretation(*(*itAns)->interpretation));
+                        intr->setRegistry(donated->registry);
+                        donated->answers.push_back(AnswerSet::Ptr(new AnswerSet(intr)));
+                        itAns++;
+                    }
+                    pending[i].clear();
+                    DBGLOG(DBG, "[MLPSolver::comp] donating " << donated->answers.size() << " answer sets of branch point " << i);
+
+                    boost::mutex::scoped_lock lock(exploration->mutex);
+                    exploration->branches.push_back(donated);
+                    exploration->branchAvailable.notify_one();
+                }
+                for (int j = 0; j < stackAnsRes.size(); j++) {
+                    stackAnsRes[j].reset(new PreparedResults(pending[j]));
+                }
+            }
+        }
+
         C = stackC.back();
         status = stackStatus.back();
 
@@ -1472,8 +1881,7 @@ bool MLPSolver::comp(ValueCallsType C)
             }
 
             //staticSolver res = mgr.solve(config, program);
-            res = mgr.solve(*ctx.getASPSoftware(), program);
-            ctrCallToDLV++;
+            res = solveMemoized(mgr, program);
 
             if ( recordingTime == 1 ) {
                 gettimeofday(&timeStruct, NULL);
@@ -1491,7 +1899,13 @@ bool MLPSolver::comp(ValueCallsType C)
                 M2->add( *(int0->interpretation) );
                 ctrASFromDLV++;
 
-                // collect the full answer set
+                // collect the full answer set; workers number and print them one at a time
+                boost::scoped_ptr<boost::mutex::scoped_lock> outputLock;
+                if ( exploration != 0 ) {
+                    outputLock.reset(new boost::mutex::scoped_lock(exploration->mutex));
+                    if ( exploration->stop == true ) return true;
+                    ctrAS = exploration->ctrAS;
+                }
                 ctrAS++;
                 oss.str("");
                 DBGLOG(INFO, "[MLPSolver::comp] Got an answer set" << std::endl << "ANSWER SET" << std::endl << ctrAS);
@@ -1520,6 +1934,11 @@ bool MLPSolver::comp(ValueCallsType C)
                     DBGLOG(INFO, *registrySolver);
                 }
 
+                if ( exploration != 0 ) {
+                    exploration->ctrAS = ctrAS;
+                    if ( nASReturned > 0 && ctrAS == nASReturned ) exploration->stop = true;
+                    outputLock.reset();
+                }
                 if ( nASReturned > 0 && ctrAS == nASReturned) return true;
 
                 // get the next answer set
@@ -1573,8 +1992,7 @@ bool MLPSolver::comp(ValueCallsType C)
             }
 
             //staticSolver res = mgr.solve(config, program);
-            res = mgr.solve(*ctx.getASPSoftware(), program);
-            ctrCallToDLV++;
+            res = solveMemoized(mgr, program);
 
             if ( recordingTime == 1 ) {
                 gettimeofday(&timeStruct, NULL);
@@ -1615,6 +2033,7 @@ bool MLPSolver::comp(ValueCallsType C)
                 *M2 = *M;
                 stackM.push_back(M2);
                 if ( forget == 1 ) {
+                    stackAnsRes.back() = retrieveAll(res);
                     RegistryPtr R2(new Registry(*registrySolver) );
                     stackRegistry.push_back( R2 );
                     stackMInst.push_back(moduleInstTable);
@@ -1742,8 +2161,7 @@ bool MLPSolver::comp(ValueCallsType C)
         }
 
         //staticSolver res = mgr.solve(config, program);
-        res = mgr.solve(*ctx.getASPSoftware(), program);
-        ctrCallToDLV++;
+        res = solveMemoized(mgr, program);
 
         if ( recordingTime == 1 ) {
             gettimeofday(&timeStruct, NULL);
@@ -1783,6 +2201,7 @@ bool MLPSolver::comp(ValueCallsType C)
             *M2 = *M;
             stackM.push_back(M2);
             if ( forget == 1 ) {
+                stackAnsRes.back() = retrieveAll(res);
                 RegistryPtr R2(new Registry(*registrySolver) );
                 stackRegistry.push_back( R2 );
                 stackMInst.push_back(moduleInstTable);
@@ -1850,6 +2269,8 @@ bool MLPSolver::solve()
     ctrAS = 0;
     ctrCallToDLV = 0;
     ctrASFromDLV = 0;
+    ctrMemoHits = 0;
+    if ( memoization == 1 && memoFile != "" ) loadMemo();
 
     //recording time for comp
     double compStartTime;
@@ -1858,6 +2279,47 @@ bool MLPSolver::solve()
         gettimeofday(&startTimeStruct, NULL);
         compStartTime = startTimeStruct.tv_sec+(startTimeStruct.tv_usec/1000000.0);
     }
+
+    // workers for the parallel exploration of the value calls, each with its own copy of the memo;
+    // they share the solver software of ctx, which is only safe for the external DLV process
+    // (a new process with a copy of the options per call), not for the solver libraries
+    int nworkers = threads;
+    if ( nworkers > 1 && dynamic_cast<const ASPSolver::DLVSoftware::Configuration*>(ctx.getASPSoftware().get()) == 0 ) {
+        LOG(WARNING, "[MLPSolver::solve] the value calls are explored on one thread as the ASP solver backend is not thread-safe");
+        nworkers = 0;
+    }
+    std::vector<boost::shared_ptr<MLPSolver> > workers;
+    if ( nworkers > 1 ) {
+        for (int w = 0; w < nworkers; w++) {
+            boost::shared_ptr<MLPSolver> worker(new MLPSolver(ctx));
+            worker->setNASReturned(nASReturned);
+            worker->setPrintLevel(printLevel);
+            worker->setForget(forget);
+            worker->setInstSplitting(instSplitting);
+            worker->setMemoization(memoization);
+            worker->recordingTime = recordingTime;
+            worker->printProgramInformation = printProgramInformation;
+            worker->startTime = startTime;
+            worker->dataReset();
+            worker->ctrAS = worker->ctrASFromDLV = worker->ctrCallToDLV = worker->ctrMemoHits = 0;
+            worker->countB = worker->countC = 0;
+            worker->totalTimePost = worker->totalTimePartA = worker->totalTimeRewrite = worker->totalTimePartB = 0.0;
+            worker->totalTimePartC = worker->totalTimeCallDLV = worker->totalTimePushBack = worker->totalTimeCPathA = 0.0;
+            worker->totalTimeUpdateTop = 0.0;
+            std::map<std::string, MemoEntryPtr>::const_iterator itM = memo.begin();
+            while ( itM != memo.end() ) {
+                if ( itM->second->complete == true ) {
+                    MemoEntryPtr entry(new MemoEntry());
+                    entry->answerSets = itM->second->answerSets;
+                    entry->complete = true;
+                    worker->memo[itM->first] = entry;
+                }
+                itM++;
+            }
+            workers.push_back(worker);
+        }
+    }
+
     while ( it != mainModules.end() ) {
         A.clear();
         Top.clear();
@@ -1868,13 +2330,63 @@ bool MLPSolver::solve()
         DBGLOG(INFO, " ");
         DBGLOG(INFO, "[MLPSolver::solve] ==================== main module solve ctr: ["<< i << "] ==================================");
         DBGLOG(INFO, "[MLPSolver::solve] main module id inspected: " << *it);
-        if ( comp(createValueCallsMainModule(*it)) == false ) {
+        if ( workers.size() > 0 ) {
+            BranchPtr root(new Branch());
+            root->C = createValueCallsMainModule(*it);
+            root->registry = registrySolver;
+            root->moduleInstTable = moduleInstTable;
+            root->sTable = sTable;
+            root->instOgatoms = instOgatoms;
+            root->totalSizeInstOgatoms = totalSizeInstOgatoms;
+            Exploration mainExploration(workers.size(), ctrAS);
+            mainExploration.branches.push_back(root);
+            boost::thread_group group;
+            for (int w = 0; w < workers.size(); w++) {
+                workers[w]->exploration = &mainExploration;
+                group.create_thread(boost::bind(&MLPSolver::work, workers[w].get()));
+            }
+            group.join_all();
+            for (int w = 0; w < workers.size(); w++) {
+                workers[w]->exploration = 0;
+            }
+            ctrAS = mainExploration.ctrAS;
+            if ( mainExploration.error != "" ) {
+                throw GeneralError(mainExploration.error);
+            }
+        }
+        else if ( comp(createValueCallsMainModule(*it)) == false ) {
             throw FatalError("MLP solve: comp() return false");
             return false;
         }
         i++;
         it++;
     }
+
+    // collect the statistics and memoized answer sets of the workers
+    for (int w = 0; w < workers.size(); w++) {
+        ctrASFromDLV += workers[w]->ctrASFromDLV;
+        ctrCallToDLV += workers[w]->ctrCallToDLV;
+        ctrMemoHits += workers[w]->ctrMemoHits;
+        countB += workers[w]->countB;
+        countC += workers[w]->countC;
+        totalTimePost += workers[w]->totalTimePost;
+        totalTimePartA += workers[w]->totalTimePartA;
+        totalTimeRewrite += workers[w]->totalTimeRewrite;
+        totalTimePartB += workers[w]->totalTimePartB;
+        totalTimePartC += workers[w]->totalTimePartC;
+        totalTimeCallDLV += workers[w]->totalTimeCallDLV;
+        totalTimePushBack += workers[w]->totalTimePushBack;
+        totalTimeCPathA += workers[w]->totalTimeCPathA;
+        totalTimeUpdateTop += workers[w]->totalTimeUpdateTop;
+        std::map<std::string, MemoEntryPtr>::const_iterator itM = workers[w]->memo.begin();
+        while ( itM != workers[w]->memo.end() ) {
+            if ( itM->second->complete == true ) {
+                MemoEntryPtr& entry = memo[itM->first];
+                if ( !entry || entry->complete == false ) entry = itM->second;
+            }
+            itM++;
+        }
+    }
     gettimeofday(&startTimeStruct, NULL);
     //recording time...
     if ( recordingTime ==1 ) {
@@ -1887,10 +2399,12 @@ bool MLPSolver::solve()
         std::cerr << "Part C time: " << totalTimePartC << ", countC: " << countC << ", avgtimeC: " << totalTimePartC/countC << std::endl;
         std::cerr << "UpdateTop time: " << totalTimeUpdateTop << ", countUpdateTop: " << countC << ", avgtimeUpdateTop: " << totalTimeUpdateTop/countC << std::endl;
         std::cerr << "Call DLV time: " << totalTimeCallDLV << ", countCallDLV: " << ctrCallToDLV << ", avgtimeCallDLV: " << totalTimeCallDLV/ctrCallToDLV << std::endl;
+        std::cerr << "Memoized calls: " << ctrMemoHits << std::endl;
         std::cerr << "Push back time: " << totalTimePushBack << std::endl;
         std::cerr << "PushBack CPathA Time: " << totalTimeCPathA << std::endl;
     }
     DBGLOG(INFO, "Total answer set: " << ctrAS);
+    if ( memoization == 1 && memoFile != "" ) saveMemo();
     /*
       DBGLOG(INFO, "Instantiation information: ");
       std::ostringstream oss;
@@ -2099,10 +2613,13 @@ const Tuple& MLPSolver::getOgatomsInInst(int instIdx)
         instOgatoms.resize( moduleInstTable.size() );
         for (int i=totalSizeInstOgatoms; i<registrySolver->ogatoms.getSize();i++ ) {
             const OrdinaryAtom& oa = registrySolver->ogatoms.getByAddress(i);
-            int n = oa.text.find( MODULEINSTSEPARATOR );
+            // the instantiation prefix is part of the predicate name
+            ID predID = oa.tuple.front();
+            const std::string& text = predID.isPredicateTerm() ? registrySolver->preds.getByID(predID).symbol : registrySolver->terms.getByID(predID).symbol;
+            int n = text.find( MODULEINSTSEPARATOR );
             if ( n != std::string::npos ) {
                 // MODULEINSTSEPARATOR found
-                std::string pref = oa.text.substr(0, n);
+                std::string pref = text.substr(0, n);
                 pref = pref.substr( 1 );
                 int instIdx = atoi( pref.c_str() );
                 instOgatoms.at(instIdx).push_back( ID(oa.kind, i) );
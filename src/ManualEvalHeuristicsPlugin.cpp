@@ -640,6 +640,11 @@ namespace
                 LOG(INFO,"created ManualEvalHeuristicsParserModuleGrammar");
                 return grammarModule;
             }
+
+            // evaluation unit directives start with a hash, which is never the case for ground facts
+            virtual bool mayParseGroundFacts() const {
+                return false;
+            }
     };
 
 }                                // anonymous namespace
@@ -282,6 +282,39 @@ bool Nogood::isGround() const
 }
 
 
+namespace
+{
+    // applies a substitution to a term (also within function terms); ground is set to false if a variable remains
+    ID substituteTerm(RegistryPtr reg, ID term, const std::vector<std::pair<ID, ID> >& substitution, bool& ground)
+    {
+        if (term.isVariableTerm()) {
+            for (uint32_t i = 0; i < substitution.size(); ++i) {
+                if (substitution[i].first == term) {
+                    DBGLOG(DBG, "Substituting " << term << " by " << substitution[i].second);
+                    return substitution[i].second;
+                }
+            }
+            ground = false;
+            return term;
+        }
+        if (!term.isNestedTerm()) return term;
+
+        Term t = reg->terms.getByID(term);
+        bool changed = false;
+        for (uint32_t i = 1; i < t.arguments.size(); ++i) {
+            ID arg = substituteTerm(reg, t.arguments[i], substitution, ground);
+            changed |= (arg != t.arguments[i]);
+            t.arguments[i] = arg;
+        }
+        if (!changed) return term;
+        t.updateSymbolOfNestedTerm(reg.get());
+        ID tid = reg->terms.getIDByString(t.symbol);
+        if (tid == ID_FAIL) tid = reg->terms.storeAndGetID(t);
+        return tid;
+    }
+}
+
+
 bool Nogood::match(RegistryPtr reg, ID atomID, Nogood& instance) const
 {
 
@@ -290,44 +323,41 @@ bool Nogood::match(RegistryPtr reg, ID atomID, Nogood& instance) const
     const OrdinaryAtom& atom = reg->ogatoms.getByID(atomID);
 
     // find an element in the nogood with unifies with atom
+    std::vector<std::pair<ID, ID> > substitution;
     BOOST_FOREACH (ID natID, *this) {
         const OrdinaryAtom& nat = natID.isOrdinaryGroundAtom() ? reg->ogatoms.getByID(natID) : reg->onatoms.getByID(natID);
 
-        if (atom.unifiesWith(nat, reg)) {
+        if (atom.isInstanceOf(nat, reg, substitution)) {
             DBGLOG(DBG, "Unifies with " << natID);
 
-            // compute unifier
-            std::map<ID, ID> unifier;
-            int i = 0;
-            BOOST_FOREACH (ID t, nat.tuple) {
-                if (t.isVariableTerm()) {
-                    unifier[t] = atom.tuple[i];
-                    DBGLOG(DBG, "Unifier: " << t << " --> " << atom.tuple[i]);
-                }
-                i++;
-            }
-
             // apply unifier to the overall nogood
             DBGLOG(DBG, "Applying unifier");
+            Tuple substituted;
             BOOST_FOREACH (ID natID2, *this) {
                 if (natID2.isOrdinaryGroundAtom()) {
                     instance.insert(natID2);
                 }
                 else {
-                    OrdinaryAtom nat2 = reg->onatoms.getByID(natID2);
+                    const OrdinaryAtom& nat2 = reg->onatoms.getByID(natID2);
+                    IDKind kind = nat2.kind;
+                    substituted.assign(nat2.tuple.begin(), nat2.tuple.end());
                     bool ground = true;
-                    for (uint32_t i = 0; i < nat2.tuple.size(); ++i) {
-                        if (unifier.find(nat2.tuple[i]) != unifier.end()) {
-                            DBGLOG(DBG, "Substituting " << nat2.tuple[i] << " by " << unifier[nat2.tuple[i]]);
-                            nat2.tuple[i] = unifier[nat2.tuple[i]];
-                        }
-                        if (nat2.tuple[i].isVariableTerm()) ground = false;
+                    for (uint32_t i = 0; i < substituted.size(); ++i) {
+                        substituted[i] = substituteTerm(reg, substituted[i], substitution, ground);
                     }
                     if (ground) {
-                        nat2.kind &= (ID::ALL_ONES ^ ID::SUBKIND_MASK);
-                        nat2.kind |= ID::SUBKIND_ATOM_ORDINARYG;
+                        kind &= (ID::ALL_ONES ^ ID::SUBKIND_MASK);
+                        kind |= ID::SUBKIND_ATOM_ORDINARYG;
+                    }
+
+                    // the instance is usually known already, only store it otherwise
+                    ID instID = (ground ? reg->ogatoms : reg->onatoms).getIDByTuple(substituted);
+                    if (instID == ID_FAIL) {
+                        OrdinaryAtom inst(kind);
+                        inst.tuple = substituted;
+                        instID = reg->storeOrdinaryAtom(inst);
                     }
-                    instance.insert(NogoodContainer::createLiteral(reg->storeOrdinaryAtom(nat2).address, !natID2.isNaf(), ground));
+                    instance.insert(NogoodContainer::createLiteral(instID.address, !natID2.isNaf(), ground));
                 }
             }
             DBGLOG(DBG, "Instance: " << instance);
@@ -41,6 +41,9 @@
 #include <bm/bmalgo.h>
 
 #include <boost/foreach.hpp>
+#include <boost/tuple/tuple.hpp>
+
+#include <algorithm>
 
 DLVHEX_NAMESPACE_BEGIN
 
@@ -56,6 +59,30 @@ void NogoodGrounder::resetWatched(SimpleNogoodContainerPtr watched)
 }
 
 
+ID NogoodGrounder::getWatchedLiteral(const Nogood& ng) const
+{
+    int maxBoundVariables = 0;
+    ID watchedLit = ID_FAIL;
+    BOOST_FOREACH (ID lit, ng) {
+        if (lit.isOrdinaryGroundAtom()) continue;
+        if (reg->onatoms.getIDByAddress(lit.address).isGuardAuxiliary()) continue;
+
+        const OrdinaryAtom& atom = reg->onatoms.getByID(lit);
+
+        std::set<ID> distinctVar;
+        BOOST_FOREACH (ID p, atom.tuple) {
+            if (p.isVariableTerm()) distinctVar.insert(p);
+        }
+
+        if ((int)distinctVar.size() > maxBoundVariables) {
+            maxBoundVariables = distinctVar.size();
+            watchedLit = lit;
+        }
+    }
+    return watchedLit;
+}
+
+
 ImmediateNogoodGrounder::ImmediateNogoodGrounder(RegistryPtr reg, SimpleNogoodContainerPtr watched, SimpleNogoodContainerPtr destination, AnnotatedGroundProgram& agp) :
 NogoodGrounder(reg, watched, destination, agp), instantiatedNongroundNogoodsIndex(0)
 {
@@ -75,30 +102,7 @@ void ImmediateNogoodGrounder::update(InterpretationConstPtr partialInterpretatio
         if (ng.isGround()) continue;
 
         DBGLOG(DBG, "Searching for watched literal in nogood " << i);
-        int maxBoundVariables = 0;
-        ID watchedLit = ID_FAIL;
-        BOOST_FOREACH (ID lit, ng) {
-            if (lit.isOrdinaryGroundAtom()) continue;
-            if (reg->onatoms.getIDByAddress(lit.address).isGuardAuxiliary()) continue;
-
-            const OrdinaryAtom& atom = reg->onatoms.getByID(lit);
-
-            std::set<ID> distinctVar;
-            int var = 0;
-            BOOST_FOREACH (ID p, atom.tuple) {
-                if (p.isVariableTerm()) {
-                    if (std::find(distinctVar.begin(), distinctVar.end(), p) == distinctVar.end()) {
-                        distinctVar.insert(p);
-                        var++;
-                    }
-                }
-            }
-
-            if (var > maxBoundVariables) {
-                maxBoundVariables = var;
-                watchedLit = lit;
-            }
-        }
+        ID watchedLit = getWatchedLiteral(ng);
         if (watchedLit == ID_FAIL) {
             DBGLOG(DBG, "Skipping nogood " << i << " because it contains only guard atoms");
             continue;
@@ -108,19 +112,36 @@ void ImmediateNogoodGrounder::update(InterpretationConstPtr partialInterpretatio
         DBGLOG(DBG, "Watching literal " << watchedLit << " in nogood " << i);
         const OrdinaryAtom& watchedAtom = reg->onatoms.getByAddress(watchedLit.address);
 
-        // For each atom A of the program, check if the watched literal unifies with A
-        bm::bvector<>::enumerator en = agp.getProgramMask()->getStorage().first();
-        bm::bvector<>::enumerator en_end = agp.getProgramMask()->getStorage().end();
-
+        // For each atom A of the program, check if the watched literal unifies with A;
+        // if the predicate is known, only the program atoms over this predicate need to be checked
+        std::vector<IDAddress> candidates;
         DBGLOG(DBG, "Searching for unifying program atoms");
-        while (en < en_end) {
+        if (!watchedAtom.tuple[0].isVariableTerm()) {
+            OrdinaryAtomTable::PredicateIterator it, it_end;
+            for (boost::tie(it, it_end) = reg->ogatoms.getRangeByPredicateID(watchedAtom.tuple[0]); it != it_end; ++it) {
+                IDAddress adr = reg->ogatoms.getIDAddressByStorage(*it);
+                if (agp.getProgramMask()->getFact(adr)) candidates.push_back(adr);
+            }
+            // instantiate in the order of the program mask
+            std::sort(candidates.begin(), candidates.end());
+        }
+        else {
+            bm::bvector<>::enumerator en = agp.getProgramMask()->getStorage().first();
+            bm::bvector<>::enumerator en_end = agp.getProgramMask()->getStorage().end();
+            while (en < en_end) {
+                candidates.push_back(*en);
+                en++;
+            }
+        }
 
-            DBGLOG(DBG, "Checking atom " << *en);
+        BOOST_FOREACH (IDAddress adr, candidates) {
 
-            const OrdinaryAtom& currentAtom = reg->ogatoms.getByAddress(*en);
-            if (currentAtom.unifiesWith(watchedAtom, reg)) {
+            DBGLOG(DBG, "Checking atom " << adr);
+
+            const OrdinaryAtom& currentAtom = reg->ogatoms.getByAddress(adr);
+            if (currentAtom.isInstanceOf(watchedAtom, reg)) {
                 Nogood instantiatedNG;
-                ng.match(reg, reg->ogatoms.getIDByAddress(*en), instantiatedNG);
+                ng.match(reg, reg->ogatoms.getIDByAddress(adr), instantiatedNG);
                 DBGLOG(DBG, "Instantiated " << instantiatedNG.getStringRepresentation(reg) << " from " << ng.getStringRepresentation(reg));
 
                 // check if the instance of the nogood contains a ground literal which does not appear in the program
@@ -161,8 +182,6 @@ void ImmediateNogoodGrounder::update(InterpretationConstPtr partialInterpretatio
                     DBGLOG(DBG, "Removing nogood " << simplifiedNG.getStringRepresentation(reg));
                 }
             }
-
-            en++;
         }
 
     }
@@ -200,42 +219,19 @@ void LazyNogoodGrounder::update(InterpretationConstPtr partialInterpretation, In
         if (ng.isGround()) continue;
 
         DBGLOG(DBG, "Searching for watched literal in nogood " << i);
-        int maxBoundVariables = 0;
-        ID watchedLit = ID_FAIL;
-        BOOST_FOREACH (ID lit, ng) {
-            if (lit.isOrdinaryGroundAtom()) continue;
-            if (reg->onatoms.getIDByAddress(lit.address).isGuardAuxiliary()) continue;
-
-            const OrdinaryAtom& atom = reg->onatoms.getByID(lit);
-
-            std::set<ID> distinctVar;
-            int var = 0;
-            BOOST_FOREACH (ID p, atom.tuple) {
-                if (p.isVariableTerm()) {
-                    if (std::find(distinctVar.begin(), distinctVar.end(), p) == distinctVar.end()) {
-                        distinctVar.insert(p);
-                        var++;
-                    }
-                }
-            }
-
-            if (var > maxBoundVariables) {
-                maxBoundVariables = var;
-                watchedLit = lit;
-            }
-        }
+        ID watchedLit = getWatchedLiteral(ng);
         if (watchedLit == ID_FAIL) {
             DBGLOG(DBG, "Skipping nogood " << i << " because it contains only guard atoms");
         }
         else {
             // watch the atom and the corresponding nogood
             DBGLOG(DBG, "Watching literal " << watchedLit << " in nogood " << i);
-            watchedLiterals.push_back(std::pair<ID, int>(watchedLit, i));
+            watchedLiterals[getWatchKey(reg->onatoms.getByAddress(watchedLit.address))].push_back(std::pair<ID, int>(watchedLit, i));
         }
     }
     watchedNogoodsCount = watched->getNogoodCount();
 
-    // For each atom A with changed truth value: go through all watches and check if
+    // For each atom A with changed truth value: go through the watches with compatible predicate and first argument and check if
     // 1. the watched literal unifies with A
     // 2. the corresponding clause has not been instantiated for A yet
     bm::bvector<>::enumerator en = changed->getStorage().first();
@@ -245,36 +241,53 @@ void LazyNogoodGrounder::update(InterpretationConstPtr partialInterpretation, In
     while (en < en_end) {
 
         DBGLOG(DBG, "Instantiating for atom " << *en);
-        typedef std::pair<ID, int> Pair;
-        BOOST_FOREACH (Pair p, watchedLiterals) {
-            DBGLOG(DBG, "Matching nonground nogood " << p.second);
-
-            // 2.
-            if (std::find(alreadyCompared.begin(), alreadyCompared.end(), std::pair<IDAddress, int>(*en, p.second)) != alreadyCompared.end()) continue;
-
-            const OrdinaryAtom& currentAtom = reg->ogatoms.getByAddress(*en);
-            const OrdinaryAtom& watchedAtom = reg->onatoms.getByAddress(p.first.address);
-            // 1.
-            if (currentAtom.unifiesWith(watchedAtom, reg)) {
-                Nogood instantiatedNG;
-                watched->getNogood(p.second).match(reg, reg->ogatoms.getIDByAddress(*en), instantiatedNG);
-                DBGLOG(DBG, "Instantiated " << instantiatedNG.getStringRepresentation(reg) << " from " << watched->getNogood(p.second).getStringRepresentation(reg));
-
-                if (instantiatedNG.isGround()) {
-                    destination->addNogood(instantiatedNG);
-                }
-                else {
-                    watched->addNogood(instantiatedNG);
+        const OrdinaryAtom& currentAtom = reg->ogatoms.getByAddress(*en);
+
+        // watched literals may leave the predicate and the first argument unspecified
+        const WatchKey key = getWatchKey(currentAtom);
+        WatchKey keys[4] = { key, WatchKey(key.first, ID_FAIL), WatchKey(ID_FAIL, key.second), WatchKey(ID_FAIL, ID_FAIL) };
+        for (int k = 0; k < 4; ++k) {
+            if (key.second == ID_FAIL && (k == 0 || k == 2)) continue;
+            boost::unordered_map<WatchKey, std::vector<std::pair<ID, int> > >::const_iterator watches = watchedLiterals.find(keys[k]);
+            if (watches == watchedLiterals.end()) continue;
+
+            typedef std::pair<ID, int> Pair;
+            BOOST_FOREACH (Pair p, watches->second) {
+                DBGLOG(DBG, "Matching nonground nogood " << p.second);
+
+                // 2.
+                if (!alreadyCompared.insert(std::pair<IDAddress, int>(*en, p.second)).second) continue;
+
+                const OrdinaryAtom& watchedAtom = reg->onatoms.getByAddress(p.first.address);
+                // 1.
+                if (currentAtom.isInstanceOf(watchedAtom, reg)) {
+                    Nogood instantiatedNG;
+                    watched->getNogood(p.second).match(reg, reg->ogatoms.getIDByAddress(*en), instantiatedNG);
+                    DBGLOG(DBG, "Instantiated " << instantiatedNG.getStringRepresentation(reg) << " from " << watched->getNogood(p.second).getStringRepresentation(reg));
+
+                    if (instantiatedNG.isGround()) {
+                        destination->addNogood(instantiatedNG);
+                    }
+                    else {
+                        watched->addNogood(instantiatedNG);
+                    }
                 }
             }
-
-            alreadyCompared.insert(std::pair<IDAddress, int>(*en, p.second));
         }
         en++;
     }
 }
 
 
+LazyNogoodGrounder::WatchKey LazyNogoodGrounder::getWatchKey(const OrdinaryAtom& atom)
+{
+    // variables and nested terms (which might contain variables) match different terms
+    ID pred = atom.tuple[0].isVariableTerm() ? ID_FAIL : atom.tuple[0];
+    ID arg = atom.tuple.size() > 1 && !atom.tuple[1].isVariableTerm() && !atom.tuple[1].isNestedTerm() ? atom.tuple[1] : ID_FAIL;
+    return WatchKey(pred, arg);
+}
+
+
 void LazyNogoodGrounder::resetWatched(SimpleNogoodContainerPtr watched)
 {
     NogoodGrounder::resetWatched(watched);
@@ -51,7 +51,8 @@ std::ostream& out, ID id, const std::string& prefix) const
 {
     // simply print all IDs
     assert(id.isOrdinaryGroundAtom() && id.isAuxiliary());
-    out << prefix << reg->ogatoms.getByAddress(id.address).text;
+    out << prefix;
+    RawPrinter(out, reg).printOrdinaryAtom(reg->ogatoms.getByAddress(id.address));
     return true;
 }
 
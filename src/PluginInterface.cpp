@@ -49,6 +49,11 @@
 #include "dlvhex2/Benchmarking.h"
 #include "dlvhex2/HexParser.h"
 #include "dlvhex2/ExternalLearningHelper.h"
+#include "dlvhex2/ThreadPool.h"
+
+#include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
 
 DLVHEX_NAMESPACE_BEGIN
 
@@ -92,25 +97,98 @@ std::size_t hash_value(const PluginAtom::Query& q)
     //LOG("hash_combine inp " << printrange(q.input) << " yields " << seed);
     boost::hash_combine(seed, q.pattern);
     //LOG("hash_combine pat " << printrange(q.pattern) << " yields " << seed);
-    // TODO: can we take hash of pointer to interpretation here?
     if( q.interpretation == 0 ) {
         boost::hash_combine(seed, 0);
     }
     else {
-        // TODO: outsource this
-        //boost::hash_combine(seed, q.interpretation->getStorage());
-        const Interpretation::Storage& bits = q.interpretation->getStorage();
-        for(Interpretation::Storage::enumerator en = bits.first();
-        en != bits.end(); ++en) {
-            boost::hash_combine(seed, *en);
-            //LOG("hash_combine at " << *en << " yields " << seed);
-        }
+        // the fingerprint is maintained incrementally, so we do not need to walk the interpretation
+        boost::hash_combine(seed, q.interpretation->getFingerprint());
     }
     //LOG("hash_combine returning " << seed);
     return seed;
 }
 
 
+namespace
+{
+    // estimates the memory kept alive by a cache entry
+    std::size_t estimateCacheCost(const PluginAtom::Query& query, const std::vector<Tuple>& tuples, SimpleNogoodContainerPtr nogoods)
+    {
+        std::size_t cost = sizeof(PluginAtom::Query) + sizeof(PluginAtom::Answer) + 64;
+        cost += (query.input.size() + query.pattern.size()) * sizeof(ID);
+        if( query.interpretation != 0 ) {
+            // approximated by the true atoms; computing the exact memory usage of the bitset walks all of its blocks
+            cost += sizeof(Interpretation) + query.interpretation->getStorage().count() * sizeof(IDAddress);
+        }
+        BOOST_FOREACH (const Tuple& t, tuples) {
+            cost += sizeof(Tuple) + t.size() * sizeof(ID);
+        }
+        if( !!nogoods ) {
+            for (int i = 0; i < nogoods->getNogoodCount(); ++i) {
+                cost += sizeof(Nogood) + 2 * nogoods->getNogood(i).size() * sizeof(ID);
+            }
+        }
+        return cost;
+    }
+
+    // maximum number of bound output positions for which all generalizations of a pattern are looked up in the cache
+    // (the number of lookups is exponential in this value)
+    const unsigned MaxGeneralizedPositions = 4;
+
+    // checks if a pattern term can be matched against output terms by comparing IDs
+    inline bool isSimplePatternTerm(ID term)
+    {
+        return term.isVariableTerm() || term.isConstantTerm() || term.isIntegerTerm();
+    }
+
+    // computes the pattern used as cache key:
+    // variables are numbered by first occurrence such that patterns which differ only in variable names share cache entries,
+    // anonymous variables and the positions selected by generalize (bitmask) become fresh variables
+    Tuple canonicalPattern(const Tuple& pattern, uint32_t generalize)
+    {
+        Tuple canonical;
+        canonical.reserve(pattern.size());
+        std::vector<ID> vars;
+        for (uint32_t i = 0; i < pattern.size(); ++i) {
+            const ID t = pattern[i];
+            uint32_t var;
+            if (t.isVariableTerm() && !t.isAnonymousVariable()) {
+                var = std::find(vars.begin(), vars.end(), t) - vars.begin();
+                if (var == vars.size()) vars.push_back(t);
+            }
+            else if ((t.isVariableTerm()) || (i < 32 && (generalize & (1u << i)) != 0)) {
+                var = vars.size();
+                vars.push_back(ID_FAIL);
+            }
+            else {
+                canonical.push_back(t);
+                continue;
+            }
+            canonical.push_back(ID(ID::MAINKIND_TERM | ID::SUBKIND_TERM_VARIABLE, var));
+        }
+        return canonical;
+    }
+
+    // checks if an output tuple matches a pattern consisting of simple terms
+    bool matchesPattern(const Tuple& pattern, const Tuple& tuple)
+    {
+        if (pattern.size() != tuple.size()) return false;
+        for (uint32_t i = 0; i < pattern.size(); ++i) {
+            if (!pattern[i].isVariableTerm()) {
+                if (pattern[i] != tuple[i]) return false;
+            }
+            else if (!pattern[i].isAnonymousVariable()) {
+                // repeated variables must be bound to the same term
+                for (uint32_t j = 0; j < i; ++j) {
+                    if (pattern[j] == pattern[i] && tuple[j] != tuple[i]) return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+
 PluginAtom::Answer::Answer():
 output(new std::vector<Tuple>),
 used(false)
@@ -236,49 +314,206 @@ void PluginAtom::retrieveCached(const Query& query, Answer& answer)
 }
 */
 
+namespace
+{
+    // result of an atomic query answered in PluginAtom::retrieveFacade
+    struct AtomicResult
+    {
+        PluginAtom::Answer answer;
+        bool fromCache;
+        // buffers the nogoods of concurrently answered queries (NULL if nogoods are added directly)
+        SimpleNogoodContainerPtr nogoods;
+
+        AtomicResult(): fromCache(false) {}
+    };
+}
+
+
+ThreadPool* PluginAtom::getEvaluationPool(const ProgramCtx& ctx)
+{
+    const unsigned threads = ctx.config.getOption("ParallelExternalEvaluation");
+    if( threads == 0 )
+        return 0;
+    return &ctx.getThreadPool("ExternalEvaluation", threads);
+}
+
+
+void PluginAtom::retrieveAtomic(const Query& query, Answer& answer, NogoodContainerPtr nogoods, bool useCache, bool& fromCache)
+{
+    if (useCache) {
+        fromCache = retrieveCached(query, answer, nogoods);
+    }
+    else {
+        fromCache = false;
+
+        DLVHEX_BENCHMARK_REGISTER_AND_SCOPE(sidr,"PluginAtom retrieve");
+        retrieve(query, answer, nogoods);
+    }
+}
+
+
 bool PluginAtom::retrieveFacade(const Query& query, Answer& answer, NogoodContainerPtr nogoods, bool useCache)
 {
-    bool fromCache = false;
+    // the answer in the vector shares its storage with answer, thus the result is directly appended to answer
+    std::vector<Query> queries(1, query);
+    std::vector<Answer> answers(1, answer);
+    const bool fromCache = retrieveFacade(queries, answers, nogoods, useCache);
+    // the usage marker is not shared
+    answer = answers.front();
+    return fromCache;
+}
+
+
+bool PluginAtom::retrieveFacade(const std::vector<Query>& queries, std::vector<Answer>& answers, NogoodContainerPtr nogoods, bool useCache)
+{
+    return retrieveFacade(queries, answers, nogoods, useCache, 0);
+}
+
 
-    // split the query
-    const ExtSourceProperties& prop = query.ctx->registry()->eatoms.getByID(query.eatomID).getExtSourceProperties();
+bool PluginAtom::retrieveFacade(const std::vector<Query>& queries, std::vector<Answer>& answers, NogoodContainerPtr nogoods, bool useCache, DeferredLearning* deferred)
+{
+    bool fromCache = false;
+    if (queries.empty()) return false;
+    const ProgramCtx& ctx = *queries.front().ctx;
 
-    DBGLOG(DBG, "Splitting query");
-    std::vector<Query> atomicQueries = splitQuery(query, prop);
-    DBGLOG(DBG, "Got " << atomicQueries.size() << " atomic queries");
-    BOOST_FOREACH (Query atomicQuery, atomicQueries) {
-        Answer atomicAnswer;
-        bool subqueryFromCache;
+    // split the queries and remember for each atomic query to which query it belongs
+    std::vector<const ExtSourceProperties*> props;
+    std::vector<Query> atomicQueries;
+    std::vector<std::size_t> origin;
+    bool threadSafe = true;
+    for (std::size_t q = 0; q < queries.size(); ++q) {
+        const ExtSourceProperties& prop = ctx.registry()->eatoms.getByID(queries[q].eatomID).getExtSourceProperties();
+        props.push_back(&prop);
+        threadSafe &= prop.isThreadSafe();
+
+        DBGLOG(DBG, "Splitting query");
+        std::vector<Query> split = splitQuery(queries[q], prop);
+        DBGLOG(DBG, "Got " << split.size() << " atomic queries");
+        atomicQueries.insert(atomicQueries.end(), split.begin(), split.end());
+        origin.insert(origin.end(), split.size(), q);
+    }
+    while (answers.size() < queries.size()) answers.push_back(Answer());
+
+    NogoodContainerPtr userNogoods = ctx.config.getOption("ExternalLearningUser") ? nogoods : NogoodContainerPtr();
+    boost::ptr_vector<AtomicResult> results;
+    for (std::size_t i = 0; i < atomicQueries.size(); ++i) results.push_back(new AtomicResult());
+
+    // answer the atomic queries, concurrently if the source allows for this
+    ThreadPool* pool = atomicQueries.size() > 1 && threadSafe ? getEvaluationPool(ctx) : 0;
+    if (!!pool) {
+        DBGLOG(DBG, "Answering atomic queries concurrently");
+        std::vector<ThreadPool::Task> tasks;
+        for (std::size_t i = 0; i < atomicQueries.size(); ++i) {
+            // the nogood container might not be thread-safe, thus each query learns into its own one
+            if (!!userNogoods) results[i].nogoods.reset(new SimpleNogoodContainer());
+            tasks.push_back(boost::bind(&PluginAtom::retrieveAtomic, this, boost::cref(atomicQueries[i]), boost::ref(results[i].answer), results[i].nogoods, useCache, boost::ref(results[i].fromCache)));
+        }
+        pool->run(tasks);
+    }
+    else if (atomicQueries.size() == 1) {
+        retrieveAtomic(atomicQueries[0], results[0].answer, userNogoods, useCache, results[0].fromCache);
+    }
+    else {
+        // pass all atomic queries to the source at once such that it can amortize its overhead per call
+        std::vector<Answer> atomicAnswers;
+        std::vector<bool> atomicFromCache(atomicQueries.size(), false);
         if (useCache) {
-            subqueryFromCache = retrieveCached(atomicQuery, atomicAnswer, query.ctx->config.getOption("ExternalLearningUser") ? nogoods : NogoodContainerPtr());
+            retrieveCachedBatch(atomicQueries, atomicAnswers, atomicFromCache, userNogoods);
         }
         else {
-            subqueryFromCache = false;
-
             DLVHEX_BENCHMARK_REGISTER_AND_SCOPE(sidr,"PluginAtom retrieve");
-            retrieve(atomicQuery, atomicAnswer, query.ctx->config.getOption("ExternalLearningUser") ? nogoods : NogoodContainerPtr());
+            // each query learns into its own container such that the merge below adds them in order
+            std::vector<NogoodContainerPtr> atomicNogoods(atomicQueries.size());
+            if (!!userNogoods) {
+                for (std::size_t i = 0; i < atomicQueries.size(); ++i) {
+                    results[i].nogoods.reset(new SimpleNogoodContainer());
+                    atomicNogoods[i] = results[i].nogoods;
+                }
+            }
+            retrieveBatch(atomicQueries, atomicAnswers, atomicNogoods);
+            if (atomicAnswers.size() != atomicQueries.size())
+                throw PluginError("External atom " + getPredicate() + " returned a wrong number of answers to a batch of queries");
+        }
+        for (std::size_t i = 0; i < atomicQueries.size(); ++i) {
+            results[i].answer = atomicAnswers[i];
+            results[i].fromCache = atomicFromCache[i];
+        }
+    }
+
+    // merge in the order of the atomic queries such that the result does not depend on scheduling
+    for (std::size_t i = 0; i < atomicQueries.size(); ++i) {
+        const Query& atomicQuery = atomicQueries[i];
+        const ExtSourceProperties& prop = *props[origin[i]];
+        Answer& atomicAnswer = results[i].answer;
+        bool subqueryFromCache = results[i].fromCache;
+
+        if (!!results[i].nogoods) {
+            for (int j = 0; j < results[i].nogoods->getNogoodCount(); ++j) nogoods->addNogood(results[i].nogoods->getNogood(j));
         }
 
         // learn only if the query was not answered from cache (otherwise also the nogoods come from the cache)
-        if (!subqueryFromCache) {
-            if (!!nogoods && query.ctx->config.getOption("ExternalLearningIOBehavior")) ExternalLearningHelper::learnFromInputOutputBehavior(atomicQuery, atomicAnswer, prop, nogoods);
-            if (!!nogoods && query.ctx->config.getOption("ExternalLearningFunctionality") && prop.isFunctional()) ExternalLearningHelper::learnFromFunctionality(atomicQuery, atomicAnswer, prop, otuples, nogoods);
+        if (!subqueryFromCache && !!nogoods) {
+            if (!!deferred) {
+                deferred->atomicQueries.push_back(atomicQuery);
+                deferred->atomicAnswers.push_back(atomicAnswer);
+                deferred->atomicProps.push_back(&prop);
+            }
+            else {
+                learnFromAtomicAnswer(atomicQuery, atomicAnswer, prop, nogoods);
+            }
         }
 
         // overall answer is the union of the atomic answers
         DBGLOG(DBG, "Atomic query delivered " << atomicAnswer.get().size() << " tuples");
+        Answer& answer = answers[origin[i]];
         answer.get().insert(answer.get().end(), atomicAnswer.get().begin(), atomicAnswer.get().end());
 
         // query counts as answered from cache if at least one subquery was answered from cache
         fromCache |= subqueryFromCache;
     }
 
-    if (!!nogoods && query.ctx->config.getOption("ExternalLearningNeg")) ExternalLearningHelper::learnFromNegativeAtoms(query, answer, prop, nogoods);
+    for (std::size_t q = 0; q < queries.size(); ++q) {
+        // mark as used also if no atomic query delivered tuples
+        answers[q].use();
+        if (!!nogoods && ctx.config.getOption("ExternalLearningNeg")) {
+            if (!!deferred) {
+                deferred->queries.push_back(queries[q]);
+                deferred->answers.push_back(answers[q]);
+                deferred->props.push_back(props[q]);
+            }
+            else {
+                ExternalLearningHelper::learnFromNegativeAtoms(queries[q], answers[q], *props[q], nogoods);
+            }
+        }
+    }
 
     return fromCache;
 }
 
 
+void PluginAtom::learnFromAtomicAnswer(const Query& atomicQuery, const Answer& atomicAnswer, const ExtSourceProperties& prop, NogoodContainerPtr nogoods)
+{
+    const ProgramCtx& ctx = *atomicQuery.ctx;
+    if (ctx.config.getOption("ExternalLearningIOBehavior")) ExternalLearningHelper::learnFromInputOutputBehavior(atomicQuery, atomicAnswer, prop, nogoods);
+    if (ctx.config.getOption("ExternalLearningFunctionality") && prop.isFunctional()) {
+        boost::mutex::scoped_lock lock(otuplesMutex);
+        ExternalLearningHelper::learnFromFunctionality(atomicQuery, atomicAnswer, prop, otuples, nogoods);
+    }
+}
+
+
+void PluginAtom::learnDeferred(const DeferredLearning& deferred, NogoodContainerPtr nogoods)
+{
+    if (!nogoods) return;
+    for (std::size_t i = 0; i < deferred.atomicQueries.size(); ++i) {
+        learnFromAtomicAnswer(deferred.atomicQueries[i], deferred.atomicAnswers[i], *deferred.atomicProps[i], nogoods);
+    }
+    for (std::size_t q = 0; q < deferred.queries.size(); ++q) {
+        ExternalLearningHelper::learnFromNegativeAtoms(deferred.queries[q], deferred.answers[q], *deferred.props[q], nogoods);
+    }
+}
+
+
 bool PluginAtom::retrieveCached(const Query& query, Answer& answer, NogoodContainerPtr nogoods)
 {
     DBGLOG(DBG, "Retrieve with learning, pointer to nogood container: " << (!nogoods ? "not " : "") << "available" );
@@ -291,9 +526,11 @@ bool PluginAtom::retrieveCached(const Query& query, Answer& answer, NogoodContai
     // * store new cache for new inputSet/*inputi combination or unrelated (does not unify) pattern
     // * replace cache for existing inputSet/*inputi combination and less specific (unifies in one direction) pattern
     //
-    // The currently implemented "poor (wo)man's version" is:
-    // * store answers in cache with queries as keys, disregard relations between patterns
-    ///@todo: efficiency could be increased for certain programs by considering pattern relationships as indicated above
+    // The currently implemented version is:
+    // * store answers in cache with queries as keys, where variables in the pattern are renamed canonically
+    // * if there is no entry for the query itself, look up queries with the same input where some bound output positions
+    //   are replaced by variables and filter their answer (up to MaxGeneralizedPositions bound positions)
+    // * less specific entries do not replace more specific ones, the latter are evicted when they are not used anymore
 
 
     // Remark: Note that cache entries for nogoods must not be reused if the set of ground atoms in the registry (which might occur as input to the external atom) was expanded,
@@ -330,58 +567,167 @@ bool PluginAtom::retrieveCached(const Query& query, Answer& answer, NogoodContai
     // (which might occur as input), comparing predicateInputMask in Query::operator==() should guarantee that the cache entry is not reused anymore
     // (actually, comparing the sizes of predicateInputMask suffices as predicateInputMask can only increase but not decrease when the registry is expanded).
 
-    boost::mutex::scoped_lock lock(cacheMutex);
+    Query key(query);
+    key.pattern = canonicalPattern(query.pattern, 0);
 
-    Answer& ans = queryAnswerCache[query];
-    if( ans.hasBeenUsed()) {
-        // answer was not default -> use
-        answer = ans;
+    bool inCache;
+    if( lookupCached(key, query, answer, nogoods, inCache) )
+        return true;             // answered from cache
+
+    // answer is not cached, or it is cached but without nogoods:
+    // retrieve and replace in cache
+    // (the cache is not locked during evaluation, so concurrent identical queries might both be evaluated)
+    CachedAnswer entry;
+    {
+        DLVHEX_BENCHMARK_REGISTER_AND_SCOPE(sidr,"PluginAtom retrieve");
 
-        // check if there are cached nogoods
         if (nogoods) {
-            SimpleNogoodContainerPtr& cachedNogoods = queryNogoodCache[query];
-            if (cachedNogoods) {
-                // return cached nogoods
-                for (int i = 0; i < cachedNogoods->getNogoodCount(); ++i) nogoods->addNogood(cachedNogoods->getNogood(i));
-            }
-            else {
-                // answer is cached but no nogoods: reevaluate and return nogoods
-                queryAnswerCache[query] = Answer();
-                Answer& ans2 = queryAnswerCache[query];
-                cachedNogoods.reset(new SimpleNogoodContainer());
-                retrieve(query, ans2, cachedNogoods);
-                ans2.use();
-                answer = ans2;   // ans2 should be the same as ans
-                for (int i = 0; i < cachedNogoods->getNogoodCount(); ++i) nogoods->addNogood(cachedNogoods->getNogood(i));
-            }
+            entry.nogoods.reset(new SimpleNogoodContainer());
+            retrieve(query, entry.answer, entry.nogoods);
+            for (int i = 0; i < entry.nogoods->getNogoodCount(); ++i) nogoods->addNogood(entry.nogoods->getNogood(i));
+        }
+        else {
+            retrieve(query, entry.answer, NogoodContainerPtr());
         }
 
-        return true;             // answered from cache
+        // if there was no answer, perhaps it has never been used, so we use it manually
+        entry.answer.use();
     }
-    else { {
-            // answer was default constructed
-            // -> retrieve and replace in cache
-            DLVHEX_BENCHMARK_REGISTER_AND_SCOPE(sidr,"PluginAtom retrieve");
+    queryCache.insert(key, entry, estimateCacheCost(key, entry.answer.get(), entry.nogoods));
+    answer = entry.answer;
+
+    // if only the nogoods were missing, the answer still counts as cached
+    return inCache;
+}
 
-            if (nogoods) {
-                SimpleNogoodContainerPtr& cachedNogoods = queryNogoodCache[query];
-                assert(!cachedNogoods);
 
-                cachedNogoods.reset(new SimpleNogoodContainer());
-                retrieve(query, ans, cachedNogoods);
-                for (int i = 0; i < cachedNogoods->getNogoodCount(); ++i) nogoods->addNogood(cachedNogoods->getNogood(i));
+bool PluginAtom::lookupCached(const Query& key, const Query& query, Answer& answer, NogoodContainerPtr nogoods, bool& inCache)
+{
+    CachedAnswer cached;
+    inCache = queryCache.lookup(key, cached);
+    if( !inCache && retrieveSubsumed(query, cached, !!nogoods) ) {
+        // remember the filtered answer for the query itself
+        queryCache.insert(key, cached, estimateCacheCost(key, cached.answer.get(), SimpleNogoodContainerPtr()));
+    }
+    else if( !inCache || (!!nogoods && !cached.nogoods) ) {
+        // answer (or nogoods if requested) not cached
+        return false;
+    }
+
+    // answer (and nogoods if requested) cached -> use
+    answer = cached.answer;
+    if (nogoods) {
+        // return cached nogoods
+        for (int i = 0; i < cached.nogoods->getNogoodCount(); ++i) nogoods->addNogood(cached.nogoods->getNogood(i));
+    }
+    return true;
+}
+
+
+void PluginAtom::retrieveCachedBatch(const std::vector<Query>& queries, std::vector<Answer>& answers, std::vector<bool>& fromCache, NogoodContainerPtr nogoods)
+{
+    DLVHEX_BENCHMARK_REGISTER_AND_SCOPE(sidrc,"PluginAtom retrieveCached");
+
+    // answer as many queries as possible from cache and collect the others
+    std::vector<Query> keys;
+    std::vector<Query> missing;
+    std::vector<std::size_t> missingIndex;
+    answers.clear();
+    fromCache.assign(queries.size(), false);
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        answers.push_back(Answer());
+        Query key(queries[i]);
+        key.pattern = canonicalPattern(queries[i].pattern, 0);
+        bool inCache;
+        if( lookupCached(key, queries[i], answers.back(), nogoods, inCache) ) {
+            fromCache[i] = true;
+        }
+        else {
+            // if only the nogoods were missing, the answer still counts as cached
+            fromCache[i] = inCache;
+            keys.push_back(key);
+            missing.push_back(queries[i]);
+            missingIndex.push_back(i);
+        }
+    }
+    if( missing.empty() )
+        return;
+
+    // retrieve all others at once and store them in the cache
+    DBGLOG(DBG, "Retrieving " << missing.size() << " of " << queries.size() << " queries in one batch");
+    std::vector<Answer> retrieved;
+    std::vector<SimpleNogoodContainerPtr> learned(missing.size());
+    {
+        DLVHEX_BENCHMARK_REGISTER_AND_SCOPE(sidr,"PluginAtom retrieve");
+        std::vector<NogoodContainerPtr> learnedFor(missing.size());
+        if (nogoods) {
+            for (std::size_t j = 0; j < missing.size(); ++j) {
+                learned[j].reset(new SimpleNogoodContainer());
+                learnedFor[j] = learned[j];
             }
-            else {
-                retrieve(query, ans, NogoodContainerPtr());
+        }
+        retrieveBatch(missing, retrieved, learnedFor);
+        if (retrieved.size() != missing.size())
+            throw PluginError("External atom " + getPredicate() + " returned a wrong number of answers to a batch of queries");
+    }
+    for (std::size_t j = 0; j < missing.size(); ++j) {
+        CachedAnswer entry;
+        entry.answer = retrieved[j];
+        entry.nogoods = learned[j];
+        if (nogoods) {
+            for (int i = 0; i < entry.nogoods->getNogoodCount(); ++i) nogoods->addNogood(entry.nogoods->getNogood(i));
+        }
+        // if there was no answer, perhaps it has never been used, so we use it manually
+        entry.answer.use();
+        queryCache.insert(keys[j], entry, estimateCacheCost(keys[j], entry.answer.get(), entry.nogoods));
+        answers[missingIndex[j]] = entry.answer;
+    }
+}
+
+
+bool PluginAtom::retrieveSubsumed(const Query& query, CachedAnswer& result, bool withNogoods)
+{
+    // collect bound output positions
+    std::vector<uint32_t> bound;
+    BOOST_FOREACH (ID t, query.pattern) {
+        if (!isSimplePatternTerm(t)) return false;
+    }
+    for (uint32_t i = 0; i < query.pattern.size() && i < 32; ++i) {
+        if (!query.pattern[i].isVariableTerm()) bound.push_back(i);
+    }
+    if (bound.empty() || bound.size() > MaxGeneralizedPositions) return false;
+
+    // try generalizations with fewer free positions first as their answers are smaller
+    Query key(query);
+    CachedAnswer general;
+    for (uint32_t freed = 1; freed <= bound.size(); ++freed) {
+        for (uint32_t subset = 1; subset < (1u << bound.size()); ++subset) {
+            uint32_t generalize = 0;
+            uint32_t count = 0;
+            for (uint32_t b = 0; b < bound.size(); ++b) {
+                if ((subset & (1u << b)) != 0) {
+                    generalize |= (1u << bound[b]);
+                    ++count;
+                }
             }
+            if (count != freed) continue;
 
-            // if there was no answer, perhaps it has never been used, so we use it manually
-            ans.use();
-        }
-        answer = ans;
+            key.pattern = canonicalPattern(query.pattern, generalize);
+            if (!queryCache.lookup(key, general)) continue;
+            if (withNogoods && !general.nogoods) continue;
 
-        return false;            // not answered from cache
+            DBGLOG(DBG, "Answering query from cached answer of more general pattern " << printvector(key.pattern));
+            result.answer = Answer();
+            BOOST_FOREACH (const Tuple& t, general.answer.get()) {
+                if (matchesPattern(query.pattern, t)) result.answer.get().push_back(t);
+            }
+            result.answer.use();
+            // the nogoods describe the behavior of the source and thus also hold for the more specific query
+            result.nogoods = general.nogoods;
+            return true;
+        }
     }
+    return false;
 }
 
 
@@ -398,6 +744,19 @@ void PluginAtom::retrieve(const Query& query, Answer& answer)
 }
 
 
+void PluginAtom::retrieveBatch(const std::vector<Query>& queries, std::vector<Answer>& answers, const std::vector<NogoodContainerPtr>& nogoods)
+{
+    DBGLOG(DBG, "Default implementation of PluginAtom::retrieveBatch: calling PluginAtom::retrieve for each of " << queries.size() << " queries");
+    assert(nogoods.size() == queries.size());
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        answers.push_back(Answer());
+        retrieve(queries[i], answers.back(), nogoods[i]);
+        // if there was no answer, perhaps it has never been used, so we use it manually
+        answers.back().use();
+    }
+}
+
+
 void PluginAtom::learnSupportSets(const Query&, NogoodContainerPtr nogoods)
 {
     assert(prop.providesSupportSets() && "This external source does not provide support sets");
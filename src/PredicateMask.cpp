@@ -296,11 +296,11 @@ void ExternalAtomMask::addOutputAtoms(InterpretationConstPtr intr)
             const OrdinaryAtom& oatom = ctx->registry()->ogatoms.getByAddress(atom);
             if (oatom.tuple[0] == posreplacement || oatom.tuple[0] == negreplacement) {
                 if (matchOutputAtom(oatom.tuple)) {
-                    DBGLOG(DBG, "Output atom " << oatom.text << " matches the external atom");
+                    DBGLOG(DBG, "Output atom " << printToString<RawPrinter>(id, reg) << " matches the external atom");
                     maski->setFact(atom);
                 }
                 else {
-                    DBGLOG(DBG, "Output atom " << oatom.text << " does not match the external atom");
+                    DBGLOG(DBG, "Output atom " << printToString<RawPrinter>(id, reg) << " does not match the external atom");
                 }
             }
         }
@@ -519,11 +519,11 @@ void ExternalAtomMask::updateMask()
             const IDAddress outputAtom = *en;
             const OrdinaryAtom& oatom = eatom->pluginAtom->getRegistry()->ogatoms.getByAddress(outputAtom);
             if (matchOutputAtom(oatom.tuple)) {
-                DBGLOG(DBG, "Output atom " << oatom.text << " matches the external atom");
+                DBGLOG(DBG, "Output atom " << printToString<RawPrinter>(ID(oatom.kind, outputAtom), eatom->pluginAtom->getRegistry()) << " matches the external atom");
                 maski->setFact(outputAtom);
             }
             else {
-                DBGLOG(DBG, "Output atom " << oatom.text << " does not match the external atom");
+                DBGLOG(DBG, "Output atom " << printToString<RawPrinter>(ID(oatom.kind, outputAtom), eatom->pluginAtom->getRegistry()) << " does not match the external atom");
             }
             en++;
         }
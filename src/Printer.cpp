@@ -74,10 +74,10 @@ void RawPrinter::print(ID id)
         case ID::MAINKIND_ATOM:
             switch(id.kind & ID::SUBKIND_MASK) {
                 case ID::SUBKIND_ATOM_ORDINARYG:
-                    out << registry->ogatoms.getByID(id).text;
+                    printOrdinaryAtom(registry->ogatoms.getByID(id));
                     break;
                 case ID::SUBKIND_ATOM_ORDINARYN:
-                    out << registry->onatoms.getByID(id).text;
+                    printOrdinaryAtom(registry->onatoms.getByID(id));
                     break;
                 case ID::SUBKIND_ATOM_BUILTIN:
                 {
@@ -297,6 +297,24 @@ std::string RawPrinter::toString(RegistryPtr reg, ID id)
 
 
 // remove the prefix
+// the text of ordinary atoms is not stored, we generate it from the tuple
+void RawPrinter::printOrdinaryAtom(const OrdinaryAtom& atom)
+{
+    assert(!atom.tuple.empty());
+    print(atom.tuple.front());
+    if( atom.tuple.size() > 1 ) {
+        out << "(";
+        Tuple::const_iterator it = atom.tuple.begin() + 1;
+        print(*it);
+        for(++it; it != atom.tuple.end(); ++it) {
+            out << ",";
+            print(*it);
+        }
+        out << ")";
+    }
+}
+
+
 // from m0___p1__q(a) to q(a)
 std::string RawPrinter::removeModulePrefix(const std::string& text)
 {
@@ -317,8 +335,12 @@ void RawPrinter::printWithoutPrefix(ID id)
         case ID::MAINKIND_ATOM:
             switch(id.kind & ID::SUBKIND_MASK) {
                 case ID::SUBKIND_ATOM_ORDINARYG:
-                    out << removeModulePrefix(registry->ogatoms.getByID(id).text);
-                    break;
+                {
+                    std::ostringstream s;
+                    RawPrinter(s, registry).printOrdinaryAtom(registry->ogatoms.getByID(id));
+                    out << removeModulePrefix(s.str());
+                }
+                break;
                 default:
                     assert(false);
             }
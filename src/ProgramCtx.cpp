@@ -43,6 +43,7 @@
 #include "dlvhex2/PluginContainer.h"
 #include "dlvhex2/State.h"
 #include "dlvhex2/Printer.h"
+#include "dlvhex2/ThreadPool.h"
 //#include "dlvhex2/DLVProcess.h"
 //#include "dlvhex2/EvalHeuristicEasy.h"
 
@@ -54,7 +55,7 @@
 DLVHEX_NAMESPACE_BEGIN
 
 ProgramCtx::ProgramCtx():
-maxint(0), currentOptimumRelevantLevels(0), terminationRequest(false)
+maxint(0), currentOptimumRelevantLevels(0), terminationRequest(false), threadPools(new ThreadPools)
 {
     config.setOption("AllowAggExtCycles",0);
     config.setOption("FLPDecisionCriterionHead", 1);
@@ -63,6 +64,7 @@ maxint(0), currentOptimumRelevantLevels(0), terminationRequest(false)
     config.setOption("UFSCheck", 1);
     config.setOption("UFSCheckMonolithic", 0);
     config.setOption("UFSCheckAssumptionBased", 1);
+    config.setOption("UFSCheckThreads", 0);
     config.setOption("GenuineSolver", 0);
     config.setOption("ExternalLearning", 1);
     config.setOption("UFSLearning", 1);
@@ -74,10 +76,12 @@ maxint(0), currentOptimumRelevantLevels(0), terminationRequest(false)
     config.setOption("ExternalLearningNeg", 1);
     config.setOption("ExternalLearningUser", 1);
     config.setOption("ExternalLearningGeneralize", 0);
+    config.setOption("ExternalLearningReuse", 0);
     config.setOption("AlwaysEvaluateAllExternalAtoms", 0);
     config.setOption("NongroundNogoodInstantiation", 0);
     config.setOption("UFSCheckHeuristics", 0);
     config.setOption("ModelQueueSize", 5);
+    config.setOption("ModelBuilderThreads", 0);
     config.setOption("Silent", 0);
     config.setOption("Verbose", 0);
     config.setOption("UseExtAtomCache",1);
@@ -91,6 +95,7 @@ maxint(0), currentOptimumRelevantLevels(0), terminationRequest(false)
     config.setOption("DumpAttrGraph",0);
     config.setOption("KeepAuxiliaryPredicates",0);
     config.setOption("NoFacts",0);
+    config.setOption("OutputFormat",0);
     config.setOption("NumberOfModels",0);
     config.setOption("RepeatEvaluation",0);
     config.setOption("LegacyECycleDetection",0);
@@ -98,6 +103,9 @@ maxint(0), currentOptimumRelevantLevels(0), terminationRequest(false)
     config.setOption("MLP", 0);
     config.setOption("Forget", 0);
     config.setOption("Split", 0);
+    config.setOption("MLPMemo", 0);
+    config.setStringOption("MLPMemoFile", "");
+    config.setOption("MLPThreads", 0);
     config.setOption("SkipStrongSafetyCheck",0);
     config.setOption("LiberalSafety",1);
     config.setOption("IncludeAuxInputInAuxiliaries",0);
@@ -122,12 +130,25 @@ maxint(0), currentOptimumRelevantLevels(0), terminationRequest(false)
     config.setOption("NoPropagator", 0);
                                  // see --help
     config.setOption("UseConstantSpace", 0);
+    config.setOption("CompactModels", 0);
     config.setOption("ClaspForceSingleThreaded", 0);
     config.setOption("LazyUFSCheckerInitialization", 0);
     config.setOption("SupportSets", 0);
     config.setOption("ForceGC", 0);
     config.setStringOption("PluginDirs", "");
     config.setOption("IncrementalGrounding", 0);
+    config.setOption("PersistentGrounder", 0);
+    config.setOption("ExternalCacheLimit", 0);
+    config.setOption("ParallelExternalEvaluation", 0);
+    config.setOption("SplitSearch", 0);
+    // search policies of the internal solver (see --help)
+    config.setOption("InternalSolverPhaseSaving", 0);
+    config.setOption("InternalSolverRestarts", 0);
+    config.setOption("InternalSolverRestartBase", 100);
+    config.setOption("InternalSolverReduceBase", 0);
+    // read ground facts without the HEX grammar (see --help)
+    config.setOption("FastFactParser", 0);
+    config.setOption("ParserThreads", 1);
 
     // options related to WeakConstraintPlugin (we need to support this in the core for efficiency)
                                  // whether we handle answer set weights
@@ -157,6 +178,9 @@ maxint(0), currentOptimumRelevantLevels(0), terminationRequest(false)
 
 ProgramCtx::~ProgramCtx()
 {
+    DBGLOG(DBG,"releasing thread pools");
+    threadPools.reset();
+
     DBGLOG(DBG,"resetting custom model generator provider");
     if (!!customModelGeneratorProvider) customModelGeneratorProvider.reset();
 
@@ -166,6 +190,7 @@ ProgramCtx::~ProgramCtx()
     DBGLOG(DBG,"resetting callbacks");
     modelCallbacks.clear();
     finalCallbacks.clear();
+    modelBound.reset();
 
     DBGLOG(DBG,"resetting modelBuilder");
     modelBuilder.reset();
@@ -286,6 +311,19 @@ void ProgramCtx::setASPSoftware(ASPSolverManager::SoftwareConfigurationPtr softw
 }
 
 
+ThreadPool& ProgramCtx::getThreadPool(const std::string& purpose, unsigned threads) const
+{
+    assert(!!threadPools);
+    boost::mutex::scoped_lock lock(threadPools->mutex);
+    boost::shared_ptr<ThreadPool>& pool = threadPools->pools[purpose];
+    if( !pool ) {
+        DBGLOG(DBG,"creating thread pool '" << purpose << "' with " << threads << " threads");
+        pool.reset(new ThreadPool(threads));
+    }
+    return *pool;
+}
+
+
 void ProgramCtx::showPlugins() { state->showPlugins(this); }
 void ProgramCtx::convert() { state->convert(this); }
 void ProgramCtx::parse() { state->parse(this); }
@@ -413,6 +451,7 @@ std::vector<InterpretationPtr> ProgramCtx::evaluateSubprogram(ProgramCtx& pc, bo
     DBGLOG(DBG, "Setting AnswerSetCallback");
     pc.modelCallbacks.clear();
     pc.finalCallbacks.clear();
+    pc.modelBound.reset();
     SubprogramAnswerSetCallback* spasc = new SubprogramAnswerSetCallback();
     ModelCallbackPtr spascp = ModelCallbackPtr(spasc);
     pc.modelCallbacks.push_back(spascp);
@@ -451,6 +490,7 @@ void ProgramCtx::addPluginAtom(PluginAtomPtr atom)
     LOG(PLUGIN,"adding PluginAtom '" << predicate << "'");
     if( pluginAtoms.find(predicate) == pluginAtoms.end() ) {
         atom->setRegistry(_registry);
+        atom->setCacheLimit(static_cast<std::size_t>(config.getOption("ExternalCacheLimit")) * 1024 * 1024);
         pluginAtoms[predicate] = atom;
     }
     else {
@@ -490,6 +530,7 @@ void ProgramCtx::addPluginAtomsFromPluginContainer()
             }
             else {
                 pap->setRegistry(registry());
+                pap->setCacheLimit(static_cast<std::size_t>(config.getOption("ExternalCacheLimit")) * 1024 * 1024);
                 pluginAtoms[pred] = pap;
             }
         }
@@ -212,6 +212,10 @@ namespace PythonAPI
     const PluginAtom::Query* emb_query;
     PluginAtom::Answer* emb_answer;
     NogoodContainerPtr emb_nogoods;
+    // batch of queries answered by a single call of the batch helper function, see PythonAtom::retrieveBatch
+    const std::vector<PluginAtom::Query>* emb_batchQueries;
+    std::vector<PluginAtom::Answer>* emb_batchAnswers;
+    const std::vector<NogoodContainerPtr>* emb_batchNogoods;
     std::vector<PluginAtomPtr> *emb_pluginAtoms;
     boost::python::object main;
     boost::python::object dict;
@@ -250,16 +254,7 @@ class PythonAtom : public PluginAtom
                 PythonAPI::emb_answer = &answer;
                 PythonAPI::emb_nogoods = nogoods;
 
-                boost::python::tuple t;
-                DBGLOG(DBG, "Constructing input tuple");
-                for (int i = 0; i < getInputArity(); ++i) {
-                    if (getInputType(i) != TUPLE) t += boost::python::make_tuple(query.input[i]);
-                    else {
-                        boost::python::tuple tupleparameters;
-                        for (int var = i; var < query.input.size(); ++var) tupleparameters += boost::python::make_tuple(query.input[var]);
-                        t += boost::python::make_tuple(tupleparameters);
-                    }
-                }
+                boost::python::tuple t = getInputTuple(query);
 
                 DBGLOG(DBG, "Calling " << getPredicate() << "_caller helper function");
                 PythonAPI::main.attr((getPredicate() + "_caller").c_str())(t);
@@ -273,6 +268,56 @@ class PythonAtom : public PluginAtom
                 PyErr_Print();
             }
         }
+
+        virtual void
+        retrieveBatch(const std::vector<Query>& queries, std::vector<Answer>& answers, const std::vector<NogoodContainerPtr>& nogoods) throw (PluginError) {
+            // one answer per query (constructed separately because copies of an answer share their storage);
+            // queries after an error remain unanswered as in retrieve
+            for (std::size_t i = 0; i < queries.size(); ++i) {
+                answers.push_back(Answer());
+                answers.back().use();
+            }
+
+            try
+            {
+                DBGLOG(DBG, "Preparing Python for " << queries.size() << " queries");
+                boost::python::list inputs;
+                BOOST_FOREACH (const Query& query, queries) inputs.append(getInputTuple(query));
+                PythonAPI::emb_batchQueries = &queries;
+                PythonAPI::emb_batchAnswers = &answers;
+                PythonAPI::emb_batchNogoods = &nogoods;
+
+                // the helper function selects the query of each input by calling back PythonAPI::selectQuery
+                DBGLOG(DBG, "Calling " << getPredicate() << "_batchcaller helper function");
+                PythonAPI::main.attr((getPredicate() + "_batchcaller").c_str())(inputs);
+            }
+            catch(boost::python::error_already_set& e) {
+                PyErr_Print();
+            }
+
+            DBGLOG(DBG, "Resetting Python");
+            PythonAPI::emb_query = NULL;
+            PythonAPI::emb_answer = NULL;
+            PythonAPI::emb_nogoods.reset();
+            PythonAPI::emb_batchQueries = NULL;
+            PythonAPI::emb_batchAnswers = NULL;
+            PythonAPI::emb_batchNogoods = NULL;
+        }
+
+    private:
+        boost::python::tuple getInputTuple(const Query& query) {
+            boost::python::tuple t;
+            DBGLOG(DBG, "Constructing input tuple");
+            for (int i = 0; i < getInputArity(); ++i) {
+                if (getInputType(i) != TUPLE) t += boost::python::make_tuple(query.input[i]);
+                else {
+                    boost::python::tuple tupleparameters;
+                    for (int var = i; var < query.input.size(); ++var) tupleparameters += boost::python::make_tuple(query.input[var]);
+                    t += boost::python::make_tuple(tupleparameters);
+                }
+            }
+            return t;
+        }
 };
 
 namespace PythonAPI
@@ -290,11 +335,20 @@ namespace PythonAPI
         DBGLOG(DBG, "Defining helper function " << name << "_caller(input)");
         for (int i = 0; i < boost::python::len(args); ++i) passargs << (i > 0 ? ", " : "") << "input[" << i << "]";
         boost::python::exec(("def " + name + "_caller(input):\n " + name + "(" + passargs.str() + ")").c_str(), dict, dict);
+        DBGLOG(DBG, "Defining helper function " << name << "_batchcaller(inputs)");
+        boost::python::exec(("def " + name + "_batchcaller(inputs):\n import dlvhex\n for i, input in enumerate(inputs):\n  dlvhex.selectQuery(i)\n  " + name + "(" + passargs.str() + ")").c_str(), dict, dict);
 
         // return smart pointer with deleter (i.e., delete code compiled into this plugin)
         emb_pluginAtoms->push_back(dlvhex::PluginAtomPtr(new PythonAtom(*emb_ctx, "unknown", name, inputParameters, outputArity, prop), PluginPtrDeleter<PluginAtom>()));
     }
 
+    void selectQuery(int i) {
+        if (!emb_batchQueries || i < 0 || i >= (int)emb_batchQueries->size()) throw PluginError("dlvhex.selectQuery: No query with this index");
+        emb_query = &(*emb_batchQueries)[i];
+        emb_answer = &(*emb_batchAnswers)[i];
+        emb_nogoods = (*emb_batchNogoods)[i];
+    }
+
     void addAtom(std::string name, boost::python::tuple args, int outputArity) {
         addAtomWithProperties(name, args, outputArity, dlvhex::ExtSourceProperties());
     }
@@ -882,6 +936,7 @@ BOOST_PYTHON_MODULE(dlvhex)
 {
     boost::python::def("addAtom", PythonAPI::addAtomWithProperties);
     boost::python::def("addAtom", PythonAPI::addAtom);
+    boost::python::def("selectQuery", PythonAPI::selectQuery);
     boost::python::def("getValue", PythonAPI::getValue);
     boost::python::def("getValue", PythonAPI::getValueOfTuple);
     boost::python::def("getExtension", PythonAPI::getExtension);
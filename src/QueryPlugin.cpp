@@ -48,6 +48,7 @@
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/thread/mutex.hpp>
 
 DLVHEX_NAMESPACE_BEGIN
 
@@ -61,7 +62,8 @@ ground(false),
 query(),
 varAuxPred(ID_FAIL),
 novarAuxPred(ID_FAIL),
-allWitnesses(false)
+allWitnesses(false),
+enumerateAllModels(false)
 {
 }
 
@@ -86,7 +88,10 @@ void QueryPlugin::printUsage(std::ostream& o) const
         << "                      Enable or disable the querying plugin (default is disabled)." << std::endl
         << "     --query-brave    Do brave reasoning." << std::endl
         << "     --query-all      Give all witnesses when doing ground reasoning." << std::endl
-        << "     --query-cautious Do cautious reasoning." << std::endl;
+        << "     --query-cautious Do cautious reasoning." << std::endl
+        << "     --query-enumerate" << std::endl
+        << "                      Enumerate all answer sets for nonground queries instead of" << std::endl
+        << "                      pruning those which cannot change the answer." << std::endl;
 }
 
 
@@ -135,6 +140,10 @@ ProgramCtx& ctx)
             ctxdata.allWitnesses = true;
             processed = true;
         }
+        else if( str == "--query-enumerate" ) {
+            ctxdata.enumerateAllModels = true;
+            processed = true;
+        }
 
         if( processed ) {
             // return value of erase: element after it, maybe end()
@@ -299,6 +308,11 @@ namespace
                 LOG(INFO,"created QueryParserModuleGrammar");
                 return grammarModule;
             }
+
+            // queries end with a question mark, which is never the case for ground facts
+            virtual bool mayParseGroundFacts() const {
+                return false;
+            }
     };
 
 }                                // anonymous namespace
@@ -586,6 +600,101 @@ namespace
         }
     }
 
+    // bounds the models of nonground queries by the answers found so far
+    // brave mode: some substitution which was not yet found must become true
+    // cautious mode: some substitution which is still in the intersection must become false
+    // (thus at most one model per substitution is needed until the answer is complete)
+    class QueryModelBound:
+    public ModelBound
+    {
+        public:
+            QueryModelBound(
+                RegistryPtr reg, const CtxData& ctxdata);
+            virtual ~QueryModelBound() {}
+
+            virtual bool getNogood(InterpretationConstPtr programMask, unsigned& version, Nogood& ng);
+
+            // brave mode: add substitutions of the projected model
+            // cautious mode: replace the substitutions by the (projected) intersection
+            void update(InterpretationConstPtr substitutions);
+
+        protected:
+            bool cautious;
+
+            // auxiliary substitution atoms
+            PredicateMask mask;
+
+            // brave mode: substitutions found so far
+            // cautious mode: substitutions in the intersection of all models so far
+            // (null before the first model)
+            InterpretationPtr substitutions;
+            unsigned version;
+
+            boost::mutex mutex;
+    };
+    typedef boost::shared_ptr<QueryModelBound> QueryModelBoundPtr;
+
+    QueryModelBound::QueryModelBound(
+        RegistryPtr reg,
+        const CtxData& ctxdata):
+    cautious(ctxdata.mode == CtxData::CAUTIOUS),
+        substitutions(),
+    version(0) {
+        mask.setRegistry(reg);
+        mask.addPredicate(ctxdata.varAuxPred);
+    }
+
+    bool QueryModelBound::getNogood(
+    InterpretationConstPtr programMask, unsigned& version, Nogood& ng) {
+        boost::mutex::scoped_lock lock(mutex);
+        if( version == this->version )
+            return false;
+        version = this->version;
+        assert(!!substitutions);
+
+        typedef Interpretation::Storage Storage;
+        if( cautious ) {
+            // if a substitution is not in the program, it is false anyway
+            if( substitutions->getStorage().none() ||
+                (substitutions->getStorage() - programMask->getStorage()).any() )
+                return false;
+            for(Storage::enumerator it = substitutions->getStorage().first();
+            it != substitutions->getStorage().end(); ++it) {
+                ng.insert(NogoodContainer::createLiteral(*it, true));
+            }
+        }
+        else {
+            // substitutions are defined in a single evaluation unit,
+            // if the program contains none of them, they are not yet known
+            mask.updateMask();
+            Storage candidates = programMask->getStorage() & mask.mask()->getStorage();
+            if( candidates.none() )
+                return false;
+            candidates -= substitutions->getStorage();
+            for(Storage::enumerator it = candidates.first();
+            it != candidates.end(); ++it) {
+                ng.insert(NogoodContainer::createLiteral(*it, false));
+            }
+        }
+        DBGLOG(DBG,"model bound of version " << version << ": " << ng);
+        return true;
+    }
+
+    void QueryModelBound::update(
+    InterpretationConstPtr substitutions) {
+        boost::mutex::scoped_lock lock(mutex);
+        if( !this->substitutions ) {
+            this->substitutions.reset(new Interpretation(*substitutions));
+        }
+        else if( cautious ) {
+            this->substitutions->getStorage() = substitutions->getStorage();
+        }
+        else {
+            this->substitutions->getStorage() |= substitutions->getStorage();
+        }
+        version++;
+    }
+
     // gets all auxiliary substitution atoms from the model
     // substitutes into the query
     // outputs the query (one line per substitution)
@@ -595,7 +704,8 @@ namespace
     {
         public:
             QuerySubstitutionPrinterCallback(
-                RegistryPtr reg, const CtxData& ctxdata);
+                RegistryPtr reg, const CtxData& ctxdata,
+                QueryModelBoundPtr bound);
             virtual ~QuerySubstitutionPrinterCallback() {}
 
             virtual bool operator()(AnswerSetPtr model);
@@ -609,6 +719,9 @@ namespace
         protected:
             const CtxData& ctxdata;
 
+            // bound to update after each model (null if all models are enumerated)
+            QueryModelBoundPtr bound;
+
             // incrementally managed ground atom projection helper
             PredicateMask mask;
 
@@ -622,8 +735,10 @@ namespace
 
     QuerySubstitutionPrinterCallback::QuerySubstitutionPrinterCallback(
         RegistryPtr reg,
-        const CtxData& ctxdata):
-    ctxdata(ctxdata) {
+        const CtxData& ctxdata,
+        QueryModelBoundPtr bound):
+    ctxdata(ctxdata),
+    bound(bound) {
         mask.setRegistry(reg);
         mask.addPredicate(ctxdata.varAuxPred);
 
@@ -650,6 +765,8 @@ namespace
         DBGLOG(DBG,"projected model to " << *model->interpretation);
 
         printAllSubstitutions(std::cout, model->interpretation);
+        if( !!bound )
+            bound->update(model->interpretation);
 
         // never abort
         return true;
@@ -721,14 +838,14 @@ namespace
         it != bits.end(); ++it) {
             // build substitution tuple
             const OrdinaryAtom& ogatom = reg->ogatoms.getByAddress(*it);
-            DBGLOG(DBG,"got auxiliary " << ogatom.text);
+            DBGLOG(DBG,"got auxiliary " << printToString<RawPrinter>(ID(ogatom.kind, *it), reg));
             assert(ogatom.tuple.size() > 1);
             Tuple subst(ogatom.tuple.begin()+1, ogatom.tuple.end());
             assert(!subst.empty());
 
             // discard duplicates
             if( printedSubstitutions.find(subst) != printedSubstitutions.end() ) {
-                LOG(DBG,"discarded duplicate substitution from auxiliary atom " << ogatom.text);
+                LOG(DBG,"discarded duplicate substitution from auxiliary atom " << printToString<RawPrinter>(ID(ogatom.kind, *it), reg));
                 continue;
             }
 
@@ -749,6 +866,7 @@ namespace
         public:
             IntersectedQuerySubstitutionPrinterCallback(
                 RegistryPtr reg, const CtxData& ctxdata,
+                QueryModelBoundPtr bound,
                 bool printPreliminaryModels);
             virtual ~IntersectedQuerySubstitutionPrinterCallback() {}
 
@@ -767,8 +885,9 @@ namespace
     IntersectedQuerySubstitutionPrinterCallback::IntersectedQuerySubstitutionPrinterCallback(
         RegistryPtr reg,
         const CtxData& ctxdata,
+        QueryModelBoundPtr bound,
         bool printPreliminaryModels):
-    QuerySubstitutionPrinterCallback(reg, ctxdata),
+    QuerySubstitutionPrinterCallback(reg, ctxdata, bound),
     // do not create it here!
         cachedInterpretation(),
     printPreliminaryModels(printPreliminaryModels) {
@@ -824,6 +943,9 @@ namespace
             printAllSubstitutions(std::cerr, cachedInterpretation);
         }
 
+        if( changed && !!bound )
+            bound->update(cachedInterpretation);
+
         // abort iff cached interpretation contains no bits -> no more substitutions cautiously entailed
         if( cachedInterpretation->getStorage().none() ) {
             // abort
@@ -925,10 +1047,17 @@ void QueryPlugin::setupProgramCtx(ProgramCtx& ctx)
         ctx.finalCallbacks.push_back(fprinter);
     }
     else {
+        // prune models which cannot change the answer
+        QueryModelBoundPtr bound;
+        if( !ctxdata.enumerateAllModels ) {
+            bound.reset(new QueryModelBound(reg, ctxdata));
+            ctx.modelBound = bound;
+        }
+
         switch(ctxdata.mode) {
             case CtxData::BRAVE:
             {
-                ModelCallbackPtr qsprinter(new QuerySubstitutionPrinterCallback(reg, ctxdata));
+                ModelCallbackPtr qsprinter(new QuerySubstitutionPrinterCallback(reg, ctxdata, bound));
                 WARNING("here we could try to only remove the default answer set printer")
                     ctx.modelCallbacks.clear();
                 ctx.modelCallbacks.push_back(qsprinter);
@@ -939,7 +1068,7 @@ void QueryPlugin::setupProgramCtx(ProgramCtx& ctx)
                 bool printPreliminaryModels = !ctx.config.getOption("Silent");
                 IntersectedQuerySubstitutionPrinterCallbackPtr iqsprinter(
                     new IntersectedQuerySubstitutionPrinterCallback(
-                    reg, ctxdata, printPreliminaryModels));
+                    reg, ctxdata, bound, printPreliminaryModels));
                 WARNING("here we could try to only remove the default answer set printer")
                     ctx.modelCallbacks.clear();
                 ctx.modelCallbacks.push_back(iqsprinter);
@@ -49,6 +49,8 @@
 #include <boost/foreach.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/bimap/bimap.hpp>
+#include <boost/thread/mutex.hpp>
+#include <cstdlib>
 
 DLVHEX_NAMESPACE_BEGIN
 
@@ -136,14 +138,25 @@ struct Registry::Impl
     PredicateMaskPtr auxGroundAtomMask;
     std::list<AuxPrinterPtr> auxPrinters;
     AuxPrinterPtr defaultAuxPrinter;
+    /** \brief Protects auxSymbols, which may be extended by concurrently running solvers. */
+    boost::mutex auxSymbolsMutex;
 
     Impl():
     auxGroundAtomMask(new PredicateMask) {}
+
+    // must not copy mutex!
+    Impl(const Impl& other):
+    auxSymbols(other.auxSymbols),
+    auxGroundAtomMask(other.auxGroundAtomMask),
+    auxPrinters(other.auxPrinters),
+    defaultAuxPrinter(other.defaultAuxPrinter) {}
 };
 
 Registry::Registry():
 pimpl(new Impl)
 {
+    ogatoms.setRegistry(this);
+    onatoms.setRegistry(this);
     // do not initialize pimpl->auxGroundAtomMask here! (we can do this only outside of the constructor)
 }
 
@@ -164,6 +177,8 @@ moduleTable(other.moduleTable),
 inputList(other.inputList),
 pimpl(new Impl(*other.pimpl))
 {
+    ogatoms.setRegistry(this);
+    onatoms.setRegistry(this);
     // do not initialize pimpl->auxGroundAtomMask here! (we can do this only outside of the constructor)
 }
 
@@ -207,6 +222,72 @@ std::ostream& ExternalAtomTable::print(std::ostream& o, RegistryPtr reg) const t
 }
 
 
+// implementation from OrdinaryAtomTable.hpp
+ID OrdinaryAtomTable::getIDByString(const std::string& str) const throw()
+{
+    if( registry == 0 || str.empty() )
+        return ID_FAIL;
+
+    // split the text into the predicate and the arguments at the top-level commas
+    // (nested terms and quoted strings may contain commas and parentheses)
+    std::vector<std::string> symbols;
+    std::string::size_type begin = 0;
+    std::string::size_type pos = str.find('(');
+    if( pos == std::string::npos ) {
+        symbols.push_back(str);
+    }
+    else {
+        if( str[str.size() - 1] != ')' )
+            return ID_FAIL;
+        symbols.push_back(str.substr(0, pos));
+        begin = pos + 1;
+        int depth = 0;
+        bool quoted = false;
+        for(pos = begin; pos < str.size() - 1; ++pos) {
+            const char c = str[pos];
+            if( quoted ) {
+                if( c == '\\' ) ++pos;
+                else if( c == '"' ) quoted = false;
+            }
+            else if( c == '"' ) quoted = true;
+            else if( c == '(' ) ++depth;
+            else if( c == ')' ) --depth;
+            else if( c == ',' && depth == 0 ) {
+                symbols.push_back(str.substr(begin, pos - begin));
+                begin = pos + 1;
+            }
+        }
+        symbols.push_back(str.substr(begin, str.size() - 1 - begin));
+    }
+
+    // look up the terms of the tuple, this never stores anything
+    Tuple tuple(symbols.size());
+    for(unsigned i = 1; i < symbols.size(); ++i) {
+        const std::string& sym = symbols[i];
+        if( !sym.empty() && sym.find_first_not_of("0123456789") == std::string::npos ) {
+            tuple[i] = ID::termFromInteger(static_cast<uint32_t>(std::strtoul(sym.c_str(), 0, 10)));
+        }
+        else {
+            tuple[i] = registry->terms.getIDByString(sym);
+            if( tuple[i] == ID_FAIL )
+                return ID_FAIL;
+        }
+    }
+
+    // the predicate is stored as constant or as predicate term
+    const ID predicates[2] = { registry->terms.getIDByString(symbols[0]), registry->preds.getIDByString(symbols[0]) };
+    for(unsigned i = 0; i < 2; ++i) {
+        if( predicates[i] == ID_FAIL )
+            continue;
+        tuple[0] = predicates[i];
+        ID id = getIDByTuple(tuple);
+        if( id != ID_FAIL )
+            return id;
+    }
+    return ID_FAIL;
+}
+
+
                                  //const
 std::ostream& Registry::print(std::ostream& o)
 {
@@ -416,7 +497,7 @@ ID Registry::replaceVariablesInTerm(const ID term, const ID var, const ID by)
 
     DBGLOG(DBG, "Replacing variable in term " << term << ": " << var << " --> " << by);
     if ((term.kind & ID::SUBKIND_MASK) == ID::SUBKIND_TERM_VARIABLE) {
-        return (term == var ? by : var);
+        return (term == var ? by : term);
     }
     else if ((term.kind & ID::SUBKIND_MASK) == ID::SUBKIND_TERM_CONSTANT || (term.kind & ID::SUBKIND_MASK) == ID::SUBKIND_TERM_PREDICATE || (term.kind & ID::SUBKIND_MASK) == ID::SUBKIND_TERM_INTEGER || (term.kind & ID::SUBKIND_MASK) == ID::SUBKIND_TERM_BUILTIN) {
         return term;
@@ -457,27 +538,15 @@ ID Registry::getPredicateOfAtom(ID atom)
 namespace
 {
     // assume, that oatom.id and oatom.tuple is initialized!
-    // assume, that oatom.text is not initialized!
-    // oatom.text will be modified
     ID storeOrdinaryAtomHelper(
         Registry* reg,
         OrdinaryAtom& oatom,
     OrdinaryAtomTable& oat) {
+        // most atoms exist already, look them up under the shared lock first
         ID ret = oat.getIDByTuple(oatom.tuple);
         if( ret == ID_FAIL ) {
-            // text
-            std::stringstream s;
-            RawPrinter printer(s, reg);
-            // predicate
-            printer.print(oatom.tuple.front());
-            if( oatom.tuple.size() > 1 ) {
-                Tuple t(oatom.tuple.begin()+1, oatom.tuple.end());
-                s << "(";
-                printer.printmany(t,",");
-                s << ")";
-            }
-            oatom.text = s.str();
-
+            // looks up the tuple again and stores the atom under the same write lock
+            // (the unique tuple index yields the existing atom if another thread stored it meanwhile)
             ret = oat.storeAndGetID(oatom);
             DBGLOG(DBG,"stored oatom " << oatom << " which got " << ret);
         }
@@ -636,6 +705,7 @@ ID Registry::getAuxiliaryConstantSymbol(char type, ID id)
 
     // lookup auxiliary
     AuxiliaryKey key(type,id);
+    boost::mutex::scoped_lock lock(pimpl->auxSymbolsMutex);
     AuxiliaryStorage::left_const_iterator it =
         pimpl->auxSymbols.left.find(key);
     if( it != pimpl->auxSymbols.left.end() ) {
@@ -684,6 +754,7 @@ ID Registry::getAuxiliaryVariableSymbol(char type, ID id)
 
     // lookup auxiliary
     AuxiliaryKey key(type,id);
+    boost::mutex::scoped_lock lock(pimpl->auxSymbolsMutex);
     AuxiliaryStorage::left_const_iterator it =
         pimpl->auxSymbols.left.find(key);
     if( it != pimpl->auxSymbols.left.end() ) {
@@ -745,6 +816,7 @@ ID Registry::getIDByAuxiliaryConstantSymbol(ID auxConstantID) const
 
     // lookup ID of auxiliary
     DBGLOG(DBG,"getIDByAuxiliaryConstantSymbol for " << auxConstantID);
+    boost::mutex::scoped_lock lock(pimpl->auxSymbolsMutex);
     AuxiliaryStorage::right_const_iterator it =
         pimpl->auxSymbols.right.find(AuxiliaryValue("", auxConstantID));
     if( it != pimpl->auxSymbols.right.end() ) {
@@ -764,6 +836,7 @@ ID Registry::getIDByAuxiliaryVariableSymbol(ID auxVariableID) const
 
     // lookup ID of auxiliary
     DBGLOG(DBG,"getIDByAuxiliaryVariableSymbol for " << auxVariableID);
+    boost::mutex::scoped_lock lock(pimpl->auxSymbolsMutex);
     AuxiliaryStorage::right_const_iterator it =
         pimpl->auxSymbols.right.find(AuxiliaryValue("", auxVariableID));
     if( it != pimpl->auxSymbols.right.end() ) {
@@ -818,6 +891,7 @@ char Registry::getTypeByAuxiliaryConstantSymbol(ID auxConstantID) const
 
     // lookup ID of auxiliary
     DBGLOG(DBG,"getTypeByAuxiliaryConstantSymbol for " << auxConstantID);
+    boost::mutex::scoped_lock lock(pimpl->auxSymbolsMutex);
     AuxiliaryStorage::right_const_iterator it =
         pimpl->auxSymbols.right.find(AuxiliaryValue("", auxConstantID));
     if( it != pimpl->auxSymbols.right.end() ) {
@@ -868,7 +942,8 @@ bool Registry::printAtomForUser(std::ostream& o, IDAddress address, const std::s
     if( !getAuxiliaryGroundAtomMask()->getFact(address) ) {
         // fast direct output
         if (ogatoms.getIDByAddress(address).isHiddenAtom()) return false;
-        o << prefix << ogatoms.getByAddress(address).text;
+        o << prefix;
+        RawPrinter(o, this).printOrdinaryAtom(ogatoms.getByAddress(address));
         return true;
     }
     else {
@@ -340,6 +340,9 @@ void MLPSolverState::mlpSolver(ProgramCtx* ctx)
     m.setPrintLevel(ctx->config.getOption("Verbose"));
     m.setForget(ctx->config.getOption("Forget"));
     m.setInstSplitting(ctx->config.getOption("Split"));
+    m.setMemoization(ctx->config.getOption("MLPMemo"));
+    m.setMemoFile(ctx->config.getStringOption("MLPMemoFile"));
+    m.setThreads(ctx->config.getOption("MLPThreads"));
     m.solve();
     #endif
     StatePtr next(new PostProcessState);
@@ -685,6 +688,9 @@ namespace
             ModelBuilderConfig<FinalEvalGraph> cfg(*ctx->evalgraph);
             cfg.redundancyElimination = true;
             cfg.constantSpace = ctx->config.getOption("UseConstantSpace") == 1;
+            cfg.compactModels = ctx->config.getOption("CompactModels") == 1;
+            cfg.workerThreads = ctx->config.getOption("ModelBuilderThreads");
+            cfg.optimization = ctx->config.getOption("Optimization") == 1;
             ctx->modelBuilder = ModelBuilderPtr(ctx->modelBuilderFactory(cfg));
         }
         return *ctx->modelBuilder;
@@ -732,7 +738,7 @@ namespace
             if( !!om ) {
                 Model m = om.get();
                 InterpretationConstPtr interpretation =
-                    mb.getModelGraph().propsOf(m).interpretation;
+                    mb.getModelGraph().propsOf(m).getInterpretation();
 
                 // if the program is empty, we may get a NULL interpretation
                 if( !interpretation ) {
@@ -796,7 +802,7 @@ namespace
             if( !!om ) {
                 Model m = om.get();
                 InterpretationConstPtr interpretation =
-                    mb.getModelGraph().propsOf(m).interpretation;
+                    mb.getModelGraph().propsOf(m).getInterpretation();
 
                 // if the program is empty, we may get a NULL interpretation
                 if( !interpretation ) {
@@ -871,7 +877,7 @@ namespace
             if( !!om ) {
                 Model m = om.get();
                 InterpretationConstPtr interpretation =
-                    mb.getModelGraph().propsOf(m).interpretation;
+                    mb.getModelGraph().propsOf(m).getInterpretation();
                 // if the program is empty, we may get a NULL interpretation
                 if( !interpretation ) {
                     assert(mb.getModelGraph().propsOf(m).dummy == true);
@@ -299,6 +299,11 @@ namespace
                 LOG(INFO,"created StrongNegationParserModuleGrammar");
                 return grammarModule;
             }
+
+            // strongly negated atoms start with a minus, which is never the case for ground facts
+            virtual bool mayParseGroundFacts() const {
+                return false;
+            }
     };
 
 }                                // anonymous namespace
@@ -0,0 +1,213 @@
+/* dlvhex -- Answer-Set Programming with external interfaces.
+ * Copyright (C) 2005-2007 Roman Schindlauer
+ * Copyright (C) 2006-2015 Thomas Krennwallner
+ * Copyright (C) 2009-2015 Peter Schüller
+ * Copyright (C) 2011-2015 Christoph Redl
+ *
+ * This file is part of dlvhex.
+ *
+ * dlvhex is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * dlvhex is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with dlvhex; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+/**
+ * @file   ThreadPool.cpp
+ *
+ * @brief  Fixed-size pool of worker threads for concurrent evaluation tasks.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif                           // HAVE_CONFIG_H
+
+#include "dlvhex2/ThreadPool.h"
+#include "dlvhex2/Logger.h"
+#include "dlvhex2/Error.h"
+
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+
+#include <string>
+
+DLVHEX_NAMESPACE_BEGIN
+
+ThreadPool::ThreadPool(unsigned threads):
+threads(threads),
+running(0),
+shutdown(false)
+{
+    if( this->threads == 0 )
+        this->threads = boost::thread::hardware_concurrency();
+    if( this->threads == 0 )
+        this->threads = 1;
+    DBGLOG(DBG, "starting thread pool with " << this->threads << " workers");
+    for (unsigned i = 0; i < this->threads; ++i)
+        workerIds.insert(workers.create_thread(boost::bind(&ThreadPool::work, this))->get_id());
+}
+
+
+ThreadPool::~ThreadPool()
+{
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        shutdown = true;
+    }
+    taskAvailable.notify_all();
+    workers.join_all();
+}
+
+
+void ThreadPool::schedule(const Task& task)
+{
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        assert(!shutdown && "cannot schedule tasks on a terminating thread pool");
+        tasks.push_back(task);
+    }
+    taskAvailable.notify_one();
+}
+
+
+void ThreadPool::wait()
+{
+    boost::mutex::scoped_lock lock(mutex);
+    while( !tasks.empty() || running > 0 )
+        taskDone.wait(lock);
+}
+
+
+namespace
+{
+    // completion state of one batch executed by ThreadPool::run
+    struct Batch
+    {
+        boost::mutex mutex;
+        boost::condition_variable done;
+        unsigned pending;
+        // message of the first exception thrown by a task of the batch
+        bool failed;
+        std::string error;
+    };
+
+    // executes a task of a batch and signals its completion (also if it throws)
+    struct BatchTask
+    {
+        ThreadPool::Task task;
+        Batch* batch;
+
+        BatchTask(const ThreadPool::Task& task, Batch* batch): task(task), batch(batch) {}
+
+        struct Completion
+        {
+            Batch* batch;
+            Completion(Batch* batch): batch(batch) {}
+            ~Completion() {
+                boost::mutex::scoped_lock lock(batch->mutex);
+                if( --batch->pending == 0 )
+                    batch->done.notify_all();
+            }
+        };
+
+        void fail(const std::string& error) {
+            boost::mutex::scoped_lock lock(batch->mutex);
+            if( !batch->failed ) {
+                batch->failed = true;
+                batch->error = error;
+            }
+        }
+
+        void operator()() {
+            Completion completion(batch);
+            try
+            {
+                task();
+            }
+            catch(const std::exception& e) {
+                fail(e.what());
+            }
+            catch(...) {
+                fail("unknown exception");
+            }
+        }
+    };
+}
+
+
+void ThreadPool::run(const std::vector<Task>& batch, const Task& callerTask)
+{
+    Batch state;
+    state.pending = batch.size() + (callerTask.empty() ? 0 : 1);
+    state.failed = false;
+
+    if( state.pending < 2 || workerIds.count(boost::this_thread::get_id()) > 0 ) {
+        // not worth a context switch or called from one of our workers
+        if( !callerTask.empty() ) BatchTask(callerTask, &state)();
+        BOOST_FOREACH (const Task& task, batch) BatchTask(task, &state)();
+    }
+    else {
+        BOOST_FOREACH (const Task& task, batch) schedule(BatchTask(task, &state));
+        if( !callerTask.empty() ) BatchTask(callerTask, &state)();
+
+        boost::mutex::scoped_lock lock(state.mutex);
+        while( state.pending > 0 )
+            state.done.wait(lock);
+    }
+
+    if( state.failed )
+        throw GeneralError(state.error);
+}
+
+
+void ThreadPool::work()
+{
+    while( true ) {
+        Task task;
+        {
+            boost::mutex::scoped_lock lock(mutex);
+            while( tasks.empty() && !shutdown )
+                taskAvailable.wait(lock);
+            // pending tasks are executed also during shutdown
+            if( tasks.empty() )
+                return;
+            task = tasks.front();
+            tasks.pop_front();
+            running++;
+        }
+
+        try
+        {
+            task();
+        }
+        catch(const std::exception& e) {
+            LOG(ERROR, "thread pool task terminated with exception: " << e.what());
+        }
+        catch(...) {
+            LOG(ERROR, "thread pool task terminated with unknown exception");
+        }
+
+        {
+            boost::mutex::scoped_lock lock(mutex);
+            running--;
+        }
+        taskDone.notify_all();
+    }
+}
+
+
+DLVHEX_NAMESPACE_END
+
+// vim:expandtab:ts=4:sw=4:
+// mode: C++
+// End:
@@ -40,12 +40,15 @@
 #include "dlvhex2/Printer.h"
 #include "dlvhex2/Benchmarking.h"
 #include "dlvhex2/ClaspSolver.h"
+#include "dlvhex2/ThreadPool.h"
 
 #include <boost/graph/graph_traits.hpp>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/breadth_first_search.hpp>
 #include <boost/graph/visitors.hpp>
 #include <boost/graph/strong_components.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
 
 #include <fstream>
 
@@ -1193,6 +1196,18 @@ std::vector<IDAddress> EncodingBasedUnfoundedSetChecker::getUnfoundedSet(Interpr
 }
 
 
+InterpretationPtr EncodingBasedUnfoundedSetChecker::saveState() const
+{
+    return InterpretationPtr(new Interpretation(*domain));
+}
+
+
+void EncodingBasedUnfoundedSetChecker::restoreState(InterpretationConstPtr state)
+{
+    *domain = *state;
+}
+
+
 /*
  * AssumptionBasedUnfoundedSetChecker
  *
@@ -2264,6 +2279,136 @@ void UnfoundedSetCheckerManager::learnNogoodsFromMainSearch(bool reset)
 }
 
 
+namespace
+{
+    // returns the pool for concurrent unfounded set checks (or NULL if components are checked sequentially)
+    ThreadPool* getUnfoundedSetCheckPool(const ProgramCtx& ctx)
+    {
+        const unsigned threads = ctx.config.getOption("UFSCheckThreads");
+        if (threads == 0) return 0;
+        return &ctx.getThreadPool("UnfoundedSetCheck", threads);
+    }
+
+    // checks a component unless a component with a smaller index is already known to contain an unfounded set
+    void checkComponent(UnfoundedSetCheckerPtr ufsc, int comp,
+        InterpretationConstPtr interpretation, const std::set<ID>& skipProgram,
+        std::vector<IDAddress>& ufs, boost::atomic<int>& firstUFSComponent)
+    {
+        if (firstUFSComponent.load() < comp) {
+            DBGLOG(DBG, "Cancelling UFS check of component " << comp);
+            return;
+        }
+        DBGLOG(DBG, "Checking for UFS in component " << comp);
+        ufs = ufsc->getUnfoundedSet(interpretation, skipProgram);
+        if (ufs.size() > 0) {
+            DBGLOG(DBG, "Found a UFS in component " << comp);
+            int first = firstUFSComponent.load();
+            while (comp < first && !firstUFSComponent.compare_exchange_weak(first, comp));
+        }
+    }
+}
+
+
+UnfoundedSetCheckerPtr UnfoundedSetCheckerManager::getUnfoundedSetCheckerForComponent(int comp, bool withExternals)
+{
+    std::map<int, UnfoundedSetCheckerPtr>::const_iterator it = preparedUnfoundedSetCheckers.find(comp);
+    if (it != preparedUnfoundedSetCheckers.end()) return it->second;
+
+    UnfoundedSetCheckerPtr ufsc;
+    if (withExternals) {
+        ufsc = instantiateUnfoundedSetChecker(*mg, ctx, agp.getProgramOfComponent(comp), agp, agp.getAtomsOfComponent(comp), ngc);
+    }
+    else {
+        ufsc = instantiateUnfoundedSetChecker(ctx, agp.getProgramOfComponent(comp), agp.getAtomsOfComponent(comp), ngc);
+    }
+    preparedUnfoundedSetCheckers.insert(std::pair<int, UnfoundedSetCheckerPtr>(comp, ufsc));
+    return ufsc;
+}
+
+
+std::vector<IDAddress> UnfoundedSetCheckerManager::getUnfoundedSetConcurrently(
+ThreadPool& pool,
+InterpretationConstPtr interpretation,
+const std::set<ID>& skipProgram,
+const std::vector<int>& components)
+{
+    DLVHEX_BENCHMARK_REGISTER_AND_SCOPE(sid, "UnfoundedSetChkMgr::getUFS concurrently");
+    bool flpdc_e = (ctx.config.getOption("FLPDecisionCriterionE") != 0);
+
+    // checks which evaluate external atoms are not run concurrently because
+    // external sources need not be thread-safe and they add learned nogoods to ngc
+    std::vector<int> concurrentComponents, sequentialComponents;
+    std::vector<UnfoundedSetCheckerPtr> checkers;
+    std::vector<InterpretationPtr> states;
+    BOOST_FOREACH (int comp, components) {
+        if (mg && (agp.hasECycles(comp) || !flpdc_e)) {
+            sequentialComponents.push_back(comp);
+            continue;
+        }
+
+        // checkers are instantiated here because this modifies preparedUnfoundedSetCheckers
+        UnfoundedSetCheckerPtr ufsc = getUnfoundedSetCheckerForComponent(comp, false);
+
+        // the first component is checked in any case, the checks of the others are undone if they are not needed
+        InterpretationPtr state;
+        if (comp != components.front()) {
+            state = ufsc->saveState();
+            if (!state) {
+                sequentialComponents.push_back(comp);
+                continue;
+            }
+        }
+        concurrentComponents.push_back(comp);
+        checkers.push_back(ufsc);
+        states.push_back(state);
+    }
+
+    boost::atomic<int> firstUFSComponent(agp.getComponentCount());
+    std::vector<std::vector<IDAddress> > ufsOfComponent(concurrentComponents.size());
+    std::vector<ThreadPool::Task> tasks;
+    for (std::size_t i = 0; i < concurrentComponents.size(); ++i) {
+        tasks.push_back(boost::bind(&checkComponent, checkers[i], concurrentComponents[i],
+            interpretation, boost::cref(skipProgram), boost::ref(ufsOfComponent[i]), boost::ref(firstUFSComponent)));
+    }
+    DBGLOG(DBG, "Checking " << tasks.size() << " components concurrently");
+    if (tasks.size() == 1) tasks[0]();
+    else if (tasks.size() > 1) pool.run(tasks);
+
+    int ufsComponent = firstUFSComponent.load();
+    std::vector<IDAddress> ufs;
+    for (std::size_t i = 0; i < concurrentComponents.size(); ++i) {
+        if (concurrentComponents[i] == ufsComponent) ufs = ufsOfComponent[i];
+    }
+
+    // components which are not checked concurrently and precede the first component with a UFS
+    BOOST_FOREACH (int comp, sequentialComponents) {
+        if (comp > ufsComponent) break;
+        bool withExternals = mg && (agp.hasECycles(comp) || !flpdc_e);
+        DBGLOG(DBG, "Checking for UFS in component " << comp << (withExternals ? " under consideration of external atoms" : ""));
+        std::vector<IDAddress> sufs = getUnfoundedSetCheckerForComponent(comp, withExternals)->getUnfoundedSet(interpretation, skipProgram);
+        if (sufs.size() > 0) {
+            ufs = sufs;
+            ufsComponent = comp;
+            break;
+        }
+    }
+
+    // undo the checks which a sequential check would not have done
+    for (std::size_t i = 0; i < concurrentComponents.size(); ++i) {
+        if (concurrentComponents[i] > ufsComponent) {
+            DBGLOG(DBG, "Restoring the state of the UFS checker of component " << concurrentComponents[i]);
+            checkers[i]->restoreState(states[i]);
+        }
+    }
+
+    if (ufs.size() > 0) {
+        DBGLOG(DBG, "Found a UFS in component " << ufsComponent);
+        ufsnogood = preparedUnfoundedSetCheckers.find(ufsComponent)->second->getUFSNogood(ufs, interpretation);
+    }
+    return ufs;
+}
+
+
 std::vector<IDAddress> UnfoundedSetCheckerManager::getUnfoundedSet(
 InterpretationConstPtr interpretation,
 const std::set<ID>& skipProgram,
@@ -2325,44 +2470,32 @@ SimpleNogoodContainerPtr ngc)
 
         // search in each component for unfounded sets
         DBGLOG(DBG, "UnfoundedSetCheckerManager::getUnfoundedSet component-wise");
+        ThreadPool* pool = getUnfoundedSetCheckPool(ctx);
+        std::vector<int> components;
         for (int comp = 0; comp < agp.getComponentCount(); ++comp) {
             if ((!agp.hasHeadCycles(comp) && flpdc_head) && !intersectsWithNonHCFDisjunctiveRules[comp] && (!mg || !agp.hasECycles(comp) && flpdc_e)) {
                 DBGLOG(DBG, "Skipping component " << comp << " because it contains neither head-cycles nor e-cycles");
                 continue;
             }
+            if (!!pool) {
+                components.push_back(comp);
+                continue;
+            }
 
             DBGLOG(DBG, "Checking for UFS in component " << comp);
-            if (mg && (agp.hasECycles(comp) || !flpdc_e)) {
-                DBGLOG(DBG, "Checking UFS under consideration of external atoms");
-                if (preparedUnfoundedSetCheckers.find(comp) == preparedUnfoundedSetCheckers.end()) {
-                    preparedUnfoundedSetCheckers.insert(std::pair<int, UnfoundedSetCheckerPtr>
-                        (comp, instantiateUnfoundedSetChecker(*mg, ctx, agp.getProgramOfComponent(comp), agp, agp.getAtomsOfComponent(comp), ngc))
-                        );
-                }
-                UnfoundedSetCheckerPtr ufsc = preparedUnfoundedSetCheckers.find(comp)->second;
-                ufs = ufsc->getUnfoundedSet(interpretation, skipProgram);
-                if (ufs.size() > 0) {
-                    DBGLOG(DBG, "Found a UFS");
-                    ufsnogood = ufsc->getUFSNogood(ufs, interpretation);
-                    break;
-                }
-            }
-            else {
-                DBGLOG(DBG, "Checking UFS without considering external atoms");
-                if (preparedUnfoundedSetCheckers.find(comp) == preparedUnfoundedSetCheckers.end()) {
-                    preparedUnfoundedSetCheckers.insert(std::pair<int, UnfoundedSetCheckerPtr>
-                        (comp, instantiateUnfoundedSetChecker(ctx, agp.getProgramOfComponent(comp), agp.getAtomsOfComponent(comp), ngc))
-                        );
-                }
-                UnfoundedSetCheckerPtr ufsc = preparedUnfoundedSetCheckers.find(comp)->second;
-                ufs = ufsc->getUnfoundedSet(interpretation, skipProgram);
-                if (ufs.size() > 0) {
-                    DBGLOG(DBG, "Found a UFS");
-                    ufsnogood = ufsc->getUFSNogood(ufs, interpretation);
-                    break;
-                }
+            bool withExternals = mg && (agp.hasECycles(comp) || !flpdc_e);
+            DBGLOG(DBG, "Checking UFS " << (withExternals ? "under consideration of" : "without considering") << " external atoms");
+            UnfoundedSetCheckerPtr ufsc = getUnfoundedSetCheckerForComponent(comp, withExternals);
+            ufs = ufsc->getUnfoundedSet(interpretation, skipProgram);
+            if (ufs.size() > 0) {
+                DBGLOG(DBG, "Found a UFS");
+                ufsnogood = ufsc->getUFSNogood(ufs, interpretation);
+                break;
             }
         }
+        if (!!pool && components.size() > 0) {
+            ufs = getUnfoundedSetConcurrently(*pool, interpretation, skipProgram, components);
+        }
     }
 
     // no ufs found
@@ -148,6 +148,7 @@
 #include "dlvhex2/UnfoundedSetCheckHeuristics.h"
 #include "dlvhex2/OnlineModelBuilder.h"
 #include "dlvhex2/OfflineModelBuilder.h"
+#include "dlvhex2/ParallelModelBuilder.h"
 
 // internal plugins
 #include "dlvhex2/QueryPlugin.h"
@@ -180,6 +181,7 @@
 #include <boost/tokenizer.hpp>
 #include <boost/foreach.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/thread/thread.hpp>
 
 #include <iostream>
 #include <sstream>
@@ -240,6 +242,12 @@ printUsage(std::ostream &out, const char* whoAmI, bool full)
         << " -f, --filter=foo[,bar[,...]]" << std::endl
         << "                      Only display instances of the specified predicate(s)." << std::endl
         << "     --nofacts        Do not output EDB facts." << std::endl
+        << "     --outputformat=[text,ndjson]" << std::endl
+        << "                      Output format of answer sets." << std::endl
+        << "                         text (default)   : One answer set per line in the form {atom,...}" << std::endl
+        << "                         ndjson           : One JSON object per line; each atom is printed once as" << std::endl
+        << "                                            {\"atom\":N,\"symbol\":\"...\"} before the first answer set" << std::endl
+        << "                                            {\"answerset\":[N,...]} that contains it (implies --silent)." << std::endl
         << " -n, --number=<num>   Limit number of displayed models to <num>, 0 (default) means all." << std::endl
         << " -N, --maxint=<num>   Set maximum integer (#maxint in the program takes precedence over the parameter)." << std::endl
         << "     --weaksafety     Skip strong safety check." << std::endl
@@ -248,7 +256,16 @@ printUsage(std::ostream &out, const char* whoAmI, bool full)
         << "     --mlp            Use dlvhex+mlp solver (modular nonmonotonic logic programs)." << std::endl
         << "     --forget         Forget previous instantiations that are not involved in current computation (mlp setting)." << std::endl
         << "     --split          Use instantiation splitting techniques." << std::endl
+        << "     --mlpmemo[=FILE] Reuse the answer sets of module instantiations which are solved again with the same input" << std::endl
+        << "                      (mlp setting); if FILE is given, they are loaded from and saved to FILE." << std::endl
+        << "     --mlpthreads[=N] Explore the value calls using N threads (mlp setting; default: number of cores;" << std::endl
+        << "                      only with --solver=dlv)." << std::endl
         << "     --noeval         Just parse the program, don't evaluate it (only useful with --verbose)." << std::endl
+        << "     --fastfacts      Parse ground facts with a dedicated parser instead of the full HEX grammar" << std::endl
+        << "                      (default: disabled; not used if a plugin might parse facts itself)." << std::endl
+        << "     --parserthreads[=N]" << std::endl
+        << "                      Scan large inputs for facts using N threads (only with --fastfacts;" << std::endl
+        << "                      default: number of cores)." << std::endl
         << "     --keepnsprefix   Keep specified namespace-prefixes in the result." << std::endl
         << "     --keepauxpreds   Keep auxiliary predicates in answer sets." << std::endl
 
@@ -259,7 +276,7 @@ printUsage(std::ostream &out, const char* whoAmI, bool full)
         << "                      preset plugin paths, e.g., '!:/lib' will use only /lib/." << std::endl
 
         << std::endl << "Performance Tuning Options:" << std::endl
-        << "     --extlearn[=none,iobehavior,monotonicity,functionality,linearity,neg,user,generalize]" << std::endl
+        << "     --extlearn[=none,iobehavior,monotonicity,functionality,linearity,neg,user,generalize,reuse]" << std::endl
         << "                      Learn nogoods from external atom evaluation (only useful with --solver=genuineii or --solver=genuinegi)." << std::endl
         << "                         none             : Deactivate external learning" << std::endl
         << "                         iobehavior       : Apply generic rules to learn input-output behavior" << std::endl
@@ -270,7 +287,9 @@ printUsage(std::ostream &out, const char* whoAmI, bool full)
         << "                         neg              : Learn negative information" << std::endl
         << "                         user             : Apply user-defined rules for nogood learning" << std::endl
         << "                         generalize       : Generalize learned ground nogoods to nonground nogoods" << std::endl
-        << "                      By default, all options except \"generalize\" are enabled." << std::endl
+        << "                         reuse            : Reuse learned nogoods which hold for all inputs of an evaluation unit" << std::endl
+        << "                                            when the unit is evaluated for further inputs" << std::endl
+        << "                      By default, all options except \"generalize\" and \"reuse\" are enabled." << std::endl
         << "     --supportsets    Exploits support sets for evaluation." << std::endl
         << "     --evalall        Evaluate all external atoms in every compatibility check, even if previous external atoms already failed." << std::endl
         << "                      This makes nogood learning more independent of the sequence of external atom checks." << std::endl
@@ -300,6 +319,8 @@ printUsage(std::ostream &out, const char* whoAmI, bool full)
         << "                         none             : No learning" << std::endl
         << "                         reduct           : Learning is based on the FLP-reduct" << std::endl
         << "                         ufs (default)    : Learning is based on the unfounded set" << std::endl
+        << "     --ufsthreads[=N] Check the components of a program for unfounded sets concurrently using N threads" << std::endl
+        << "                      (default: number of cores; only useful with --flpcheck=[a]ufs)." << std::endl
         << "     --eaevalheuristics=[always,inputcomplete,eacomplete,post,never]" << std::endl
         << "                      Selects the heuristic for external atom evaluation." << std::endl
         << "                         always           : Evaluate whenever possible" << std::endl
@@ -332,11 +353,40 @@ printUsage(std::ostream &out, const char* whoAmI, bool full)
         << "                                            where component indices <idx> are from '--graphviz=comp'" << std::endl
         << "                         asp:<script>     : Use asp program <script> as eval heuristic" << std::endl
         << "     --forcegc        Always use the guess and check model generator." << std::endl
-        << " -m, --modelbuilder=M Use M as model builder, where M is one of (online,offline)." << std::endl
+        << " -m, --modelbuilder=M Use M as model builder, where M is one of (online,offline,parallel)." << std::endl
+        << "                         parallel         : Like online, but evaluates independent units concurrently" << std::endl
+        << "                                            (only with --solver=dlv and thread-safe external sources;" << std::endl
+        << "                                            like online with weak constraints)" << std::endl
+        << "     --modelbuilderthreads=N" << std::endl
+        << "                      Number of worker threads of the parallel model builder (default: number of cores)." << std::endl
+        << "     --persistentgrounder" << std::endl
+        << "                      Extend the analysis of the ground program of the previous input of an evaluation unit" << std::endl
+        << "                      instead of recomputing it (only useful with --solver=genuine*)." << std::endl
         << "     --nocache        Do not cache queries to and answers from external atoms." << std::endl
+        << "     --cachelimit=N   Limit the cache of each external source to N MB; least recently used answers" << std::endl
+        << "                      are evicted first (default: 0 = unlimited)." << std::endl
+        << "     --parallelext[=N]" << std::endl
+        << "                      Answer independent queries to thread-safe external sources concurrently" << std::endl
+        << "                      using N threads (default: number of cores)." << std::endl
+        << "     --splitsearch[=N]" << std::endl
+        << "                      Split the search space of guess and check units into N parts which are enumerated" << std::endl
+        << "                      concurrently, sharing learned nogoods (default: number of cores; only with --solver=genuine*;" << std::endl
+        << "                      not with weak constraints)." << std::endl
+        << "     --internalrestarts=[none,luby,glucose]" << std::endl
+        << "                      Restart policy of the internal solver (only useful with --solver=genuineii or --solver=genuinegi)." << std::endl
+        << "                         none (default)   : Never restart" << std::endl
+        << "                         luby             : Restart after 100 conflicts times the next element of the Luby sequence" << std::endl
+        << "                         glucose          : Restart when recently learned nogoods are worse than average" << std::endl
+        << "     --internalreduce=N" << std::endl
+        << "                      Delete learned nogoods of the internal solver with high literal block distance after" << std::endl
+        << "                      N conflicts and in growing intervals afterwards (e.g. 2000; default: 0, i.e. disabled)." << std::endl
+        << "     --phasesaving    Reuse the previous truth value of atoms when the internal solver guesses" << std::endl
+        << "                      (default: disabled)." << std::endl
         << "     --iauxinaux      Keep auxiliary input predicates in auxiliary external atom predicates (can increase or decrease efficiency)." << std::endl
         << "     --constspace     Free partial models immediately after using them. This may cause some models." << std::endl
         << "                      to be computed multiple times. (Not with monolithic.)" << std::endl
+        << "     --compactmodels  Let the input models of an evaluation unit reference the models of its predecessors" << std::endl
+        << "                      instead of joining their interpretations into a copy (default: disabled)." << std::endl
 
         << std::endl << "Debugging and General Options:" << std::endl
         << "     --dumpevalplan=F Dump evaluation plan (usable as manual heuristics) to file F." << std::endl
@@ -829,6 +879,21 @@ Config& config, ProgramCtx& pctx)
         { "incremental", no_argument, 0, 50 },
         { "strongsafety", no_argument, 0, 52 },
 		{ "optmode", required_argument, 0, 54 },
+        { "modelbuilderthreads", required_argument, 0, 55 },
+        { "persistentgrounder", no_argument, 0, 56 },
+        { "cachelimit", required_argument, 0, 57 },
+        { "parallelext", optional_argument, 0, 58 },
+        { "internalrestarts", required_argument, 0, 59 },
+        { "internalreduce", required_argument, 0, 60 },
+        { "phasesaving", no_argument, 0, 61 },
+        { "fastfacts", no_argument, 0, 62 },
+        { "parserthreads", optional_argument, 0, 64 },
+        { "outputformat", required_argument, 0, 65 },
+        { "compactmodels", no_argument, 0, 66 },
+        { "splitsearch", optional_argument, 0, 67 },
+        { "ufsthreads", optional_argument, 0, 68 },
+        { "mlpmemo", optional_argument, 0, 69 },
+        { "mlpthreads", optional_argument, 0, 70 },
         { NULL, 0, NULL, 0 }
     };
 
@@ -930,7 +995,7 @@ Config& config, ProgramCtx& pctx)
                 break;
 
             case 'm':
-                // modelbuilder={offline,online}
+                // modelbuilder={offline,online,parallel}
                 {
                     std::string modelbuilder(optarg);
                     if( modelbuilder == "offline" ) {
@@ -941,6 +1006,10 @@ Config& config, ProgramCtx& pctx)
                         pctx.modelBuilderFactory =
                             boost::factory<OnlineModelBuilder<FinalEvalGraph>*>();
                     }
+                    else if( modelbuilder == "parallel" ) {
+                        pctx.modelBuilderFactory =
+                            boost::factory<ParallelModelBuilder<FinalEvalGraph>*>();
+                    }
                     else {
                         throw UsageError("unknown model builder '" + modelbuilder +"' specified!");
                     }
@@ -1159,6 +1228,7 @@ Config& config, ProgramCtx& pctx)
                 pctx.config.setOption("ExternalLearningLinearity", 0);
                 pctx.config.setOption("ExternalLearningNeg", 0);
                 pctx.config.setOption("ExternalLearningUser", 0);
+                pctx.config.setOption("ExternalLearningReuse", 0);
 
                 bool noneToken = false;
                 bool enableToken = false;
@@ -1202,6 +1272,10 @@ Config& config, ProgramCtx& pctx)
                             pctx.config.setOption("ExternalLearningGeneralize", 1);
                             enableToken = true;
                         }
+                        else if( token == "reuse" ) {
+                            pctx.config.setOption("ExternalLearningReuse", 1);
+                            enableToken = true;
+                        }
                         else {
                             throw GeneralError("Unknown learning option: \"" + token + "\"");
                         }
@@ -1215,6 +1289,7 @@ Config& config, ProgramCtx& pctx)
                     pctx.config.setOption("ExternalLearningLinearity", 1);
                     pctx.config.setOption("ExternalLearningNeg", 1);
                     pctx.config.setOption("ExternalLearningUser", 1);
+                    //pctx.config.setOption("ExternalLearningReuse", 1);	// do not activate by default (the nogoods are kept for all inputs of a unit)
                     //pctx.config.setOption("ExternalLearningGeneralize", 1);	// do not activate by default (it is mostly counterproductive)
                 }
                 if (noneToken && enableToken) {
@@ -1487,6 +1562,170 @@ Config& config, ProgramCtx& pctx)
             case 52:
                 pctx.config.setOption("LiberalSafety", 0);
                 break;
+            case 56:
+                pctx.config.setOption("PersistentGrounder", 1);
+                break;
+            case 57:
+            {
+                unsigned limit = 0;
+                try
+                {
+                    limit = boost::lexical_cast<unsigned>(optarg);
+                }
+                catch(const boost::bad_lexical_cast&) {
+                    throw UsageError("could not parse cache limit '" + std::string(optarg) + "'");
+                }
+                pctx.config.setOption("ExternalCacheLimit", limit);
+            }
+            break;
+            case 58:
+            {
+                unsigned threads = boost::thread::hardware_concurrency();
+                if( optarg ) {
+                    try
+                    {
+                        threads = boost::lexical_cast<unsigned>(optarg);
+                    }
+                    catch(const boost::bad_lexical_cast&) {
+                        throw UsageError("could not parse number of external evaluation threads '" + std::string(optarg) + "'");
+                    }
+                }
+                pctx.config.setOption("ParallelExternalEvaluation", threads > 0 ? threads : 1);
+            }
+            break;
+            case 59:
+            {
+                std::string policy(optarg);
+                if( policy == "none" ) {
+                    pctx.config.setOption("InternalSolverRestarts", 0);
+                }else if( policy == "luby" )
+                {
+                    pctx.config.setOption("InternalSolverRestarts", 1);
+                }else if( policy == "glucose" )
+                {
+                    pctx.config.setOption("InternalSolverRestarts", 2);
+                }
+                else {
+                    throw UsageError("unknown restart policy '" + policy + "' specified!");
+                }
+            }
+            break;
+            case 60:
+            {
+                unsigned conflicts = 0;
+                try
+                {
+                    conflicts = boost::lexical_cast<unsigned>(optarg);
+                }
+                catch(const boost::bad_lexical_cast&) {
+                    throw UsageError("could not parse number of conflicts '" + std::string(optarg) + "'");
+                }
+                pctx.config.setOption("InternalSolverReduceBase", conflicts);
+            }
+            break;
+            case 61:
+                pctx.config.setOption("InternalSolverPhaseSaving", 1);
+                break;
+            case 62:
+                pctx.config.setOption("FastFactParser", 1);
+                break;
+            case 64:
+            {
+                unsigned threads = boost::thread::hardware_concurrency();
+                if( optarg ) {
+                    try
+                    {
+                        threads = boost::lexical_cast<unsigned>(optarg);
+                    }
+                    catch(const boost::bad_lexical_cast&) {
+                        throw UsageError("could not parse number of parser threads '" + std::string(optarg) + "'");
+                    }
+                }
+                pctx.config.setOption("ParserThreads", threads > 0 ? threads : 1);
+            }
+            break;
+            case 65:
+            {
+                std::string format(optarg);
+                if( format == "text" ) {
+                    pctx.config.setOption("OutputFormat", 0);
+                }
+                else if( format == "ndjson" ) {
+                    pctx.config.setOption("OutputFormat", 1);
+                    // NDJSON output makes only sense with silent
+                    pctx.config.setOption("Silent", 1);
+                }
+                else {
+                    throw UsageError("unknown output format '" + format + "'");
+                }
+            }
+            break;
+            case 66:
+                pctx.config.setOption("CompactModels", 1);
+                break;
+            case 67:
+            {
+                unsigned parts = boost::thread::hardware_concurrency();
+                if( optarg ) {
+                    try
+                    {
+                        parts = boost::lexical_cast<unsigned>(optarg);
+                    }
+                    catch(const boost::bad_lexical_cast&) {
+                        throw UsageError("could not parse number of search space parts '" + std::string(optarg) + "'");
+                    }
+                }
+                pctx.config.setOption("SplitSearch", parts);
+            }
+            break;
+            case 68:
+            {
+                unsigned threads = boost::thread::hardware_concurrency();
+                if( optarg ) {
+                    try
+                    {
+                        threads = boost::lexical_cast<unsigned>(optarg);
+                    }
+                    catch(const boost::bad_lexical_cast&) {
+                        throw UsageError("could not parse number of unfounded set check threads '" + std::string(optarg) + "'");
+                    }
+                }
+                pctx.config.setOption("UFSCheckThreads", threads > 0 ? threads : 1);
+            }
+            break;
+            case 69:
+                pctx.config.setOption("MLPMemo", 1);
+                if( optarg )
+                    pctx.config.setStringOption("MLPMemoFile", std::string(optarg));
+                break;
+            case 70:
+            {
+                unsigned threads = boost::thread::hardware_concurrency();
+                if( optarg ) {
+                    try
+                    {
+                        threads = boost::lexical_cast<unsigned>(optarg);
+                    }
+                    catch(const boost::bad_lexical_cast&) {
+                        throw UsageError("could not parse number of mlp threads '" + std::string(optarg) + "'");
+                    }
+                }
+                pctx.config.setOption("MLPThreads", threads);
+            }
+            break;
+            case 55:
+            {
+                unsigned threads = 0;
+                try
+                {
+                    threads = boost::lexical_cast<unsigned>(optarg);
+                }
+                catch(const boost::bad_lexical_cast&) {
+                    throw UsageError("could not parse number of model builder threads '" + std::string(optarg) + "'");
+                }
+                pctx.config.setOption("ModelBuilderThreads", threads);
+            }
+            break;
             case 54:
                 int optmode = 0;
                 try
@@ -0,0 +1,142 @@
+/* dlvhex -- Answer-Set Programming with external interfaces.
+ * Copyright (C) 2005, 2006, 2007 Roman Schindlauer
+ * Copyright (C) 2006, 2007, 2008, 2009, 2010 Thomas Krennwallner
+ * Copyright (C) 2009, 2010 Peter Schüller
+ *
+ * This file is part of dlvhex.
+ *
+ * dlvhex is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * dlvhex is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with dlvhex; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+/**
+ * @file   TestAnnotatedGroundProgram.cpp
+ *
+ * @brief  Compares the incrementally extended analysis of ground programs with the analysis from scratch.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif // HAVE_CONFIG_H
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include <boost/tuple/tuple.hpp>
+#include <boost/tuple/tuple_comparison.hpp>
+
+#define BOOST_TEST_MODULE __FILE__
+#include <boost/test/unit_test.hpp>
+
+#include "dlvhex2/AnnotatedGroundProgram.h"
+#include "dlvhex2/ProgramCtx.h"
+#include "dlvhex2/Registry.h"
+#include "dlvhex2/Interpretation.h"
+#include "dlvhex2/Logger.h"
+#include "fixtureRandomGroundProgram.h"
+
+LOG_INIT(Logger::ERROR | Logger::WARNING)
+
+DLVHEX_NAMESPACE_USE
+
+namespace
+{
+
+  // component atoms, sorted component rules, head cycles, e-cycles
+  typedef boost::tuple<std::vector<IDAddress>, std::vector<ID>, bool, bool> Component;
+
+  // random rules with one or two head atoms and up to three body literals
+  void createRules(RandomGroundProgramGenerator& gen, ProgramCtx& ctx, const std::vector<ID>& atoms, int count, std::vector<ID>& idb)
+  {
+    for (int i = 0; i < count; ++i) {
+      idb.push_back(gen.createRule(ctx, atoms, 4, 0, 3, 3));
+    }
+  }
+
+  std::set<Component> components(const AnnotatedGroundProgram& agp)
+  {
+    std::set<Component> comps;
+    for (int c = 0; c < agp.getComponentCount(); ++c) {
+      std::vector<IDAddress> atoms;
+      bm::bvector<>::enumerator en = agp.getAtomsOfComponent(c)->getStorage().first();
+      bm::bvector<>::enumerator en_end = agp.getAtomsOfComponent(c)->getStorage().end();
+      while (en < en_end) {
+        atoms.push_back(*en);
+        en++;
+      }
+      std::vector<ID> rules = agp.getProgramOfComponent(c).idb;
+      std::sort(rules.begin(), rules.end());
+      BOOST_REQUIRE(agp.getProgramOfComponent(c).edb == agp.getGroundProgram().edb);
+      comps.insert(Component(atoms, rules, agp.hasHeadCycles(c), agp.hasECycles(c)));
+    }
+    return comps;
+  }
+
+}
+
+BOOST_AUTO_TEST_CASE(testExtendedAnalysisEqualsAnalysisFromScratch)
+{
+  RandomGroundProgramGenerator gen(1234);
+  for (int round = 0; round < 300; ++round) {
+    ProgramCtx ctx;
+    ctx.setupRegistry(RegistryPtr(new Registry));
+    std::vector<ID> atoms = gen.createAtoms(ctx, 5 + round % 20);
+
+    std::vector<ID> idb;
+    createRules(gen, ctx, atoms, round % 15, idb);
+    AnnotatedGroundProgram agp(ctx, OrdinaryASPProgram(ctx.registry(), idb, gen.createInterpretation(ctx, atoms, 5)));
+
+    // extend the program several times, also by no rules, with changing EDBs
+    for (int step = 0; step < 4; ++step) {
+      createRules(gen, ctx, atoms, gen.random(6), idb);
+      OrdinaryASPProgram program(ctx.registry(), idb, gen.createInterpretation(ctx, atoms, 5));
+      AnnotatedGroundProgram copy = agp;
+      std::set<Component> copyComponents = components(copy);
+      agp.updateGroundProgram(program);
+      AnnotatedGroundProgram expected(ctx, program);
+
+      BOOST_CHECK(components(agp) == components(expected));
+      BOOST_CHECK_EQUAL(agp.hasHeadCycles(), expected.hasHeadCycles());
+      BOOST_CHECK_EQUAL(agp.getProgramMask()->getStorage().count(), expected.getProgramMask()->getStorage().count());
+      BOOST_CHECK(agp.getProgramMask()->getStorage() == expected.getProgramMask()->getStorage());
+      BOOST_FOREACH (ID r, idb) {
+        BOOST_CHECK_EQUAL(agp.containsHeadCycles(r), expected.containsHeadCycles(r));
+      }
+      // copies made before the update keep their analysis
+      BOOST_CHECK(components(copy) == copyComponents);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testUnrelatedProgramIsAnalyzedFromScratch)
+{
+  RandomGroundProgramGenerator gen(99);
+  ProgramCtx ctx;
+  ctx.setupRegistry(RegistryPtr(new Registry));
+  std::vector<ID> atoms = gen.createAtoms(ctx, 12);
+
+  std::vector<ID> idb1, idb2;
+  createRules(gen, ctx, atoms, 10, idb1);
+  createRules(gen, ctx, atoms, 10, idb2);
+  AnnotatedGroundProgram agp(ctx, OrdinaryASPProgram(ctx.registry(), idb1, gen.createInterpretation(ctx, atoms, 5)));
+  OrdinaryASPProgram program(ctx.registry(), idb2, gen.createInterpretation(ctx, atoms, 5));
+  agp.updateGroundProgram(program);
+  BOOST_CHECK(components(agp) == components(AnnotatedGroundProgram(ctx, program)));
+}
+
+// Local Variables:
+// mode: C++
+// End:
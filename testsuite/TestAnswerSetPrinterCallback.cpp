@@ -0,0 +1,172 @@
+/* dlvhex -- Answer-Set Programming with external interfaces.
+ * Copyright (C) 2005, 2006, 2007 Roman Schindlauer
+ * Copyright (C) 2006, 2007, 2008, 2009, 2010 Thomas Krennwallner
+ * Copyright (C) 2009, 2010 Peter Schüller
+ *
+ * This file is part of dlvhex.
+ *
+ * dlvhex is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * dlvhex is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with dlvhex; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+/**
+ * @file   TestAnswerSetPrinterCallback.cpp
+ *
+ * @brief  Tests the text and NDJSON output of answer sets.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif // HAVE_CONFIG_H
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#define BOOST_TEST_MODULE __FILE__
+#include <boost/test/unit_test.hpp>
+
+#include "dlvhex2/AnswerSetPrinterCallback.h"
+#include "dlvhex2/AnswerSet.h"
+#include "dlvhex2/ProgramCtx.h"
+#include "dlvhex2/Registry.h"
+#include "dlvhex2/Logger.h"
+
+LOG_INIT(Logger::ERROR | Logger::WARNING)
+
+DLVHEX_NAMESPACE_USE
+
+namespace
+{
+
+  ID storeAtom(RegistryPtr reg, const std::string& pred, const std::string& arg)
+  {
+    OrdinaryAtom atom(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG);
+    atom.tuple.push_back(reg->storeConstantTerm(pred));
+    if (!arg.empty()) atom.tuple.push_back(reg->storeConstantTerm(arg));
+    return reg->storeOrdinaryGAtom(atom);
+  }
+
+  // prints the answer sets with the callback and returns the output
+  std::string print(AnswerSetPrinterCallback& printer, AnswerSetPtr as1, AnswerSetPtr as2)
+  {
+    std::stringstream out;
+    std::streambuf* cout = std::cout.rdbuf(out.rdbuf());
+    printer(as1);
+    printer(as2);
+    std::cout.rdbuf(cout);
+    return out.str();
+  }
+
+  struct PrinterFixture
+  {
+    ProgramCtx ctx;
+    RegistryPtr reg;
+    ID quoted, control, plain;
+    AnswerSetPtr as1, as2;
+
+    PrinterFixture()
+    {
+      ctx.setupRegistry(RegistryPtr(new Registry));
+      reg = ctx.registry();
+      // string constants with an escaped quote and a backslash, and with control characters
+      quoted = storeAtom(reg, "p", "\"a\\\"b\\\\c\"");
+      control = storeAtom(reg, "p", "\"x\ty\nz\x01\"");
+      plain = storeAtom(reg, "q", "");
+
+      as1.reset(new AnswerSet(reg));
+      as1->interpretation->setFact(quoted.address);
+      as1->interpretation->setFact(plain.address);
+      as1->getWeightVector().clear();
+      as1->getWeightVector().push_back(0);
+      as1->getWeightVector().push_back(3);
+      as1->getWeightVector().push_back(0);
+      as1->getWeightVector().push_back(12);
+
+      as2.reset(new AnswerSet(reg));
+      as2->interpretation->setFact(quoted.address);
+      as2->interpretation->setFact(control.address);
+      as2->getWeightVector().clear();
+    }
+  };
+
+}
+
+BOOST_AUTO_TEST_CASE(testNDJSON)
+{
+  PrinterFixture f;
+  f.ctx.config.setOption("OutputFormat", 1);
+  AnswerSetPrinterCallback printer(f.ctx);
+
+  // symbols are announced before the first answer set which contains them, and only once
+  std::string expected =
+    "{\"atom\":0,\"symbol\":\"p(\\\"a\\\\\\\"b\\\\\\\\c\\\")\"}\n"
+    "{\"atom\":1,\"symbol\":\"q\"}\n"
+    "{\"answerset\":[0,1],"
+    "\"cost\":[{\"level\":1,\"weight\":3},{\"level\":3,\"weight\":12}]}\n"
+    "{\"atom\":2,\"symbol\":\"p(\\\"x\\ty\\nz\\u0001\\\")\"}\n"
+    "{\"answerset\":[0,2]}\n";
+  BOOST_CHECK_EQUAL(print(printer, f.as1, f.as2), expected);
+}
+
+BOOST_AUTO_TEST_CASE(testText)
+{
+  PrinterFixture f;
+  f.ctx.config.setOption("OutputFormat", 0);
+  AnswerSetPrinterCallback printer(f.ctx);
+
+  std::string expected =
+    "{p(\"a\\\"b\\\\c\"),q} <[3:1],[12:3]>\n"
+    "{p(\"a\\\"b\\\\c\"),p(\"x\ty\nz\x01\")}\n";
+  BOOST_CHECK_EQUAL(print(printer, f.as1, f.as2), expected);
+}
+
+BOOST_AUTO_TEST_CASE(testTwoRegistries)
+{
+  PrinterFixture f;
+  ProgramCtx ctx2;
+  ctx2.setupRegistry(RegistryPtr(new Registry));
+  RegistryPtr reg2 = ctx2.registry();
+  // stored in a different order, so the same addresses denote different atoms
+  ID control2 = storeAtom(reg2, "p", "\"x\ty\nz\x01\"");
+  ID plain2 = storeAtom(reg2, "q", "");
+  ID quoted2 = storeAtom(reg2, "p", "\"a\\\"b\\\\c\"");
+  BOOST_REQUIRE_EQUAL(control2.address, f.quoted.address);
+
+  AnswerSetPtr as3(new AnswerSet(reg2));
+  as3->interpretation->setFact(control2.address);
+  as3->interpretation->setFact(plain2.address);
+  as3->interpretation->setFact(quoted2.address);
+  as3->getWeightVector().clear();
+
+  f.ctx.config.setOption("OutputFormat", 0);
+  AnswerSetPrinterCallback text(f.ctx);
+  BOOST_CHECK_EQUAL(print(text, f.as1, as3),
+    "{p(\"a\\\"b\\\\c\"),q} <[3:1],[12:3]>\n"
+    "{p(\"x\ty\nz\x01\"),q,p(\"a\\\"b\\\\c\")}\n");
+
+  // atoms of different registries get different numbers, even if they are equal
+  f.ctx.config.setOption("OutputFormat", 1);
+  AnswerSetPrinterCallback ndjson(f.ctx);
+  f.as1->getWeightVector().clear();
+  BOOST_CHECK_EQUAL(print(ndjson, f.as1, as3),
+    "{\"atom\":0,\"symbol\":\"p(\\\"a\\\\\\\"b\\\\\\\\c\\\")\"}\n"
+    "{\"atom\":1,\"symbol\":\"q\"}\n"
+    "{\"answerset\":[0,1]}\n"
+    "{\"atom\":2,\"symbol\":\"p(\\\"x\\ty\\nz\\u0001\\\")\"}\n"
+    "{\"atom\":3,\"symbol\":\"q\"}\n"
+    "{\"atom\":4,\"symbol\":\"p(\\\"a\\\\\\\"b\\\\\\\\c\\\")\"}\n"
+    "{\"answerset\":[2,3,4]}\n");
+}
@@ -0,0 +1,279 @@
+/* dlvhex -- Answer-Set Programming with external interfaces.
+ * Copyright (C) 2005, 2006, 2007 Roman Schindlauer
+ * Copyright (C) 2006, 2007, 2008, 2009, 2010 Thomas Krennwallner
+ * Copyright (C) 2009, 2010 Peter Schüller
+ *
+ * This file is part of dlvhex.
+ *
+ * dlvhex is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * dlvhex is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with dlvhex; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+/**
+ * @file   TestCDNLSolver.cpp
+ *
+ * @brief  Compares the models of the internal CDNL solver with a brute-force enumeration.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif // HAVE_CONFIG_H
+
+#include <set>
+#include <vector>
+
+#define BOOST_TEST_MODULE __FILE__
+#include <boost/test/unit_test.hpp>
+
+#include "dlvhex2/CDNLSolver.h"
+#include "dlvhex2/ProgramCtx.h"
+#include "dlvhex2/Registry.h"
+#include "dlvhex2/Logger.h"
+#include "fixtureRandomGroundProgram.h"
+
+LOG_INIT(Logger::ERROR | Logger::WARNING)
+
+DLVHEX_NAMESPACE_USE
+
+namespace
+{
+
+  typedef std::set<IDAddress> Model;
+
+  // addresses of ground atoms a0, ..., a(n-1)
+  std::vector<IDAddress> createAtoms(RandomGroundProgramGenerator& gen, ProgramCtx& ctx, int n)
+  {
+    std::vector<IDAddress> atoms;
+    BOOST_FOREACH (ID a, gen.createAtoms(ctx, n)) atoms.push_back(a.address);
+    return atoms;
+  }
+
+  // random nogoods with one to four literals; every atom occurs in some nogood
+  NogoodSet createNogoods(RandomGroundProgramGenerator& gen, const std::vector<IDAddress>& atoms, int count)
+  {
+    NogoodSet ns;
+    for (unsigned i = 0; i < atoms.size(); ++i) {
+      Nogood ng;
+      ng.insert(NogoodContainer::createLiteral(atoms[i], gen.oneIn(2)));
+      ng.insert(NogoodContainer::createLiteral(atoms[(i + 1) % atoms.size()], gen.oneIn(2)));
+      ns.addNogood(ng);
+    }
+    for (int i = 0; i < count; ++i) {
+      Nogood ng;
+      int size = 1 + gen.random(4);
+      for (int j = 0; j < size; ++j) {
+        IDAddress adr = atoms[gen.random(atoms.size())];
+        ID lit = NogoodContainer::createLiteral(adr, gen.oneIn(2));
+        // avoid complementary literals
+        if (!ng.contains(NogoodContainer::createLiteral(adr, lit.isNaf()))) ng.insert(lit);
+      }
+      ns.addNogood(ng);
+    }
+    return ns;
+  }
+
+  bool violates(const NogoodSet& ns, const std::vector<IDAddress>& atoms, unsigned long assignment)
+  {
+    for (int i = 0; i < ns.getNogoodCount(); ++i) {
+      bool allTrue = true;
+      BOOST_FOREACH (ID lit, ns.getNogood(i)) {
+        unsigned pos = std::find(atoms.begin(), atoms.end(), lit.address) - atoms.begin();
+        bool value = (assignment >> pos) & 1;
+        if (value == lit.isNaf()) {
+          allTrue = false;
+          break;
+        }
+      }
+      if (allTrue) return true;
+    }
+    return false;
+  }
+
+  std::set<Model> bruteForce(const NogoodSet& ns, const std::vector<IDAddress>& atoms, const std::vector<ID>& assumptions)
+  {
+    std::set<Model> models;
+    for (unsigned long assignment = 0; assignment < (1UL << atoms.size()); ++assignment) {
+      if (violates(ns, atoms, assignment)) continue;
+      Model m;
+      for (unsigned pos = 0; pos < atoms.size(); ++pos) {
+        if ((assignment >> pos) & 1) m.insert(atoms[pos]);
+      }
+      bool compatible = true;
+      BOOST_FOREACH (ID a, assumptions) {
+        if ((m.count(a.address) > 0) == a.isNaf()) compatible = false;
+      }
+      if (compatible) models.insert(m);
+    }
+    return models;
+  }
+
+  std::set<Model> enumerate(CDNLSolver& solver)
+  {
+    std::set<Model> models;
+    InterpretationPtr intr;
+    while (!!(intr = solver.getNextModel())) {
+      Model m;
+      bm::bvector<>::enumerator en = intr->getStorage().first();
+      bm::bvector<>::enumerator en_end = intr->getStorage().end();
+      while (en < en_end) {
+        m.insert(*en);
+        ++en;
+      }
+      // models must not be repeated
+      BOOST_REQUIRE(models.insert(m).second);
+    }
+    return models;
+  }
+
+}
+
+BOOST_AUTO_TEST_CASE(testCDNLSolverEnumeratesAllModels)
+{
+  RandomGroundProgramGenerator gen(42);
+  for (int round = 0; round < 200; ++round) {
+    ProgramCtx ctx;
+    ctx.setupRegistry(RegistryPtr(new Registry));
+    std::vector<IDAddress> atoms = createAtoms(gen, ctx, 4 + round % 9);
+    NogoodSet ns = createNogoods(gen, atoms, round % 25);
+
+    CDNLSolver solver(ctx, ns);
+    std::set<Model> expected = bruteForce(ns, atoms, std::vector<ID>());
+    BOOST_CHECK(enumerate(solver) == expected);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testCDNLSolverRestartWithAssumptions)
+{
+  RandomGroundProgramGenerator gen(4711);
+  for (int round = 0; round < 100; ++round) {
+    ProgramCtx ctx;
+    ctx.setupRegistry(RegistryPtr(new Registry));
+    std::vector<IDAddress> atoms = createAtoms(gen, ctx, 6 + round % 5);
+    NogoodSet ns = createNogoods(gen, atoms, round % 15);
+
+    CDNLSolver solver(ctx, ns);
+    enumerate(solver);
+
+    std::vector<ID> assumptions;
+    assumptions.push_back(NogoodContainer::createLiteral(atoms[0], round % 2 == 0));
+    assumptions.push_back(NogoodContainer::createLiteral(atoms[atoms.size() - 1], round % 3 == 0));
+    solver.restartWithAssumptions(assumptions);
+    BOOST_CHECK(enumerate(solver) == bruteForce(ns, atoms, assumptions));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testCDNLSolverRestartsAndNogoodDeletion)
+{
+  RandomGroundProgramGenerator gen(815);
+  for (int round = 0; round < 200; ++round) {
+    ProgramCtx ctx;
+    ctx.setupRegistry(RegistryPtr(new Registry));
+    // restart and delete learned nogoods as often as possible
+    ctx.config.setOption("InternalSolverRestarts", 1 + round % 2);
+    ctx.config.setOption("InternalSolverRestartBase", 1);
+    ctx.config.setOption("InternalSolverReduceBase", 4);
+    ctx.config.setOption("InternalSolverPhaseSaving", round % 3 != 0);
+    std::vector<IDAddress> atoms = createAtoms(gen, ctx, 8 + round % 6);
+    NogoodSet ns = createNogoods(gen, atoms, 20 + round % 30);
+
+    CDNLSolver solver(ctx, ns);
+    BOOST_CHECK(enumerate(solver) == bruteForce(ns, atoms, std::vector<ID>()));
+  }
+}
+
+// adds nogoods between the calls of getNextModel;
+// the models found afterwards must satisfy them and no model of the extended set may be missed
+void checkIncrementalNogoods(RandomGroundProgramGenerator& gen, int round, bool unitOrConflicting)
+{
+  ProgramCtx ctx;
+  ctx.setupRegistry(RegistryPtr(new Registry));
+  std::vector<IDAddress> atoms = createAtoms(gen, ctx, 5 + round % 6);
+  NogoodSet ns = createNogoods(gen, atoms, round % 10);
+  NogoodSet all = ns;
+
+  CDNLSolver solver(ctx, ns);
+  std::set<Model> models;
+  std::vector<Nogood> added;
+  InterpretationPtr intr;
+  while (!!(intr = solver.getNextModel())) {
+    Model m;
+    bm::bvector<>::enumerator en = intr->getStorage().first();
+    bm::bvector<>::enumerator en_end = intr->getStorage().end();
+    while (en < en_end) {
+      m.insert(*en);
+      ++en;
+    }
+    BOOST_REQUIRE(models.insert(m).second);
+
+    // the model must satisfy all nogoods added so far
+    unsigned long assignment = 0;
+    for (unsigned pos = 0; pos < atoms.size(); ++pos) {
+      if (m.count(atoms[pos]) > 0) assignment |= (1UL << pos);
+    }
+    BOOST_CHECK(!violates(all, atoms, assignment));
+
+    if (gen.oneIn(2)) continue;
+    Nogood ng;
+    if (unitOrConflicting) {
+      // nogood which is violated by the current assignment,
+      // or with one more literal which is false (such that it becomes unit after backtracking)
+      int size = 1 + gen.random(3);
+      for (int j = 0; j < size; ++j) {
+        IDAddress adr = atoms[gen.random(atoms.size())];
+        ng.insert(NogoodContainer::createLiteral(adr, m.count(adr) > 0));
+      }
+      if (gen.oneIn(2)) {
+        IDAddress adr = atoms[gen.random(atoms.size())];
+        if (!ng.contains(NogoodContainer::createLiteral(adr, m.count(adr) > 0)))
+          ng.insert(NogoodContainer::createLiteral(adr, m.count(adr) == 0));
+      }
+    }
+    else {
+      for (int j = 0; j < 2; ++j) {
+        IDAddress adr = atoms[gen.random(atoms.size())];
+        ID lit = NogoodContainer::createLiteral(adr, gen.oneIn(2));
+        if (!ng.contains(NogoodContainer::createLiteral(adr, lit.isNaf()))) ng.insert(lit);
+      }
+    }
+    solver.addNogood(ng);
+    all.addNogood(ng);
+  }
+
+  // every model of the extended nogood set was found (before or after the nogoods were added)
+  std::set<Model> expected = bruteForce(all, atoms, std::vector<ID>());
+  BOOST_FOREACH (const Model& m, expected) {
+    BOOST_CHECK(models.count(m) > 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testCDNLSolverAddNogoodsDuringEnumeration)
+{
+  RandomGroundProgramGenerator gen(1234);
+  for (int round = 0; round < 200; ++round) {
+    checkIncrementalNogoods(gen, round, false);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testCDNLSolverAddUnitAndConflictingNogoodsDuringEnumeration)
+{
+  RandomGroundProgramGenerator gen(5678);
+  for (int round = 0; round < 200; ++round) {
+    checkIncrementalNogoods(gen, round, true);
+  }
+}
+
+// Local Variables:
+// mode: C++
+// End:
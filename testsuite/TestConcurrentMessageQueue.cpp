@@ -0,0 +1,211 @@
+/* dlvhex -- Answer-Set Programming with external interfaces.
+ * Copyright (C) 2005, 2006, 2007 Roman Schindlauer
+ * Copyright (C) 2006, 2007, 2008, 2009, 2010 Thomas Krennwallner
+ * Copyright (C) 2009, 2010 Peter Schüller
+ * 
+ * This file is part of dlvhex.
+ *
+ * dlvhex is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * dlvhex is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with dlvhex; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+/**
+ * @file   TestConcurrentMessageQueue.cpp
+ *
+ * @brief  Unit tests and microbenchmark for ConcurrentMessageQueueOwning.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif // HAVE_CONFIG_H
+
+#include <deque>
+#include <utility>
+#include <vector>
+
+#define BOOST_TEST_MODULE __FILE__
+#include <boost/test/unit_test.hpp>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include "dlvhex2/ConcurrentMessageQueueOwning.h"
+
+using dlvhex::ConcurrentMessageQueueOwning;
+
+namespace
+{
+
+  // message: sender and sequence number
+  typedef std::pair<int, int> Message;
+  typedef boost::shared_ptr<Message> MessagePtr;
+  typedef ConcurrentMessageQueueOwning<Message> Queue;
+
+  void produce(Queue& q, int sender, int count, int batch)
+  {
+    std::vector<MessagePtr> ms;
+    for (int i = 0; i < count; ++i) {
+      MessagePtr m(new Message(sender, i));
+      if (batch <= 1) {
+        q.send(m, 0);
+        continue;
+      }
+      ms.push_back(m);
+      if ((int)ms.size() == batch || i == count - 1) {
+        q.send_batch(ms, 0);
+        ms.clear();
+      }
+    }
+  }
+
+  // receives until a message with negative sender arrives, records the last sequence number per sender
+  void consume(Queue& q, std::vector<int>& received, bool& ordered, int batch)
+  {
+    std::vector<int> last(received.size(), -1);
+    unsigned prio = 0;
+    std::vector<MessagePtr> ms;
+    for (;;) {
+      ms.clear();
+      if (batch <= 1) {
+        MessagePtr m;
+        q.receive(m, prio);
+        ms.push_back(m);
+      }
+      else {
+        q.receive_batch(ms, batch, prio);
+      }
+      for (unsigned i = 0; i < ms.size(); ++i) {
+        if (ms[i]->first < 0) {
+          // the end markers of the other consumers come last, pass them on
+          q.send_batch(std::vector<MessagePtr>(ms.begin() + i + 1, ms.end()), 0);
+          return;
+        }
+        // messages of one sender arrive in the order in which they were sent
+        if (ms[i]->second <= last[ms[i]->first]) ordered = false;
+        last[ms[i]->first] = ms[i]->second;
+        received[ms[i]->first]++;
+      }
+    }
+  }
+
+  // runs producers and consumers, checks that each message arrives exactly once, and returns the elapsed milliseconds
+  long exchange(std::size_t capacity, int producers, int consumers, int count, int batch)
+  {
+    Queue q(capacity);
+    std::vector<std::vector<int> > received(consumers, std::vector<int>(producers, 0));
+    std::deque<bool> ordered(consumers, true);
+
+    boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+    boost::thread_group ct, pt;
+    for (int c = 0; c < consumers; ++c)
+      ct.create_thread(boost::bind(&consume, boost::ref(q), boost::ref(received[c]), boost::ref(ordered[c]), batch));
+    for (int p = 0; p < producers; ++p)
+      pt.create_thread(boost::bind(&produce, boost::ref(q), p, count, batch));
+    pt.join_all();
+    // one end marker per consumer
+    for (int c = 0; c < consumers; ++c)
+      q.send(MessagePtr(new Message(-1, 0)), 0);
+    ct.join_all();
+    long elapsed = (boost::posix_time::microsec_clock::universal_time() - start).total_milliseconds();
+
+    for (int p = 0; p < producers; ++p) {
+      int total = 0;
+      for (int c = 0; c < consumers; ++c) total += received[c][p];
+      BOOST_CHECK_EQUAL(total, count);
+    }
+    for (int c = 0; c < consumers; ++c)
+      BOOST_CHECK(ordered[c]);
+    BOOST_CHECK(q.empty());
+    return elapsed;
+  }
+
+}
+
+BOOST_AUTO_TEST_CASE(testConcurrentMessageQueueSingleThreaded)
+{
+  Queue q(2);
+  unsigned prio = 0;
+  MessagePtr m;
+
+  BOOST_CHECK(q.empty());
+  BOOST_CHECK(!q.try_receive(m, prio));
+  BOOST_CHECK(!q.timed_receive(m, prio, boost::posix_time::milliseconds(10)));
+
+  BOOST_CHECK(q.try_send(MessagePtr(new Message(0, 1)), 0));
+  BOOST_CHECK(q.try_send(MessagePtr(new Message(0, 2)), 0));
+  BOOST_CHECK(!q.try_send(MessagePtr(new Message(0, 3)), 0));
+  BOOST_CHECK(!q.timed_send(MessagePtr(new Message(0, 3)), 0, boost::posix_time::milliseconds(10)));
+  BOOST_CHECK(!q.empty());
+
+  BOOST_REQUIRE(q.try_receive(m, prio));
+  BOOST_CHECK_EQUAL(m->second, 1);
+  q.send(MessagePtr(new Message(0, 3)), 0);
+
+  std::vector<MessagePtr> ms;
+  BOOST_CHECK_EQUAL(q.receive_batch(ms, 10, prio), 2U);
+  BOOST_REQUIRE_EQUAL(ms.size(), 2U);
+  BOOST_CHECK_EQUAL(ms[0]->second, 2);
+  BOOST_CHECK_EQUAL(ms[1]->second, 3);
+  BOOST_CHECK(q.empty());
+
+  // flush drops messages and releases their memory
+  MessagePtr kept(new Message(0, 4));
+  q.send(kept, 0);
+  BOOST_CHECK_EQUAL(kept.use_count(), 2);
+  q.flush();
+  BOOST_CHECK_EQUAL(kept.use_count(), 1);
+  BOOST_CHECK(q.empty());
+}
+
+BOOST_AUTO_TEST_CASE(testConcurrentMessageQueueCapacityOne)
+{
+  exchange(1, 1, 1, 20000, 1);
+}
+
+BOOST_AUTO_TEST_CASE(testConcurrentMessageQueueMultipleProducersAndConsumers)
+{
+  exchange(3, 3, 2, 20000, 1);
+  exchange(16, 3, 2, 20000, 5);
+}
+
+BOOST_AUTO_TEST_CASE(testConcurrentMessageQueueBenchmark)
+{
+  // many small messages, as for programs with many small answer sets;
+  // exchange checks that every message arrives exactly once and in order,
+  // the time bound is far above any regular run and only fails if the threads stall instead of handing over messages
+  const int count = 200000;
+  const long bound = 60000;
+  long elapsed;
+
+  elapsed = exchange(1, 1, 1, count, 1);
+  BOOST_TEST_MESSAGE("capacity 1: " << elapsed << "ms");
+  BOOST_CHECK_LT(elapsed, bound);
+
+  elapsed = exchange(64, 1, 1, count, 1);
+  BOOST_TEST_MESSAGE("capacity 64: " << elapsed << "ms");
+  BOOST_CHECK_LT(elapsed, bound);
+
+  elapsed = exchange(64, 1, 1, count, 32);
+  BOOST_TEST_MESSAGE("capacity 64, batches of 32: " << elapsed << "ms");
+  BOOST_CHECK_LT(elapsed, bound);
+
+  elapsed = exchange(64, 4, 2, count / 4, 1);
+  BOOST_TEST_MESSAGE("capacity 64, 4 producers, 2 consumers: " << elapsed << "ms");
+  BOOST_CHECK_LT(elapsed, bound);
+}
+
+// Local Variables:
+// mode: C++
+// End:
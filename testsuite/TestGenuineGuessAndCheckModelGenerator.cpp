@@ -0,0 +1,295 @@
+/* dlvhex -- Answer-Set Programming with external interfaces.
+ * Copyright (C) 2005, 2006, 2007 Roman Schindlauer
+ * Copyright (C) 2006, 2007, 2008, 2009, 2010 Thomas Krennwallner
+ * Copyright (C) 2009, 2010 Peter Schüller
+ *
+ * This file is part of dlvhex.
+ *
+ * dlvhex is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * dlvhex is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with dlvhex; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+/**
+ * @file   TestGenuineGuessAndCheckModelGenerator.cpp
+ *
+ * @brief  Tests which learned nogoods the guess and check model generators of a unit share across inputs.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif // HAVE_CONFIG_H
+
+#include <string>
+#include <vector>
+
+#define BOOST_TEST_MODULE __FILE__
+#include <boost/test/unit_test.hpp>
+
+#include "dlvhex2/GenuineGuessAndCheckModelGenerator.h"
+#include "dlvhex2/AnnotatedGroundProgram.h"
+#include "dlvhex2/ComponentGraph.h"
+#include "dlvhex2/ExternalAtomEvaluationHeuristics.h"
+#include "dlvhex2/UnfoundedSetCheckHeuristics.h"
+#include "dlvhex2/PluginInterface.h"
+#include "dlvhex2/ProgramCtx.h"
+#include "dlvhex2/Registry.h"
+#include "dlvhex2/Logger.h"
+
+LOG_INIT(Logger::ERROR | Logger::WARNING)
+
+DLVHEX_NAMESPACE_USE
+
+namespace
+{
+
+  // external source with one predicate input and one output; only its properties are used
+  class PropertyAtom:
+    public PluginAtom
+  {
+  public:
+    PropertyAtom(const std::string& name, bool monotonic, bool functional):
+      PluginAtom(name, monotonic)
+    {
+      addInputPredicate();
+      setOutputArity(1);
+      if (monotonic) prop.monotonicInputPredicates.insert(0);
+      prop.functional = functional;
+    }
+
+    virtual void retrieve(const Query&, Answer&)
+    {
+      BOOST_FAIL("external source must not be evaluated");
+    }
+  };
+
+  // gives access to the classification of nogoods
+  class TestFactory:
+    public GenuineGuessAndCheckModelGeneratorFactory
+  {
+  public:
+    TestFactory(ProgramCtx& ctx, const ComponentInfo& ci):
+      GenuineGuessAndCheckModelGeneratorFactory(ctx, ci, ASPSolverManager::SoftwareConfigurationPtr()) {}
+
+    using GenuineGuessAndCheckModelGeneratorFactory::isInputIndependent;
+
+    boost::shared_ptr<AnnotatedGroundProgram> getPersistentAnnotatedGroundProgram()
+    {
+      return persistentAnnotatedGroundProgram;
+    }
+  };
+
+  struct FactoryFixture
+  {
+    ProgramCtx ctx;
+    RegistryPtr reg;
+    PluginAtomPtr monotonicAtom, nonmonotonicAtom, functionalAtom;
+    ID mon, nonmon, fun;
+    ID p, a, b;
+    ComponentGraph::ComponentInfo ci;
+
+    FactoryFixture():
+      monotonicAtom(new PropertyAtom("mon", true, false)),
+      nonmonotonicAtom(new PropertyAtom("nonmon", false, false)),
+      functionalAtom(new PropertyAtom("fun", true, true))
+    {
+      ctx.setupRegistry(RegistryPtr(new Registry));
+      reg = ctx.registry();
+      p = reg->storeConstantTerm("p");
+      a = reg->storeConstantTerm("a");
+      b = reg->storeConstantTerm("b");
+      mon = storeExternalAtom(monotonicAtom);
+      nonmon = storeExternalAtom(nonmonotonicAtom);
+      fun = storeExternalAtom(functionalAtom);
+      ci.innerEatoms.push_back(mon);
+      ci.innerEatoms.push_back(nonmon);
+      ci.innerEatoms.push_back(fun);
+    }
+
+    // stores &name[p](var) with the properties of the plugin atom
+    ID storeExternalAtom(PluginAtomPtr pluginAtom, const std::string& name = "", const std::string& var = "X")
+    {
+      ExternalAtom eatom(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_EXTERNAL);
+      eatom.predicate = reg->storeConstantTerm(name.empty() ? pluginAtom->getPredicate() : name);
+      eatom.inputs.push_back(p);
+      eatom.tuple.push_back(reg->storeVariableTerm(var));
+      ID id = reg->eatoms.storeAndGetID(eatom);
+      const ExternalAtom& stored = reg->eatoms.getByID(id);
+      stored.pluginAtom = pluginAtom.get();
+      stored.prop |= pluginAtom->getExtSourceProperties();
+      return id;
+    }
+
+    // literal of the positive ('r') or negative ('n') replacement atom of eatom for output tuple (out)
+    ID replacement(ID eaid, char type, ID out, bool truthValue)
+    {
+      OrdinaryAtom atom(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG | ID::PROPERTY_AUX | ID::PROPERTY_EXTERNALAUX);
+      atom.tuple.push_back(reg->getAuxiliaryConstantSymbol(type, reg->eatoms.getByID(eaid).predicate));
+      atom.tuple.push_back(p);
+      atom.tuple.push_back(out);
+      return NogoodContainer::createLiteral(reg->storeOrdinaryGAtom(atom).address, truthValue);
+    }
+
+    // literal of the input atom p(c)
+    ID input(ID c, bool truthValue)
+    {
+      OrdinaryAtom atom(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG);
+      atom.tuple.push_back(p);
+      atom.tuple.push_back(c);
+      return NogoodContainer::createLiteral(reg->storeOrdinaryGAtom(atom).address, truthValue);
+    }
+  };
+
+  Nogood nogood(ID lit1, ID lit2, ID lit3 = ID_FAIL)
+  {
+    Nogood ng;
+    ng.insert(lit1);
+    ng.insert(lit2);
+    if (lit3 != ID_FAIL) ng.insert(lit3);
+    return ng;
+  }
+
+}
+
+BOOST_AUTO_TEST_CASE(testMonotonicNogoods)
+{
+  FactoryFixture f;
+  TestFactory factory(f.ctx, f.ci);
+
+  // p(a), p(b) true implies mon[p](a) true: more input atoms cannot invalidate this
+  BOOST_CHECK(factory.isInputIndependent(nogood(f.input(f.a, true), f.input(f.b, true), f.replacement(f.mon, 'r', f.a, false))));
+  BOOST_CHECK(factory.isInputIndependent(nogood(f.input(f.a, true), f.replacement(f.mon, 'n', f.a, true))));
+  // the same for a nonmonotonic source depends on the absence of other input atoms
+  BOOST_CHECK(!factory.isInputIndependent(nogood(f.input(f.a, true), f.replacement(f.nonmon, 'r', f.a, false))));
+  BOOST_CHECK(!factory.isInputIndependent(nogood(f.input(f.a, true), f.replacement(f.nonmon, 'n', f.a, true))));
+  // a false output tuple is not implied by true input atoms
+  BOOST_CHECK(!factory.isInputIndependent(nogood(f.input(f.a, true), f.replacement(f.mon, 'r', f.a, true))));
+}
+
+BOOST_AUTO_TEST_CASE(testNegativeInputNogoods)
+{
+  FactoryFixture f;
+  TestFactory factory(f.ctx, f.ci);
+
+  // false input atoms are specific to the input
+  BOOST_CHECK(!factory.isInputIndependent(nogood(f.input(f.a, false), f.replacement(f.mon, 'r', f.a, false))));
+  BOOST_CHECK(!factory.isInputIndependent(nogood(f.input(f.a, true), f.input(f.b, false), f.replacement(f.mon, 'r', f.a, false))));
+  BOOST_CHECK(!factory.isInputIndependent(nogood(f.input(f.a, false), f.replacement(f.fun, 'r', f.a, true), f.replacement(f.fun, 'r', f.b, true))));
+}
+
+BOOST_AUTO_TEST_CASE(testFunctionalNogoods)
+{
+  FactoryFixture f;
+  TestFactory factory(f.ctx, f.ci);
+
+  // two output tuples of a functional source exclude each other
+  BOOST_CHECK(factory.isInputIndependent(nogood(f.replacement(f.fun, 'r', f.a, true), f.replacement(f.fun, 'r', f.b, true))));
+  BOOST_CHECK(factory.isInputIndependent(nogood(f.replacement(f.fun, 'r', f.a, true), f.replacement(f.fun, 'n', f.b, false))));
+  // not for sources which are not functional
+  BOOST_CHECK(!factory.isInputIndependent(nogood(f.replacement(f.mon, 'r', f.a, true), f.replacement(f.mon, 'r', f.b, true))));
+  // not for output tuples of different sources
+  BOOST_CHECK(!factory.isInputIndependent(nogood(f.replacement(f.fun, 'r', f.a, true), f.replacement(f.mon, 'r', f.b, true))));
+  // not if the exclusion depends on input atoms
+  BOOST_CHECK(!factory.isInputIndependent(nogood(f.input(f.a, true), f.replacement(f.fun, 'r', f.a, true), f.replacement(f.fun, 'r', f.b, true))));
+  // not if an output tuple is false
+  BOOST_CHECK(!factory.isInputIndependent(nogood(f.replacement(f.fun, 'r', f.a, true), f.replacement(f.fun, 'r', f.b, false))));
+}
+
+BOOST_AUTO_TEST_CASE(testPropertiesOfAllOccurrences)
+{
+  // a source is only treated as monotonic or functional if all its inner external atoms are
+  FactoryFixture f;
+  f.ci.innerEatoms.push_back(f.storeExternalAtom(f.functionalAtom, "fun", "Y"));
+  TestFactory factory(f.ctx, f.ci);
+  BOOST_CHECK(factory.isInputIndependent(nogood(f.replacement(f.fun, 'r', f.a, true), f.replacement(f.fun, 'r', f.b, true))));
+  BOOST_CHECK(factory.isInputIndependent(nogood(f.input(f.a, true), f.replacement(f.fun, 'r', f.a, false))));
+
+  // the second occurrence does not have the properties of the first one
+  FactoryFixture g;
+  g.ci.innerEatoms.push_back(g.storeExternalAtom(g.nonmonotonicAtom, "fun", "Y"));
+  TestFactory factory2(g.ctx, g.ci);
+  BOOST_CHECK(!factory2.isInputIndependent(nogood(g.replacement(g.fun, 'r', g.a, true), g.replacement(g.fun, 'r', g.b, true))));
+  BOOST_CHECK(!factory2.isInputIndependent(nogood(g.input(g.a, true), g.replacement(g.fun, 'r', g.a, false))));
+}
+
+BOOST_AUTO_TEST_CASE(testSharedPersistentAnalysis)
+{
+  // the analysis of the persistent ground program is shared with the model generators
+  // and copied only before an update while a model generator still uses it
+  ProgramCtx ctx;
+  ctx.setupRegistry(RegistryPtr(new Registry));
+  RegistryPtr reg = ctx.registry();
+  ctx.edb.reset(new Interpretation(reg));
+  ctx.config.setOption("GenuineSolver", 1);
+  ctx.config.setOption("PersistentGrounder", 1);
+  ctx.defaultExternalAtomEvaluationHeuristicsFactory.reset(new ExternalAtomEvaluationHeuristicsNeverFactory());
+  ctx.unfoundedSetCheckHeuristicsFactory.reset(new UnfoundedSetCheckHeuristicsPostFactory());
+
+  ID atoms[4];
+  const char* names[4] = { "a", "b", "c", "d" };
+  for (int i = 0; i < 4; ++i) {
+    OrdinaryAtom atom(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG);
+    atom.tuple.push_back(reg->storeConstantTerm(names[i]));
+    atoms[i] = reg->storeOrdinaryGAtom(atom);
+  }
+  // c v d.  a :- b.
+  ComponentGraph::ComponentInfo ci;
+  Rule guess(ID::MAINKIND_RULE | ID::SUBKIND_RULE_REGULAR | ID::PROPERTY_RULE_DISJ);
+  guess.head.push_back(atoms[2]);
+  guess.head.push_back(atoms[3]);
+  ci.innerRules.push_back(reg->storeRule(guess));
+  Rule rule(ID::MAINKIND_RULE | ID::SUBKIND_RULE_REGULAR);
+  rule.head.push_back(atoms[0]);
+  rule.body.push_back(ID::posLiteralFromAtom(atoms[1]));
+  ci.innerRules.push_back(reg->storeRule(rule));
+
+  TestFactory factory(ctx, ci);
+  InterpretationPtr withB(new Interpretation(reg));
+  withB->setFact(atoms[1].address);
+
+  TestFactory::ModelGeneratorPtr gen1 = factory.createModelGenerator(withB);
+  boost::shared_ptr<AnnotatedGroundProgram> analysis1 = factory.getPersistentAnnotatedGroundProgram();
+  BOOST_REQUIRE(!!analysis1);
+  // factory, model generator and this test
+  BOOST_CHECK_EQUAL(analysis1.use_count(), 3);
+
+  // gen1 still uses the analysis, hence the second input gets a copy
+  TestFactory::ModelGeneratorPtr gen2 = factory.createModelGenerator(InterpretationPtr(new Interpretation(reg)));
+  boost::shared_ptr<AnnotatedGroundProgram> analysis2 = factory.getPersistentAnnotatedGroundProgram();
+  BOOST_CHECK(analysis1 != analysis2);
+  BOOST_CHECK_EQUAL(analysis1.use_count(), 2);
+
+  // both model generators still compute the models of their own input
+  int models1 = 0, models2 = 0;
+  InterpretationPtr model;
+  while (!!(model = gen1->generateNextModel())) {
+    BOOST_CHECK(model->getFact(atoms[0].address));
+    ++models1;
+  }
+  while (!!(model = gen2->generateNextModel())) {
+    BOOST_CHECK(!model->getFact(atoms[0].address));
+    ++models2;
+  }
+  BOOST_CHECK_EQUAL(models1, 2);
+  BOOST_CHECK_EQUAL(models2, 2);
+
+  // without other users the analysis is updated in place
+  const AnnotatedGroundProgram* shared = analysis2.get();
+  gen1.reset();
+  gen2.reset();
+  analysis1.reset();
+  analysis2.reset();
+  TestFactory::ModelGeneratorPtr gen3 = factory.createModelGenerator(withB);
+  BOOST_CHECK(factory.getPersistentAnnotatedGroundProgram().get() == shared);
+}
@@ -45,6 +45,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <cstdio>
 
 #define LOG_REGISTRY_PROGRAM(ctx) \
   LOG(INFO,*ctx.registry()); \
@@ -373,3 +374,118 @@ BOOST_AUTO_TEST_CASE(testHexParserExternalAtoms)
   }
 }
 
+
+BOOST_AUTO_TEST_CASE(testHexParserFileInput) 
+{
+  ProgramCtx ctx;
+  ctx.setupRegistry(RegistryPtr(new Registry));
+
+  // files are parsed from their memory mapping, empty files cannot be mapped
+  {
+    std::ofstream f("testHexParserFileInput.hex");
+    f << "a. c(d,e)." << std::endl << "% no newline at end of file" << std::endl << "f(\"x y\").";
+  }
+  {
+    std::ofstream f("testHexParserFileInputEmpty.hex");
+  }
+  InputProviderPtr ip(new InputProvider);
+  ip->addFileInput("testHexParserFileInput.hex");
+  ip->addFileInput("testHexParserFileInputEmpty.hex");
+  ip->addStringInput("b :- a.", "testinput");
+  ModuleHexParser parser;
+  BOOST_REQUIRE_NO_THROW(parser.parse(ip, ctx));
+  ip.reset();
+  std::remove("testHexParserFileInput.hex");
+  std::remove("testHexParserFileInputEmpty.hex");
+
+  ID ida = ctx.registry()->ogatoms.getIDByString("a");
+  ID idcde = ctx.registry()->ogatoms.getIDByString("c(d,e)");
+  ID idfxy = ctx.registry()->ogatoms.getIDByString("f(\"x y\")");
+  BOOST_REQUIRE((ida | idcde | idfxy) != ID_FAIL);
+  BOOST_REQUIRE(ctx.edb != 0);
+  BOOST_CHECK(ctx.edb->getFact(ida.address));
+  BOOST_CHECK(ctx.edb->getFact(idcde.address));
+  BOOST_CHECK(ctx.edb->getFact(idfxy.address));
+  BOOST_CHECK(ctx.idb.size() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(testHexParserFastFacts) 
+{
+  // facts, statements which only look like facts at first, and non-facts
+  const std::string input =
+    "a. c(d,e). c ( d , \"x \\\" y\" ,007 ) . % comment\n"
+    "f(\"a\\\\b\"). g(1,\n 42). i(f(a)). j(a) v k(b). l(a) :- a.\n"
+    "m(X) :- c(d,X). :- l(b). #maxint=50. n(a,b,123456789). o(1234567890).";
+
+  std::string printed[2];
+  for (int fast = 0; fast <= 1; ++fast) {
+    ProgramCtx ctx;
+    ctx.setupRegistry(RegistryPtr(new Registry));
+    ctx.config.setOption("FastFactParser", fast);
+
+    InputProviderPtr ip(new InputProvider);
+    ip->addStringInput(input, "testinput");
+    ModuleHexParser parser;
+    BOOST_REQUIRE_NO_THROW(parser.parse(ip, ctx));
+
+    BOOST_CHECK(ctx.edb->getFact(ctx.registry()->ogatoms.getIDByString("c(d,\"x \\\" y\",7)").address));
+    BOOST_CHECK(ctx.edb->getFact(ctx.registry()->ogatoms.getIDByString("g(1,42)").address));
+    BOOST_CHECK(ctx.edb->getFact(ctx.registry()->ogatoms.getIDByString("o(1234567890)").address));
+    BOOST_CHECK(ctx.idb.size() == 4);
+    BOOST_CHECK(ctx.maxint == 1234567890);
+
+    // the fact parser must store exactly the same terms and atoms as the grammar
+    std::ostringstream out;
+    out << *ctx.edb << " " << ctx.registry()->terms.getSize() << " " <<
+      ctx.registry()->ogatoms.getSize() << " " << ctx.registry()->onatoms.getSize();
+    printed[fast] = out.str();
+  }
+  BOOST_CHECK_EQUAL(printed[0], printed[1]);
+
+  // syntax errors are reported as before
+  ProgramCtx ctx;
+  ctx.setupRegistry(RegistryPtr(new Registry));
+  InputProviderPtr ip(new InputProvider);
+  ip->addStringInput("a. b(c,", "testinput");
+  ModuleHexParser parser;
+  BOOST_CHECK_THROW(parser.parse(ip, ctx), SyntaxError);
+}
+
+BOOST_AUTO_TEST_CASE(testHexParserConcurrentFacts) 
+{
+  // several chunks with facts, rules (also spanning multiple lines) and comments
+  std::stringstream big;
+  for (int i = 0; i < 60000; ++i) {
+    switch (i % 11) {
+      case 3: big << "r(X) :- p(X,Y," << i << "),\n  q(X)."; break;
+      case 5: big << "q(c" << i % 97 << ",\nd). % q(x).\n"; break;
+      case 7: big << "s(f(c" << i % 13 << "))."; break;
+      default: big << "p(c" << i % 1000 << "," << i << ",\"s " << i % 7 << "\").";
+    }
+    big << (i % 3 == 0 ? " " : "\n");
+  }
+
+  std::string printed[2];
+  for (int run = 0; run <= 1; ++run) {
+    ProgramCtx ctx;
+    ctx.setupRegistry(RegistryPtr(new Registry));
+    ctx.config.setOption("ParserThreads", run == 0 ? 1 : 3);
+
+    InputProviderPtr ip(new InputProvider);
+    ip->addStringInput(big.str(), "big");
+    ip->addStringInput("t(a). t(b) :- t(a).", "small");
+    ip->addStringInput("", "empty");
+    ip->addStringInput(big.str(), "big2");
+    ModuleHexParser parser;
+    BOOST_REQUIRE_NO_THROW(parser.parse(ip, ctx));
+
+    // IDs must not depend on the number of threads
+    std::ostringstream out;
+    RawPrinter printer(out, ctx.registry());
+    printer.printmany(ctx.idb, " ");
+    out << " " << *ctx.edb << " " << ctx.registry()->terms.getSize() << " " <<
+      ctx.registry()->ogatoms.getSize() << " " << ctx.registry()->onatoms.getSize() << " " << ctx.maxint;
+    printed[run] = out.str();
+  }
+  BOOST_CHECK(printed[0] == printed[1]);
+}
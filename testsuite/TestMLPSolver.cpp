@@ -47,6 +47,11 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <algorithm>
+#include <string>
+#include <vector>
 
 #ifdef NDEBUG
 	#define LOG_REGISTRY_PROGRAM(ctx) {}
@@ -1019,6 +1024,207 @@ void testComplexProgram()
   LOG(DBG, "Test Complex Program finish");
 }
 
+// parses examples/<name> and verifies its syntax
+template<typename SolverSoftwareConfiguration>
+void parseModuleProgram(ProgramCtx& ctx, const std::string& name)
+{
+  ctx.setupRegistry(RegistryPtr(new Registry));
+  ctx.setASPSoftware(ASPSolverManager::SoftwareConfigurationPtr(new SolverSoftwareConfiguration));
+
+  char *TOP_SRCDIR = getenv("TOP_SRCDIR");
+  assert(TOP_SRCDIR != 0);
+
+  std::string filename(TOP_SRCDIR);
+  filename += "/examples/" + name;
+  std::ifstream ifs(filename.c_str());
+  BOOST_REQUIRE(ifs.is_open());
+  std::stringstream ss;
+  ss << ifs.rdbuf();
+
+  InputProviderPtr ip(new InputProvider);
+  ip->addStreamInput(ss, "testinput");
+  ModuleHexParser parser;
+  BOOST_REQUIRE_NO_THROW(parser.parse(ip, ctx));
+  MLPSyntaxChecker sC(ctx);
+  BOOST_REQUIRE( sC.verifySyntax() == true );
+}
+
+// reads the elements of a printed set or tuple up to the closing bracket;
+// the elements of sets are sorted, as their order depends on the registry
+std::string normalizeElements(const std::string& text, std::size_t& pos, char close, bool sort)
+{
+  std::vector<std::string> elements(1);
+  while ( pos < text.size() && text[pos] != close ) {
+    char c = text[pos++];
+    if ( sort && c == ',' ) {
+      elements.push_back("");
+      continue;
+    }
+    if ( sort && c == ' ' ) continue;
+    elements.back() += c;
+    if ( c == '{' || c == '(' || c == '[' ) {
+      char nestedClose = ( c == '{' ? '}' : c == '(' ? ')' : ']' );
+      elements.back() += normalizeElements(text, pos, nestedClose, c == '{');
+      elements.back() += nestedClose;
+      pos++;
+    }
+  }
+  if ( sort ) std::sort(elements.begin(), elements.end());
+  std::string result;
+  for ( unsigned int i = 0; i < elements.size(); i++ ) {
+    if ( i > 0 ) result += ',';
+    result += elements[i];
+  }
+  return result;
+}
+
+// solves the program and returns its answer sets (as printed by the solver) in a normalized form
+std::vector<std::string> solveAndNormalize(MLPSolver& m)
+{
+  std::stringstream out;
+  std::streambuf* cout = std::cout.rdbuf(out.rdbuf());
+  bool solved = m.solve();
+  std::cout.rdbuf(cout);
+  BOOST_REQUIRE ( solved == true );
+
+  // an answer set is the set of the module instantiations with their interpretations
+  std::vector<std::string> answerSets;
+  std::string line;
+  while ( std::getline(out, line) ) {
+    if ( line.empty() || line[0] != '(' ) continue;
+    std::size_t pos = 1;
+    answerSets.push_back(normalizeElements(line, pos, ')', true));
+  }
+  std::sort(answerSets.begin(), answerSets.end());
+  return answerSets;
+}
+
+//19
+template<typename SolverSoftwareConfiguration>
+void testMemoization()
+{
+  LOG(DBG, "Test Memoization begin");
+
+  const char* programs[] = { "module-EvenOddTwoCalls2.mlp", "module-Hanoi.mlp", "module-Complex.mlp", "module-Cs.mlp" };
+  int hits = 0;
+  for ( unsigned int i = 0; i < sizeof(programs) / sizeof(programs[0]); i++ ) {
+    for ( int forget = 0; forget <= 1; forget++ ) {
+      ProgramCtx ctx;
+      parseModuleProgram<SolverSoftwareConfiguration>(ctx, programs[i]);
+      MLPSolver m(ctx);
+      m.setForget(forget);
+      BOOST_REQUIRE ( m.solve() == true );
+
+      // with --forget the memoized answer sets are parsed into the new registry
+      ProgramCtx ctxMemo;
+      parseModuleProgram<SolverSoftwareConfiguration>(ctxMemo, programs[i]);
+      MLPSolver mMemo(ctxMemo);
+      mMemo.setForget(forget);
+      mMemo.setMemoization(1);
+      BOOST_REQUIRE ( mMemo.solve() == true );
+      BOOST_CHECK_EQUAL ( mMemo.ctrAS, m.ctrAS );
+      BOOST_CHECK_EQUAL ( mMemo.ctrCallToDLV + mMemo.ctrMemoHits, m.ctrCallToDLV );
+      hits += mMemo.ctrMemoHits;
+    }
+  }
+  BOOST_CHECK ( hits > 0 );
+  LOG(DBG, "Test Memoization finish");
+}
+
+//20
+template<typename SolverSoftwareConfiguration>
+void testMemoFile()
+{
+  LOG(DBG, "Test Memo File begin");
+
+  const std::string memoFile = "TestMLPSolver.memo";
+  std::remove(memoFile.c_str());
+
+  // the first run writes the file
+  ProgramCtx ctx;
+  parseModuleProgram<SolverSoftwareConfiguration>(ctx, "module-Complex.mlp");
+  MLPSolver m(ctx);
+  m.setMemoization(1);
+  m.setMemoFile(memoFile);
+  BOOST_REQUIRE ( m.solve() == true );
+  BOOST_REQUIRE ( m.ctrCallToDLV > 0 );
+  BOOST_REQUIRE ( std::ifstream(memoFile.c_str()).is_open() );
+
+  // the second run reads all instantiations from the file
+  ProgramCtx ctxLoaded;
+  parseModuleProgram<SolverSoftwareConfiguration>(ctxLoaded, "module-Complex.mlp");
+  MLPSolver mLoaded(ctxLoaded);
+  mLoaded.setMemoization(1);
+  mLoaded.setMemoFile(memoFile);
+  BOOST_REQUIRE ( mLoaded.solve() == true );
+  BOOST_CHECK_EQUAL ( mLoaded.ctrAS, m.ctrAS );
+  BOOST_CHECK_EQUAL ( mLoaded.ctrCallToDLV, 0 );
+  BOOST_CHECK_EQUAL ( mLoaded.ctrMemoHits, m.ctrCallToDLV + m.ctrMemoHits );
+
+  // entries of other programs are not used
+  ProgramCtx ctxOther;
+  parseModuleProgram<SolverSoftwareConfiguration>(ctxOther, "module-Hanoi.mlp");
+  MLPSolver mOther(ctxOther);
+  mOther.setMemoization(1);
+  mOther.setMemoFile(memoFile);
+  BOOST_REQUIRE ( mOther.solve() == true );
+  BOOST_CHECK_EQUAL ( mOther.ctrAS, 1 );
+  BOOST_CHECK ( mOther.ctrCallToDLV > 0 );
+
+  // a truncated file is rejected
+  {
+    std::ofstream ofs(memoFile.c_str());
+    ofs << "100 1" << std::endl << "p." << std::endl;
+  }
+  ProgramCtx ctxCorrupt;
+  parseModuleProgram<SolverSoftwareConfiguration>(ctxCorrupt, "module-Complex.mlp");
+  MLPSolver mCorrupt(ctxCorrupt);
+  mCorrupt.setMemoization(1);
+  mCorrupt.setMemoFile(memoFile);
+  BOOST_CHECK_THROW ( mCorrupt.solve(), GeneralError );
+
+  std::remove(memoFile.c_str());
+  LOG(DBG, "Test Memo File finish");
+}
+
+//21
+template<typename SolverSoftwareConfiguration>
+void testThreads()
+{
+  LOG(DBG, "Test Threads begin");
+
+  const char* programs[] = { "module-EvenOddTwoCalls2.mlp", "module-Hanoi.mlp", "module-Complex.mlp", "module-Cs.mlp", "module-Indirection.mlp" };
+  for ( unsigned int i = 0; i < sizeof(programs) / sizeof(programs[0]); i++ ) {
+    ProgramCtx ctx;
+    parseModuleProgram<SolverSoftwareConfiguration>(ctx, programs[i]);
+    MLPSolver m(ctx);
+    std::vector<std::string> answerSets = solveAndNormalize(m);
+    BOOST_REQUIRE ( (int)answerSets.size() == m.ctrAS );
+
+    for ( int threads = 2; threads <= 4; threads += 2 ) {
+      ProgramCtx ctxThreads;
+      parseModuleProgram<SolverSoftwareConfiguration>(ctxThreads, programs[i]);
+      MLPSolver mThreads(ctxThreads);
+      mThreads.setThreads(threads);
+      std::vector<std::string> threadAnswerSets = solveAndNormalize(mThreads);
+      BOOST_CHECK_EQUAL ( mThreads.ctrAS, m.ctrAS );
+      BOOST_CHECK ( threadAnswerSets == answerSets );
+
+      // the workers stop after the first answer set, which may be any of the answer sets
+      ProgramCtx ctxFirst;
+      parseModuleProgram<SolverSoftwareConfiguration>(ctxFirst, programs[i]);
+      MLPSolver mFirst(ctxFirst);
+      mFirst.setThreads(threads);
+      mFirst.setNASReturned(1);
+      std::vector<std::string> firstAnswerSets = solveAndNormalize(mFirst);
+      BOOST_CHECK_EQUAL ( mFirst.ctrAS, std::min(m.ctrAS, 1) );
+      BOOST_CHECK_EQUAL ( (int)firstAnswerSets.size(), mFirst.ctrAS );
+      BOOST_CHECK ( std::includes(answerSets.begin(), answerSets.end(), firstAnswerSets.begin(), firstAnswerSets.end()) );
+    }
+  }
+  LOG(DBG, "Test Threads finish");
+}
+
 template<typename SolverSoftwareConfiguration>
 void testAll()
 {
@@ -1041,6 +1247,9 @@ void testAll()
   testIStratified2Program<SolverSoftwareConfiguration>();
   testHanoiProgram<SolverSoftwareConfiguration>();
   testComplexProgram<SolverSoftwareConfiguration>();
+  testMemoization<SolverSoftwareConfiguration>();
+  testMemoFile<SolverSoftwareConfiguration>();
+  testThreads<SolverSoftwareConfiguration>();
 }
 
 
@@ -0,0 +1,443 @@
+/* dlvhex -- Answer-Set Programming with external interfaces.
+ * Copyright (C) 2005, 2006, 2007 Roman Schindlauer
+ * Copyright (C) 2006, 2007, 2008, 2009, 2010 Thomas Krennwallner
+ * Copyright (C) 2009, 2010 Peter Schüller
+ *
+ * This file is part of dlvhex.
+ *
+ * dlvhex is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * dlvhex is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with dlvhex; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+/**
+ * @file   TestNogoodGrounder.cpp
+ *
+ * @brief  Tests matching of ground atoms against nonground ones and compares the nogood grounders with a brute-force instantiation.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif // HAVE_CONFIG_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <set>
+#include <string>
+#include <vector>
+
+#define BOOST_TEST_MODULE __FILE__
+#include <boost/test/unit_test.hpp>
+
+#include "dlvhex2/NogoodGrounder.h"
+#include "dlvhex2/AnnotatedGroundProgram.h"
+#include "dlvhex2/ProgramCtx.h"
+#include "dlvhex2/Registry.h"
+#include "dlvhex2/Interpretation.h"
+#include "dlvhex2/Printer.h"
+#include "dlvhex2/Logger.h"
+
+LOG_INIT(Logger::ERROR | Logger::WARNING)
+
+DLVHEX_NAMESPACE_USE
+
+namespace
+{
+
+  // constants start with a lower case letter, variables with an upper case letter or "_"
+  ID term(RegistryPtr reg, const std::string& symbol)
+  {
+    if (symbol == "_") {
+      ID id = reg->terms.getIDByString(symbol);
+      if (id != ID_FAIL) return id;
+      Term t(ID::MAINKIND_TERM | ID::SUBKIND_TERM_VARIABLE | ID::PROPERTY_VAR_ANONYMOUS, symbol);
+      return reg->terms.storeAndGetID(t);
+    }
+    return isupper(symbol[0]) ? reg->storeVariableTerm(symbol) : reg->storeConstantTerm(symbol);
+  }
+
+  ID fun(RegistryPtr reg, const std::string& symbol, ID arg1, ID arg2 = ID_FAIL)
+  {
+    std::vector<ID> args;
+    args.push_back(term(reg, symbol));
+    args.push_back(arg1);
+    if (arg2 != ID_FAIL) args.push_back(arg2);
+    Term t(ID::MAINKIND_TERM | ID::SUBKIND_TERM_NESTED, args, reg);
+    ID id = reg->terms.getIDByString(t.symbol);
+    return id != ID_FAIL ? id : reg->terms.storeAndGetID(t);
+  }
+
+  bool isGroundTerm(RegistryPtr reg, ID t)
+  {
+    if (t.isVariableTerm()) return false;
+    if (!t.isNestedTerm()) return true;
+    const Term& nested = reg->terms.getByID(t);
+    for (unsigned i = 1; i < nested.arguments.size(); ++i) {
+      if (!isGroundTerm(reg, nested.arguments[i])) return false;
+    }
+    return true;
+  }
+
+  // stores the atom pred(args) as ground or nonground atom
+  ID atom(RegistryPtr reg, ID pred, ID arg1 = ID_FAIL, ID arg2 = ID_FAIL)
+  {
+    Tuple tuple;
+    tuple.push_back(pred);
+    if (arg1 != ID_FAIL) tuple.push_back(arg1);
+    if (arg2 != ID_FAIL) tuple.push_back(arg2);
+    bool ground = true;
+    for (unsigned i = 0; i < tuple.size(); ++i) ground &= isGroundTerm(reg, tuple[i]);
+    ID id = (ground ? reg->ogatoms : reg->onatoms).getIDByTuple(tuple);
+    if (id != ID_FAIL) return id;
+    OrdinaryAtom oatom(ID::MAINKIND_ATOM | (ground ? ID::SUBKIND_ATOM_ORDINARYG : ID::SUBKIND_ATOM_ORDINARYN));
+    oatom.tuple = tuple;
+    return reg->storeOrdinaryAtom(oatom);
+  }
+
+  ID atom(RegistryPtr reg, const std::string& pred, ID arg1 = ID_FAIL, ID arg2 = ID_FAIL)
+  {
+    return atom(reg, term(reg, pred), arg1, arg2);
+  }
+
+  bool instance(RegistryPtr reg, ID ground, ID pattern)
+  {
+    const OrdinaryAtom& p = pattern.isOrdinaryGroundAtom() ? reg->ogatoms.getByID(pattern) : reg->onatoms.getByID(pattern);
+    return reg->ogatoms.getByID(ground).isInstanceOf(p, reg);
+  }
+
+  Nogood nogood(ID lit1, bool naf1, ID lit2, bool naf2, ID lit3 = ID_FAIL, bool naf3 = false)
+  {
+    Nogood ng;
+    ng.insert(NogoodContainer::createLiteral(ID::literalFromAtom(lit1, naf1)));
+    ng.insert(NogoodContainer::createLiteral(ID::literalFromAtom(lit2, naf2)));
+    if (lit3 != ID_FAIL) ng.insert(NogoodContainer::createLiteral(ID::literalFromAtom(lit3, naf3)));
+    ng.recomputeHash();
+    return ng;
+  }
+
+  typedef std::set<std::set<ID> > NogoodInstances;
+
+  NogoodInstances instances(SimpleNogoodContainer& container)
+  {
+    NogoodInstances result;
+    for (int i = 0; i < container.getNogoodCount(); ++i) {
+      const Nogood& ng = container.getNogood(i);
+      result.insert(std::set<ID>(ng.begin(), ng.end()));
+    }
+    return result;
+  }
+
+  // all ground (sub)terms of the tuple, including function symbols and predicates
+  void collectTerms(RegistryPtr reg, ID t, std::set<ID>& terms)
+  {
+    terms.insert(t);
+    if (t.isNestedTerm()) {
+      const Term& nested = reg->terms.getByID(t);
+      for (unsigned i = 0; i < nested.arguments.size(); ++i) collectTerms(reg, nested.arguments[i], terms);
+    }
+  }
+
+  void collectVariables(RegistryPtr reg, ID t, std::set<ID>& vars)
+  {
+    if (t.isVariableTerm()) vars.insert(t);
+    if (t.isNestedTerm()) {
+      const Term& nested = reg->terms.getByID(t);
+      for (unsigned i = 1; i < nested.arguments.size(); ++i) collectVariables(reg, nested.arguments[i], vars);
+    }
+  }
+
+  // same choice as NogoodGrounder::getWatchedLiteral: the first literal with the most distinct variables at the top level
+  ID watchedLiteral(RegistryPtr reg, const Nogood& ng)
+  {
+    unsigned maxBoundVariables = 0;
+    ID watched = ID_FAIL;
+    for (Nogood::const_iterator it = ng.begin(); it != ng.end(); ++it) {
+      if (it->isOrdinaryGroundAtom()) continue;
+      const OrdinaryAtom& oatom = reg->onatoms.getByID(*it);
+      std::set<ID> vars;
+      for (unsigned i = 0; i < oatom.tuple.size(); ++i) {
+        if (oatom.tuple[i].isVariableTerm()) vars.insert(oatom.tuple[i]);
+      }
+      if (vars.size() > maxBoundVariables) {
+        maxBoundVariables = vars.size();
+        watched = *it;
+      }
+    }
+    return watched;
+  }
+
+  ID substitute(RegistryPtr reg, ID lit, const std::vector<ID>& vars, const std::vector<ID>& values)
+  {
+    if (lit.isOrdinaryGroundAtom()) return lit;
+    Tuple tuple = reg->onatoms.getByID(lit).tuple;
+    for (unsigned i = 0; i < tuple.size(); ++i) {
+      for (unsigned v = 0; v < vars.size(); ++v) tuple[i] = reg->replaceVariablesInTerm(tuple[i], vars[v], values[v]);
+    }
+    ID id = reg->ogatoms.getIDByTuple(tuple);
+    if (id == ID_FAIL) {
+      OrdinaryAtom oatom(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG);
+      oatom.tuple = tuple;
+      id = reg->storeOrdinaryAtom(oatom);
+    }
+    return NogoodContainer::createLiteral(id.address, !lit.isNaf());
+  }
+
+  // brute-force instantiation: tries all substitutions over the terms of the program and keeps those
+  // which map the watched literal to a program atom; optionally simplifies the instances like ImmediateNogoodGrounder
+  NogoodInstances expectedInstances(RegistryPtr reg, const std::vector<Nogood>& nogoods, InterpretationConstPtr mask, bool simplify)
+  {
+    std::set<ID> domain;
+    bm::bvector<>::enumerator en = mask->getStorage().first();
+    bm::bvector<>::enumerator en_end = mask->getStorage().end();
+    while (en < en_end) {
+      const OrdinaryAtom& oatom = reg->ogatoms.getByAddress(*en);
+      for (unsigned i = 0; i < oatom.tuple.size(); ++i) collectTerms(reg, oatom.tuple[i], domain);
+      en++;
+    }
+    std::vector<ID> values(domain.begin(), domain.end());
+
+    NogoodInstances result;
+    for (unsigned n = 0; n < nogoods.size(); ++n) {
+      const Nogood& ng = nogoods[n];
+      ID watched = watchedLiteral(reg, ng);
+      BOOST_REQUIRE(watched != ID_FAIL);
+
+      std::set<ID> varSet, watchedVars;
+      for (Nogood::const_iterator it = ng.begin(); it != ng.end(); ++it) {
+        if (it->isOrdinaryGroundAtom()) continue;
+        const OrdinaryAtom& oatom = reg->onatoms.getByID(*it);
+        for (unsigned i = 0; i < oatom.tuple.size(); ++i) collectVariables(reg, oatom.tuple[i], *it == watched ? watchedVars : varSet);
+      }
+      // instances of the test nogoods are ground
+      BOOST_REQUIRE(std::includes(watchedVars.begin(), watchedVars.end(), varSet.begin(), varSet.end()));
+      std::vector<ID> vars(watchedVars.begin(), watchedVars.end());
+
+      std::vector<unsigned> choice(vars.size(), 0);
+      std::vector<ID> assignment(vars.size());
+      for (;;) {
+        for (unsigned v = 0; v < vars.size(); ++v) assignment[v] = values[choice[v]];
+        ID w = substitute(reg, watched, vars, assignment);
+        if (mask->getFact(w.address)) {
+          std::set<ID> inst;
+          bool relevant = true;
+          for (Nogood::const_iterator it = ng.begin(); it != ng.end(); ++it) {
+            ID lit = substitute(reg, *it, vars, assignment);
+            if (simplify && !mask->getFact(lit.address)) {
+              if (!lit.isNaf()) relevant = false;
+              continue;
+            }
+            inst.insert(lit);
+          }
+          if (relevant) result.insert(inst);
+        }
+
+        unsigned v = 0;
+        while (v < vars.size() && ++choice[v] == values.size()) choice[v++] = 0;
+        if (v == vars.size()) break;
+      }
+    }
+    return result;
+  }
+
+  struct GrounderFixture
+  {
+    ProgramCtx ctx;
+    RegistryPtr reg;
+    InterpretationPtr edb;
+    std::vector<Nogood> nogoods;
+
+    GrounderFixture()
+    {
+      ctx.setupRegistry(RegistryPtr(new Registry));
+      reg = ctx.registry();
+      ID a = term(reg, "a"), b = term(reg, "b"), c = term(reg, "c");
+      ID X = term(reg, "X"), Y = term(reg, "Y"), Z = term(reg, "Z");
+
+      // the program consists of facts only
+      edb.reset(new Interpretation(reg));
+      ID facts[] = {
+        atom(reg, "p", a, a), atom(reg, "p", a, b), atom(reg, "p", b, b), atom(reg, "p", c, a),
+        atom(reg, "p", fun(reg, "f", a), a), atom(reg, "p", fun(reg, "f", a), b), atom(reg, "p", fun(reg, "g", a), a),
+        atom(reg, "p", fun(reg, "f", a, b), a), atom(reg, "p", fun(reg, "f", fun(reg, "g", b)), b),
+        atom(reg, "q", a), atom(reg, "r", a), atom(reg, "s", a), atom(reg, "s", b), atom(reg, "s", fun(reg, "g", b)), atom(reg, "t", a, b)
+      };
+      for (unsigned i = 0; i < sizeof(facts) / sizeof(ID); ++i) edb->setFact(facts[i].address);
+      // known to the registry but not part of the program
+      atom(reg, "q", b);
+      atom(reg, "r", b);
+
+      // repeated variable
+      nogoods.push_back(nogood(atom(reg, "p", X, X), false, atom(reg, "q", X), true));
+      // repeated variable inside and outside of a function term
+      nogoods.push_back(nogood(atom(reg, "p", fun(reg, "f", X), X), false, atom(reg, "r", X), false));
+      // function term with two arguments
+      nogoods.push_back(nogood(atom(reg, "p", fun(reg, "f", X, Y), X), false, atom(reg, "s", fun(reg, "g", Y)), true));
+      // constant first argument
+      nogoods.push_back(nogood(atom(reg, "p", a, Y), false, atom(reg, "q", Y), false));
+      // variable predicate
+      nogoods.push_back(nogood(atom(reg, Z, X, Y), false, atom(reg, "s", X), false, atom(reg, "r", Y), true));
+      // nested term in the nogood but not in the watched literal
+      nogoods.push_back(nogood(atom(reg, "t", X, Y), false, atom(reg, "p", fun(reg, "f", X), Y), false));
+    }
+
+    SimpleNogoodContainerPtr watched()
+    {
+      SimpleNogoodContainerPtr container(new SimpleNogoodContainer());
+      for (unsigned i = 0; i < nogoods.size(); ++i) container->addNogood(nogoods[i]);
+      return container;
+    }
+  };
+
+}
+
+BOOST_AUTO_TEST_CASE(testIsInstanceOf)
+{
+  ProgramCtx ctx;
+  ctx.setupRegistry(RegistryPtr(new Registry));
+  RegistryPtr reg = ctx.registry();
+  ID a = term(reg, "a"), b = term(reg, "b"), c = term(reg, "c");
+  ID X = term(reg, "X"), Y = term(reg, "Y"), anon = term(reg, "_");
+
+  // repeated variables
+  BOOST_CHECK(instance(reg, atom(reg, "p", a, a), atom(reg, "p", X, X)));
+  BOOST_CHECK(!instance(reg, atom(reg, "p", a, b), atom(reg, "p", X, X)));
+  BOOST_CHECK(instance(reg, atom(reg, "p", a, b), atom(reg, "p", X, Y)));
+  BOOST_CHECK(instance(reg, atom(reg, "p", a, a), atom(reg, "p", X, Y)));
+
+  // constants, predicates and arities
+  BOOST_CHECK(instance(reg, atom(reg, "p", a, b), atom(reg, "p", X, b)));
+  BOOST_CHECK(!instance(reg, atom(reg, "p", a, b), atom(reg, "p", X, c)));
+  BOOST_CHECK(!instance(reg, atom(reg, "p", a, b), atom(reg, "q", X, Y)));
+  BOOST_CHECK(!instance(reg, atom(reg, "p", a), atom(reg, "p", X, Y)));
+  BOOST_CHECK(instance(reg, atom(reg, "p", a, b), atom(reg, "p", a, b)));
+  BOOST_CHECK(!instance(reg, atom(reg, "p", a, b), atom(reg, "p", b, a)));
+
+  // anonymous variables match any term, also if they occur several times
+  BOOST_CHECK(instance(reg, atom(reg, "p", a, b), atom(reg, "p", anon, anon)));
+  BOOST_CHECK(instance(reg, atom(reg, "p", fun(reg, "f", a), b), atom(reg, "p", fun(reg, "f", anon), anon)));
+
+  // nested function terms
+  BOOST_CHECK(instance(reg, atom(reg, "p", fun(reg, "f", a), a), atom(reg, "p", fun(reg, "f", X), X)));
+  BOOST_CHECK(!instance(reg, atom(reg, "p", fun(reg, "f", a), b), atom(reg, "p", fun(reg, "f", X), X)));
+  BOOST_CHECK(!instance(reg, atom(reg, "p", fun(reg, "g", a), a), atom(reg, "p", fun(reg, "f", X), X)));
+  BOOST_CHECK(!instance(reg, atom(reg, "p", fun(reg, "f", a, b), a), atom(reg, "p", fun(reg, "f", X), X)));
+  BOOST_CHECK(!instance(reg, atom(reg, "p", a, a), atom(reg, "p", fun(reg, "f", X), X)));
+  BOOST_CHECK(instance(reg, atom(reg, "p", fun(reg, "f", a), a), atom(reg, "p", X, a)));
+  BOOST_CHECK(instance(reg, atom(reg, "p", fun(reg, "f", fun(reg, "g", a)), a), atom(reg, "p", fun(reg, "f", fun(reg, "g", X)), X)));
+  BOOST_CHECK(!instance(reg, atom(reg, "p", fun(reg, "f", fun(reg, "g", a)), a), atom(reg, "p", fun(reg, "f", fun(reg, "h", X)), X)));
+  BOOST_CHECK(instance(reg, atom(reg, "p", fun(reg, "f", a, a)), atom(reg, "p", fun(reg, "f", X, X))));
+  BOOST_CHECK(!instance(reg, atom(reg, "p", fun(reg, "f", a, b)), atom(reg, "p", fun(reg, "f", X, X))));
+  BOOST_CHECK(!instance(reg, atom(reg, "p", fun(reg, "f", a, b)), atom(reg, "p", fun(reg, "f", a, c))));
+
+  // substitution
+  std::vector<std::pair<ID, ID> > substitution;
+  BOOST_REQUIRE(reg->ogatoms.getByID(atom(reg, "p", fun(reg, "f", a, b), b)).isInstanceOf(reg->onatoms.getByID(atom(reg, "p", fun(reg, "f", X, Y), Y)), reg, substitution));
+  BOOST_REQUIRE_EQUAL(substitution.size(), 2);
+  BOOST_CHECK(substitution[0] == std::make_pair(X, a));
+  BOOST_CHECK(substitution[1] == std::make_pair(Y, b));
+}
+
+BOOST_AUTO_TEST_CASE(testNogoodMatch)
+{
+  ProgramCtx ctx;
+  ctx.setupRegistry(RegistryPtr(new Registry));
+  RegistryPtr reg = ctx.registry();
+  ID a = term(reg, "a"), b = term(reg, "b");
+  ID X = term(reg, "X"), Y = term(reg, "Y"), Z = term(reg, "Z");
+
+  // variables are substituted also within function terms
+  Nogood ng = nogood(atom(reg, "p", fun(reg, "f", X), Y), false, atom(reg, "q", X), true, atom(reg, "r", fun(reg, "g", X, Y)), false);
+  Nogood inst;
+  BOOST_REQUIRE(ng.match(reg, atom(reg, "p", fun(reg, "f", a), b), inst));
+  Nogood expected = nogood(atom(reg, "p", fun(reg, "f", a), b), false, atom(reg, "q", a), true, atom(reg, "r", fun(reg, "g", a, b)), false);
+  inst.recomputeHash();
+  BOOST_CHECK(inst.isGround());
+  BOOST_CHECK_MESSAGE(inst == expected, inst.getStringRepresentation(reg) << " != " << expected.getStringRepresentation(reg));
+
+  // repeated variables and non-matching constants
+  Nogood ng2 = nogood(atom(reg, "p", X, X), false, atom(reg, "q", X), false);
+  Nogood inst2;
+  BOOST_CHECK(!ng2.match(reg, atom(reg, "p", a, b), inst2));
+  BOOST_CHECK(!ng2.match(reg, atom(reg, "s", a, a), inst2));
+  BOOST_CHECK(inst2.empty());
+  BOOST_REQUIRE(ng2.match(reg, atom(reg, "p", b, b), inst2));
+  inst2.recomputeHash();
+  BOOST_CHECK(inst2 == nogood(atom(reg, "p", b, b), false, atom(reg, "q", b), false));
+
+  // variables which are not bound by the matched literal remain
+  Nogood ng3 = nogood(atom(reg, "p", X), false, atom(reg, "q", X, fun(reg, "f", Z)), false);
+  Nogood inst3;
+  BOOST_REQUIRE(ng3.match(reg, atom(reg, "p", a), inst3));
+  inst3.recomputeHash();
+  BOOST_CHECK(!inst3.isGround());
+  BOOST_CHECK(inst3 == nogood(atom(reg, "p", a), false, atom(reg, "q", a, fun(reg, "f", Z)), false));
+}
+
+BOOST_AUTO_TEST_CASE(testImmediateNogoodGrounder)
+{
+  GrounderFixture f;
+  AnnotatedGroundProgram agp(f.ctx, OrdinaryASPProgram(f.reg, std::vector<ID>(), f.edb));
+
+  SimpleNogoodContainerPtr watched = f.watched();
+  SimpleNogoodContainerPtr destination(new SimpleNogoodContainer());
+  ImmediateNogoodGrounder grounder(f.reg, watched, destination, agp);
+  grounder.update();
+
+  NogoodInstances expected = expectedInstances(f.reg, f.nogoods, agp.getProgramMask(), true);
+  BOOST_CHECK(!expected.empty());
+  BOOST_CHECK_EQUAL(destination->getNogoodCount(), expected.size());
+  BOOST_CHECK(instances(*destination) == expected);
+
+  // the nonground nogoods are instantiated only once
+  grounder.update();
+  BOOST_CHECK_EQUAL(destination->getNogoodCount(), expected.size());
+}
+
+BOOST_AUTO_TEST_CASE(testLazyNogoodGrounder)
+{
+  srand(42);
+  for (int round = 0; round < 20; ++round) {
+    GrounderFixture f;
+    AnnotatedGroundProgram agp(f.ctx, OrdinaryASPProgram(f.reg, std::vector<ID>(), f.edb));
+
+    SimpleNogoodContainerPtr watched = f.watched();
+    SimpleNogoodContainerPtr destination(new SimpleNogoodContainer());
+    LazyNogoodGrounder grounder(f.reg, watched, destination, agp);
+
+    // assign the program atoms in random order and in several steps; some atoms change more than once
+    std::vector<IDAddress> atoms;
+    bm::bvector<>::enumerator en = agp.getProgramMask()->getStorage().first();
+    bm::bvector<>::enumerator en_end = agp.getProgramMask()->getStorage().end();
+    while (en < en_end) atoms.push_back(*en++);
+    std::random_shuffle(atoms.begin(), atoms.end());
+    atoms.push_back(atoms[0]);
+
+    InterpretationPtr interpretation(new Interpretation(f.reg));
+    InterpretationPtr factWasSet(new Interpretation(f.reg));
+    for (unsigned i = 0; i < atoms.size(); ) {
+      InterpretationPtr changed(new Interpretation(f.reg));
+      for (unsigned n = 1 + rand() % 4; n > 0 && i < atoms.size(); --n, ++i) {
+        factWasSet->setFact(atoms[i]);
+        if (rand() % 2 == 0) interpretation->setFact(atoms[i]);
+        changed->setFact(atoms[i]);
+      }
+      grounder.update(interpretation, factWasSet, changed);
+    }
+
+    NogoodInstances expected = expectedInstances(f.reg, f.nogoods, agp.getProgramMask(), false);
+    BOOST_CHECK_EQUAL(destination->getNogoodCount(), expected.size());
+    BOOST_CHECK(instances(*destination) == expected);
+    BOOST_CHECK_EQUAL(watched->getNogoodCount(), f.nogoods.size());
+  }
+}
@@ -483,4 +483,64 @@ BOOST_FIXTURE_TEST_CASE(online_model_building_ex1_ufinal_input, OnlineModelBuild
   DO_MODEL_GENERATION_TWICE_CHECK_GENERATORCOUNT_END
 }
 
+BOOST_FIXTURE_TEST_CASE(online_model_building_ex1_compact_models, OnlineModelBuilderEx1Fixture)
+{
+  // second model builder on the same eval graph which shares interpretations between models
+  dlvhex::ModelBuilderConfig<TestEvalGraph> ccfg(eg);
+  ccfg.compactModels = true;
+  ModelBuilder cmb(ccfg);
+
+  unsigned count = 0;
+  while( true )
+  {
+    OptionalModel m = omb.getNextIModel(ufinal);
+    OptionalModel cm = cmb.getNextIModel(ufinal);
+    BOOST_REQUIRE_EQUAL(!!m, !!cm);
+    if( !m )
+      break;
+    count++;
+
+    BOOST_REQUIRE(cmb.getModelGraph().propsOf(cm.get()).interpretation == NULL);
+    TestInterpretation::ConstPtr ci = cmb.getModelGraph().propsOf(cm.get()).getInterpretation();
+    BOOST_REQUIRE(ci != NULL);
+    TestInterpretation::ConstPtr ti = omb.getModelGraph().propsOf(m.get()).interpretation;
+    BOOST_CHECK(ti->getAtoms() == ci->getAtoms());
+    // the union is materialized only once
+    BOOST_CHECK(cmb.getModelGraph().propsOf(cm.get()).getInterpretation() == ci);
+  }
+  BOOST_CHECK_EQUAL(count, 6U);
+}
+
+BOOST_AUTO_TEST_CASE(delta_interpretation_changed_delta)
+{
+  typedef dlvhex::DeltaInterpretation<TestInterpretation> DeltaInterpretation;
+  TestAtomSet a, b, c;
+  a.insert("a");
+  b.insert("b");
+  c.insert("c");
+
+  DeltaInterpretation::Ptr da(new DeltaInterpretation(TestInterpretation::ConstPtr(new TestInterpretation(a))));
+  DeltaInterpretation::Ptr db(new DeltaInterpretation(TestInterpretation::ConstPtr(new TestInterpretation(b))));
+  std::vector<DeltaInterpretation::ConstPtr> bases;
+  bases.push_back(da);
+  bases.push_back(db);
+  DeltaInterpretation::Ptr dab(new DeltaInterpretation(bases));
+  // a union of a union reaches the same base twice
+  bases.push_back(dab);
+  DeltaInterpretation dabab(bases);
+
+  TestInterpretation::ConstPtr ab = dabab.materialize();
+  BOOST_CHECK_EQUAL(ab->getAtoms().size(), 2U);
+  BOOST_CHECK(dabab.materialize() == ab);
+
+  // changing the delta of a base changes all unions containing it
+  db->setDelta(TestInterpretation::ConstPtr(new TestInterpretation(c)));
+  TestInterpretation::ConstPtr ac = dabab.materialize();
+  BOOST_CHECK(ac != ab);
+  BOOST_CHECK_EQUAL(ac->getAtoms().count("b"), 0U);
+  BOOST_CHECK_EQUAL(ac->getAtoms().count("c"), 1U);
+  BOOST_CHECK_EQUAL(dab->materialize()->getAtoms().count("c"), 1U);
+  BOOST_CHECK(dabab.materialize() == ac);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
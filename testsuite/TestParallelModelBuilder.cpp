@@ -0,0 +1,153 @@
+/* dlvhex -- Answer-Set Programming with external interfaces.
+ * Copyright (C) 2005, 2006, 2007 Roman Schindlauer
+ * Copyright (C) 2006, 2007, 2008, 2009, 2010 Thomas Krennwallner
+ * Copyright (C) 2009, 2010 Peter Schüller
+ * 
+ * This file is part of dlvhex.
+ *
+ * dlvhex is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * dlvhex is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with dlvhex; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+/**
+ * @file   TestParallelModelBuilder.cpp
+ * 
+ * @brief  Unit tests for ParallelModelBuilder template.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif // HAVE_CONFIG_H
+
+#include <iostream>
+#include <vector>
+
+#define BOOST_TEST_MODULE __FILE__
+#include <boost/test/unit_test.hpp>
+
+#include "dlvhex2/Logger.h"
+#include "dlvhex2/ParallelModelBuilder.h"
+
+#include "fixtureOnlineMB.h"
+
+LOG_INIT(Logger::ERROR | Logger::WARNING)
+
+typedef dlvhex::ParallelModelBuilder<TestEvalGraph> TestParallelModelBuilder;
+
+// enumerate all input models at ufinal with the online and with the parallel model builder,
+// both must produce the same models in the same order
+template<typename EvalGraphBaseFixtureT>
+void compareWithOnlineModelBuilder()
+{
+  typedef OnlineModelBuilderTFixture<EvalGraphBaseFixtureT> OnlineFixture;
+  typedef OnlineModelBuilderTFixture<EvalGraphBaseFixtureT, TestParallelModelBuilder> ParallelFixture;
+  OnlineFixture online;
+  ParallelFixture parallel;
+
+  unsigned count = 0;
+  while(true)
+  {
+    BOOST_TEST_MESSAGE("requesting model #" << (count+1));
+    typename OnlineFixture::OptionalModel mo = online.omb.getNextIModel(online.ufinal);
+    typename ParallelFixture::OptionalModel mp = parallel.omb.getNextIModel(parallel.ufinal);
+    BOOST_REQUIRE_EQUAL(!!mo, !!mp);
+    if( !mo )
+      break;
+    count++;
+
+    const TestInterpretation& io = *(online.omb.getModelGraph().propsOf(mo.get()).interpretation);
+    const TestInterpretation& ip = *(parallel.omb.getModelGraph().propsOf(mp.get()).interpretation);
+    BOOST_CHECK(io.getAtoms() == ip.getAtoms());
+  }
+  BOOST_CHECK(count > 0);
+  BOOST_CHECK_EQUAL(online.omb.getModelGraph().countModels(), parallel.omb.getModelGraph().countModels());
+}
+
+// number of models requested from the model generators of all units
+template<typename FixtureT>
+unsigned countGeneratedModels(FixtureT& f)
+{
+  unsigned count = 0;
+  TestEvalGraph::EvalUnitIterator it, itend;
+  for(boost::tie(it, itend) = f.eg.getEvalUnits(); it != itend; ++it)
+  {
+    if( *it != f.ufinal )
+      count += static_cast<TestModelGeneratorFactory&>(*f.eg.propsOf(*it).mgf).generateNextModelCount;
+  }
+  return count;
+}
+
+// with optimization, the parallel model builder must not compute models in advance,
+// hence its model generators are asked for exactly the models the online model builder asks for
+template<typename EvalGraphBaseFixtureT>
+void compareWithOnlineModelBuilderOptimization()
+{
+  typedef OnlineModelBuilderTFixture<EvalGraphBaseFixtureT> OnlineFixture;
+  typedef OnlineModelBuilderTFixture<EvalGraphBaseFixtureT, TestParallelModelBuilder> ParallelFixture;
+  OnlineFixture online(true);
+  ParallelFixture parallel(true);
+
+  unsigned count = 0;
+  while(true)
+  {
+    typename OnlineFixture::OptionalModel mo = online.omb.getNextIModel(online.ufinal);
+    typename ParallelFixture::OptionalModel mp = parallel.omb.getNextIModel(parallel.ufinal);
+    BOOST_REQUIRE_EQUAL(!!mo, !!mp);
+    BOOST_CHECK_EQUAL(countGeneratedModels(online), countGeneratedModels(parallel));
+    if( !mo )
+      break;
+    count++;
+
+    const TestInterpretation& io = *(online.omb.getModelGraph().propsOf(mo.get()).interpretation);
+    const TestInterpretation& ip = *(parallel.omb.getModelGraph().propsOf(mp.get()).interpretation);
+    BOOST_CHECK(io.getAtoms() == ip.getAtoms());
+  }
+  BOOST_CHECK(count > 0);
+}
+
+BOOST_AUTO_TEST_SUITE(root_TestParallelModelBuilder)
+
+BOOST_AUTO_TEST_CASE(parallel_model_building_e1_ufinal_input)
+{
+  compareWithOnlineModelBuilder<EvalGraphE1Fixture>();
+}
+
+BOOST_AUTO_TEST_CASE(parallel_model_building_e2_ufinal_input)
+{
+  compareWithOnlineModelBuilder<EvalGraphE2Fixture>();
+}
+
+BOOST_AUTO_TEST_CASE(parallel_model_building_e2mirrored_ufinal_input)
+{
+  compareWithOnlineModelBuilder<EvalGraphE2MirroredFixture>();
+}
+
+BOOST_AUTO_TEST_CASE(parallel_model_building_ex1_ufinal_input)
+{
+  compareWithOnlineModelBuilder<EvalGraphEx1Fixture>();
+}
+
+BOOST_AUTO_TEST_CASE(parallel_model_building_e2_optimization)
+{
+  compareWithOnlineModelBuilderOptimization<EvalGraphE2Fixture>();
+}
+
+BOOST_AUTO_TEST_CASE(parallel_model_building_ex1_optimization)
+{
+  compareWithOnlineModelBuilderOptimization<EvalGraphEx1Fixture>();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -78,6 +78,9 @@ public:
 	{
 		addInputPredicate();
 		setOutputArity(1);
+
+		// retrieve does not keep any state
+		prop.threadSafe = true;
 	}
 
 	virtual void retrieve(const ComfortQuery& query, ComfortAnswer& answer)
@@ -106,6 +109,9 @@ public:
 		addInputPredicate();
 		addInputPredicate();
 		setOutputArity(1);
+
+		// retrieve does not keep any state
+		prop.threadSafe = true;
 	}
 
 	virtual void retrieve(const ComfortQuery& query, ComfortAnswer& answer)
@@ -244,6 +250,7 @@ public:
     setOutputArity(1);
 
     prop.functional = true;
+    prop.threadSafe = true;
   }
 
   virtual void retrieve(const Query& query, Answer& answer)
@@ -858,6 +865,7 @@ public:
     prop.monotonicInputPredicates.insert(0);
     prop.antimonotonicInputPredicates.insert(1);
     prop.finiteOutputDomain.insert(0);
+    prop.threadSafe = true;
   }
 
   virtual void retrieve(const ComfortQuery& query, ComfortAnswer& answer)
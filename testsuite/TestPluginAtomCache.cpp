@@ -0,0 +1,438 @@
+/* dlvhex -- Answer-Set Programming with external interfaces.
+ * Copyright (C) 2005, 2006, 2007 Roman Schindlauer
+ * Copyright (C) 2006, 2007, 2008, 2009, 2010 Thomas Krennwallner
+ * Copyright (C) 2009, 2010 Peter Schüller
+ *
+ * This file is part of dlvhex.
+ *
+ * dlvhex is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * dlvhex is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with dlvhex; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+/**
+ * @file   TestPluginAtomCache.cpp
+ *
+ * @brief  Unit tests for the query answer cache of PluginAtom.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif // HAVE_CONFIG_H
+
+#include <algorithm>
+#include <boost/foreach.hpp>
+
+#define BOOST_TEST_MODULE __FILE__
+#include <boost/test/unit_test.hpp>
+
+#include "dlvhex2/PluginInterface.h"
+#include "dlvhex2/Nogood.h"
+
+using namespace dlvhex;
+
+namespace
+{
+
+// variables and constants are created without registry, the cache only compares IDs
+ID var(uint32_t i) { return ID(ID::MAINKIND_TERM | ID::SUBKIND_TERM_VARIABLE, i); }
+ID anon(uint32_t i) { return ID(ID::MAINKIND_TERM | ID::SUBKIND_TERM_VARIABLE | ID::PROPERTY_VAR_ANONYMOUS, i); }
+ID num(uint32_t i) { return ID::termFromInteger(i); }
+
+Tuple tuple(ID a, ID b) { Tuple t; t.push_back(a); t.push_back(b); return t; }
+Tuple tuple(ID a, ID b, ID c) { Tuple t = tuple(a, b); t.push_back(c); return t; }
+
+// external source with a fixed relation as output for each input constant;
+// answers only the tuples which match the pattern and counts the calls of retrieve
+class FixedRelationAtom:
+  public PluginAtom
+{
+public:
+  FixedRelationAtom(unsigned arity):
+    PluginAtom("fixed", true),
+    calls(0)
+  {
+    addInputConstant();
+    setOutputArity(arity);
+  }
+
+  std::vector<Tuple> relation;
+  unsigned calls;
+
+  static bool matches(const Tuple& pattern, const Tuple& t)
+  {
+    if( pattern.size() != t.size() )
+      return false;
+    for(unsigned i = 0; i < pattern.size(); ++i)
+    {
+      if( !pattern[i].isVariableTerm() )
+      {
+        if( pattern[i] != t[i] )
+          return false;
+      }
+      else if( !pattern[i].isAnonymousVariable() )
+      {
+        for(unsigned j = 0; j < i; ++j)
+          if( pattern[j] == pattern[i] && t[j] != t[i] )
+            return false;
+      }
+    }
+    return true;
+  }
+
+  virtual void retrieve(const Query& query, Answer& answer)
+  {
+    ++calls;
+    // the relation is scaled by the input constant such that different inputs yield different answers
+    const uint32_t scale = query.input.front().address;
+    BOOST_FOREACH(const Tuple& t, relation)
+    {
+      Tuple scaled;
+      BOOST_FOREACH(ID term, t)
+        scaled.push_back(num(term.address * scale));
+      if( matches(query.pattern, scaled) )
+        answer.get().push_back(scaled);
+    }
+    answer.use();
+  }
+
+  // answers a query through the cache and returns the sorted answer
+  std::vector<Tuple> ask(uint32_t input, const Tuple& pattern)
+  {
+    Tuple in; in.push_back(num(input));
+    Query query(0, InterpretationConstPtr(), in, pattern);
+    Answer answer;
+    retrieveCached(query, answer, NogoodContainerPtr());
+    std::vector<Tuple> result = answer.get();
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  // answers a query without cache
+  std::vector<Tuple> expect(uint32_t input, const Tuple& pattern)
+  {
+    const unsigned before = calls;
+    Tuple in; in.push_back(num(input));
+    Query query(0, InterpretationConstPtr(), in, pattern);
+    Answer answer;
+    retrieve(query, answer);
+    calls = before;
+    std::vector<Tuple> result = answer.get();
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+};
+
+// answers batches with the default implementation and learns for each query the nogood { T input }
+class LearningRelationAtom:
+  public FixedRelationAtom
+{
+public:
+  LearningRelationAtom(): FixedRelationAtom(2), batches(0), batched(0) {}
+
+  unsigned batches;
+  unsigned batched;
+
+  static Nogood learnedFor(uint32_t input)
+  {
+    Nogood ng;
+    ng.insert(NogoodContainer::createLiteral(input));
+    ng.recomputeHash();
+    return ng;
+  }
+
+  virtual void retrieve(const Query& query, Answer& answer, NogoodContainerPtr nogoods)
+  {
+    FixedRelationAtom::retrieve(query, answer);
+    if( !!nogoods )
+      nogoods->addNogood(learnedFor(query.input.front().address));
+  }
+
+  virtual void retrieveBatch(const std::vector<Query>& queries, std::vector<Answer>& answers, const std::vector<NogoodContainerPtr>& nogoods)
+  {
+    ++batches;
+    batched += queries.size();
+    PluginAtom::retrieveBatch(queries, answers, nogoods);
+  }
+
+  // answers the queries through the cache in one batch and returns the learned nogoods
+  SimpleNogoodContainerPtr askBatch(const std::vector<uint32_t>& inputs, std::vector<Answer>& answers, std::vector<bool>& fromCache)
+  {
+    std::vector<Query> queries;
+    BOOST_FOREACH(uint32_t input, inputs)
+    {
+      Tuple in; in.push_back(num(input));
+      queries.push_back(Query(0, InterpretationConstPtr(), in, tuple(var(0), var(1))));
+    }
+    SimpleNogoodContainerPtr nogoods(new SimpleNogoodContainer());
+    retrieveCachedBatch(queries, answers, fromCache, nogoods);
+    return nogoods;
+  }
+
+  // answers a single query through the cache and returns the learned nogoods
+  SimpleNogoodContainerPtr askLearning(uint32_t input, Answer& answer)
+  {
+    Tuple in; in.push_back(num(input));
+    Query query(0, InterpretationConstPtr(), in, tuple(var(0), var(1)));
+    SimpleNogoodContainerPtr nogoods(new SimpleNogoodContainer());
+    retrieveCached(query, answer, nogoods);
+    return nogoods;
+  }
+};
+
+void addBinaryRelation(FixedRelationAtom& atom)
+{
+  atom.relation.push_back(tuple(num(1), num(1)));
+  atom.relation.push_back(tuple(num(1), num(2)));
+  atom.relation.push_back(tuple(num(2), num(2)));
+  atom.relation.push_back(tuple(num(3), num(1)));
+}
+
+}
+
+// canonicalPattern: patterns which differ only in the names of variables share a cache entry
+BOOST_AUTO_TEST_CASE(testCacheRenamedVariables)
+{
+  FixedRelationAtom atom(2);
+  addBinaryRelation(atom);
+
+  std::vector<Tuple> xy = atom.ask(1, tuple(var(0), var(1)));
+  BOOST_CHECK_EQUAL(atom.calls, 1);
+  BOOST_CHECK_EQUAL(xy.size(), 4);
+
+  BOOST_CHECK(atom.ask(1, tuple(var(7), var(3))) == xy);
+  BOOST_CHECK_EQUAL(atom.calls, 1);
+
+  // a repeated variable is a different pattern
+  std::vector<Tuple> xx = atom.ask(1, tuple(var(0), var(0)));
+  BOOST_CHECK_EQUAL(atom.calls, 2);
+  BOOST_CHECK(xx == atom.expect(1, tuple(var(0), var(0))));
+  BOOST_CHECK_EQUAL(xx.size(), 2);
+  BOOST_CHECK(atom.ask(1, tuple(var(5), var(5))) == xx);
+  BOOST_CHECK_EQUAL(atom.calls, 2);
+
+  // anonymous variables are distinct from each other
+  BOOST_CHECK(atom.ask(1, tuple(anon(0), anon(1))) == xy);
+  BOOST_CHECK_EQUAL(atom.calls, 2);
+
+  // another input is another query
+  BOOST_CHECK(atom.ask(2, tuple(var(0), var(1))) == atom.expect(2, tuple(var(0), var(1))));
+  BOOST_CHECK_EQUAL(atom.calls, 3);
+}
+
+// retrieveSubsumed: queries with bound output positions are answered from the cached answer of a more general pattern
+BOOST_AUTO_TEST_CASE(testCacheSubsumedLookup)
+{
+  FixedRelationAtom atom(2);
+  addBinaryRelation(atom);
+
+  atom.ask(1, tuple(var(0), var(1)));
+  BOOST_CHECK_EQUAL(atom.calls, 1);
+
+  const Tuple patterns[] = {
+    tuple(num(1), var(0)),
+    tuple(var(0), num(1)),
+    tuple(num(2), num(2)),
+    tuple(num(2), num(1)),
+    tuple(num(4), var(0)),
+    tuple(anon(0), num(2)),
+  };
+  BOOST_FOREACH(const Tuple& pattern, patterns)
+  {
+    BOOST_CHECK(atom.ask(1, pattern) == atom.expect(1, pattern));
+  }
+  BOOST_CHECK_EQUAL(atom.calls, 1);
+  BOOST_CHECK_EQUAL(atom.ask(1, tuple(num(1), var(0))).size(), 2);
+  BOOST_CHECK_EQUAL(atom.ask(1, tuple(num(4), var(0))).size(), 0);
+
+  // the filtered answers are cached for the specific patterns as well
+  BOOST_CHECK(atom.ask(1, tuple(num(1), var(3))) == atom.expect(1, tuple(num(1), var(0))));
+  BOOST_CHECK_EQUAL(atom.calls, 1);
+}
+
+// retrieveSubsumed: more specific answers never answer more general or unrelated queries
+BOOST_AUTO_TEST_CASE(testCacheNonSubsumedLookup)
+{
+  FixedRelationAtom atom(2);
+  addBinaryRelation(atom);
+
+  // specific first: the general query must still be evaluated
+  BOOST_CHECK(atom.ask(1, tuple(num(1), var(0))) == atom.expect(1, tuple(num(1), var(0))));
+  BOOST_CHECK_EQUAL(atom.calls, 1);
+  BOOST_CHECK(atom.ask(1, tuple(var(0), var(1))) == atom.expect(1, tuple(var(0), var(1))));
+  BOOST_CHECK_EQUAL(atom.calls, 2);
+
+  // a cached answer for (X,X) does not subsume (1,Y)
+  FixedRelationAtom other(2);
+  addBinaryRelation(other);
+  other.ask(1, tuple(var(0), var(0)));
+  BOOST_CHECK(other.ask(1, tuple(num(1), var(0))) == other.expect(1, tuple(num(1), var(0))));
+  BOOST_CHECK_EQUAL(other.calls, 2);
+
+  // nested terms are not matched by comparing IDs and thus not looked up in more general answers
+  const ID nested(ID::MAINKIND_TERM | ID::SUBKIND_TERM_NESTED, 0);
+  other.ask(1, tuple(var(0), var(1)));
+  BOOST_CHECK_EQUAL(other.calls, 3);
+  BOOST_CHECK(other.ask(1, tuple(nested, var(0))).empty());
+  BOOST_CHECK_EQUAL(other.calls, 4);
+}
+
+// matchesPattern: repeated variables in a specific query which is answered from a more general one
+BOOST_AUTO_TEST_CASE(testCacheSubsumedRepeatedVariables)
+{
+  FixedRelationAtom atom(3);
+  atom.relation.push_back(tuple(num(1), num(1), num(1)));
+  atom.relation.push_back(tuple(num(1), num(1), num(2)));
+  atom.relation.push_back(tuple(num(1), num(2), num(1)));
+  atom.relation.push_back(tuple(num(2), num(2), num(2)));
+  atom.relation.push_back(tuple(num(3), num(3), num(1)));
+
+  // (X,X,Z) is the generalization of (X,X,1)
+  atom.ask(1, tuple(var(0), var(0), var(1)));
+  BOOST_CHECK_EQUAL(atom.calls, 1);
+  std::vector<Tuple> specific = atom.ask(1, tuple(var(4), var(4), num(1)));
+  BOOST_CHECK(specific == atom.expect(1, tuple(var(0), var(0), num(1))));
+  BOOST_CHECK_EQUAL(specific.size(), 2);
+  BOOST_CHECK_EQUAL(atom.calls, 1);
+
+  // (X,Y,1) has no cached generalization with the same variables: (X,Y,Z) is not cached
+  BOOST_CHECK(atom.ask(1, tuple(var(0), var(1), num(1))) == atom.expect(1, tuple(var(0), var(1), num(1))));
+  BOOST_CHECK_EQUAL(atom.calls, 2);
+
+  // (X,1,X) is answered from the cached (X,Y,X)
+  atom.ask(1, tuple(var(0), var(1), var(0)));
+  BOOST_CHECK_EQUAL(atom.calls, 3);
+  BOOST_CHECK(atom.ask(1, tuple(var(2), num(1), var(2))) == atom.expect(1, tuple(var(0), num(1), var(0))));
+  BOOST_CHECK(atom.ask(1, tuple(var(2), num(2), var(2))) == atom.expect(1, tuple(var(0), num(2), var(0))));
+  BOOST_CHECK_EQUAL(atom.calls, 3);
+}
+
+// retrieveCachedBatch: only the queries which are not cached are passed to retrieveBatch
+BOOST_AUTO_TEST_CASE(testCacheBatchAnswers)
+{
+  LearningRelationAtom atom;
+  addBinaryRelation(atom);
+  // scaled by 4, no tuple matches (1,Y)
+  atom.ask(4, tuple(num(1), var(0)));
+  BOOST_CHECK_EQUAL(atom.calls, 1);
+
+  std::vector<uint32_t> inputs;
+  inputs.push_back(1); inputs.push_back(2); inputs.push_back(1);
+  std::vector<PluginAtom::Answer> answers;
+  std::vector<bool> fromCache;
+  atom.askBatch(inputs, answers, fromCache);
+  BOOST_CHECK_EQUAL(atom.batches, 1);
+  BOOST_REQUIRE_EQUAL(answers.size(), 3);
+  for(unsigned i = 0; i < inputs.size(); ++i)
+  {
+    std::vector<Tuple> result = answers[i].get();
+    std::sort(result.begin(), result.end());
+    BOOST_CHECK(result == atom.expect(inputs[i], tuple(var(0), var(1))));
+    BOOST_CHECK(answers[i].hasBeenUsed());
+    BOOST_CHECK(!fromCache[i]);
+  }
+
+  // the cached answers are used by single queries and by the next batch
+  const unsigned calls = atom.calls;
+  BOOST_CHECK(atom.ask(2, tuple(var(3), var(4))) == atom.expect(2, tuple(var(0), var(1))));
+  inputs.clear();
+  inputs.push_back(2); inputs.push_back(3); inputs.push_back(4);
+  atom.askBatch(inputs, answers, fromCache);
+  BOOST_CHECK_EQUAL(atom.batches, 2);
+  BOOST_CHECK_EQUAL(atom.batched, 3 + 2);
+  BOOST_CHECK_EQUAL(atom.calls, calls + 2);
+  BOOST_CHECK(fromCache[0]);
+  BOOST_CHECK(!fromCache[1]);
+  BOOST_CHECK(!fromCache[2]);
+  BOOST_REQUIRE_EQUAL(answers.size(), 3);
+  BOOST_CHECK(answers[2].hasBeenUsed());
+  BOOST_CHECK(answers[2].get() == atom.expect(4, tuple(var(0), var(1))));
+
+  // the answers of a batch are cached for the next batch
+  atom.askBatch(inputs, answers, fromCache);
+  BOOST_CHECK_EQUAL(atom.batches, 2);
+  BOOST_CHECK(fromCache[0] && fromCache[1] && fromCache[2]);
+}
+
+// retrieveCachedBatch: each query is cached with the nogoods learned while answering it
+BOOST_AUTO_TEST_CASE(testCacheBatchNogoods)
+{
+  LearningRelationAtom atom;
+  addBinaryRelation(atom);
+
+  std::vector<uint32_t> inputs;
+  inputs.push_back(1); inputs.push_back(2); inputs.push_back(3);
+  std::vector<PluginAtom::Answer> answers;
+  std::vector<bool> fromCache;
+  SimpleNogoodContainerPtr learned = atom.askBatch(inputs, answers, fromCache);
+  BOOST_CHECK_EQUAL(atom.batches, 1);
+  BOOST_REQUIRE_EQUAL(learned->getNogoodCount(), 3);
+  for(unsigned i = 0; i < inputs.size(); ++i)
+    BOOST_CHECK(learned->getNogood(i) == LearningRelationAtom::learnedFor(inputs[i]));
+
+  // a cached query returns only its own nogoods
+  const unsigned calls = atom.calls;
+  for(unsigned i = 0; i < inputs.size(); ++i)
+  {
+    PluginAtom::Answer answer;
+    SimpleNogoodContainerPtr cached = atom.askLearning(inputs[i], answer);
+    BOOST_REQUIRE_EQUAL(cached->getNogoodCount(), 1);
+    BOOST_CHECK(cached->getNogood(0) == LearningRelationAtom::learnedFor(inputs[i]));
+  }
+  BOOST_CHECK_EQUAL(atom.calls, calls);
+
+  // answers cached without nogoods are retrieved again if nogoods are requested
+  atom.ask(5, tuple(var(0), var(1)));
+  inputs.clear();
+  inputs.push_back(2); inputs.push_back(5);
+  learned = atom.askBatch(inputs, answers, fromCache);
+  BOOST_CHECK_EQUAL(atom.batches, 2);
+  BOOST_CHECK_EQUAL(atom.batched, 3 + 1);
+  // the answer counts as cached even though the nogoods were not
+  BOOST_CHECK(fromCache[0] && fromCache[1]);
+  BOOST_REQUIRE_EQUAL(learned->getNogoodCount(), 2);
+  BOOST_CHECK(learned->getNogood(0) == LearningRelationAtom::learnedFor(2));
+  BOOST_CHECK(learned->getNogood(1) == LearningRelationAtom::learnedFor(5));
+}
+
+// the fingerprint used for hashing queries stays valid if the storage is modified through a reference kept by the caller
+BOOST_AUTO_TEST_CASE(testFingerprintExposedStorage)
+{
+  Interpretation intr((RegistryPtr()));
+  intr.setFact(3);
+  Interpretation::Storage& bits = intr.getStorage();
+  bits.set_bit(5);
+  const std::size_t fp = intr.getFingerprint();
+  bits.set_bit(7);
+  BOOST_CHECK(intr.getFingerprint() != fp);
+
+  Interpretation expected((RegistryPtr()));
+  expected.setFact(3);
+  expected.setFact(5);
+  expected.setFact(7);
+  BOOST_CHECK_EQUAL(intr.getFingerprint(), expected.getFingerprint());
+
+  // also after the interpretation was cleared
+  intr.clear();
+  intr.setFact(5);
+  bits.set_bit(3);
+  bits.set_bit(7);
+  BOOST_CHECK_EQUAL(intr.getFingerprint(), expected.getFingerprint());
+
+  // a copy does not share the storage
+  Interpretation copy(intr);
+  copy.clearFact(7);
+  expected.clearFact(7);
+  BOOST_CHECK_EQUAL(copy.getFingerprint(), expected.getFingerprint());
+}
@@ -0,0 +1,129 @@
+/* dlvhex -- Answer-Set Programming with external interfaces.
+ * Copyright (C) 2005, 2006, 2007 Roman Schindlauer
+ * Copyright (C) 2006, 2007, 2008, 2009, 2010 Thomas Krennwallner
+ * Copyright (C) 2009, 2010 Peter Schüller
+ * 
+ * This file is part of dlvhex.
+ *
+ * dlvhex is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * dlvhex is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with dlvhex; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+/**
+ * @file   TestShardedCache.cpp
+ * 
+ * @brief  Unit tests for ShardedCache template.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif // HAVE_CONFIG_H
+
+#include <string>
+
+#define BOOST_TEST_MODULE __FILE__
+#include <boost/test/unit_test.hpp>
+
+#include "dlvhex2/ShardedCache.h"
+
+using dlvhex::ShardedCache;
+
+BOOST_AUTO_TEST_CASE(testShardedCacheLookup)
+{
+  ShardedCache<int, std::string> cache;
+
+  std::string value;
+  BOOST_CHECK(!cache.lookup(1, value));
+
+  cache.insert(1, "one", 10);
+  cache.insert(2, "two", 10);
+  BOOST_REQUIRE(cache.lookup(1, value));
+  BOOST_CHECK_EQUAL(value, "one");
+  BOOST_REQUIRE(cache.lookup(2, value));
+  BOOST_CHECK_EQUAL(value, "two");
+
+  // replace
+  cache.insert(1, "uno", 10);
+  BOOST_REQUIRE(cache.lookup(1, value));
+  BOOST_CHECK_EQUAL(value, "uno");
+  BOOST_CHECK_EQUAL(cache.size(), 2);
+
+  cache.clear();
+  BOOST_CHECK(!cache.lookup(1, value));
+  BOOST_CHECK_EQUAL(cache.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(testShardedCacheEvictsLeastRecentlyUsed)
+{
+  // single shard with room for three entries of cost 10
+  ShardedCache<int, int> cache(30, 1);
+
+  cache.insert(1, 1, 10);
+  cache.insert(2, 2, 10);
+  cache.insert(3, 3, 10);
+
+  // touch 1, so 2 is the least recently used entry
+  int value;
+  BOOST_REQUIRE(cache.lookup(1, value));
+
+  cache.insert(4, 4, 10);
+  BOOST_CHECK_EQUAL(cache.size(), 3);
+  BOOST_CHECK(cache.lookup(1, value));
+  BOOST_CHECK(!cache.lookup(2, value));
+  BOOST_CHECK(cache.lookup(3, value));
+  BOOST_CHECK(cache.lookup(4, value));
+
+  // an entry exceeding the budget on its own is kept until the next insertion
+  cache.insert(5, 5, 100);
+  BOOST_CHECK_EQUAL(cache.size(), 1);
+  BOOST_CHECK(cache.lookup(5, value));
+
+  // shrinking the budget evicts the least recently used entries
+  cache.insert(6, 6, 10);
+  BOOST_CHECK_EQUAL(cache.size(), 1);
+  cache.insert(7, 7, 10);
+  cache.insert(8, 8, 10);
+  BOOST_CHECK_EQUAL(cache.size(), 3);
+  cache.setCapacity(15);
+  BOOST_CHECK_EQUAL(cache.size(), 1);
+  BOOST_CHECK(!cache.lookup(6, value));
+  BOOST_CHECK(!cache.lookup(7, value));
+  BOOST_CHECK(cache.lookup(8, value));
+
+  // a budget of 0 means unbounded
+  cache.setCapacity(0);
+  cache.insert(9, 9, 1000);
+  BOOST_CHECK_EQUAL(cache.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(testShardedCacheBudgetOverShards)
+{
+  ShardedCache<int, int> cache(16 * 50, 16);
+  for(int i = 0; i < 1000; ++i)
+    cache.insert(i, i, 10);
+
+  // each shard holds at most 5 entries
+  BOOST_CHECK(cache.size() <= 16 * 5);
+  BOOST_CHECK(cache.size() > 0);
+
+  // the most recent entry is always present
+  int value;
+  BOOST_REQUIRE(cache.lookup(999, value));
+  BOOST_CHECK_EQUAL(value, 999);
+}
+
+// Local Variables:
+// mode: C++
+// End:
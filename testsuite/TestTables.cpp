@@ -41,10 +41,14 @@
 #include "dlvhex2/BuiltinAtomTable.h"
 #include "dlvhex2/AggregateAtomTable.h"
 #include "dlvhex2/RuleTable.h"
+#include "dlvhex2/Registry.h"
+#include "dlvhex2/Printer.h"
 
 #define BOOST_TEST_MODULE "TestTables"
 #include <boost/test/unit_test.hpp>
 
+#include <boost/thread/thread.hpp>
+
 #include <iostream>
 
 LOG_INIT(Logger::ERROR | Logger::WARNING)
@@ -142,7 +146,9 @@ BOOST_AUTO_TEST_CASE(testOrdinaryAtomTable)
 	Term term_X(ID::MAINKIND_TERM | ID::SUBKIND_TERM_VARIABLE, "X");
 	Term term_Y(ID::MAINKIND_TERM | ID::SUBKIND_TERM_VARIABLE, "Y");
 
-  TermTable stab;
+  // getIDByString generates the text of atoms from the terms of the registry
+  RegistryPtr reg(new Registry);
+  TermTable& stab = reg->terms;
   ID ida = stab.storeAndGetID(term_a);
   ID idX = stab.storeAndGetID(term_X);
   ID idb = stab.storeAndGetID(term_b);
@@ -151,18 +157,19 @@ BOOST_AUTO_TEST_CASE(testOrdinaryAtomTable)
   LOG(INFO,"TermTable" << stab);
 
   Tuple tupb; tupb.push_back(idb);
-  OrdinaryAtom atb(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG, "b", tupb);
+  OrdinaryAtom atb(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG, tupb);
 #warning reenable true negation
   ////OrdinaryAtom atmb(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG | ID::PROPERTY_NEGATIVE, "-b", tupb);
   Tuple tupab; tupab.push_back(ida); tupab.push_back(idb);
-  OrdinaryAtom atab(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG, "a(b)", tupab);
+  OrdinaryAtom atab(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG, tupab);
   Tuple tupaX; tupaX.push_back(ida); tupaX.push_back(idX);
-  OrdinaryAtom ataX(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYN, "a(X)", tupaX);
+  OrdinaryAtom ataX(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYN, tupaX);
   Tuple tupYhello; tupYhello.push_back(idY); tupYhello.push_back(idhello);
-  OrdinaryAtom atYhello(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYN, "Y(\"Hello World\")", tupYhello);
+  OrdinaryAtom atYhello(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYN, tupYhello);
 
 	{
 		OrdinaryAtomTable oatab;
+		oatab.setRegistry(reg.get());
 
 		BOOST_CHECK_EQUAL(ID_FAIL, oatab.getIDByString("b"));
 
@@ -183,6 +190,120 @@ BOOST_AUTO_TEST_CASE(testOrdinaryAtomTable)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(testOrdinaryAtomTableTextLookup) 
+{
+	RegistryPtr reg(new Registry);
+
+	Term term_a(ID::MAINKIND_TERM | ID::SUBKIND_TERM_CONSTANT, "a");
+	Term term_b(ID::MAINKIND_TERM | ID::SUBKIND_TERM_CONSTANT, "b");
+	Term term_hello(ID::MAINKIND_TERM | ID::SUBKIND_TERM_CONSTANT, "\"Hello, World\"");
+	Term term_X(ID::MAINKIND_TERM | ID::SUBKIND_TERM_VARIABLE, "X");
+	ID ida = reg->terms.storeAndGetID(term_a);
+	ID idb = reg->terms.storeAndGetID(term_b);
+	ID idhello = reg->terms.storeAndGetID(term_hello);
+	ID idX = reg->terms.storeAndGetID(term_X);
+
+	OrdinaryAtom atb(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG);
+	atb.tuple.push_back(idb);
+	OrdinaryAtom atab(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG);
+	atab.tuple.push_back(ida); atab.tuple.push_back(idb);
+	OrdinaryAtom atahello3(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG);
+	atahello3.tuple.push_back(ida); atahello3.tuple.push_back(idhello); atahello3.tuple.push_back(ID::termFromInteger(3));
+	OrdinaryAtom ataX(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYN);
+	ataX.tuple.push_back(ida); ataX.tuple.push_back(idX);
+
+	ID idatb = reg->storeOrdinaryAtom(atb);
+	ID idatab = reg->storeOrdinaryAtom(atab);
+	ID idatahello3 = reg->storeOrdinaryAtom(atahello3);
+	ID idataX = reg->storeOrdinaryAtom(ataX);
+
+	// nested terms may contain commas
+	Term term_fab(ID::MAINKIND_TERM, "f(a,g(b))");
+	term_fab.analyzeTerm(reg);
+	OrdinaryAtom atafabb(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG);
+	atafabb.tuple.push_back(ida); atafabb.tuple.push_back(reg->storeTerm(term_fab)); atafabb.tuple.push_back(idb);
+	ID idatafabb = reg->storeOrdinaryAtom(atafabb);
+
+	// storing again yields the same atom
+	BOOST_CHECK_EQUAL(idatab, reg->storeOrdinaryAtom(atab));
+
+	BOOST_CHECK_EQUAL(idatb, reg->ogatoms.getIDByString("b"));
+	BOOST_CHECK_EQUAL(idatab, reg->ogatoms.getIDByString("a(b)"));
+	BOOST_CHECK_EQUAL(idatahello3, reg->ogatoms.getIDByString("a(\"Hello, World\",3)"));
+	BOOST_CHECK_EQUAL(idataX, reg->onatoms.getIDByString("a(X)"));
+	BOOST_CHECK_EQUAL(idatafabb, reg->ogatoms.getIDByString("a(f(a,g(b)),b)"));
+	BOOST_CHECK_EQUAL(ID_FAIL, reg->ogatoms.getIDByString("a(a)"));
+	BOOST_CHECK_EQUAL(ID_FAIL, reg->ogatoms.getIDByString("a(b,3)"));
+	BOOST_CHECK_EQUAL(ID_FAIL, reg->ogatoms.getIDByString("c(b)"));
+	BOOST_CHECK_EQUAL(ID_FAIL, reg->ogatoms.getIDByString("a(X)"));
+
+	// the text is generated from the tuple
+	BOOST_CHECK_EQUAL(printToString<RawPrinter>(idatahello3, reg), "a(\"Hello, World\",3)");
+	BOOST_CHECK_EQUAL(printToString<RawPrinter>(idataX, reg), "a(X)");
+
+	// a copy of the registry generates the text from its own tables
+	RegistryPtr copy(new Registry(*reg));
+	BOOST_CHECK_EQUAL(idatab, copy->ogatoms.getIDByString("a(b)"));
+}
+
+namespace
+{
+	// stores the atoms p(0),...,p(n-1) starting at an offset, such that threads store the same atoms concurrently
+	struct StoreAtoms
+	{
+		RegistryPtr reg;
+		ID pred;
+		unsigned n;
+		unsigned offset;
+		std::vector<ID>* ids;
+
+		void operator()()
+		{
+			for(unsigned i = 0; i < n; ++i)
+			{
+				const unsigned value = (i + offset) % n;
+				OrdinaryAtom atom(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG);
+				atom.tuple.push_back(pred);
+				atom.tuple.push_back(ID::termFromInteger(value));
+				(*ids)[value] = reg->storeOrdinaryGAtom(atom);
+			}
+		}
+	};
+}
+
+BOOST_AUTO_TEST_CASE(testOrdinaryAtomTableConcurrentStore) 
+{
+	RegistryPtr reg(new Registry);
+	const ID pred = reg->storeConstantTerm("p");
+	const unsigned threads = 4;
+	const unsigned n = 5000;
+
+	std::vector<std::vector<ID> > ids(threads, std::vector<ID>(n, ID_FAIL));
+	boost::thread_group group;
+	for(unsigned t = 0; t < threads; ++t)
+	{
+		StoreAtoms store = { reg, pred, n, t * n / threads, &ids[t] };
+		group.create_thread(store);
+	}
+	group.join_all();
+
+	// every atom is stored exactly once and all threads got the same ID
+	BOOST_REQUIRE_EQUAL(reg->ogatoms.getSize(), n);
+	for(unsigned t = 1; t < threads; ++t)
+		BOOST_CHECK(ids[t] == ids[0]);
+
+	// the address of each atom is its position in the table
+	OrdinaryAtomTable::AddressIterator it, it_end;
+	boost::tie(it, it_end) = reg->ogatoms.getAllByAddress();
+	for(IDAddress addr = 0; it != it_end; ++it, ++addr)
+	{
+		const ID id = reg->ogatoms.getIDByTuple(it->tuple);
+		BOOST_CHECK_EQUAL(id.address, addr);
+		BOOST_CHECK(&reg->ogatoms.getByAddress(addr) == &*it);
+		BOOST_CHECK_EQUAL(ids[0][it->tuple[1].address], id);
+	}
+}
+
 BOOST_AUTO_TEST_CASE(testBuiltinAtomTable) 
 {
   ID idint(ID::MAINKIND_TERM | ID::SUBKIND_TERM_BUILTIN, ID::TERM_BUILTIN_INT);
@@ -240,7 +361,7 @@ BOOST_AUTO_TEST_CASE(testAggregateAtomTable)
 
   // ordinary atoms
   Tuple tupaXY; tupaXY.push_back(ida); tupaXY.push_back(idX); tupaXY.push_back(idY);
-  OrdinaryAtom ataXY(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYN, "a(X,Y)", tupaXY);
+  OrdinaryAtom ataXY(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYN, tupaXY);
 
   OrdinaryAtomTable oatab;
   ID idaXY = oatab.storeAndGetID(ataXY);
@@ -297,13 +418,13 @@ BOOST_AUTO_TEST_CASE(testRuleTable)
 
   // ordinary atoms
   Tuple tupb; tupb.push_back(idb);
-  OrdinaryAtom atb(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG, "b", tupb);
+  OrdinaryAtom atb(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG, tupb);
   Tuple tupab; tupab.push_back(ida); tupab.push_back(idb);
-  OrdinaryAtom atab(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG, "a(b)", tupab);
+  OrdinaryAtom atab(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYG, tupab);
   Tuple tupaX; tupaX.push_back(ida); tupaX.push_back(idX);
-  OrdinaryAtom ataX(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYN, "a(X)", tupaX);
+  OrdinaryAtom ataX(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYN, tupaX);
   Tuple tupYhello; tupYhello.push_back(idY); tupYhello.push_back(idhello);
-  OrdinaryAtom atYhello(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYN, "Y(\"Hello World\")", tupYhello);
+  OrdinaryAtom atYhello(ID::MAINKIND_ATOM | ID::SUBKIND_ATOM_ORDINARYN, tupYhello);
 
   OrdinaryAtomTable oatab;
   ID idatb = oatab.storeAndGetID(atb);
@@ -0,0 +1,139 @@
+/* dlvhex -- Answer-Set Programming with external interfaces.
+ * Copyright (C) 2005, 2006, 2007 Roman Schindlauer
+ * Copyright (C) 2006, 2007, 2008, 2009, 2010 Thomas Krennwallner
+ * Copyright (C) 2009, 2010 Peter Schüller
+ * 
+ * This file is part of dlvhex.
+ *
+ * dlvhex is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * dlvhex is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with dlvhex; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+/**
+ * @file   TestThreadPool.cpp
+ * 
+ * @brief  Unit tests for ThreadPool.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif // HAVE_CONFIG_H
+
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#define BOOST_TEST_MODULE __FILE__
+#include <boost/test/unit_test.hpp>
+
+#include "dlvhex2/ThreadPool.h"
+#include "dlvhex2/Error.h"
+
+using dlvhex::ThreadPool;
+
+namespace
+{
+  void store(std::vector<int>* results, int i)
+  {
+    (*results)[i] = i * i;
+  }
+
+  // runs a nested batch from within a worker
+  void nested(ThreadPool* pool, std::vector<int>* results, int i)
+  {
+    std::vector<int> inner(4, -1);
+    std::vector<ThreadPool::Task> tasks;
+    for(int j = 0; j < 4; ++j)
+      tasks.push_back(boost::bind(&store, &inner, j));
+    pool->run(tasks);
+    (*results)[i] = inner[0] + inner[1] + inner[2] + inner[3];
+  }
+
+  void remember(boost::thread::id* id)
+  {
+    *id = boost::this_thread::get_id();
+  }
+
+  void fail(int i)
+  {
+    if( i == 3 )
+      throw dlvhex::GeneralError("task 3 failed");
+  }
+}
+
+BOOST_AUTO_TEST_CASE(testThreadPoolRun)
+{
+  ThreadPool pool(4);
+  std::vector<int> results(100, -1);
+  std::vector<ThreadPool::Task> tasks;
+  for(int i = 0; i < 100; ++i)
+    tasks.push_back(boost::bind(&store, &results, i));
+  pool.run(tasks);
+
+  for(int i = 0; i < 100; ++i)
+    BOOST_CHECK_EQUAL(results[i], i * i);
+}
+
+BOOST_AUTO_TEST_CASE(testThreadPoolNestedRun)
+{
+  // more outer tasks than workers must not deadlock
+  ThreadPool pool(2);
+  std::vector<int> results(8, -1);
+  std::vector<ThreadPool::Task> tasks;
+  for(int i = 0; i < 8; ++i)
+    tasks.push_back(boost::bind(&nested, &pool, &results, i));
+  pool.run(tasks);
+
+  for(int i = 0; i < 8; ++i)
+    BOOST_CHECK_EQUAL(results[i], 0 + 1 + 4 + 9);
+}
+
+BOOST_AUTO_TEST_CASE(testThreadPoolRunCallerTask)
+{
+  ThreadPool pool(2);
+  std::vector<int> results(4, -1);
+  std::vector<ThreadPool::Task> tasks;
+  for(int i = 0; i < 4; ++i)
+    tasks.push_back(boost::bind(&store, &results, i));
+  boost::thread::id callerId;
+  pool.run(tasks, boost::bind(&remember, &callerId));
+
+  BOOST_CHECK(callerId == boost::this_thread::get_id());
+  for(int i = 0; i < 4; ++i)
+    BOOST_CHECK_EQUAL(results[i], i * i);
+}
+
+BOOST_AUTO_TEST_CASE(testThreadPoolRunPropagatesErrors)
+{
+  ThreadPool pool(2);
+  std::vector<ThreadPool::Task> tasks;
+  for(int i = 0; i < 6; ++i)
+    tasks.push_back(boost::bind(&fail, i));
+  BOOST_CHECK_THROW(pool.run(tasks), dlvhex::GeneralError);
+
+  // the pool is still usable afterwards
+  std::vector<int> results(2, -1);
+  tasks.clear();
+  tasks.push_back(boost::bind(&store, &results, 0));
+  tasks.push_back(boost::bind(&store, &results, 1));
+  pool.run(tasks);
+  BOOST_CHECK_EQUAL(results[1], 1);
+}
+
+// Local Variables:
+// mode: C++
+// End:
@@ -0,0 +1,135 @@
+/* dlvhex -- Answer-Set Programming with external interfaces.
+ * Copyright (C) 2005, 2006, 2007 Roman Schindlauer
+ * Copyright (C) 2006, 2007, 2008, 2009, 2010 Thomas Krennwallner
+ * Copyright (C) 2009, 2010 Peter Schüller
+ *
+ * This file is part of dlvhex.
+ *
+ * dlvhex is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * dlvhex is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with dlvhex; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+/**
+ * @file   TestUnfoundedSetChecker.cpp
+ *
+ * @brief  Tests that concurrent unfounded set checks of the components agree with sequential checks.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif // HAVE_CONFIG_H
+
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#define BOOST_TEST_MODULE __FILE__
+#include <boost/test/unit_test.hpp>
+
+#include "dlvhex2/UnfoundedSetChecker.h"
+#include "dlvhex2/AnnotatedGroundProgram.h"
+#include "dlvhex2/ProgramCtx.h"
+#include "dlvhex2/Registry.h"
+#include "dlvhex2/Interpretation.h"
+#include "dlvhex2/Logger.h"
+#include "fixtureRandomGroundProgram.h"
+
+LOG_INIT(Logger::ERROR | Logger::WARNING)
+
+DLVHEX_NAMESPACE_USE
+
+namespace
+{
+
+  // a head-cycle a0 v a1. a0 :- a1. a1 :- a0. and random rules over the atoms of one component
+  void createComponent(RandomGroundProgramGenerator& gen, ProgramCtx& ctx, const std::vector<ID>& atoms, std::vector<ID>& idb)
+  {
+    Tuple head, body;
+    head.push_back(atoms[0]);
+    head.push_back(atoms[1]);
+    idb.push_back(gen.storeRule(ctx, head, Tuple()));
+    for (int i = 0; i < 2; ++i) {
+      head = Tuple(1, atoms[i]);
+      body = Tuple(1, ID::posLiteralFromAtom(atoms[1 - i]));
+      idb.push_back(gen.storeRule(ctx, head, body));
+    }
+    for (int i = 0; i < 5; ++i) {
+      idb.push_back(gen.createRule(ctx, atoms, 3, 1, 2, 4));
+    }
+  }
+
+}
+
+BOOST_AUTO_TEST_CASE(testConcurrentCheckEqualsSequentialCheck)
+{
+  RandomGroundProgramGenerator gen(4711);
+  int unfounded = 0, founded = 0;
+  for (int round = 0; round < 50; ++round) {
+    ProgramCtx ctx;
+    ctx.setupRegistry(RegistryPtr(new Registry));
+
+    // several components with head-cycles
+    std::vector<ID> atoms, idb;
+    int components = 2 + round % 5;
+    for (int c = 0; c < components; ++c) {
+      std::stringstream prefix;
+      prefix << "c" << c << "_a";
+      std::vector<ID> componentAtoms = gen.createAtoms(ctx, 4, prefix.str());
+      createComponent(gen, ctx, componentAtoms, idb);
+      atoms.insert(atoms.end(), componentAtoms.begin(), componentAtoms.end());
+    }
+    InterpretationPtr edb(new Interpretation(ctx.registry()));
+    AnnotatedGroundProgram agp(ctx, OrdinaryASPProgram(ctx.registry(), idb, edb));
+    BOOST_REQUIRE(agp.hasHeadCycles());
+
+    // the managers are reused for all interpretations, as the checkers keep a state from one check to the next
+    ctx.config.setOption("UFSCheckThreads", 0);
+    UnfoundedSetCheckerManager sequential(ctx, agp);
+    ctx.config.setOption("UFSCheckThreads", 3);
+    UnfoundedSetCheckerManager concurrent(ctx, agp);
+
+    for (int i = 0; i < 20; ++i) {
+      InterpretationPtr intr = gen.createInterpretation(ctx, atoms, 2);
+
+      ctx.config.setOption("UFSCheckThreads", 0);
+      std::vector<IDAddress> expected = sequential.getUnfoundedSet(intr);
+      ctx.config.setOption("UFSCheckThreads", 3);
+      std::vector<IDAddress> ufs = concurrent.getUnfoundedSet(intr);
+
+      std::sort(expected.begin(), expected.end());
+      std::sort(ufs.begin(), ufs.end());
+      BOOST_CHECK(ufs == expected);
+      if (expected.size() > 0) {
+        Nogood expectedNogood = sequential.getLastUFSNogood();
+        Nogood nogood = concurrent.getLastUFSNogood();
+        expectedNogood.recomputeHash();
+        nogood.recomputeHash();
+        BOOST_CHECK(nogood == expectedNogood);
+        unfounded++;
+      }
+      else {
+        founded++;
+      }
+    }
+  }
+  // both verdicts occur
+  BOOST_CHECK(unfounded > 0);
+  BOOST_CHECK(founded > 0);
+}
+
+// Local Variables:
+// mode: C++
+// End:
@@ -209,6 +209,10 @@ public:
     return ModelGeneratorPtr(new ModelGenerator(input, *this));
   }
 
+  // the fixtures only enumerate fixed models, this can be done concurrently
+  virtual bool isThreadSafe() const
+    { return true; }
+
   // debug output
   virtual std::ostream& print(std::ostream& o) const
   {
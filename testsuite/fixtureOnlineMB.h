@@ -44,21 +44,23 @@
 // fixture for testing online model building with some underlying eval graph fixture
 // for that we add a final unit depending on all other units
 // and we setup model generator factories
-template<typename EvalGraphBaseFixtureT>
+// (the model builder can be exchanged to test other builders derived from OnlineModelBuilder)
+template<typename EvalGraphBaseFixtureT,
+  typename ModelBuilderT = dlvhex::OnlineModelBuilder<TestEvalGraph> >
 struct OnlineModelBuilderTFixture:
   public EvalGraphBaseFixtureT
 {
   typedef EvalGraphBaseFixtureT Base;
-  typedef dlvhex::OnlineModelBuilder<TestEvalGraph> ModelBuilder;
-  typedef ModelBuilder::OptionalModel OptionalModel;
+  typedef ModelBuilderT ModelBuilder;
+  typedef typename ModelBuilder::OptionalModel OptionalModel;
 
   dlvhex::ModelBuilderConfig<TestEvalGraph> cfg;
   ModelBuilder omb;
   EvalUnit ufinal;
 
-  OnlineModelBuilderTFixture():
+  OnlineModelBuilderTFixture(bool optimization = false):
     EvalGraphBaseFixtureT(),
-    cfg(Base::eg),
+    cfg(config(Base::eg, optimization)),
     omb(cfg)
   {
     LOG_SCOPE(INFO,"OnlineModelBuilderTFixture<...>", true);
@@ -86,6 +88,13 @@ struct OnlineModelBuilderTFixture:
   }
 
   ~OnlineModelBuilderTFixture() {}
+
+  static dlvhex::ModelBuilderConfig<TestEvalGraph> config(TestEvalGraph& eg, bool optimization)
+  {
+    dlvhex::ModelBuilderConfig<TestEvalGraph> cfg(eg);
+    cfg.optimization = optimization;
+    return cfg;
+  }
 };
 
 // create one E1 model building fixture
@@ -0,0 +1,113 @@
+/* dlvhex -- Answer-Set Programming with external interfaces.
+ * Copyright (C) 2005, 2006, 2007 Roman Schindlauer
+ * Copyright (C) 2006, 2007, 2008, 2009, 2010 Thomas Krennwallner
+ * Copyright (C) 2009, 2010 Peter Schüller
+ *
+ * This file is part of dlvhex.
+ *
+ * dlvhex is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * dlvhex is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with dlvhex; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA.
+ */
+
+/**
+ * @file   fixtureRandomGroundProgram.h
+ *
+ * @brief  Seeded generator of random ground atoms, rules and interpretations for randomized tests.
+ */
+
+#ifndef FIXTURE_RANDOM_GROUND_PROGRAM_HPP_INCLUDED
+#define FIXTURE_RANDOM_GROUND_PROGRAM_HPP_INCLUDED
+
+#include "dlvhex2/PlatformDefinitions.h"
+#include "dlvhex2/ProgramCtx.h"
+#include "dlvhex2/Registry.h"
+#include "dlvhex2/Interpretation.h"
+#include "dlvhex2/ID.h"
+
+#include <boost/foreach.hpp>
+#include <boost/random/mersenne_twister.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+// the same seed yields the same atoms, rules and interpretations on every platform
+class RandomGroundProgramGenerator
+{
+public:
+  RandomGroundProgramGenerator(unsigned seed):
+    rng(seed) {}
+
+  // random number in [0, n)
+  unsigned random(unsigned n)
+  { return rng() % n; }
+
+  // true with probability 1/n
+  bool oneIn(unsigned n)
+  { return random(n) == 0; }
+
+  // creates ground atoms <prefix>0, ..., <prefix>(n-1)
+  std::vector<dlvhex::ID> createAtoms(dlvhex::ProgramCtx& ctx, int n, const std::string& prefix = "a")
+  {
+    std::vector<dlvhex::ID> atoms;
+    for (int i = 0; i < n; ++i) {
+      std::stringstream ss;
+      ss << prefix << i;
+      dlvhex::OrdinaryAtom atom(dlvhex::ID::MAINKIND_ATOM | dlvhex::ID::SUBKIND_ATOM_ORDINARYG);
+      atom.tuple.push_back(ctx.registry()->storeConstantTerm(ss.str()));
+      atoms.push_back(ctx.registry()->storeOrdinaryGAtom(atom));
+    }
+    return atoms;
+  }
+
+  dlvhex::ID storeRule(dlvhex::ProgramCtx& ctx, const dlvhex::Tuple& head, const dlvhex::Tuple& body)
+  {
+    dlvhex::Rule r(dlvhex::ID::MAINKIND_RULE | dlvhex::ID::SUBKIND_RULE_REGULAR |
+      (head.size() > 1 ? dlvhex::ID::PROPERTY_RULE_DISJ : 0), head, body);
+    return ctx.registry()->storeRule(r);
+  }
+
+  // random rule with a second head atom with probability 1/disjunctionOneIn,
+  // between minBody and maxBody body literals, each of them default-negated with probability 1/nafOneIn
+  dlvhex::ID createRule(dlvhex::ProgramCtx& ctx, const std::vector<dlvhex::ID>& atoms, unsigned disjunctionOneIn, unsigned minBody, unsigned maxBody, unsigned nafOneIn)
+  {
+    dlvhex::Tuple head, body;
+    head.push_back(atoms[random(atoms.size())]);
+    if (oneIn(disjunctionOneIn)) {
+      dlvhex::ID h = atoms[random(atoms.size())];
+      if (h != head[0]) head.push_back(h);
+    }
+    unsigned bodySize = minBody + random(maxBody - minBody + 1);
+    for (unsigned j = 0; j < bodySize; ++j) {
+      body.push_back(dlvhex::ID::literalFromAtom(atoms[random(atoms.size())], oneIn(nafOneIn)));
+    }
+    return storeRule(ctx, head, body);
+  }
+
+  // interpretation containing each of the atoms with probability 1/oneInN
+  dlvhex::InterpretationPtr createInterpretation(dlvhex::ProgramCtx& ctx, const std::vector<dlvhex::ID>& atoms, unsigned oneInN)
+  {
+    dlvhex::InterpretationPtr intr(new dlvhex::Interpretation(ctx.registry()));
+    BOOST_FOREACH (dlvhex::ID a, atoms) {
+      if (oneIn(oneInN)) intr->setFact(a.address);
+    }
+    return intr;
+  }
+
+private:
+  boost::mt19937 rng;
+};
+
+#endif // FIXTURE_RANDOM_GROUND_PROGRAM_HPP_INCLUDED